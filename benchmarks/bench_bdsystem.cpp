@@ -0,0 +1,53 @@
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+
+#include "steps/solver/efield/bdsystem.hpp"
+
+#include "bench_common.hpp"
+
+using steps::solver::efield::BDSystem;
+
+// Fill a diagonally dominant banded system, similar in shape to the
+// membrane potential systems built by the EField solver.
+static void fillSystem(BDSystem & sys, std::size_t n, std::size_t halfbw)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        double offsum = 0.0;
+        std::size_t lo = i < halfbw ? 0 : i - halfbw;
+        std::size_t hi = i + halfbw < n ? i + halfbw : n - 1;
+        for (std::size_t j = lo; j <= hi; ++j) {
+            if (j == i) continue;
+            double v = -1.0 / (1.0 + (i + 2 * j) % 5);
+            sys.A()[i][j] = v;
+            offsum -= v;
+        }
+        sys.A()[i][i] = offsum + 1.0;
+        sys.b()[i] = 1.0 + i % 3;
+    }
+}
+
+// Args: system size, half bandwidth.
+static void BM_BDSystem_solve(benchmark::State & state)
+{
+    std::size_t n = state.range(0);
+    std::size_t halfbw = state.range(1);
+    BDSystem sys(n, halfbw);
+
+    bench::AllocScope alloc;
+    for (auto _ : state) {
+        // solve() overwrites the matrix, so refill outside the timing.
+        state.PauseTiming();
+        fillSystem(sys, n, halfbw);
+        state.ResumeTiming();
+        sys.solve();
+        benchmark::DoNotOptimize(sys.x()[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    alloc.report(state);
+}
+BENCHMARK(BM_BDSystem_solve)
+    ->Args({1000, 10})->Args({10000, 30})->Args({50000, 60})
+    ->Unit(benchmark::kMicrosecond);
+
+// END
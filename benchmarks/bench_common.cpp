@@ -0,0 +1,116 @@
+#include <string>
+#include <vector>
+
+#include "steps/geom/tmcomp.hpp"
+#include "steps/geom/tmpatch.hpp"
+#include "steps/model/diff.hpp"
+#include "steps/model/reac.hpp"
+#include "steps/model/spec.hpp"
+#include "steps/model/sreac.hpp"
+#include "steps/model/surfsys.hpp"
+#include "steps/model/volsys.hpp"
+#include "steps/rng/create.hpp"
+
+#include "bench_common.hpp"
+#include "kuhn_cube.hpp"
+
+namespace smod = steps::model;
+namespace stm = steps::tetmesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+void bench::cubeMeshData(uint n, double side, std::vector<double> & verts, std::vector<uint> & tets)
+{
+    KuhnCube cube(n, side / n);
+    verts = cube.verts;
+    tets = cube.tets;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<stm::Tetmesh> bench::cubeMesh(uint n, double side, bool with_patch)
+{
+    std::vector<double> verts;
+    std::vector<uint> tets;
+    cubeMeshData(n, side, verts, tets);
+
+    std::unique_ptr<stm::Tetmesh> mesh(new stm::Tetmesh(verts, tets));
+
+    std::vector<uint> all(mesh->countTets());
+    for (uint t = 0; t < all.size(); ++t) all[t] = t;
+    auto * comp = new stm::TmComp("comp", mesh.get(), all);
+    comp->addVolsys("vsys");
+
+    if (with_patch) {
+        std::vector<uint> bottom;
+        for (int t : mesh->getSurfTris()) {
+            bool on_face = true;
+            for (uint v : mesh->getTri(t)) {
+                if (mesh->getVertex(v)[2] != 0.0) on_face = false;
+            }
+            if (on_face) bottom.push_back(t);
+        }
+        auto * patch = new stm::TmPatch("patch", mesh.get(), bottom, comp);
+        patch->addSurfsys("ssys");
+    }
+    return mesh;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void bench::reacDiffModel(smod::Model & m, bool with_surface)
+{
+    auto * A = new smod::Spec("A", &m);
+    auto * B = new smod::Spec("B", &m);
+    auto * C = new smod::Spec("C", &m);
+
+    auto * vsys = new smod::Volsys("vsys", &m);
+    new smod::Reac("fwd", vsys, {A, B}, {C}, 1.0e8);
+    new smod::Reac("bwd", vsys, {C}, {A, B}, 10.0);
+    new smod::Diff("diffA", vsys, A, 1.0e-12);
+    new smod::Diff("diffB", vsys, B, 5.0e-13);
+    new smod::Diff("diffC", vsys, C, 2.0e-13);
+
+    if (with_surface) {
+        auto * R = new smod::Spec("R", &m);
+        auto * AR = new smod::Spec("AR", &m);
+        auto * ssys = new smod::Surfsys("ssys", &m);
+        new smod::SReac("sfwd", ssys, {}, {A}, {R}, {}, {AR}, {}, 1.0e8);
+        new smod::SReac("sbwd", ssys, {}, {}, {AR}, {A}, {R}, {}, 5.0);
+        new smod::Diff("diffR", ssys, R, 1.0e-13);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void bench::diffModel(smod::Model & m)
+{
+    auto * D = new smod::Spec("D", &m);
+    auto * vsys = new smod::Volsys("vsys", &m);
+    new smod::Diff("diffD", vsys, D, 1.0e-12);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void bench::ringModel(smod::Model & m, uint nreacs)
+{
+    std::vector<smod::Spec *> specs;
+    for (uint i = 0; i < nreacs; ++i) {
+        specs.push_back(new smod::Spec("X" + std::to_string(i), &m));
+    }
+    auto * vsys = new smod::Volsys("vsys", &m);
+    for (uint i = 0; i < nreacs; ++i) {
+        new smod::Reac("r" + std::to_string(i), vsys, {specs[i]}, {specs[(i + 1) % nreacs]}, 1.0 + i % 7);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<steps::rng::RNG> bench::makeRNG(std::string const & name, uint seed)
+{
+    std::unique_ptr<steps::rng::RNG> r(steps::rng::create(name, 1024));
+    r->initialize(seed);
+    return r;
+}
+
+// END
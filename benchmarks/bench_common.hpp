@@ -0,0 +1,95 @@
+#ifndef STEPS_BENCHMARKS_BENCH_COMMON_HPP
+#define STEPS_BENCHMARKS_BENCH_COMMON_HPP 1
+
+// Synthetic meshes and models shared by the benchmarks. Everything here is
+// deterministic so that results are comparable between builds.
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "steps/common.h"
+#include "steps/geom/tetmesh.hpp"
+#include "steps/model/model.hpp"
+#include "steps/rng/rng.hpp"
+
+namespace bench {
+
+////////////////////////////////////////////////////////////////////////////////
+// Allocation accounting, fed by the operator new replacement in main.cpp.
+
+extern std::atomic<std::size_t> bytes_allocated;
+extern std::atomic<std::size_t> n_allocations;
+
+/// Records allocation totals on construction; report() publishes the
+/// per-iteration averages since then as benchmark counters.
+class AllocScope
+{
+public:
+    AllocScope()
+    : pBytes(bytes_allocated.load())
+    , pCount(n_allocations.load())
+    {}
+
+    void report(benchmark::State & state) const
+    {
+        double bytes = static_cast<double>(bytes_allocated.load() - pBytes);
+        double count = static_cast<double>(n_allocations.load() - pCount);
+        state.counters["bytes_alloc"] = benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+        state.counters["allocs"] = benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    std::size_t pBytes;
+    std::size_t pCount;
+};
+
+/// Publish \a events as an events/second rate.
+inline void reportEvents(benchmark::State & state, double events)
+{
+    state.counters["events/s"] = benchmark::Counter(events, benchmark::Counter::kIsRate);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Geometry.
+
+/// Vertices and tetrahedra of a unit cube of side \a side split into
+/// n^3 sub-cubes of 6 Kuhn tetrahedra each.
+void cubeMeshData(uint n, double side, std::vector<double> & verts, std::vector<uint> & tets);
+
+/// Cube mesh with a single compartment "comp" (volume system "vsys") and,
+/// if \a with_patch, a patch "patch" (surface system "ssys") on the z = 0
+/// face.
+std::unique_ptr<steps::tetmesh::Tetmesh> cubeMesh(uint n, double side, bool with_patch = false);
+
+////////////////////////////////////////////////////////////////////////////////
+// Models.
+
+/// A + B <-> C with diffusion of all species in volume system "vsys";
+/// if \a with_surface, also A + R <-> AR with diffusion of R in surface
+/// system "ssys".
+void reacDiffModel(steps::model::Model & m, bool with_surface = false);
+
+/// Pure diffusion of species "D" in volume system "vsys".
+void diffModel(steps::model::Model & m);
+
+/// \a nreacs first order reactions X_i -> X_{i+1 mod nreacs} in volume
+/// system "vsys", giving a flat propensity profile for well-mixed solvers.
+void ringModel(steps::model::Model & m, uint nreacs);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Seeded RNG owned by the caller.
+std::unique_ptr<steps::rng::RNG> makeRNG(std::string const & name, uint seed = 1234);
+
+}
+
+#endif
+
+// STEPS_BENCHMARKS_BENCH_COMMON_HPP
+
+// END
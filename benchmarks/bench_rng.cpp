@@ -0,0 +1,51 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "steps/rng/rng.hpp"
+
+#include "bench_common.hpp"
+
+// Arg 0: generator (0 = mt19937, 1 = r123).
+static std::string rngName(benchmark::State const & state)
+{
+    return state.range(0) == 0 ? "mt19937" : "r123";
+}
+
+static void BM_RNG_getExp(benchmark::State & state)
+{
+    auto r = bench::makeRNG(rngName(state));
+    bench::AllocScope alloc;
+    double acc = 0.0;
+    for (auto _ : state) {
+        acc += r->getExp(2.5);
+    }
+    benchmark::DoNotOptimize(acc);
+    bench::reportEvents(state, state.iterations());
+    alloc.report(state);
+    state.SetLabel(rngName(state));
+}
+BENCHMARK(BM_RNG_getExp)->Arg(0)->Arg(1);
+
+// Args: generator, number of trials, success probability in 1/1000.
+static void BM_RNG_getBinom(benchmark::State & state)
+{
+    auto r = bench::makeRNG(rngName(state));
+    uint n = static_cast<uint>(state.range(1));
+    double p = state.range(2) / 1000.0;
+
+    bench::AllocScope alloc;
+    uint acc = 0;
+    for (auto _ : state) {
+        acc += r->getBinom(n, p);
+    }
+    benchmark::DoNotOptimize(acc);
+    bench::reportEvents(state, state.iterations());
+    alloc.report(state);
+    state.SetLabel(rngName(state));
+}
+BENCHMARK(BM_RNG_getBinom)
+    ->Args({0, 10, 300})->Args({0, 1000, 300})->Args({0, 100000, 10})
+    ->Args({1, 10, 300})->Args({1, 1000, 300})->Args({1, 100000, 10});
+
+// END
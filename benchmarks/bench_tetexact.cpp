@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "steps/model/model.hpp"
+#include "steps/tetexact/tetexact.hpp"
+
+#include "bench_common.hpp"
+
+// A Tetexact simulation of the reaction-diffusion cube model, populated so
+// that reaction and diffusion events are both frequent.
+struct TetexactFixture
+{
+    explicit TetexactFixture(uint n)
+    : model()
+    , mesh()
+    , rng(bench::makeRNG("r123"))
+    , sim()
+    {
+        bench::reacDiffModel(model, true);
+        mesh = bench::cubeMesh(n, 1.0e-6, true);
+        sim.reset(new steps::tetexact::Tetexact(&model, mesh.get(), rng.get()));
+        double ntets = mesh->countTets();
+        sim->setCompCount("comp", "A", 4.0 * ntets);
+        sim->setCompCount("comp", "B", 3.0 * ntets);
+        sim->setPatchCount("patch", "R", 0.5 * ntets);
+    }
+
+    steps::model::Model                                 model;
+    std::unique_ptr<steps::tetmesh::Tetmesh>            mesh;
+    std::unique_ptr<steps::rng::RNG>                    rng;
+    std::unique_ptr<steps::tetexact::Tetexact>          sim;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// One SSA event per iteration: Tetexact::_getNext and _executeStep,
+// including the dependent propensity updates. Arg: cube subdivisions.
+static void BM_Tetexact_step(benchmark::State & state)
+{
+    TetexactFixture fx(state.range(0));
+
+    bench::AllocScope alloc;
+    for (auto _ : state) {
+        fx.sim->step();
+    }
+    bench::reportEvents(state, state.iterations());
+    alloc.report(state);
+}
+BENCHMARK(BM_Tetexact_step)->Arg(5)->Arg(10)->Arg(20);
+
+////////////////////////////////////////////////////////////////////////////////
+
+static double fileSize(std::string const & path)
+{
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    return static_cast<double>(f.tellg());
+}
+
+// Arg: cube subdivisions.
+static void BM_Tetexact_checkpoint(benchmark::State & state)
+{
+    TetexactFixture fx(state.range(0));
+    fx.sim->run(1.0e-3);
+    std::string path = "steps_bench_tetexact.cp";
+
+    bench::AllocScope alloc;
+    for (auto _ : state) {
+        fx.sim->checkpoint(path);
+    }
+    state.SetBytesProcessed(state.iterations() * fileSize(path));
+    alloc.report(state);
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_Tetexact_checkpoint)->Arg(10)->Arg(20)->Unit(benchmark::kMillisecond);
+
+// Arg: cube subdivisions.
+static void BM_Tetexact_restore(benchmark::State & state)
+{
+    TetexactFixture fx(state.range(0));
+    fx.sim->run(1.0e-3);
+    std::string path = "steps_bench_tetexact.cp";
+    fx.sim->checkpoint(path);
+
+    bench::AllocScope alloc;
+    for (auto _ : state) {
+        fx.sim->restore(path);
+    }
+    state.SetBytesProcessed(state.iterations() * fileSize(path));
+    alloc.report(state);
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_Tetexact_restore)->Arg(10)->Arg(20)->Unit(benchmark::kMillisecond);
+
+// END
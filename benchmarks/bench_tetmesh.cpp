@@ -0,0 +1,27 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "steps/geom/tetmesh.hpp"
+
+#include "bench_common.hpp"
+
+// Arg: cube subdivisions per side (6 n^3 tetrahedra).
+static void BM_Tetmesh_construct(benchmark::State & state)
+{
+    std::vector<double> verts;
+    std::vector<uint> tets;
+    bench::cubeMeshData(state.range(0), 1.0e-6, verts, tets);
+    uint ntets = tets.size() / 4;
+
+    bench::AllocScope alloc;
+    for (auto _ : state) {
+        steps::tetmesh::Tetmesh mesh(verts, tets);
+        benchmark::DoNotOptimize(mesh.countTris());
+    }
+    state.SetItemsProcessed(state.iterations() * ntets);
+    alloc.report(state);
+}
+BENCHMARK(BM_Tetmesh_construct)->Arg(8)->Arg(16)->Arg(24)->Unit(benchmark::kMillisecond);
+
+// END
@@ -0,0 +1,40 @@
+#include <map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "steps/model/model.hpp"
+#include "steps/mpi/tetopsplit/tetopsplit.hpp"
+
+#include "bench_common.hpp"
+
+// Operator-split diffusion on a single rank: every iteration advances the
+// simulation by a fixed interval, which is dominated by the binomial
+// sampling of molecules leaving each tetrahedron. Reports diffused
+// molecules per second. Arg: cube subdivisions.
+static void BM_TetOpSplitP_diffusion(benchmark::State & state)
+{
+    steps::model::Model model;
+    bench::diffModel(model);
+    auto mesh = bench::cubeMesh(state.range(0), 1.0e-6);
+    auto rng = bench::makeRNG("r123");
+
+    std::vector<uint> tet_hosts(mesh->countTets(), 0);
+    std::map<uint, uint> tri_hosts;
+    steps::mpi::tetopsplit::TetOpSplitP sim(&model, mesh.get(), rng.get(),
+        steps::solver::API::EF_NONE, tet_hosts, tri_hosts);
+    sim.setCompCount("comp", "D", 100.0 * mesh->countTets());
+
+    const double interval = 1.0e-4;
+    double start_extent = sim.getDiffExtent(true);
+
+    bench::AllocScope alloc;
+    for (auto _ : state) {
+        sim.run(sim.getTime() + interval);
+    }
+    bench::reportEvents(state, sim.getDiffExtent(true) - start_extent);
+    alloc.report(state);
+}
+BENCHMARK(BM_TetOpSplitP_diffusion)->Arg(5)->Arg(10)->Arg(20)->Unit(benchmark::kMillisecond);
+
+// END
@@ -0,0 +1,53 @@
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "steps/geom/comp.hpp"
+#include "steps/geom/geom.hpp"
+#include "steps/model/model.hpp"
+#include "steps/wmdirect/wmdirect.hpp"
+#include "steps/wmrssa/wmrssa.hpp"
+
+#include "bench_common.hpp"
+
+// Time single SSA events of a well-mixed solver on a ring of first order
+// reactions. Arg: number of reactions.
+template <typename Solver>
+static void wellMixedStep(benchmark::State & state)
+{
+    uint nreacs = state.range(0);
+
+    steps::model::Model model;
+    bench::ringModel(model, nreacs);
+    steps::wm::Geom geom;
+    auto * comp = new steps::wm::Comp("comp", &geom, 1.0e-18);
+    comp->addVolsys("vsys");
+
+    auto r = bench::makeRNG("r123");
+    Solver sim(&model, &geom, r.get());
+    for (uint i = 0; i < nreacs; ++i) {
+        sim.setCompCount("comp", "X" + std::to_string(i), 100.0);
+    }
+
+    bench::AllocScope alloc;
+    for (auto _ : state) {
+        sim.step();
+    }
+    bench::reportEvents(state, state.iterations());
+    alloc.report(state);
+}
+
+static void BM_Wmdirect_step(benchmark::State & state)
+{
+    wellMixedStep<steps::wmdirect::Wmdirect>(state);
+}
+BENCHMARK(BM_Wmdirect_step)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_Wmrssa_step(benchmark::State & state)
+{
+    wellMixedStep<steps::wmrssa::Wmrssa>(state);
+}
+BENCHMARK(BM_Wmrssa_step)->Arg(10)->Arg(100)->Arg(1000);
+
+// END
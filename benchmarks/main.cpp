@@ -0,0 +1,74 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+#include "benchmark/benchmark.h"
+
+#include "bench_common.hpp"
+
+std::atomic<std::size_t> bench::bytes_allocated(0);
+std::atomic<std::size_t> bench::n_allocations(0);
+
+////////////////////////////////////////////////////////////////////////////////
+// Count every heap allocation made by the process, including those made
+// inside libsteps, so that benchmarks can report bytes allocated.
+
+void * operator new(std::size_t size)
+{
+    bench::bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+    bench::n_allocations.fetch_add(1, std::memory_order_relaxed);
+    void * p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void * operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv)
+{
+#ifdef USE_MPI
+    // TetOpSplitP requires MPI; the benchmarks run on a single rank.
+    MPI_Init(&argc, &argv);
+#endif
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+#ifdef USE_MPI
+    MPI_Finalize();
+#endif
+    return 0;
+}
+
+// END
@@ -1287,6 +1287,124 @@ cdef class _py_Tetmesh(_py_Geom):
         """
         return self.ptrx().findTetByPoint(p)
 
+    def findTetsByPoints(self, std.vector[double] points):
+        """
+        Returns the indices of the tetrahedrons which encompass a list of
+        points (given in Cartesian coordinates x0,y0,z0,x1,y1,z1,...),
+        with -1 for each point outside the mesh.
+
+        Syntax::
+
+            findTetsByPoints(points)
+
+        Arguments:
+        list<float, length = 3 * number of points> points
+
+        Return:
+        list<int, length = number of points>
+
+        """
+        return self.ptrx().findTetsByPoints(points)
+
+    def findTetsByPointsNP(self, double[:] points, int[:] tets):
+        """
+        Find the tetrahedrons which encompass a list of points, write
+        their indices (-1 for points outside the mesh) into tets.
+
+        Syntax::
+
+            import numpy as np
+            points = np.array([0.0, 0.0, 0.0, 1e-6, 1e-6, 1e-6])
+            tets = np.zeros(len(points) // 3, dtype = np.intc)
+            findTetsByPointsNP(points, tets)
+
+        Arguments:
+        numpy.array<float> points
+        numpy.array<int, length = len(points) / 3> tets
+
+        Return:
+        None
+
+        """
+        self.ptrx().findTetsByPointsNP(&points[0], points.shape[0], &tets[0], tets.shape[0])
+
+    def getTetsInBox(self, std.vector[double] lo, std.vector[double] hi):
+        """
+        Returns the indices of the tetrahedrons whose barycentres lie in
+        the axis-aligned box from lo to hi.
+
+        Syntax::
+
+            getTetsInBox(lo, hi)
+
+        Arguments:
+        list<float, length = 3> lo
+        list<float, length = 3> hi
+
+        Return:
+        list<int>
+
+        """
+        return self.ptrx().getTetsInBox(lo, hi)
+
+    def getTetsInSphere(self, std.vector[double] centre, double radius):
+        """
+        Returns the indices of the tetrahedrons whose barycentres lie in
+        the sphere of given centre and radius.
+
+        Syntax::
+
+            getTetsInSphere(centre, radius)
+
+        Arguments:
+        list<float, length = 3> centre
+        float radius
+
+        Return:
+        list<int>
+
+        """
+        return self.ptrx().getTetsInSphere(centre, radius)
+
+    def getTetsInCylinder(self, std.vector[double] p0, std.vector[double] p1, double radius):
+        """
+        Returns the indices of the tetrahedrons whose barycentres lie in
+        the cylinder of given radius around the axis from p0 to p1.
+
+        Syntax::
+
+            getTetsInCylinder(p0, p1, radius)
+
+        Arguments:
+        list<float, length = 3> p0
+        list<float, length = 3> p1
+        float radius
+
+        Return:
+        list<int>
+
+        """
+        return self.ptrx().getTetsInCylinder(p0, p1, radius)
+
+    def getSurfTrisNearPoint(self, std.vector[double] p, double radius):
+        """
+        Returns the indices of the surface triangles of the mesh whose
+        closest point to p is within the given distance.
+
+        Syntax::
+
+            getSurfTrisNearPoint(p, radius)
+
+        Arguments:
+        list<float, length = 3> p
+        float radius
+
+        Return:
+        list<int>
+
+        """
+        return self.ptrx().getSurfTrisNearPoint(p, radius)
+
     def getBoundMin(self, ):
         """
         Returns the minimal Cartesian coordinate of the rectangular bounding box of the mesh.
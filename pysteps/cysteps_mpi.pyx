@@ -39,14 +39,14 @@ cdef class _py_TetOpSplitP(_py_API):
     cdef TetOpSplitP *ptrx(self):
         return <TetOpSplitP*> self._ptr
 
-    def __init__(self, _py_Model model, _py_Geom geom, _py_RNG rng, int calcMembPot=0, std.vector[uint] tet_hosts = [], dict tri_hosts = {}, std.vector[uint] wm_hosts = []):
+    def __init__(self, _py_Model model, _py_Geom geom, _py_RNG rng, int calcMembPot=0, std.vector[uint] tet_hosts = [], dict tri_hosts = {}, std.vector[uint] wm_hosts = [], std.vector[uint] tet_gidx = [], std.vector[uint] tri_gidx = []):
         """        
         Construction::
         
             sim = steps.solver.TetOpSplit(model, geom, rng, tet_hosts=[], tri_hosts={}, wm_hosts=[], calcMembPot=0)
         
         Create a spatial stochastic solver based on operator splitting, that is that reaction events are partitioned and diffusion is approximated. 
-        If voltage is to be simulated, argument calcMembPot specifies the solver e.g. calcMembPot=steps.solver.EF_DV_PETSC will utilise the PETSc library. calcMembPot=0 means voltage will not be simulated. 
+        If voltage is to be simulated, argument calcMembPot specifies the solver e.g. calcMembPot=steps.solver.EF_DV_PETSC will utilise the PETSc library, and calcMembPot=steps.solver.EF_DV_DIST solves on the same partition as the reaction-diffusion, each rank holding the rows of its own vertices. calcMembPot=0 means voltage will not be simulated. 
         
         Arguments:
         steps.model.Model model
@@ -56,6 +56,19 @@ cdef class _py_TetOpSplitP(_py_API):
         dict<int, int> tri_hosts (default={})
         list<int> wm_hosts (default=[])
         int calcMemPot (default=0)
+        list<int> tet_gidx (default=[])
+        list<int> tri_gidx (default=[])
+        
+        If tet_hosts is empty, the mesh is partitioned by the solver: recursive
+        coordinate bisection weighted by the number of kinetic processes of
+        each element, refined to reduce the number of cut faces. Patch triangles
+        are then placed with their tetrahedrons, and tri_hosts must be empty.
+        
+        If tet_gidx is given, geom is only this process's part of the mesh, as
+        built by steps.utilities.geom_decompose.distributeMesh: tet_hosts and
+        tri_hosts are indexed by its own tetrahedrons and triangles, and
+        tet_gidx and tri_gidx give their indices in the whole mesh, which all
+        per-element methods are then called with.
         
         """
         cdef std.map[uint, uint] _tri_hosts
@@ -68,7 +81,7 @@ cdef class _py_TetOpSplitP(_py_API):
             raise TypeError('The Geom object is empty.')
         if rng == None:
             raise TypeError('The RNG object is empty.')
-        self._ptr = new TetOpSplitP(model.ptr(), geom.ptr(), rng.ptr(), calcMembPot, tet_hosts, _tri_hosts, wm_hosts)
+        self._ptr = new TetOpSplitP(model.ptr(), geom.ptr(), rng.ptr(), calcMembPot, tet_hosts, _tri_hosts, wm_hosts, tet_gidx, tri_gidx)
 
     def getSolverName(self, ):
         """
@@ -228,6 +241,9 @@ cdef class _py_TetOpSplitP(_py_API):
     def restore(self, str file_name):
         """
         Restore data from a file.
+        The mesh elements are moved back to the partition they had when the
+        checkpoint was written. If the checkpoint is missing, truncated or was
+        written for another model, every process raises and the state is unchanged.
             
         Syntax::
             
@@ -602,6 +618,219 @@ cdef class _py_TetOpSplitP(_py_API):
 
         return self.ptrx().sumBatchTriOhmicIsNP(&tri_array[0], tri_array.shape[0], ghk)
 
+    # ---------------------------------------------------------------------------------
+    # Recorded observables section
+    # ---------------------------------------------------------------------------------
+    def addTetCountObservable(self, std.vector[uint] tets, str s):
+        """
+        Declare the counts of species s in a list of tetrahedrons as an observable
+        recorded by recordObservables() and runAndRecord().
+
+        This function is called globally in all processes.
+
+        Syntax::
+
+            addTetCountObservable(tets, s)
+
+        Arguments:
+        list<int> tets
+        string s
+
+        Return:
+        int
+
+        """
+        if not isinstance(s, bytes):
+            s = s.encode()
+
+        return self.ptrx().addTetCountObservable(tets, s)
+
+    def addTriCountObservable(self, std.vector[uint] tris, str s):
+        """
+        Declare the counts of species s in a list of triangles as an observable
+        recorded by recordObservables() and runAndRecord().
+
+        This function is called globally in all processes.
+
+        Syntax::
+
+            addTriCountObservable(tris, s)
+
+        Arguments:
+        list<int> tris
+        string s
+
+        Return:
+        int
+
+        """
+        if not isinstance(s, bytes):
+            s = s.encode()
+
+        return self.ptrx().addTriCountObservable(tris, s)
+
+    def countObservables(self):
+        """
+        Return the number of declared observables.
+
+        Syntax::
+
+            countObservables()
+
+        Arguments:
+        None
+
+        Return:
+        int
+
+        """
+        return self.ptrx().countObservables()
+
+    def recordObservables(self):
+        """
+        Buffer a sample of all observables at the current time.
+        No communication takes place until flushObservables().
+
+        Syntax::
+
+            recordObservables()
+
+        Arguments:
+        None
+
+        Return:
+        None
+
+        """
+        self.ptrx().recordObservables()
+
+    def runAndRecord(self, std.vector[double] times):
+        """
+        Run the simulation to each of the ascending times and buffer
+        a sample of all observables there.
+
+        Syntax::
+
+            runAndRecord(times)
+
+        Arguments:
+        list<float> times
+
+        Return:
+        None
+
+        """
+        self.ptrx().runAndRecord(times)
+
+    def flushObservables(self, bool rank_local=False):
+        """
+        Move the buffered samples into the observable data, gathered on
+        rank 0 with a single collective or, if rank_local, kept on the
+        owning process.
+
+        This function is called globally in all processes.
+
+        Syntax::
+
+            flushObservables(rank_local)
+
+        Arguments:
+        bool rank_local (default=False)
+
+        Return:
+        None
+
+        """
+        self.ptrx().flushObservables(rank_local)
+
+    def getObservableTimes(self):
+        """
+        Return the times of the flushed samples.
+
+        Syntax::
+
+            getObservableTimes()
+
+        Arguments:
+        None
+
+        Return:
+        list<float>
+
+        """
+        return self.ptrx().getObservableTimes()
+
+    def getObservableData(self, uint obs):
+        """
+        Return the flushed samples of an observable on rank 0 as a
+        row-major list, one row of counts per sample. Empty on other ranks.
+
+        Syntax::
+
+            getObservableData(obs)
+
+        Arguments:
+        int obs
+
+        Return:
+        list<float>
+
+        """
+        return self.ptrx().getObservableData(obs)
+
+    def getObservableLocalPositions(self, uint obs):
+        """
+        Return the positions in the observable element list owned by this process.
+
+        Syntax::
+
+            getObservableLocalPositions(obs)
+
+        Arguments:
+        int obs
+
+        Return:
+        list<int>
+
+        """
+        return self.ptrx().getObservableLocalPositions(obs)
+
+    def getObservableLocalData(self, uint obs):
+        """
+        Return the samples of an observable flushed with rank_local as a
+        row-major list, one row of counts at getObservableLocalPositions() per sample.
+        Rows flushed before a repartition or rebalance read zero.
+
+        Syntax::
+
+            getObservableLocalData(obs)
+
+        Arguments:
+        int obs
+
+        Return:
+        list<float>
+
+        """
+        return self.ptrx().getObservableLocalData(obs)
+
+    def clearObservableData(self):
+        """
+        Drop all buffered and flushed samples, keeping the declared observables.
+
+        Syntax::
+
+            clearObservableData()
+
+        Arguments:
+        None
+
+        Return:
+        None
+
+        """
+        self.ptrx().clearObservableData()
+
     # ---------------------------------------------------------------------------------
     # ROI section
     # ---------------------------------------------------------------------------------
@@ -1337,6 +1566,185 @@ cdef class _py_TetOpSplitP(_py_API):
         cdef std.map[uint, uint] _tri_hosts = tri_hosts
         self.ptrx().repartitionAndReset(tet_hosts, _tri_hosts, wm_hosts)
 
+    def setRebalanceInterval(self, uint interval, double threshold=1.2):
+        """
+        Enable automatic load rebalancing.
+        
+        Every interval diffusion update periods the work of each process
+        (SSA events, diffused molecules and visited diffusion rules) is
+        compared. If the busiest process exceeds the mean by more than
+        threshold, the mesh is repartitioned by the measured work and the
+        simulation state is migrated between processes without a reset.
+        An interval of 0 disables automatic rebalancing.
+        
+        Syntax::
+            
+            setRebalanceInterval(interval, threshold)
+            
+        Arguments:
+        uint interval
+        float threshold (default = 1.2)
+        
+        Return:
+            None
+        """
+        self.ptrx().setRebalanceInterval(interval, threshold)
+
+    def rebalance(self, ):
+        """
+        Repartition the mesh by the work measured since the last rebalance
+        and migrate the simulation state, without resetting the simulation.
+        
+        Syntax::
+            
+            rebalance()
+            
+        Arguments:
+        None
+        
+        Return:
+            None
+        """
+        self.ptrx().rebalance()
+
+    def getRebalanceCount(self, ):
+        """
+        Return the number of rebalances done so far.
+        
+        Syntax::
+            
+            getRebalanceCount()
+            
+        Arguments:
+        None
+        
+        Return:
+        uint
+        """
+        return self.ptrx().getRebalanceCount()
+
+    def setDiffusionThreads(self, uint nthreads):
+        """
+        Set the number of OpenMP threads applying the diffusions of
+        tetrahedrons and triangles that have no neighbour on another
+        process. With more than one thread each thread draws from its
+        own random number stream, so results differ from the
+        single-threaded run but do not depend on thread scheduling
+        or on how the simulation is split into run() calls. More than
+        one thread requires MPI_THREAD_FUNNELED support from the MPI
+        library.
+        
+        Syntax::
+            
+            setDiffusionThreads(nthreads)
+            
+        Arguments:
+        uint nthreads
+        
+        Return:
+            None
+        """
+        self.ptrx().setDiffusionThreads(nthreads)
+
+    def getDiffusionThreads(self, ):
+        """
+        Return the number of threads applying interior diffusions.
+        
+        Syntax::
+            
+            getDiffusionThreads()
+            
+        Arguments:
+        None
+        
+        Return:
+        uint
+        """
+        return self.ptrx().getDiffusionThreads()
+
+    def setDiffusionRateLevels(self, uint nlevels):
+        """
+        Set the number of power-of-two update periods diffusions are
+        binned into by their own scaled diffusion constant. A diffusion
+        of level l is applied every 2^l update periods, from the
+        occupancy of its species over those periods, and molecule
+        changes are only exchanged between processes in periods where a
+        level with diffusions on a process boundary is applied. All
+        levels are applied in the last period of a run, and automatic
+        rebalancing waits for such a period. One level (the default) is
+        the single-rate scheme.
+        
+        Syntax::
+            
+            setDiffusionRateLevels(nlevels)
+            
+        Arguments:
+        uint nlevels
+        
+        Return:
+            None
+        """
+        self.ptrx().setDiffusionRateLevels(nlevels)
+
+    def getDiffusionRateLevels(self, ):
+        """
+        Return the number of diffusion rate levels.
+        
+        Syntax::
+            
+            getDiffusionRateLevels()
+            
+        Arguments:
+        None
+        
+        Return:
+        uint
+        """
+        return self.ptrx().getDiffusionRateLevels()
+
+    def setElementRNG(self, bool enable, unsigned long seed=0):
+        """
+        Draw the random numbers of each diffusion update and of the
+        reactions from their own counter-based streams, derived from seed
+        (which must be the same on all processes), the iteration and the
+        tetrahedron or triangle. Reactions are simulated separately for
+        each group of elements sharing molecules (a triangle with surface
+        reactions and the tetrahedrons next to it). Simulations then give
+        the same results for any partition and number of diffusion
+        threads, as long as the number of diffusion rate levels is the
+        same (it decides the iterations that apply each diffusion). With
+        a membrane potential, results only match as far as the potentials
+        computed for the partitions do.
+        
+        Syntax::
+            
+            setElementRNG(enable, seed)
+            
+        Arguments:
+        bool enable
+        unsigned long seed
+        
+        Return:
+            None
+        """
+        self.ptrx().setElementRNG(enable, seed)
+
+    def getElementRNG(self, ):
+        """
+        Return whether diffusion and reactions use per-element random streams.
+        
+        Syntax::
+            
+            getElementRNG()
+            
+        Arguments:
+        None
+        
+        Return:
+        bool
+        """
+        return self.ptrx().getElementRNG()
+
 
     @staticmethod
     cdef _py_TetOpSplitP from_ptr(TetOpSplitP *ptr):
@@ -2223,6 +2223,8 @@ cdef class _py_API(_py__base):
     EF_DV_BDSYS  = steps_solver.EF_DV_BDSYS
     EF_DV_SLUSYS = steps_solver.EF_DV_SLUSYS
     EF_DV_PETSC  = steps_solver.EF_DV_PETSC
+    EF_DV_CG     = steps_solver.EF_DV_CG
+    EF_DV_DIST   = steps_solver.EF_DV_DIST
 
     cdef API *ptr(self):
         return <API*> self._ptr
@@ -2232,6 +2234,62 @@ cdef class _py_API(_py__base):
         self.model = m
         self.geom = g
 
+    def getSpecHandle(self, str s):
+        """
+        Returns a handle to the species with identifier string spec, which
+        can be passed in place of the identifier to getTetCount, getTetConc,
+        getTriCount, getCompCount, getCompConc and getPatchCount to avoid
+        resolving the name on every call.
+
+        Syntax::
+            
+            getSpecHandle(spec)
+            
+        Arguments:
+        string spec
+
+        Return:
+        int
+
+        """
+        return self.ptr().getSpecHandle(to_std_string(s))
+
+    def getCompHandle(self, str c):
+        """
+        Returns a handle to the compartment with identifier string comp,
+        see getSpecHandle.
+
+        Syntax::
+            
+            getCompHandle(comp)
+            
+        Arguments:
+        string comp
+
+        Return:
+        int
+
+        """
+        return self.ptr().getCompHandle(to_std_string(c))
+
+    def getPatchHandle(self, str p):
+        """
+        Returns a handle to the patch with identifier string pat,
+        see getSpecHandle.
+
+        Syntax::
+            
+            getPatchHandle(pat)
+            
+        Arguments:
+        string pat
+
+        Return:
+        int
+
+        """
+        return self.ptr().getPatchHandle(to_std_string(p))
+
     def getCompVol(self, str c):
         """
         Returns the volume of compartment with identifier string comp (in m^3).
@@ -2267,7 +2325,7 @@ cdef class _py_API(_py__base):
         """
         self.ptr().setCompVol(to_std_string(c), vol)
 
-    def getCompCount(self, str c, str s):
+    def getCompCount(self, c, s):
         """
         Returns the number of molecules of a species with identifier string spec 
         in compartment with identifier string comp.
@@ -2280,14 +2338,20 @@ cdef class _py_API(_py__base):
             getCompCount(comp, spec)
             
         Arguments:
-        string comp
-        string spec
+        string comp (or handle from getCompHandle)
+        string spec (or species handle from getSpecHandle)
 
         Return:
         float
 
         """
-        return self.ptr().getCompCount(to_std_string(c), to_std_string(s))
+        if isinstance(c, str) and isinstance(s, str):
+            return self.ptr().getCompCount(to_std_string(c), to_std_string(s))
+        if isinstance(c, str):
+            c = self.ptr().getCompHandle(to_std_string(c))
+        if isinstance(s, str):
+            s = self.ptr().getSpecHandle(to_std_string(s))
+        return self.ptr().getCompCount(<unsigned int> c, <unsigned int> s)
 
     def setCompCount(self, str c, str s, double n):
         """
@@ -2357,7 +2421,7 @@ cdef class _py_API(_py__base):
         """
         self.ptr().setCompAmount(to_std_string(c), to_std_string(s), a)
 
-    def getCompConc(self, str c, str s):
+    def getCompConc(self, c, s):
         """
         Returns the concentration (in Molar units) of species with identifier string spec 
         in compartment with identifier string comp.
@@ -2371,14 +2435,20 @@ cdef class _py_API(_py__base):
             getCompConc(comp, spec)
             
         Arguments:
-        string comp
-        string spec
+        string comp (or handle from getCompHandle)
+        string spec (or species handle from getSpecHandle)
 
         Return:
         float
 
         """
-        return self.ptr().getCompConc(to_std_string(c), to_std_string(s))
+        if isinstance(c, str) and isinstance(s, str):
+            return self.ptr().getCompConc(to_std_string(c), to_std_string(s))
+        if isinstance(c, str):
+            c = self.ptr().getCompHandle(to_std_string(c))
+        if isinstance(s, str):
+            s = self.ptr().getSpecHandle(to_std_string(s))
+        return self.ptr().getCompConc(<unsigned int> c, <unsigned int> s)
 
     def setCompConc(self, str c, str s, double conc):
         """
@@ -2807,7 +2877,7 @@ cdef class _py_API(_py__base):
         """
         return self.ptr().getTetSpecDefined(tidx, to_std_string(s))
 
-    def getTetCount(self, unsigned int tidx, str s):
+    def getTetCount(self, unsigned int tidx, s):
         """
         Returns the number of molecules of species with identifier string spec 
         in the tetrahedral element with index idx.
@@ -2818,13 +2888,15 @@ cdef class _py_API(_py__base):
             
         Arguments:
         int idx
-        string spec
+        string spec (or species handle from getSpecHandle)
 
         Return:
         int
 
         """
-        return self.ptr().getTetCount(tidx, to_std_string(s))
+        if isinstance(s, str):
+            return self.ptr().getTetCount(tidx, to_std_string(s))
+        return self.ptr().getTetCount(tidx, <unsigned int> s)
 
     def setTetCount(self, unsigned int tidx, str s, double n):
         """
@@ -2891,7 +2963,7 @@ cdef class _py_API(_py__base):
         """
         self.ptr().setTetAmount(tidx, to_std_string(s), m)
 
-    def getTetConc(self, unsigned int tidx, str s):
+    def getTetConc(self, unsigned int tidx, s):
         """
         Returns the concentration (in Molar units) of species with identifier 
         string spec in a tetrahedral element with index idx.
@@ -2902,13 +2974,15 @@ cdef class _py_API(_py__base):
             
         Arguments:
         int idx
-        string spec
+        string spec (or species handle from getSpecHandle)
 
         Return:
         float
 
         """
-        return self.ptr().getTetConc(tidx, to_std_string(s))
+        if isinstance(s, str):
+            return self.ptr().getTetConc(tidx, to_std_string(s))
+        return self.ptr().getTetConc(tidx, <unsigned int> s)
 
     def setTetConc(self, unsigned int tidx, str s, double c):
         """
@@ -3330,7 +3404,7 @@ cdef class _py_API(_py__base):
         """
         self.ptr().setPatchArea(to_std_string(p), area)
 
-    def getPatchCount(self, str p, str s):
+    def getPatchCount(self, p, s):
         """
         Returns the number of molecules of species with identifier string spec in patch 
         with identifier string pat.Note: in a mesh-based simulation this 
@@ -3341,14 +3415,20 @@ cdef class _py_API(_py__base):
             getPatchCount(pat, spec)
             
         Arguments:
-        string pat
-        string spec
+        string pat (or handle from getPatchHandle)
+        string spec (or species handle from getSpecHandle)
 
         Return:
         float
 
         """
-        return self.ptr().getPatchCount(to_std_string(p), to_std_string(s))
+        if isinstance(p, str) and isinstance(s, str):
+            return self.ptr().getPatchCount(to_std_string(p), to_std_string(s))
+        if isinstance(p, str):
+            p = self.ptr().getPatchHandle(to_std_string(p))
+        if isinstance(s, str):
+            s = self.ptr().getSpecHandle(to_std_string(s))
+        return self.ptr().getPatchCount(<unsigned int> p, <unsigned int> s)
 
     def setPatchCount(self, str p, str s, double n):
         """
@@ -3884,7 +3964,7 @@ cdef class _py_API(_py__base):
         """
         return self.ptr().getTriSpecDefined(tidx, to_std_string(s))
 
-    def getTriCount(self, unsigned int tidx, str s):
+    def getTriCount(self, unsigned int tidx, s):
         """
         Returns the number of molecules of species with identifier string spec 
         in the triangular element with index idx.
@@ -3895,13 +3975,15 @@ cdef class _py_API(_py__base):
             
         Arguments:
         int idx
-        string spec
+        string spec (or species handle from getSpecHandle)
 
         Return:
         float
 
         """
-        return self.ptr().getTriCount(tidx, to_std_string(s))
+        if isinstance(s, str):
+            return self.ptr().getTriCount(tidx, to_std_string(s))
+        return self.ptr().getTriCount(tidx, <unsigned int> s)
 
     def setTriCount(self, unsigned int tidx, str s, double n):
         """
@@ -48,6 +48,8 @@ EF_DEFAULT = stepslib._py_API.EF_DEFAULT
 EF_DV_BDSYS = stepslib._py_API.EF_DV_BDSYS
 EF_DV_SLUSYS = stepslib._py_API.EF_DV_SLUSYS
 EF_DV_PETSC  = stepslib._py_API.EF_DV_PETSC
+EF_DV_CG     = stepslib._py_API.EF_DV_CG
+EF_DV_DIST   = stepslib._py_API.EF_DV_DIST
 
 # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
 # Tetrahedral Direct SSA
@@ -69,6 +71,11 @@ class TetOpSplit(stepslib._py_TetOpSplitP, _Base_Solver) :
     dict<int, int> tri_hosts (default={})
     list<int> wm_hosts (default=[])
     int calcMemPot (default=0)
+    list<int> tet_gidx (default=[])
+    list<int> tri_gidx (default=[])
+    
+    If tet_gidx is given, geom is only this process's part of the mesh, see
+    steps.utilities.geom_decompose.distributeMesh.
     
     """
     def run(self, end_time, cp_interval=0.0, prefix=""):
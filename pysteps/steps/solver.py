@@ -32,6 +32,7 @@ EF_DEFAULT = stepslib._py_API.EF_DEFAULT
 EF_DV_BDSYS = stepslib._py_API.EF_DV_BDSYS
 EF_DV_SLUSYS = stepslib._py_API.EF_DV_SLUSYS
 EF_DV_PETSC  = stepslib._py_API.EF_DV_PETSC
+EF_DV_CG     = stepslib._py_API.EF_DV_CG
 
 
 # --------------------------------------------------------------------
@@ -361,6 +361,119 @@ def printPartitionStat(tet_partitions = [], tri_partitions = {}, wmvol_partition
 
 ################################################################################
 
+def distributeMesh(mesh, tet_partitions, tri_partitions, rank):
+    """
+    Extract the part of the mesh a process of the parallel TetOpSplit solver
+    needs when it is only given the elements it hosts.
+
+    The part holds the tetrahedrons and patch triangles hosted by rank, the
+    tetrahedrons next to them and the patch triangles sharing a bar with them,
+    and one tetrahedron of each compartment the rank would not hold otherwise.
+    It has the same compartments and patches as the mesh, so that the model
+    is the same on every process.
+
+    The parts are meant to be built once, e.g. saved with
+    steps.utilities.meshio.saveMesh together with the returned lists, and each
+    process then loads its own part only, so that its memory scales with its
+    partition rather than with the mesh:
+
+        part, tet_hosts, tri_hosts, tet_gidx, tri_gidx = (loaded for this rank)
+        sim = steps.mpi.solver.TetOpSplit(model, part, rng, tet_hosts=tet_hosts,
+            tri_hosts=tri_hosts, tet_gidx=tet_gidx, tri_gidx=tri_gidx)
+
+    The solver is then called with the indices of the whole mesh. Membrane
+    potential, diffusion boundaries, regions of interest and rebalancing are
+    not supported on a distributed mesh.
+
+    Parameters:
+        * mesh                STEPS Tetmesh object
+        * tet_partitions      List of partioning for each tetrahedron in the mesh
+        * tri_partitions      Partitioning dictionary for the patch triangles, e.g. from partitionTris
+        * rank                The process the part is extracted for
+
+    Return:
+        part, tet_hosts, tri_hosts, tet_gidx, tri_gidx
+        part is the Tetmesh of the process, tet_hosts and tri_hosts its partitioning by its own indices, and tet_gidx and tri_gidx the indices of its tetrahedrons and triangles in the mesh
+    """
+    import steps.geom as sgeom
+
+    comps = [sgeom.castToTmComp(c) for c in mesh.getAllComps()]
+    patches = [sgeom.castToTmPatch(p) for p in mesh.getAllPatches()]
+
+    owned_tets = [t for t in range(mesh.ntets) if tet_partitions[t] == rank]
+    owned_tris = [t for t in tri_partitions if tri_partitions[t] == rank]
+
+    # the halo: volumes next to the hosted tetrahedrons and triangles next to
+    # the hosted ones in their patch, with the volumes on both sides of them
+    tets = set(owned_tets)
+    for tet in owned_tets:
+        tets.update(n for n in mesh.getTetTetNeighb(tet) if n != -1)
+    tris = set(owned_tris)
+    for tri in owned_tris:
+        patch = mesh.getTriPatch(tri)
+        tris.update(mesh.getTriTriNeighb(tri, sgeom.castToTmPatch(patch)))
+    for tri in tris:
+        tets.update(n for n in mesh.getTriTetNeighb(tri) if n != -1)
+
+    # compartments cannot be empty
+    for comp in comps:
+        comp_tets = comp.getAllTetIndices()
+        if len(tets.intersection(comp_tets)) == 0:
+            tets.add(min(comp_tets))
+
+    # Keep the order of the mesh for the vertices, tetrahedrons and triangles,
+    # so that the part has the same neighbours in the same order.
+    tet_gidx = sorted(tets)
+    verts = sorted(set(v for tet in tet_gidx for v in mesh.getTet(tet)))
+    vert_l = dict((v, i) for i, v in enumerate(verts))
+    tri_gidx = sorted(set(t for tet in tet_gidx for t in mesh.getTetTriNeighb(tet)))
+    tet_l = dict((t, i) for i, t in enumerate(tet_gidx))
+    tri_l = dict((t, i) for i, t in enumerate(tri_gidx))
+
+    part_verts = []
+    for v in verts:
+        part_verts.extend(mesh.getVertex(v))
+    part_tets = []
+    for tet in tet_gidx:
+        part_tets.extend(vert_l[v] for v in mesh.getTet(tet))
+    part_tris = []
+    for tri in tri_gidx:
+        part_tris.extend(vert_l[v] for v in mesh.getTri(tri))
+    part = sgeom.Tetmesh(part_verts, part_tets, part_tris)
+
+    part_comps = {}
+    for comp in comps:
+        part_comp = sgeom.TmComp(comp.getID(), part,
+            [tet_l[t] for t in comp.getAllTetIndices() if t in tet_l])
+        for volsys in comp.getVolsys():
+            part_comp.addVolsys(volsys)
+        part_comps[comp.getID()] = part_comp
+
+    # patch triangles cut off from one of their volumes are left out
+    tri_hosts = {}
+    for patch in patches:
+        patch_tris = []
+        for tri in patch.getAllTriIndices():
+            if tri in tri_l and all(n == -1 or n in tet_l for n in mesh.getTriTetNeighb(tri)):
+                patch_tris.append(tri_l[tri])
+                tri_hosts[tri_l[tri]] = tri_partitions[tri]
+        icomp = part_comps[patch.getIComp().getID()]
+        ocomp = patch.getOComp()
+        if ocomp is not None:
+            ocomp = part_comps[ocomp.getID()]
+        part_patch = sgeom.TmPatch(patch.getID(), part, patch_tris, icomp, ocomp)
+        for surfsys in patch.getSurfsys():
+            part_patch.addSurfsys(surfsys)
+
+    tet_hosts = [tet_partitions[t] for t in tet_gidx]
+    return part, tet_hosts, tri_hosts, tet_gidx, tri_gidx
+
+################################################################################
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+################################################################################
+
 def isPointInCylinder(cyl_p0, cyl_p1, test_pnt, scale):
     """
         Check if a point is inside a cylinder in 3D. The cylinder is defined by an axis from
@@ -331,7 +331,7 @@ cdef extern from "steps/mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::te
 
     ###### Cybinding for TetOpSplitP ######
     cdef cppclass TetOpSplitP:
-        TetOpSplitP(steps_model.Model*, steps_wm.Geom*, steps_rng.RNG*, int, std.vector[unsigned int], std.map[unsigned int,unsigned int], std.vector[unsigned int]) except +
+        TetOpSplitP(steps_model.Model*, steps_wm.Geom*, steps_rng.RNG*, int, std.vector[unsigned int], std.map[unsigned int,unsigned int], std.vector[unsigned int], std.vector[unsigned int], std.vector[unsigned int]) except +
         std.string getSolverName() except +
         std.string getSolverDesc() except +
         std.string getSolverAuthors() except +
@@ -351,12 +351,17 @@ cdef extern from "steps/mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::te
         double getTemp() except +
         double getA0() except +
         unsigned int getNSteps() except +
+        unsigned int getSpecHandle(std.string) except +
+        unsigned int getCompHandle(std.string) except +
+        unsigned int getPatchHandle(std.string) except +
         double getCompVol(std.string) except +
         double getCompCount(std.string, std.string) except +
+        double getCompCount(unsigned int, unsigned int) except +
         void setCompCount(std.string, std.string, double) except +
         double getCompAmount(std.string, std.string) except +
         void setCompAmount(std.string, std.string, double) except +
         double getCompConc(std.string, std.string) except +
+        double getCompConc(unsigned int, unsigned int) except +
         void setCompConc(std.string, std.string, double) except +
         bool getCompClamped(std.string, std.string) except +
         void setCompClamped(std.string, std.string, bool) except +
@@ -377,10 +382,12 @@ cdef extern from "steps/mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::te
         void setTetVol(unsigned int, double) except +
         bool getTetSpecDefined(unsigned int, std.string) except +
         double getTetCount(unsigned int, std.string) except +
+        double getTetCount(unsigned int, unsigned int) except +
         void setTetCount(unsigned int, std.string, double) except +
         double getTetAmount(unsigned int, std.string) except +
         void setTetAmount(unsigned int, std.string, double) except +
         double getTetConc(unsigned int, std.string) except +
+        double getTetConc(unsigned int, unsigned int) except +
         void setTetConc(unsigned int, std.string, double) except +
         bool getTetClamped(unsigned int, std.string) except +
         void setTetClamped(unsigned int, std.string, bool) except +
@@ -402,6 +409,7 @@ cdef extern from "steps/mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::te
         void setTetVClamped(unsigned int, bool) except +
         double getPatchArea(std.string) except +
         double getPatchCount(std.string, std.string) except +
+        double getPatchCount(unsigned int, unsigned int) except +
         void setPatchCount(std.string, std.string, double) except +
         double getPatchAmount(std.string, std.string) except +
         void setPatchAmount(std.string, std.string, double) except +
@@ -428,6 +436,7 @@ cdef extern from "steps/mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::te
         void setTriArea(unsigned int, double) except +
         bool getTriSpecDefined(unsigned int, std.string) except +
         double getTriCount(unsigned int, std.string) except +
+        double getTriCount(unsigned int, unsigned int) except +
         void setTriCount(unsigned int, std.string, double) except +
         double getTriAmount(unsigned int, std.string) except +
         void setTriAmount(unsigned int, std.string, double) except +
@@ -498,6 +507,17 @@ cdef extern from "steps/mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::te
         double sumBatchTriCountsNP(unsigned int*, int, std.string) except +
         double sumBatchTriGHKIsNP(unsigned int*, int, std.string) except +
         double sumBatchTriOhmicIsNP(unsigned int*, int, std.string) except +
+        unsigned int addTetCountObservable(std.vector[unsigned int], std.string) except +
+        unsigned int addTriCountObservable(std.vector[unsigned int], std.string) except +
+        unsigned int countObservables() except +
+        void recordObservables() except +
+        void runAndRecord(std.vector[double]) except +
+        void flushObservables(bool) except +
+        std.vector[double] getObservableTimes() except +
+        std.vector[double] getObservableData(unsigned int) except +
+        std.vector[unsigned int] getObservableLocalPositions(unsigned int) except +
+        std.vector[double] getObservableLocalData(unsigned int) except +
+        void clearObservableData() except +
         void setDiffApplyThreshold(int) except +
         double getReacExtent(bool) except +
         double getDiffExtent(bool) except +
@@ -510,6 +530,15 @@ cdef extern from "steps/mpi/tetopsplit/tetopsplit.hpp" namespace "steps::mpi::te
         double getRDTime() except +
         double getDataExchangeTime() except +
         void repartitionAndReset(std.vector[unsigned int],std.map[unsigned int, unsigned int], std.vector[unsigned int]) except +
+        void setRebalanceInterval(unsigned int, double) except +
+        void rebalance() except +
+        unsigned int getRebalanceCount()
+        void setDiffusionThreads(unsigned int) except +
+        unsigned int getDiffusionThreads()
+        void setDiffusionRateLevels(unsigned int) except +
+        unsigned int getDiffusionRateLevels()
+        void setElementRNG(bool, unsigned long) except +
+        bool getElementRNG()
  
 
 # # ======================================================================================================================
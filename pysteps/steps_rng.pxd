@@ -42,10 +42,10 @@ cdef extern from "steps/rng/rng.hpp" namespace "steps::rng":
         double getUnfIE()
         double getUnfEE()
         double getUnfIE53()
-        float getStdExp()
+        double getStdExp()
         double getExp(double)
         long getPsn(float)
-        float getStdNrm()
+        double getStdNrm()
         unsigned int getBinom(unsigned int, double)
 
 # ======================================================================================================================
@@ -607,6 +607,8 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver::API":
         EF_DV_BDSYS
         EF_DV_SLUSYS
         EF_DV_PETSC
+        EF_DV_CG
+        EF_DV_DIST
         # ======================================================================================================================
 cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
 # ----------------------------------------------------------------------------------------------------------------------
@@ -640,13 +642,18 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         #double getTemp() except +
         #double getA0() except +
         #unsigned int getNSteps() except +
+        unsigned int getSpecHandle(std.string) except +
+        unsigned int getCompHandle(std.string) except +
+        unsigned int getPatchHandle(std.string) except +
         double getCompVol(std.string) except +
         void setCompVol(std.string, double) except +
         double getCompCount(std.string, std.string) except +
+        double getCompCount(unsigned int, unsigned int) except +
         void setCompCount(std.string, std.string, double) except +
         double getCompAmount(std.string, std.string) except +
         void setCompAmount(std.string, std.string, double) except +
         double getCompConc(std.string, std.string) except +
+        double getCompConc(unsigned int, unsigned int) except +
         void setCompConc(std.string, std.string, double) except +
         bool getCompClamped(std.string, std.string) except +
         void setCompClamped(std.string, std.string, bool) except +
@@ -667,10 +674,12 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         void setTetVol(unsigned int, double) except +
         bool getTetSpecDefined(unsigned int, std.string) except +
         double getTetCount(unsigned int, std.string) except +
+        double getTetCount(unsigned int, unsigned int) except +
         void setTetCount(unsigned int, std.string, double) except +
         double getTetAmount(unsigned int, std.string) except +
         void setTetAmount(unsigned int, std.string, double) except +
         double getTetConc(unsigned int, std.string) except +
+        double getTetConc(unsigned int, unsigned int) except +
         void setTetConc(unsigned int, std.string, double) except +
         bool getTetClamped(unsigned int, std.string) except +
         void setTetClamped(unsigned int, std.string, bool) except +
@@ -693,6 +702,7 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         double getPatchArea(std.string) except +
         void setPatchArea(std.string, double) except +
         double getPatchCount(std.string, std.string) except +
+        double getPatchCount(unsigned int, unsigned int) except +
         void setPatchCount(std.string, std.string, double) except +
         double getPatchAmount(std.string, std.string) except +
         void setPatchAmount(std.string, std.string, double) except +
@@ -719,6 +729,7 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         void setTriArea(unsigned int, double) except +
         bool getTriSpecDefined(unsigned int, std.string) except +
         double getTriCount(unsigned int, std.string) except +
+        double getTriCount(unsigned int, unsigned int) except +
         void setTriCount(unsigned int, std.string, double) except +
         double getTriAmount(unsigned int, std.string) except +
         void setTriAmount(unsigned int, std.string, double) except +
@@ -148,6 +148,12 @@ cdef extern from "steps/geom/tetmesh.hpp" namespace "steps::tetmesh":
         std.vector[unsigned int] getTetTriNeighb(unsigned int) except +
         std.vector[int] getTetTetNeighb(unsigned int) except +
         int findTetByPoint(std.vector[double]) except +
+        std.vector[int] findTetsByPoints(std.vector[double]) except +
+        void findTetsByPointsNP(double*, int, int*, int) except +
+        std.vector[unsigned int] getTetsInBox(std.vector[double], std.vector[double]) except +
+        std.vector[unsigned int] getTetsInSphere(std.vector[double], double) except +
+        std.vector[unsigned int] getTetsInCylinder(std.vector[double], std.vector[double], double) except +
+        std.vector[unsigned int] getSurfTrisNearPoint(std.vector[double], double) except +
         std.vector[double] getBoundMin() except +
         std.vector[double] getBoundMax() except +
         double getMeshVolume() except +
@@ -41,6 +41,7 @@
 #include "steps/error.hpp"
 
 #include "steps/math/bbox.hpp"
+#include "steps/math/bbox_grid.hpp"
 #include "steps/math/point.hpp"
 #include "steps/math/smallsort.hpp"
 #include "steps/math/tetrahedron.hpp"
@@ -828,14 +829,24 @@ std::vector<int> stetmesh::Tetmesh::getTetTetNeighb(uint tidx) const
 int stetmesh::Tetmesh::findTetByPoint(std::vector<double> const &p) const
 {
     point3d x{p[0],p[1],p[2]};
+    return _findTetByPoint(x);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int stetmesh::Tetmesh::_findTetByPoint(point3d const &x) const
+{
     if (!pBBox.contains(x)) {
         return -1;
     }
 
-    for (int tidx = 0; tidx < pTetsN; ++tidx) {
-        tet_verts v = pTets[tidx];
+    // candidates are in ascending order, so the first tetrahedron found is
+    // the one a linear scan would find
+    auto range = _tetGrid().candidates(x);
+    for (const uint * c = range.first; c != range.second; ++c) {
+        tet_verts const & v = pTets[*c];
         if (steps::math::tet_inside(pVerts[v[0]], pVerts[v[1]], pVerts[v[2]], pVerts[v[3]], x)) {
-            return tidx;
+            return *c;
         }
     }
 
@@ -873,6 +884,157 @@ std::vector<int> stetmesh::Tetmesh::getSurfTris() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+const steps::math::bbox_grid & stetmesh::Tetmesh::_tetGrid() const
+{
+    std::call_once(pTetGridOnce, [this]() {
+        std::vector<steps::math::bounding_box> boxes(pTetsN);
+        for (uint t = 0; t < pTetsN; ++t) {
+            for (uint v: pTets[t]) boxes[t].insert(pVerts[v]);
+        }
+        pTetGrid = steps::math::bbox_grid(boxes);
+    });
+    return pTetGrid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const steps::math::bbox_grid & stetmesh::Tetmesh::_surfTriGrid() const
+{
+    std::call_once(pSurfTriGridOnce, [this]() {
+        std::vector<int> surftris = getSurfTris();
+        pGridSurfTris.assign(surftris.begin(), surftris.end());
+        std::vector<steps::math::bounding_box> boxes(pGridSurfTris.size());
+        for (uint i = 0; i < pGridSurfTris.size(); ++i) {
+            for (uint v: pTris[pGridSurfTris[i]]) boxes[i].insert(pVerts[v]);
+        }
+        pSurfTriGrid = steps::math::bbox_grid(boxes);
+    });
+    return pSurfTriGrid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static steps::math::point3d as_point3d(std::vector<double> const &p, const char * name)
+{
+    if (p.size() != 3) {
+        std::ostringstream os;
+        os << "Coordinates of " << name << " should have length 3.";
+        ArgErrLog(os.str());
+    }
+    return steps::math::point3d{p[0], p[1], p[2]};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<int> stetmesh::Tetmesh::findTetsByPoints(std::vector<double> const &points) const
+{
+    if (points.size() % 3) {
+        ArgErrLog("Length of points array should be a multiple of 3.");
+    }
+    std::vector<int> tets(points.size() / 3);
+    findTetsByPointsNP(points.data(), points.size(), tets.data(), tets.size());
+    return tets;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stetmesh::Tetmesh::findTetsByPointsNP(const double* points, int input_size, int* tets, int output_size) const
+{
+    if (input_size != output_size * 3) {
+        ArgErrLog("Length of points array should be 3 * length of output array.");
+    }
+    for (int i = 0; i < output_size; ++i) {
+        tets[i] = _findTetByPoint(point3d{points[3*i], points[3*i+1], points[3*i+2]});
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint> stetmesh::Tetmesh::getTetsInBox(std::vector<double> const &lo, std::vector<double> const &hi) const
+{
+    steps::math::bounding_box box(as_point3d(lo, "box minimum"), as_point3d(hi, "box maximum"));
+
+    std::vector<uint> tets;
+    for (uint t: _tetGrid().candidates(box)) {
+        if (box.contains(pTet_barycentres[t])) tets.push_back(t);
+    }
+    return tets;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint> stetmesh::Tetmesh::getTetsInSphere(std::vector<double> const &centre, double radius) const
+{
+    point3d c = as_point3d(centre, "sphere centre");
+    if (radius < 0.0) {
+        ArgErrLog("Radius of sphere should not be negative.");
+    }
+    point3d r{radius, radius, radius};
+    double r2 = radius * radius;
+
+    std::vector<uint> tets;
+    for (uint t: _tetGrid().candidates(steps::math::bounding_box(c - r, c + r))) {
+        if (steps::math::dist2(pTet_barycentres[t], c) <= r2) tets.push_back(t);
+    }
+    return tets;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint> stetmesh::Tetmesh::getTetsInCylinder(std::vector<double> const &p0, std::vector<double> const &p1,
+                                                       double radius) const
+{
+    point3d a = as_point3d(p0, "cylinder axis start");
+    point3d b = as_point3d(p1, "cylinder axis end");
+    if (radius < 0.0) {
+        ArgErrLog("Radius of cylinder should not be negative.");
+    }
+    point3d axis = b - a;
+    double len2 = dot(axis, axis);
+    if (len2 == 0.0) {
+        ArgErrLog("End points of cylinder axis should be distinct.");
+    }
+    point3d r{radius, radius, radius};
+    double r2 = radius * radius;
+
+    steps::math::bounding_box box(a);
+    box.insert(b);
+    box = steps::math::bounding_box(box.min() - r, box.max() + r);
+
+    std::vector<uint> tets;
+    for (uint t: _tetGrid().candidates(box)) {
+        point3d d = pTet_barycentres[t] - a;
+        double proj = dot(d, axis);
+        if (proj < 0.0 || proj > len2) continue;
+        if (dot(d, d) - proj * proj / len2 <= r2) tets.push_back(t);
+    }
+    return tets;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint> stetmesh::Tetmesh::getSurfTrisNearPoint(std::vector<double> const &p, double radius) const
+{
+    point3d x = as_point3d(p, "point");
+    if (radius < 0.0) {
+        ArgErrLog("Radius should not be negative.");
+    }
+    point3d r{radius, radius, radius};
+    double r2 = radius * radius;
+
+    steps::math::bbox_grid const & grid = _surfTriGrid();
+    std::vector<uint> tris;
+    for (uint i: grid.candidates(steps::math::bounding_box(x - r, x + r))) {
+        uint t = pGridSurfTris[i];
+        tri_verts const & v = pTris[t];
+        point3d c = steps::math::tri_closest_point(pVerts[v[0]], pVerts[v[1]], pVerts[v[2]], x);
+        if (steps::math::dist2(c, x) <= r2) tris.push_back(t);
+    }
+    return tris;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void stetmesh::Tetmesh::_checkMembID(std::string const & id) const
 {
     checkID(id);
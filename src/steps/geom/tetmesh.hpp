@@ -32,6 +32,7 @@
 #include "steps/common.h"
 #include "steps/math/point.hpp"
 #include "steps/math/bbox.hpp"
+#include "steps/math/bbox_grid.hpp"
 #include "steps/geom/geom.hpp"
 #include "steps/geom/tmpatch.hpp"
 #include "steps/geom/tmcomp.hpp"
@@ -42,6 +43,7 @@
 // STL headers
 #include <vector>
 #include <map>
+#include <mutex>
 #include <set>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -399,6 +401,45 @@ public:
 
     int findTetByPoint(std::vector<double> const &p) const;
 
+    ////////////////////////////////////////////////////////////////////////
+    // SPATIAL QUERIES
+    ////////////////////////////////////////////////////////////////////////
+    //
+    // Point location and region queries go through uniform grids over the
+    // bounding boxes of the tetrahedrons and of the surface triangles,
+    // built on first use. Region queries select tetrahedrons by their
+    // barycentres and return them in ascending order.
+
+    /// Find the tetrahedrons which encompass a list of points, as
+    /// findTetByPoint does for each.
+    /// \param points Coordinates of the points, x0,y0,z0,x1,...
+    /// \return ID of the found tetrahedron, or -1, for each point.
+    std::vector<int> findTetsByPoints(std::vector<double> const &points) const;
+
+    /// Find the tetrahedrons which encompass a list of points
+    void findTetsByPointsNP(const double* points, int input_size, int* tets, int output_size) const;
+
+    /// Return the tetrahedrons whose barycentres lie in an axis-aligned box.
+    /// \param lo Minimal coordinate of the box.
+    /// \param hi Maximal coordinate of the box.
+    std::vector<uint> getTetsInBox(std::vector<double> const &lo, std::vector<double> const &hi) const;
+
+    /// Return the tetrahedrons whose barycentres lie in a sphere.
+    /// \param centre Centre of the sphere.
+    /// \param radius Radius of the sphere.
+    std::vector<uint> getTetsInSphere(std::vector<double> const &centre, double radius) const;
+
+    /// Return the tetrahedrons whose barycentres lie in a cylinder.
+    /// \param p0,p1 End points of the axis of the cylinder.
+    /// \param radius Radius of the cylinder.
+    std::vector<uint> getTetsInCylinder(std::vector<double> const &p0, std::vector<double> const &p1,
+                                        double radius) const;
+
+    /// Return the surface triangles within a distance of a point.
+    /// \param p A point given by its coordinates.
+    /// \param radius Maximal distance from p to the closest point of a triangle.
+    std::vector<uint> getSurfTrisNearPoint(std::vector<double> const &p, double radius) const;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS (EXPOSED TO PYTHON): MESH
     ////////////////////////////////////////////////////////////////////////
@@ -811,6 +852,15 @@ private:
     /// Build pBars, pBarsN, pTri_bars from pTris.
     void buildBarData();
 
+    /// Build pTetGrid on first use.
+    const steps::math::bbox_grid & _tetGrid() const;
+
+    /// Build pSurfTriGrid and pGridSurfTris on first use.
+    const steps::math::bbox_grid & _surfTriGrid() const;
+
+    /// Index of the tetrahedron that encompasses x, or -1.
+    int _findTetByPoint(point3d const &x) const;
+
     ///////////////////////// DATA: VERTICES ///////////////////////////////
     ///
     /// The total number of vertices in the mesh
@@ -877,6 +927,15 @@ private:
     /// Information about the minimal and maximal boundary values
     steps::math::bounding_box           pBBox;
 
+    /// Spatial indices of the tetrahedrons and of the surface triangles;
+    /// built once by the first query, which other concurrent queries wait on
+    mutable steps::math::bbox_grid      pTetGrid;
+    mutable steps::math::bbox_grid      pSurfTriGrid;
+    /// The surface triangles indexed by pSurfTriGrid
+    mutable std::vector<uint>           pGridSurfTris;
+    mutable std::once_flag              pTetGridOnce;
+    mutable std::once_flag              pSurfTriGridOnce;
+
     ////////////////////////////////////////////////////////////////////////
 
     // List of contained membranes. Members of this class because they
@@ -0,0 +1,386 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################
+
+ */
+
+// STL headers.
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+#include "steps/geom/tetmesh.hpp"
+#include "steps/geom/tetmesh_partition.hpp"
+#include "steps/math/point.hpp"
+
+// logging
+#include "easylogging++.h"
+
+namespace stetmesh = steps::tetmesh;
+
+using steps::math::point3d;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const uint NO_PART = std::numeric_limits<uint>::max();
+
+// Sub-range [bgn, end) of the bisection order to be split over the
+// parts [lo, lo + n).
+struct BisectRange
+{
+    uint bgn;
+    uint end;
+    uint lo;
+    uint n;
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stetmesh::partitionMesh(Tetmesh const & mesh, std::vector<double> const & tet_weights,
+                             std::map<uint, double> const & tri_weights, uint nparts,
+                             std::vector<uint> & tet_hosts, std::map<uint, uint> & tri_hosts,
+                             double imbalance, uint passes)
+{
+    uint ntets = mesh.countTets();
+    if (tet_weights.size() != ntets)
+    {
+        std::ostringstream os;
+        os << "Expected " << ntets << " tetrahedron weights, got " << tet_weights.size() << ".\n";
+        ArgErrLog(os.str());
+    }
+    if (nparts == 0)
+    {
+        std::ostringstream os;
+        os << "Cannot partition a mesh into zero parts.\n";
+        ArgErrLog(os.str());
+    }
+
+    // Tets on both sides of a triangle are merged into one group with a
+    // union-find; the groups are the vertices of the partitioned graph.
+    std::vector<uint> root(ntets);
+    std::iota(root.begin(), root.end(), 0);
+    auto find = [&root](uint t) {
+        while (root[t] != t) {
+            root[t] = root[root[t]];
+            t = root[t];
+        }
+        return t;
+    };
+
+    std::vector<int> tri_tet;
+    for (auto const & tw : tri_weights)
+    {
+        if (tw.first >= mesh.countTris())
+        {
+            std::ostringstream os;
+            os << "Triangle index " << tw.first << " is out of range.\n";
+            ArgErrLog(os.str());
+        }
+        const int * tets = mesh._getTriTetNeighb(tw.first);
+        if (tets[0] < 0 && tets[1] < 0)
+        {
+            std::ostringstream os;
+            os << "Triangle " << tw.first << " has no neighbouring tetrahedron.\n";
+            ArgErrLog(os.str());
+        }
+        tri_tet.push_back(tets[0] >= 0 ? tets[0] : tets[1]);
+        if (tets[0] < 0 || tets[1] < 0) continue;
+        uint g0 = find(tets[0]);
+        uint g1 = find(tets[1]);
+        if (g0 != g1) root[std::max(g0, g1)] = std::min(g0, g1);
+    }
+
+    std::vector<uint> group(ntets, NO_PART);
+    std::vector<double> gweight;
+    std::vector<point3d> gcentre;
+    std::vector<uint> gsize;
+    for (uint t = 0; t < ntets; ++t)
+    {
+        uint r = find(t);
+        if (group[r] == NO_PART)
+        {
+            group[r] = gweight.size();
+            gweight.push_back(0.0);
+            gcentre.push_back(point3d(0.0, 0.0, 0.0));
+            gsize.push_back(0);
+        }
+        uint g = group[r];
+        group[t] = g;
+        gweight[g] += tet_weights[t];
+        gcentre[g] += mesh._getTetBarycenter(t);
+        gsize[g] += 1;
+    }
+    uint ngroups = gweight.size();
+    for (uint g = 0; g < ngroups; ++g) gcentre[g] /= gsize[g];
+    uint k = 0;
+    for (auto const & tw : tri_weights) gweight[group[tri_tet[k++]]] += tw.second;
+
+    double total = std::accumulate(gweight.begin(), gweight.end(), 0.0);
+    if (total <= 0.0)
+    {
+        std::fill(gweight.begin(), gweight.end(), 1.0);
+        total = ngroups;
+    }
+
+    // Group adjacency in compressed rows, weighted by the number of
+    // tet faces shared between two groups.
+    std::vector<std::pair<uint, uint> > edges;
+    for (uint t = 0; t < ntets; ++t)
+    {
+        const int * neighbs = mesh._getTetTetNeighb(t);
+        for (uint j = 0; j < 4; ++j)
+        {
+            if (neighbs[j] < 0 || group[neighbs[j]] == group[t]) continue;
+            edges.push_back(std::make_pair(group[t], group[neighbs[j]]));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    std::vector<uint> xadj(ngroups + 1, 0);
+    std::vector<uint> adj;
+    std::vector<long> adjw;
+    for (uint e = 0; e < edges.size(); ++e)
+    {
+        if (e > 0 && edges[e] == edges[e - 1]) {
+            adjw.back() += 1;
+            continue;
+        }
+        adj.push_back(edges[e].second);
+        adjw.push_back(1);
+        xadj[edges[e].first + 1] = adj.size();
+    }
+    for (uint g = 1; g <= ngroups; ++g) xadj[g] = std::max(xadj[g], xadj[g - 1]);
+
+    // Recursive coordinate bisection: split along the longest extent of
+    // the group centres so that each side gets work in proportion to its
+    // number of parts.
+    std::vector<uint> part(ngroups, 0);
+    std::vector<uint> order(ngroups);
+    std::iota(order.begin(), order.end(), 0);
+
+    std::vector<BisectRange> stack(1, BisectRange{0, ngroups, 0, nparts});
+    while (!stack.empty())
+    {
+        BisectRange r = stack.back();
+        stack.pop_back();
+        uint count = r.end - r.bgn;
+        if (r.n == 1 || count <= 1)
+        {
+            for (uint i = r.bgn; i < r.end; ++i) part[order[i]] = r.lo;
+            continue;
+        }
+
+        point3d lo = gcentre[order[r.bgn]];
+        point3d hi = lo;
+        double weight = 0.0;
+        for (uint i = r.bgn; i < r.end; ++i)
+        {
+            point3d const & c = gcentre[order[i]];
+            for (uint d = 0; d < 3; ++d)
+            {
+                lo[d] = std::min(lo[d], c[d]);
+                hi[d] = std::max(hi[d], c[d]);
+            }
+            weight += gweight[order[i]];
+        }
+        uint axis = 0;
+        for (uint d = 1; d < 3; ++d)
+        {
+            if (hi[d] - lo[d] > hi[axis] - lo[axis]) axis = d;
+        }
+        std::sort(order.begin() + r.bgn, order.begin() + r.end,
+            [&gcentre, axis](uint a, uint b) {
+                return gcentre[a][axis] < gcentre[b][axis]
+                    || (gcentre[a][axis] == gcentre[b][axis] && a < b);
+            });
+
+        uint nleft = r.n / 2;
+        double target = weight * nleft / r.n;
+        double prefix = 0.0;
+        uint cut = 0;
+        while (cut < count && prefix + 0.5 * gweight[order[r.bgn + cut]] <= target)
+        {
+            prefix += gweight[order[r.bgn + cut]];
+            cut++;
+        }
+        // every part gets at least one group when there are enough
+        if (count >= r.n) cut = std::min(std::max(cut, nleft), count - (r.n - nleft));
+        else cut = std::min(std::max(cut, 1u), count - 1);
+
+        stack.push_back(BisectRange{r.bgn, r.bgn + cut, r.lo, nleft});
+        stack.push_back(BisectRange{r.bgn + cut, r.end, r.lo + nleft, r.n - nleft});
+    }
+
+    // Fiduccia-Mattheyses refinement of the boundary. Each pass moves
+    // every boundary group at most once, best gain first, accepting moves
+    // that increase the cut so that the pass can climb out of a local
+    // minimum. The pass is then rolled back to the prefix of its moves
+    // with the smallest cut, ties going to the better balanced one.
+    std::vector<double> pweight(nparts, 0.0);
+    std::vector<uint> psize(nparts, 0);
+    for (uint g = 0; g < ngroups; ++g)
+    {
+        pweight[part[g]] += gweight[g];
+        psize[part[g]] += 1;
+    }
+    double maxweight = std::max(total / nparts * (1.0 + imbalance),
+                                *std::max_element(pweight.begin(), pweight.end()));
+
+    std::vector<std::pair<uint, long> > conn;
+    auto bestMove = [&](uint g, uint & dest) {
+        uint own = part[g];
+        long internal = 0;
+        conn.clear();
+        for (uint e = xadj[g]; e < xadj[g + 1]; ++e)
+        {
+            uint p = part[adj[e]];
+            if (p == own) {
+                internal += adjw[e];
+                continue;
+            }
+            auto c = std::find_if(conn.begin(), conn.end(),
+                [p](std::pair<uint, long> const & pc) { return pc.first == p; });
+            if (c == conn.end()) conn.push_back(std::make_pair(p, adjw[e]));
+            else c->second += adjw[e];
+        }
+
+        dest = NO_PART;
+        long best = 0;
+        if (psize[own] <= 1) return best;
+        for (auto const & pc : conn)
+        {
+            long gain = pc.second - internal;
+            if (pweight[pc.first] + gweight[g] > maxweight) continue;
+            if (dest == NO_PART || gain > best
+                || (gain == best && pweight[pc.first] < pweight[dest]))
+            {
+                dest = pc.first;
+                best = gain;
+            }
+        }
+        return best;
+    };
+
+    auto moveGroup = [&](uint g, uint dest) {
+        pweight[part[g]] -= gweight[g];
+        psize[part[g]] -= 1;
+        part[g] = dest;
+        pweight[dest] += gweight[g];
+        psize[dest] += 1;
+    };
+
+    // a pass gives up after this many moves without a new best prefix
+    const uint max_uphill = std::max(64u, ngroups / 100);
+
+    std::vector<char> locked(ngroups);
+    std::vector<std::pair<uint, uint> > moves;
+    for (uint pass = 0; pass < passes; ++pass)
+    {
+        std::fill(locked.begin(), locked.end(), 0);
+        std::priority_queue<std::pair<long, uint> > queue;
+        for (uint g = 0; g < ngroups; ++g)
+        {
+            uint dest;
+            long gain = bestMove(g, dest);
+            if (dest != NO_PART) queue.push(std::make_pair(gain, g));
+        }
+
+        // cut change and sum of squared part weights after each move
+        double sqsum = 0.0;
+        for (double w : pweight) sqsum += w * w;
+        long delta = 0;
+        long best_delta = 0;
+        double best_sqsum = sqsum;
+        uint best_len = 0;
+        moves.clear();
+
+        while (!queue.empty() && moves.size() - best_len < max_uphill)
+        {
+            long gain = queue.top().first;
+            uint g = queue.top().second;
+            queue.pop();
+            if (locked[g]) continue;
+
+            // gains of queued groups go stale as their neighbours move
+            uint dest;
+            long current = bestMove(g, dest);
+            if (dest == NO_PART) continue;
+            if (current != gain) {
+                queue.push(std::make_pair(current, g));
+                continue;
+            }
+
+            uint own = part[g];
+            double w = gweight[g];
+            sqsum += 2.0 * w * (w + pweight[dest] - pweight[own]);
+            delta -= gain;
+            moves.push_back(std::make_pair(g, own));
+            moveGroup(g, dest);
+            locked[g] = 1;
+
+            if (delta < best_delta
+                || (delta == best_delta && sqsum < best_sqsum * (1.0 - 1e-12)))
+            {
+                best_delta = delta;
+                best_sqsum = sqsum;
+                best_len = moves.size();
+            }
+
+            for (uint e = xadj[g]; e < xadj[g + 1]; ++e)
+            {
+                uint h = adj[e];
+                if (locked[h]) continue;
+                long hgain = bestMove(h, dest);
+                if (dest != NO_PART) queue.push(std::make_pair(hgain, h));
+            }
+        }
+
+        while (moves.size() > best_len)
+        {
+            moveGroup(moves.back().first, moves.back().second);
+            moves.pop_back();
+        }
+        if (best_len == 0) break;
+    }
+
+    tet_hosts.resize(ntets);
+    for (uint t = 0; t < ntets; ++t) tet_hosts[t] = part[group[t]];
+    tri_hosts.clear();
+    k = 0;
+    for (auto const & tw : tri_weights) tri_hosts[tw.first] = tet_hosts[tri_tet[k++]];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// END
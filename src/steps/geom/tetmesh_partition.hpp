@@ -0,0 +1,84 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################
+
+ */
+
+#ifndef STEPS_TETMESH_TETMESH_PARTITION_HPP
+#define STEPS_TETMESH_TETMESH_PARTITION_HPP 1
+
+
+// STEPS headers.
+#include "steps/common.h"
+
+// STL headers
+#include <map>
+#include <vector>
+
+ namespace steps {
+ namespace tetmesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Forward & auxiliary declarations.
+class Tetmesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Partition the tetrahedron dual graph of a mesh into nparts hosts.
+///
+/// Tetrahedrons are first split by weighted recursive coordinate
+/// bisection of their barycentres, then the cut between the parts is
+/// reduced by Fiduccia-Mattheyses refinement passes. A pass moves
+/// boundary elements to a neighbouring part, best gain first and even
+/// when this adds cut faces, then keeps only the prefix of its moves that
+/// gives the fewest cut faces (the best balance among equals). No part
+/// grows beyond (1 + imbalance) times the mean weight.
+///
+/// The two tetrahedrons on either side of a triangle in tri_weights are
+/// kept on one host, and the triangle is assigned to it, as required by
+/// the TetOpSplitP solver for patch triangles.
+///
+/// \param mesh         The mesh.
+/// \param tet_weights  Expected work of each tetrahedron (countTets() entries).
+/// \param tri_weights  Expected work of each patch triangle, by triangle index.
+/// \param nparts       Number of hosts.
+/// \param tet_hosts    Receives the host of each tetrahedron.
+/// \param tri_hosts    Receives the host of each triangle in tri_weights.
+/// \param imbalance    Tolerated relative excess of a part over the mean.
+/// \param passes       Maximum number of refinement passes.
+///
+void partitionMesh(Tetmesh const & mesh, std::vector<double> const & tet_weights,
+                   std::map<uint, double> const & tri_weights, uint nparts,
+                   std::vector<uint> & tet_hosts, std::map<uint, uint> & tri_hosts,
+                   double imbalance = 0.03, uint passes = 8);
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif
+// STEPS_TETMESH_TETMESH_PARTITION_HPP
+
+// END
@@ -0,0 +1,169 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#include <algorithm>
+#include <cmath>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/math/bbox.hpp"
+#include "steps/math/bbox_grid.hpp"
+#include "steps/math/point.hpp"
+
+namespace steps {
+namespace math {
+
+////////////////////////////////////////////////////////////////////////////////
+
+// upper bound on the number of cells per box
+static const double BBOX_GRID_MAX_CELLS_PER_BOX = 2.0;
+
+////////////////////////////////////////////////////////////////////////////////
+
+bbox_grid::bbox_grid(const std::vector<bounding_box> &boxes)
+: ncells{{0,0,0}}
+{
+    double mean_side = 0.0;
+    uint nboxes = 0;
+    for (auto const & b: boxes) {
+        if (b.empty()) continue;
+        extent.insert(b.min());
+        extent.insert(b.max());
+        point3d d = b.max()-b.min();
+        mean_side += d[0] + d[1] + d[2];
+        ++nboxes;
+    }
+    if (nboxes == 0) {
+        ncells = {{1,1,1}};
+        cell_start.assign(2, 0);
+        return;
+    }
+    mean_side /= 3.0 * nboxes;
+
+    point3d ext = extent.max()-extent.min();
+    double max_ext = std::max(ext[0], std::max(ext[1], ext[2]));
+    double side = mean_side > 0.0 ? mean_side : max_ext / std::cbrt(double(nboxes));
+
+    // coarsen until the grid is within the memory bound
+    double max_cells = BBOX_GRID_MAX_CELLS_PER_BOX * nboxes;
+    while (true) {
+        double total = 1.0;
+        for (uint a = 0; a < 3; ++a) {
+            double n = side > 0.0 ? std::ceil(ext[a]/side) : 1.0;
+            ncells[a] = static_cast<uint>(std::max(1.0, std::min(n, max_cells)));
+            total *= ncells[a];
+        }
+        if (total <= max_cells || total <= 1.0) break;
+        side *= std::cbrt(total/max_cells) * 1.01;
+    }
+    for (uint a = 0; a < 3; ++a) {
+        inv_cell_size[a] = ext[a] > 0.0 ? ncells[a]/ext[a] : 0.0;
+    }
+
+    // two passes: count the boxes of each cell, then fill in box order so
+    // that each cell list is sorted
+    uint ntotal = ncells[0] * ncells[1] * ncells[2];
+    cell_start.assign(ntotal + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (uint i = 0; i < boxes.size(); ++i) {
+            bounding_box const & b = boxes[i];
+            if (b.empty()) continue;
+            uint lo[3], hi[3];
+            for (uint a = 0; a < 3; ++a) {
+                lo[a] = cell_coord(a, b.min()[a]);
+                hi[a] = cell_coord(a, b.max()[a]);
+            }
+            for (uint x = lo[0]; x <= hi[0]; ++x)
+                for (uint y = lo[1]; y <= hi[1]; ++y)
+                    for (uint z = lo[2]; z <= hi[2]; ++z) {
+                        uint c = (x * ncells[1] + y) * ncells[2] + z;
+                        if (pass == 0) ++cell_start[c + 1];
+                        else items[cell_start[c]++] = i;
+                    }
+        }
+        if (pass == 0) {
+            for (uint c = 0; c < ntotal; ++c) cell_start[c + 1] += cell_start[c];
+            items.resize(cell_start[ntotal]);
+        }
+        else {
+            // the fill advanced each start to the start of the next cell
+            for (uint c = ntotal; c > 0; --c) cell_start[c] = cell_start[c - 1];
+            cell_start[0] = 0;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint bbox_grid::cell_coord(uint axis, double x) const
+{
+    // monotonic in x, so a point in a box maps between the cells of the
+    // box corners
+    double c = std::floor((x - extent.min()[axis]) * inv_cell_size[axis]);
+    if (c < 0.0) return 0;
+    if (c >= ncells[axis]) return ncells[axis] - 1;
+    return static_cast<uint>(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::pair<const uint *, const uint *> bbox_grid::candidates(const point3d &p) const
+{
+    if (empty() || !extent.contains(p)) {
+        return std::make_pair(nullptr, nullptr);
+    }
+    uint c = (cell_coord(0, p[0]) * ncells[1] + cell_coord(1, p[1])) * ncells[2] + cell_coord(2, p[2]);
+    const uint * base = items.data();
+    return std::make_pair(base + cell_start[c], base + cell_start[c + 1]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint> bbox_grid::candidates(const bounding_box &b) const
+{
+    std::vector<uint> found;
+    if (empty() || b.empty() || extent.empty()) return found;
+    uint lo[3], hi[3];
+    for (uint a = 0; a < 3; ++a) {
+        if (b.max()[a] < extent.min()[a] || b.min()[a] > extent.max()[a]) return found;
+        lo[a] = cell_coord(a, b.min()[a]);
+        hi[a] = cell_coord(a, b.max()[a]);
+    }
+    for (uint x = lo[0]; x <= hi[0]; ++x)
+        for (uint y = lo[1]; y <= hi[1]; ++y)
+            for (uint z = lo[2]; z <= hi[2]; ++z) {
+                uint c = (x * ncells[1] + y) * ncells[2] + z;
+                found.insert(found.end(), items.begin() + cell_start[c], items.begin() + cell_start[c + 1]);
+            }
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    return found;
+}
+
+}  // namespace math
+}  // namespace steps
+
+// END
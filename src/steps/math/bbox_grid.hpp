@@ -0,0 +1,87 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_MATH_BBOX_GRID_HPP
+#define STEPS_MATH_BBOX_GRID_HPP 1
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "steps/common.h"
+#include "steps/math/bbox.hpp"
+#include "steps/math/point.hpp"
+
+namespace steps {
+namespace math {
+
+/** Uniform grid over a set of axis-aligned bounding boxes.
+ *
+ * Each cell lists, in ascending order, the indices of the boxes that
+ * overlap it, so that the boxes that may contain a point are those of
+ * the cell of the point.
+ */
+
+class bbox_grid {
+public:
+    /** Construct empty grid. */
+    bbox_grid(): ncells{{0,0,0}} {}
+
+    /** Construct grid over boxes.
+     *
+     * Cells are about the size of an average box, with at most a few
+     * cells per box.
+     */
+    explicit bbox_grid(const std::vector<bounding_box> &boxes);
+
+    /** Return true if grid has not been built. */
+    bool empty() const { return cell_start.empty(); }
+
+    /** Return the range of the indices of the boxes that may contain p.
+     *
+     * The range is empty if p lies outside the extent of the grid.
+     */
+    std::pair<const uint *, const uint *> candidates(const point3d &p) const;
+
+    /** Return the indices of the boxes that may overlap b, in ascending
+     * order and without duplicates. */
+    std::vector<uint> candidates(const bounding_box &b) const;
+
+private:
+    bounding_box extent;
+    point3d inv_cell_size;
+    std::array<uint,3> ncells;
+
+    // cell c holds items[cell_start[c]] .. items[cell_start[c+1]-1]
+    std::vector<uint> cell_start;
+    std::vector<uint> items;
+
+    uint cell_coord(uint axis, double x) const;
+};
+
+}} // namespace steps::math
+
+#endif // ndef STEPS_MATH_BBOX_GRID_HPP
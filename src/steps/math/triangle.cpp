@@ -68,6 +68,40 @@ point3d tri_ranpnt(const point3d &p0, const point3d &p1, const point3d &p2, doub
     return (1-u)*p0 + (u-v)*p1 + v*p2;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+point3d tri_closest_point(const point3d &p0, const point3d &p1, const point3d &p2, const point3d &x)
+{
+    // Voronoi regions of the vertices, edges and face, after Ericson,
+    // Real-Time Collision Detection, section 5.1.5
+    point3d e1 = p1-p0, e2 = p2-p0, d0 = x-p0;
+    double a1 = dot(e1, d0), a2 = dot(e2, d0);
+    if (a1 <= 0 && a2 <= 0) return p0;
+
+    point3d d1 = x-p1;
+    double b1 = dot(e1, d1), b2 = dot(e2, d1);
+    if (b1 >= 0 && b2 <= b1) return p1;
+
+    double vc = a1*b2 - b1*a2;
+    if (vc <= 0 && a1 >= 0 && b1 <= 0) return p0 + (a1/(a1-b1))*e1;
+
+    point3d d2 = x-p2;
+    double c1 = dot(e1, d2), c2 = dot(e2, d2);
+    if (c2 >= 0 && c1 <= c2) return p2;
+
+    double vb = c1*a2 - a1*c2;
+    if (vb <= 0 && a2 >= 0 && c2 <= 0) return p0 + (a2/(a2-c2))*e2;
+
+    double va = b1*c2 - c1*b2;
+    if (va <= 0 && (b2-b1) >= 0 && (c1-c2) >= 0) {
+        double w = (b2-b1)/((b2-b1) + (c1-c2));
+        return p1 + w*(p2-p1);
+    }
+
+    double den = 1.0/(va + vb + vc);
+    return p0 + (vb*den)*e1 + (vc*den)*e2;
+}
+
 }  // namespace math
 }  // namespace steps
 
@@ -67,6 +67,14 @@ point3d tri_normal(const point3d &p0, const point3d &p1, const point3d &p2);
  */
 point3d tri_ranpnt(const point3d &p0, const point3d &p1, const point3d &p2, double s, double t);
 
+/** Find the point of a triangle closest to a given point.
+ *
+ * \param p0,p1,p2 Vertices of triangle.
+ * \param x Query point.
+ * \return Closest point of the triangle (interior, edge or vertex) to x.
+ */
+point3d tri_closest_point(const point3d &p0, const point3d &p1, const point3d &p2, const point3d &x);
+
 }} // namespace steps::math
 
 #endif // ndef STEPS_MATH_TRIANGLE_HPP
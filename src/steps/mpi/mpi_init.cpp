@@ -34,8 +34,10 @@
 
 
 void steps::mpi::mpiInit() {
-    /* Initialize MPI */
-    MPI_Init(NULL, NULL);
+    /* Initialize MPI; only the main thread of a rank makes MPI calls,
+       diffusion may run on more threads in between */
+    int provided;
+    MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &provided);
 
     int rank; MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
@@ -63,6 +65,11 @@ void steps::mpi::mpiInit() {
 
     el::Loggers::getLogger("general_log");
     el::Loggers::reconfigureLogger("general_log", parallel_conf);
+
+    if (provided < MPI_THREAD_FUNNELED) {
+        CLOG(WARNING, "general_log") << "MPI_THREAD_FUNNELED is not supported, "
+                                     << "diffusion will run on one thread per rank.\n";
+    }
     
     MPI_Barrier(MPI_COMM_WORLD);
 }
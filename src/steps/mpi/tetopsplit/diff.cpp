@@ -250,6 +250,39 @@ void smtos::Diff::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::Diff::packState(std::vector<double> & buf) const
+{
+    KProc::packState(buf);
+    buf.push_back(pDcst);
+    buf.insert(buf.end(), pDiffBndActive, pDiffBndActive + 4);
+    buf.push_back(directionalDcsts.size());
+    for (auto const & item : directionalDcsts) {
+        buf.push_back(item.first);
+        buf.push_back(item.second);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double const * smtos::Diff::unpackState(double const * buf)
+{
+    buf = KProc::unpackState(buf);
+    double dcst = *buf++;
+    for (uint i = 0; i < 4; ++i) pDiffBndActive[i] = (*buf++ != 0.0);
+
+    // directional dcsts are set on top of the compartment one, the same
+    // way setDirectionDcst() does
+    setDcst(dcst);
+    uint n_direct_dcsts = static_cast<uint>(*buf++);
+    for (uint i = 0; i < n_direct_dcsts; i++) {
+        int direction = static_cast<int>(*buf++);
+        setDirectionDcst(direction, *buf++);
+    }
+    return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void smtos::Diff::setupDeps()
 {
     // We will check all KProcs of the following simulation elements:
@@ -708,7 +741,7 @@ double smtos::Diff::rate(steps::mpi::tetopsplit::TetOpSplitP * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-int smtos::Diff::apply(steps::rng::RNG * rng)
+int smtos::Diff::apply(steps::rng::RNG * rng, double period)
 {
 
 	// Apply local change.
@@ -743,9 +776,9 @@ int smtos::Diff::apply(steps::rng::RNG * rng)
 
     if (nexttet->clamped(pNeighbCompLidx[iSel]) == false)
     {
-        nexttet->incCount(pNeighbCompLidx[iSel],1);
+        nexttet->incCount(pNeighbCompLidx[iSel], 1, period);
     }
-    if (clamped == false) {pTet->incCount(lidxTet, -1); }
+    if (clamped == false) {pTet->incCount(lidxTet, -1, period); }
 
     rExtent++;
 
@@ -754,7 +787,7 @@ int smtos::Diff::apply(steps::rng::RNG * rng)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int smtos::Diff::apply(steps::rng::RNG * rng, uint nmolcs)
+int smtos::Diff::apply(steps::rng::RNG * rng, uint nmolcs, double period)
 {
 	// Apply local change.
 	uint * local = pTet->pools() + lidxTet;
@@ -801,7 +834,7 @@ int smtos::Diff::apply(steps::rng::RNG * rng, uint nmolcs)
 
         	if (nexttet->clamped(pNeighbCompLidx[direction]) == false)
         	{
-        		nexttet->incCount(pNeighbCompLidx[direction],molcsthisdir);
+        		nexttet->incCount(pNeighbCompLidx[direction], molcsthisdir, period);
         	}
 
         	molcs_moved+=molcsthisdir;
@@ -822,7 +855,7 @@ int smtos::Diff::apply(steps::rng::RNG * rng, uint nmolcs)
 
         	if (nexttet->clamped(pNeighbCompLidx[direction]) == false)
         	{
-        		nexttet->incCount(pNeighbCompLidx[direction],molcsthisdir);
+        		nexttet->incCount(pNeighbCompLidx[direction], molcsthisdir, period);
         	}
 
         	molcs_moved+=molcsthisdir;
@@ -830,7 +863,7 @@ int smtos::Diff::apply(steps::rng::RNG * rng, uint nmolcs)
 
 	AssertLog(molcs_moved == nmolcs);
 
-	if (clamped == false) {pTet->incCount(lidxTet, -nmolcs); }
+	if (clamped == false) {pTet->incCount(lidxTet, -nmolcs, period); }
 
 	rExtent+=nmolcs;
 	return -1;
@@ -87,6 +87,30 @@ void smtos::KProc::resetExtent()
 {
     rExtent = 0;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::KProc::setExtent(uint extent)
+{
+    rExtent = extent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::KProc::packState(std::vector<double> & buf) const
+{
+    buf.push_back(rExtent);
+    buf.push_back(pFlags);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double const * smtos::KProc::unpackState(double const * buf)
+{
+    rExtent = static_cast<uint>(*buf++);
+    pFlags = static_cast<uint>(*buf++);
+    return buf;
+}
 ////////////////////////////////////////////////////////////////////////////////
 
 void smtos::KProc::resetCcst() const
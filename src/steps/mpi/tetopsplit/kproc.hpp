@@ -50,7 +50,7 @@
 //#include "tetopsplit.hpp"
 
 // TetOpSplitP CR header
-#include "steps/mpi/tetopsplit/crstruct.hpp"
+#include "steps/solver/crscheduler.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -103,6 +103,13 @@ public:
     /// restore data
     virtual void restore(std::fstream & cp_file) = 0;
 
+    /// append the extent, the flags and the rate parameters set on this
+    /// kproc to buf, for migration to another rank
+    virtual void packState(std::vector<double> & buf) const;
+
+    /// read back what packState wrote, returns the end of the record
+    virtual double const * unpackState(double const * buf);
+
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS
     ////////////////////////////////////////////////////////////////////////
@@ -189,6 +196,7 @@ public:
 
     uint getExtent() const;
     void resetExtent();
+    void setExtent(uint extent);
 
     ////////////////////////////////////////////////////////////////////////
     /*
@@ -203,7 +211,7 @@ public:
     ////////////////////////////////////////////////////////////////////////
 
     // data for CR SSA
-    CRKProcData                         crData;
+    steps::solver::CRKProcData          crData;
 
 protected:
 
@@ -126,6 +126,25 @@ void smtos::Reac::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::Reac::packState(std::vector<double> & buf) const
+{
+    KProc::packState(buf);
+    buf.push_back(pCcst);
+    buf.push_back(pKcst);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double const * smtos::Reac::unpackState(double const * buf)
+{
+    buf = KProc::unpackState(buf);
+    pCcst = *buf++;
+    pKcst = *buf++;
+    return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void smtos::Reac::reset()
 {
 
@@ -236,18 +255,14 @@ double smtos::Reac::rate(smtos::TetOpSplitP * solver)
 
     // Prefetch some variables.
     ssolver::Compdef * cdef = pTet->compdef();
-    uint nspecs = cdef->countSpecs();
-    uint * lhs_vec = cdef->reac_lhs_bgn(cdef->reacG2L(pReacdef->gidx()));
     uint * cnt_vec = pTet->pools();
 
     // Compute combinatorial part.
     double h_mu = 1.0;
-    for (uint pool = 0; pool < nspecs; ++pool)
+    for (auto const & sc : cdef->reac_lhs_sparse(cdef->reacG2L(pReacdef->gidx())))
     {
-        uint lhs = lhs_vec[pool];
-        if (lhs == 0) { continue;
-        }
-        uint cnt = cnt_vec[pool];
+        uint lhs = sc.coeff;
+        uint cnt = cnt_vec[sc.lidx];
         if (lhs > cnt)	  
         {	
             h_mu = 0.0;	
@@ -291,13 +306,12 @@ void smtos::Reac::apply(steps::rng::RNG * rng, double dt, double simtime, double
     uint * local = pTet->pools();
     ssolver::Compdef * cdef = pTet->compdef();
     uint l_ridx = cdef->reacG2L(pReacdef->gidx());
-    int * upd_vec = cdef->reac_upd_bgn(l_ridx);
-    uint nspecs = cdef->countSpecs();
-    for (uint i = 0; i < nspecs; ++i)
+    for (auto const & sc : cdef->reac_upd_sparse(l_ridx))
     {
+        uint i = sc.lidx;
         if (pTet->clamped(i) == true) { continue;
 }
-        int j = upd_vec[i];
+        int j = sc.coeff;
         int nc = static_cast<int>(local[i]) + j;
         AssertLog(nc >= 0);
         pTet->setCount(i, static_cast<uint>(nc), period);
@@ -80,6 +80,9 @@ public:
     /// restore data
     void restore(std::fstream & cp_file);
 
+    void packState(std::vector<double> & buf) const;
+    double const * unpackState(double const * buf);
+
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS
     ////////////////////////////////////////////////////////////////////////
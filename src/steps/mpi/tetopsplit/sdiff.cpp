@@ -194,8 +194,6 @@ void smtos::SDiff::checkpoint(std::fstream & cp_file)
     cp_file.write((char*)pSDiffBndDirection, sizeof(bool) * 3);
     cp_file.write((char*)pNeighbPatchLidx, sizeof(int) * 3);
 
-    // Need to add directional stuff here if checkpointing ever implemented
-
     cp_file.write((char*)&(crData.recorded), sizeof(bool));
     cp_file.write((char*)&(crData.pow), sizeof(int));
     cp_file.write((char*)&(crData.pos), sizeof(unsigned));
@@ -226,8 +224,6 @@ void smtos::SDiff::restore(std::fstream & cp_file)
     cp_file.read((char*)pSDiffBndActive, sizeof(bool) * 3);
     cp_file.read((char*)pSDiffBndDirection, sizeof(bool) * 3);
     cp_file.read((char*)pNeighbPatchLidx, sizeof(int) * 3);
-
-    // Need to add directional stuff here if checkpointing ever implemented
     
     cp_file.read((char*)&(crData.recorded), sizeof(bool));
     cp_file.read((char*)&(crData.pow), sizeof(int));
@@ -237,6 +233,39 @@ void smtos::SDiff::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::SDiff::packState(std::vector<double> & buf) const
+{
+    KProc::packState(buf);
+    buf.push_back(pDcst);
+    buf.insert(buf.end(), pSDiffBndActive, pSDiffBndActive + 3);
+    buf.push_back(directionalDcsts.size());
+    for (auto const & item : directionalDcsts) {
+        buf.push_back(item.first);
+        buf.push_back(item.second);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double const * smtos::SDiff::unpackState(double const * buf)
+{
+    buf = KProc::unpackState(buf);
+    double dcst = *buf++;
+    for (uint i = 0; i < 3; ++i) pSDiffBndActive[i] = (*buf++ != 0.0);
+
+    // directional dcsts are set on top of the patch one, the same way
+    // setDirectionDcst() does
+    setDcst(dcst);
+    uint n_direct_dcsts = static_cast<uint>(*buf++);
+    for (uint i = 0; i < n_direct_dcsts; i++) {
+        int direction = static_cast<int>(*buf++);
+        setDirectionDcst(direction, *buf++);
+    }
+    return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void smtos::SDiff::setupDeps()
 {
     // We will check all KProcs of the following simulation elements:
@@ -667,7 +696,7 @@ double smtos::SDiff::getScaledDcst(steps::mpi::tetopsplit::TetOpSplitP * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-int smtos::SDiff::apply(steps::rng::RNG * rng)
+int smtos::SDiff::apply(steps::rng::RNG * rng, double period)
 {
     //uint lidxTet = this->lidxTet;
     // Pre-fetch some general info.
@@ -703,11 +732,11 @@ int smtos::SDiff::apply(steps::rng::RNG * rng)
     AssertLog(nexttri != 0);
 
     if (nexttri->clamped(pNeighbPatchLidx[iSel]) == false) {
-        nexttri->incCount(pNeighbPatchLidx[iSel],1);
+        nexttri->incCount(pNeighbPatchLidx[iSel], 1, period);
 }
 
     if (clamped == false) {
-        pTri->incCount(lidxTri, -1);
+        pTri->incCount(lidxTri, -1, period);
 }
 
     rExtent++;
@@ -716,7 +745,7 @@ int smtos::SDiff::apply(steps::rng::RNG * rng)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int smtos::SDiff::apply(steps::rng::RNG * rng, uint nmolcs)
+int smtos::SDiff::apply(steps::rng::RNG * rng, uint nmolcs, double period)
 {
 	// Apply local change.
     uint * local = pTri->pools() + lidxTri;
@@ -764,7 +793,7 @@ int smtos::SDiff::apply(steps::rng::RNG * rng, uint nmolcs)
 
             if (nexttri->clamped(pNeighbPatchLidx[direction]) == false)
         	{
-            	nexttri->incCount(pNeighbPatchLidx[direction],molcsthisdir);
+            	nexttri->incCount(pNeighbPatchLidx[direction], molcsthisdir, period);
         	}
 
         	molcs_moved+=molcsthisdir;
@@ -785,7 +814,7 @@ int smtos::SDiff::apply(steps::rng::RNG * rng, uint nmolcs)
 
         if (nexttri->clamped(pNeighbPatchLidx[direction]) == false)
     	{
-        	nexttri->incCount(pNeighbPatchLidx[direction],molcsthisdir);
+        	nexttri->incCount(pNeighbPatchLidx[direction], molcsthisdir, period);
     	}
 
     	molcs_moved+=molcsthisdir;
@@ -795,7 +824,7 @@ int smtos::SDiff::apply(steps::rng::RNG * rng, uint nmolcs)
 	AssertLog(molcs_moved == nmolcs);
 
 
-	if (clamped == false) {pTri->incCount(lidxTri, -nmolcs); }
+	if (clamped == false) {pTri->incCount(lidxTri, -nmolcs, period); }
 
 	rExtent+=nmolcs;
 
@@ -78,6 +78,9 @@ public:
     /// restore data
     void restore(std::fstream & cp_file);
 
+    void packState(std::vector<double> & buf) const;
+    double const * unpackState(double const * buf);
+
     ////////////////////////////////////////////////////////////////////////
     // VIRTUAL INTERFACE METHODS
     ////////////////////////////////////////////////////////////////////////
@@ -99,8 +102,9 @@ public:
     double getScaledDcst(steps::mpi::tetopsplit::TetOpSplitP * solver = 0);
     
     
-    int apply(steps::rng::RNG * rng);
-    int apply(steps::rng::RNG * rng, uint nmolcs);
+    // period is the simulation time of the move, for the pool occupancies
+    int apply(steps::rng::RNG * rng, double period);
+    int apply(steps::rng::RNG * rng, uint nmolcs, double period);
 
     std::vector<KProc*> const & getLocalUpdVec(int direction = -1);
     std::vector<uint> const & getRemoteUpdVec(int direction = -1);
@@ -170,6 +170,25 @@ void smtos::SReac::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::SReac::packState(std::vector<double> & buf) const
+{
+    KProc::packState(buf);
+    buf.push_back(pCcst);
+    buf.push_back(pKcst);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double const * smtos::SReac::unpackState(double const * buf)
+{
+    buf = KProc::unpackState(buf);
+    pCcst = *buf++;
+    pKcst = *buf++;
+    return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void smtos::SReac::reset()
 {
 
@@ -441,15 +460,11 @@ double smtos::SReac::rate(steps::mpi::tetopsplit::TetOpSplitP * solver)
 
         double h_mu = 1.0;
 
-        uint * lhs_s_vec = pdef->sreac_lhs_S_bgn(lidx);
         uint * cnt_s_vec = pTri->pools();
-        uint nspecs_s = pdef->countSpecs();
-        for (uint s = 0; s < nspecs_s; ++s)
+        for (auto const & sc : pdef->sreac_lhs_S_sparse(lidx))
         {
-            uint lhs = lhs_s_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_s_vec[s];
+            uint lhs = sc.coeff;
+            uint cnt = cnt_s_vec[sc.lidx];
             if (lhs > cnt)
             {
                 return 0.0;
@@ -483,15 +498,11 @@ double smtos::SReac::rate(steps::mpi::tetopsplit::TetOpSplitP * solver)
 
         if (pSReacdef->inside())
         {
-            uint * lhs_i_vec = pdef->sreac_lhs_I_bgn(lidx);
             uint * cnt_i_vec = pTri->iTet()->pools();
-            uint nspecs_i = pdef->countSpecs_I();
-            for (uint s = 0; s < nspecs_i; ++s)
+            for (auto const & sc : pdef->sreac_lhs_I_sparse(lidx))
             {
-                uint lhs = lhs_i_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_i_vec[s];
+                uint lhs = sc.coeff;
+                uint cnt = cnt_i_vec[sc.lidx];
                 if (lhs > cnt)
                 {
                     return 0.0;
@@ -525,15 +536,11 @@ double smtos::SReac::rate(steps::mpi::tetopsplit::TetOpSplitP * solver)
         }
         else if (pSReacdef->outside())
         {
-            uint * lhs_o_vec = pdef->sreac_lhs_O_bgn(lidx);
             uint * cnt_o_vec = pTri->oTet()->pools();
-            uint nspecs_o = pdef->countSpecs_O();
-            for (uint s = 0; s < nspecs_o; ++s)
+            for (auto const & sc : pdef->sreac_lhs_O_sparse(lidx))
             {
-                uint lhs = lhs_o_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_o_vec[s];
+                uint lhs = sc.coeff;
+                uint cnt = cnt_o_vec[sc.lidx];
                 if (lhs > cnt)
                 {
                     return 0.0;
@@ -599,12 +606,12 @@ void smtos::SReac::apply(steps::rng::RNG * rng, double dt, double simtime, doubl
 		pTri->setOCchange(oc, cs_lidx, dt, simtime);
 	}
 
-    uint nspecs_s = pdef->countSpecs();
-    for (uint s = 0; s < nspecs_s; ++s)
+    for (auto const & sc : pdef->sreac_upd_S_sparse(lidx))
     {
+        uint s = sc.lidx;
         if (pTri->clamped(s) == true) { continue;
 }
-        int upd = upd_s_vec[s];
+        int upd = sc.coeff;
         int nc = static_cast<int>(cnt_s_vec[s]) + upd;
         AssertLog(nc >= 0);
         pTri->setCount(s, static_cast<uint>(nc), period);
@@ -614,14 +621,13 @@ void smtos::SReac::apply(steps::rng::RNG * rng, double dt, double simtime, doubl
     smtos::WmVol * itet = pTri->iTet();
     if (itet != nullptr)
     {
-        int * upd_i_vec = pdef->sreac_upd_I_bgn(lidx);
         uint * cnt_i_vec = itet->pools();
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
+        for (auto const & sc : pdef->sreac_upd_I_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (itet->clamped(s) == true) { continue;
 }
-            int upd = upd_i_vec[s];
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_i_vec[s]) + upd;
             AssertLog(nc >= 0);
             itet->setCount(s, static_cast<uint>(nc), period);
@@ -632,14 +638,13 @@ void smtos::SReac::apply(steps::rng::RNG * rng, double dt, double simtime, doubl
     smtos::WmVol * otet = pTri->oTet();
     if (otet != nullptr)
     {
-        int * upd_o_vec = pdef->sreac_upd_O_bgn(lidx);
         uint * cnt_o_vec = otet->pools();
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
+        for (auto const & sc : pdef->sreac_upd_O_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (otet->clamped(s) == true) { continue;
 }
-            int upd = upd_o_vec[s];
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_o_vec[s]) + upd;
             AssertLog(nc >= 0);
             otet->setCount(s, static_cast<uint>(nc), period);
@@ -75,6 +75,7 @@ smtos::Tet::Tet
 , pDist()
 , pPoolOccupancy(nullptr)
 , pLastUpdate(nullptr)
+, pPoolLevel(nullptr)
 {
     AssertLog(a0 > 0.0 && a1 > 0.0 && a2 > 0.0 && a3 > 0.0);
     AssertLog(d0 >= 0.0 && d1 >= 0.0 && d2 >= 0.0 && d3 >= 0.0);
@@ -110,6 +111,8 @@ smtos::Tet::Tet
     std::fill_n(pPoolOccupancy, nspecs, 0.0);
     pLastUpdate = new double[nspecs];
     std::fill_n(pLastUpdate, nspecs, 0.0);
+    pPoolLevel = new unsigned char[nspecs];
+    std::fill_n(pPoolLevel, nspecs, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -118,6 +121,7 @@ smtos::Tet::~Tet()
 {
     delete[] pPoolOccupancy;
     delete[] pLastUpdate;
+    delete[] pPoolLevel;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -369,12 +373,7 @@ void smtos::Tet::setCount(uint lidx, uint count, double period)
 }
 	
 	// Count has changed,
-	double lastupdate = pLastUpdate[lidx];
-	AssertLog(period >= lastupdate);
-	pPoolOccupancy[lidx] += oldcount*(period-lastupdate);
-
-	pLastUpdate[lidx] = period;
-	
+	_updateOccupancy(lidx, oldcount, period);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -407,14 +406,7 @@ void smtos::Tet::incCount(uint lidx, int inc, double period, bool local_change)
 		if (period == 0.0 || local_change) { return;
 }
 		// Count has changed,
-		double lastupdate = pLastUpdate[lidx];
-		AssertLog(period >= lastupdate);
-		pPoolOccupancy[lidx] += oldcount*(period-lastupdate);
-
-		pLastUpdate[lidx] = period;
-		
-
-
+		_updateOccupancy(lidx, oldcount, period);
     }
 }
 ////////////////////////////////////////////////////////////////////////////////
@@ -447,6 +439,40 @@ void smtos::Tet::resetPoolOccupancy()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::Tet::setPoolLevel(uint lidx, uint level)
+{
+    AssertLog(lidx < compdef()->countSpecs());
+    pPoolLevel[lidx] = static_cast<unsigned char>(level);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::Tet::_updateOccupancy(uint lidx, double oldcount, double period)
+{
+    double start = pSol->getDiffLevelStart(pPoolLevel[lidx]);
+    double lastupdate = pLastUpdate[lidx];
+    if (lastupdate <= start) {
+        pPoolOccupancy[lidx] = 0.0;
+        lastupdate = start;
+    }
+    AssertLog(period >= lastupdate);
+    pPoolOccupancy[lidx] += oldcount*(period-lastupdate);
+    pLastUpdate[lidx] = period;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double smtos::Tet::getWindowOccupancy(uint lidx, double period)
+{
+    AssertLog(lidx < compdef()->countSpecs());
+    double start = pSol->getDiffLevelStart(pPoolLevel[lidx]);
+    double lastupdate = pLastUpdate[lidx];
+    if (lastupdate <= start) return pPoolCount[lidx] * (period - start);
+    return pPoolOccupancy[lidx] + pPoolCount[lidx] * (period - lastupdate);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 std::vector<smtos::KProc*> const & smtos::Tet::getSpecUpdKProcs(uint slidx)
 {
     return localSpecUpdKProcs[slidx];
@@ -456,14 +482,27 @@ std::vector<smtos::KProc*> const & smtos::Tet::getSpecUpdKProcs(uint slidx)
 
 void smtos::Tet::repartition(smtos::TetOpSplitP * tex, int rank, int host_rank)
 {
+    bool stays = (hostRank == myRank && host_rank == rank);
     myRank = rank;
     hostRank = host_rank;
     
-    // Delete reaction rules.
-    KProcPVecCI e = pKProcs.end();
-    for (KProcPVecCI i = pKProcs.begin(); i != e; ++i) delete *i;
-    
-    setupKProcs(tex);
+    // The kprocs of a tet that stays on this rank keep their constants,
+    // flags and extents; they only get new solver indices.
+    if (stays) {
+        startKProcIdx = tex->countKProcs();
+        for (auto kp : pKProcs) {
+            kp->crData = steps::solver::CRKProcData();
+            kp->setSchedIDX(tex->addKProc(kp));
+            if (kp->getType() == KP_DIFF) tex->addDiff(static_cast<smtos::Diff*>(kp));
+        }
+    }
+    else {
+        // Delete reaction rules.
+        KProcPVecCI e = pKProcs.end();
+        for (KProcPVecCI i = pKProcs.begin(); i != e; ++i) delete *i;
+        
+        setupKProcs(tex);
+    }
     localSpecUpdKProcs.clear();
     bufferLocations.clear();
 }
@@ -184,6 +184,14 @@ public:
 	}
     double getLastUpdate(uint lidx);
 	void resetPoolOccupancy();
+
+    // Diffusion rate level of species lidx, whose window its occupancy
+    // covers.
+    void setPoolLevel(uint lidx, uint level);
+
+    // Count of species lidx integrated from the start of the current
+    // window of its level up to period.
+    double getWindowOccupancy(uint lidx, double period);
     
     std::vector<smtos::KProc*> const & getSpecUpdKProcs(uint slidx);
 
@@ -221,6 +229,12 @@ private:
     double                            * pPoolOccupancy;
     /// Structure to store time since last update, used to calculate occupancy
     double 							  *	pLastUpdate;
+    /// Diffusion rate level of each species
+    unsigned char                     * pPoolLevel;
+
+    // add the occupancy of oldcount up to period, dropping what is left
+    // of an earlier window
+    void _updateOccupancy(uint lidx, double oldcount, double period);
     
     /// location of where the change of this species is stored in  the solver buffer
     std::vector<uint>                   bufferLocations;
@@ -51,6 +51,7 @@
 #include "steps/common.h"
 #include "steps/error.hpp"
 #include "steps/geom/tetmesh.hpp"
+#include "steps/geom/tetmesh_partition.hpp"
 #include "steps/math/constants.hpp"
 #include "steps/math/point.hpp"
 #include "steps/mpi/mpi_common.hpp"
@@ -70,6 +71,7 @@
 #include "steps/mpi/tetopsplit/vdepsreac.hpp"
 #include "steps/mpi/tetopsplit/vdeptrans.hpp"
 #include "steps/mpi/tetopsplit/wmvol.hpp"
+#include "steps/rng/r123.hpp"
 #include "steps/solver/chandef.hpp"
 #include "steps/solver/compdef.hpp"
 #include "steps/solver/diffboundarydef.hpp"
@@ -86,6 +88,8 @@
 #include "steps/solver/vdeptransdef.hpp"
 
 #include "steps/solver/efield/dVsolver.hpp"
+#include "steps/solver/efield/dVsolver_cg.hpp"
+#include "steps/solver/efield/dVsolver_dist.hpp"
 #include "steps/solver/efield/dVsolver_slu.hpp"
 #include "steps/solver/efield/efield.hpp"
 #ifdef USE_PETSC
@@ -116,21 +120,27 @@ void smtos::schedIDXSet_To_Vec(smtos::SchedIDXSet const & s, smtos::SchedIDXVec
 
 smtos::TetOpSplitP::TetOpSplitP(steps::model::Model * m, steps::wm::Geom * g, steps::rng::RNG * r,
         int calcMembPot, std::vector<uint> const &tet_hosts, std::map<uint, uint> const &tri_hosts,
-        std::vector<uint> const &wm_hosts)
+        std::vector<uint> const &wm_hosts, std::vector<uint> const &tet_gidx,
+        std::vector<uint> const &tri_gidx)
 : API(m, g, r)
 , pMesh(nullptr)
-, pKProcs()
 , pComps()
 , pCompMap()
 , pPatches()
 , pDiffBoundaries()
 , pSDiffBoundaries()
-, pTets()
-, pTris()
 , pWmVols()
+, pTris()
+, pTets()
+, diffSep(0)
+, diffBndSep(0)
+, sdiffSep(0)
+, sdiffBndSep(0)
 , pA0(0.0)
+, pKProcs()
 , pEFoption(static_cast<EF_solver>(calcMembPot))
 , pTemp(0.0)
+, pEFDistSolver(nullptr)
 , pEFDT(1.0e-5)
 , pEFNVerts(0)
 , pEFNTris(0)
@@ -144,14 +154,34 @@ smtos::TetOpSplitP::TetOpSplitP(steps::model::Model * m, steps::wm::Geom * g, st
 , tetHosts(tet_hosts)
 , triHosts(tri_hosts)
 , wmHosts(wm_hosts)
-, diffApplyThreshold(10)
-, diffSep(0)
-, sdiffSep(0)
-, updPeriod(0.0)
-, recomputeUpdPeriod(true)
-, reacExtent(0.0)
 , diffExtent(0.0)
+, reacExtent(0.0)
 , nIteration(0.0)
+, updPeriod(0.0)
+, recomputeUpdPeriod(true)
+, diffApplyThreshold(10)
+, pNeighbComm(nullptr)
+, pSyncRequests(nullptr)
+, pSyncStage(0)
+, pUpdEpoch(0)
+, pObsFlushLocal(false)
+, pItersSinceRebalance(0)
+, pRebalanceInterval(0)
+, pRebalanceThreshold(1.2)
+, pRebalanceCount(0)
+, pDiffThreads(1)
+, pDiffBatches(1)
+, pDiffRateLevels(1)
+, pBndDiffLevel(0)
+, pDistMesh(false)
+, pTetGIdx()
+, pTriGIdx()
+, pTetG2L()
+, pTriG2L()
+, pGlobalTets(0)
+, pGlobalTris(0)
+, pElementRNG(false)
+, pElementRNGSeed(0)
 , rd()
 , gen(rd())
 , compTime(0.0)
@@ -172,6 +202,7 @@ smtos::TetOpSplitP::TetOpSplitP(steps::model::Model * m, steps::wm::Geom * g, st
     
     MPI_Comm_size(MPI_COMM_WORLD, &nHosts);
     
+    if (!tet_gidx.empty()) _setupDistMesh(tet_gidx, tri_gidx);
     
     // All initialization code now in _setup() to allow EField solver to be
     // derived and create EField local objects within the constructor
@@ -190,14 +221,8 @@ smtos::TetOpSplitP::~TetOpSplitP()
     for (auto wvol: pWmVols) delete wvol;
     for (auto t: pTets) delete t;
     for (auto t: pTris) delete t;
-    for (auto g: nGroups) {
-        g->free_indices();
-        delete g;
-    }
-    for (auto g: pGroups) {
-        g->free_indices();
-        delete g;
-    }
+
+    _freeNeighbComm();
 
     if (efflag())
     {
@@ -212,259 +237,438 @@ smtos::TetOpSplitP::~TetOpSplitP()
 
 void smtos::TetOpSplitP::checkpoint(std::string const & file_name)
 {
-    std::ostringstream os;
-    os << "This function has not been implemented!";
-    NotImplErrLog(os.str());
-
-    /*
-    
-    CLOG(INFO, "general_log") << "Checkpoint to " << file_name  << "...";
+    // The checkpoint consists of a manifest written by rank 0, holding the
+    // replicated state (statedef, EField), and one file per rank holding
+    // the state of the locally owned elements and kprocs only.
+    std::string rank_file_name = _rankCheckpointFile(file_name);
     std::fstream cp_file;
+    std::fstream rank_cp_file;
 
-    cp_file.open(file_name.c_str(),
-                std::fstream::out | std::fstream::binary | std::fstream::trunc);
-
-    statedef()->checkpoint(cp_file);
-
-    CompPVecCI comp_e = pComps.end();
-    for (CompPVecCI c = pComps.begin(); c != comp_e; ++c) (*c)->checkpoint(cp_file);
-
-    PatchPVecCI patch_e = pPatches.end();
-    for (PatchPVecCI p = pPatches.begin(); p != patch_e; ++p) (*p)->checkpoint(cp_file);
-
-    DiffBoundaryPVecCI db_e = pDiffBoundaries.end();
-    for (DiffBoundaryPVecCI db = pDiffBoundaries.begin(); db != db_e; ++db) {
-        (*db)->checkpoint(cp_file);
-    }
-
-    SDiffBoundaryPVecCI sdb_e = pSDiffBoundaries.end();
-    for (SDiffBoundaryPVecCI sdb = pSDiffBoundaries.begin(); sdb != sdb_e; ++sdb) {
-        (*sdb)->checkpoint(cp_file);
-    }
-
-    WmVolPVecCI wmv_e = pWmVols.end();
-    for (WmVolPVecCI wmv = pWmVols.begin(); wmv != wmv_e; ++wmv)
-    {
-        if ((*wmv) != 0) {
-            (*wmv)->checkpoint(cp_file);
-        }
-    }
-
-
-    TetPVecCI tet_e = pTets.end();
-    for (TetPVecCI t = pTets.begin(); t != tet_e; ++t)
-    {
-        if ((*t) != 0) {
-        (*t)->checkpoint(cp_file);
-        }
-    }
-
-    TriPVecCI tri_e = pTris.end();
-    for (TriPVecCI t = pTris.begin(); t != tri_e; ++t)
-    {
-        if ((*t) != 0) {
-            (*t)->checkpoint(cp_file);
-        }
+    bool opened = true;
+    if (myRank == 0) {
+        CLOG(INFO, "general_log") << "Checkpoint to " << file_name  << "...";
+        cp_file.open(file_name.c_str(),
+                    std::fstream::out | std::fstream::binary | std::fstream::trunc);
+        opened = cp_file.good();
     }
+    rank_cp_file.open(rank_file_name.c_str(),
+                std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    opened = opened && rank_cp_file.good();
 
-    KProcPVecCI e = pKProcs.end();
-    for (KProcPVecCI i = pKProcs.begin(); i != e; ++i) (*i)->checkpoint(cp_file);
-
-    if (efflag()) {
-        cp_file.write((char*)&pTemp, sizeof(double));
-        cp_file.write((char*)&pEFDT, sizeof(double));
-        pEField->checkpoint(cp_file);
+    if (_maxErrorCode(opened ? 0 : 1) != 0) {
+        std::ostringstream os;
+        os << "Unable to open checkpoint file " << file_name;
+        os << (opened ? " on another process." : " or " + rank_file_name + ".");
+        IOErrLog(os.str());
     }
 
-    cp_file.write((char*)&nEntries, sizeof(uint));
+    if (myRank == 0) {
+        cp_file.write((char*)&nHosts, sizeof(int));
+        cp_file.write((char*)&nEntries, sizeof(uint));
+
+        // the partition, which restore moves the elements back to; rank 0
+        // does not know the partition of a distributed mesh, which cannot
+        // be moved anyway
+        uint n_tet_hosts = pDistMesh ? 0 : tetHosts.size();
+        cp_file.write((char*)&n_tet_hosts, sizeof(uint));
+        cp_file.write((char*)tetHosts.data(), sizeof(uint) * n_tet_hosts);
+        uint n_tri_hosts = pDistMesh ? 0 : triHosts.size();
+        cp_file.write((char*)&n_tri_hosts, sizeof(uint));
+        for (auto const & tri_host : triHosts) {
+            if (pDistMesh) break;
+            cp_file.write((char*)&tri_host.first, sizeof(uint));
+            cp_file.write((char*)&tri_host.second, sizeof(uint));
+        }
+        uint n_wm_hosts = wmHosts.size();
+        cp_file.write((char*)&n_wm_hosts, sizeof(uint));
+        cp_file.write((char*)wmHosts.data(), sizeof(uint) * n_wm_hosts);
+
+        statedef()->checkpoint(cp_file);
+
+        for (auto c : pComps) c->checkpoint(cp_file);
+        for (auto p : pPatches) p->checkpoint(cp_file);
+        for (auto db : pDiffBoundaries) db->checkpoint(cp_file);
+        for (auto sdb : pSDiffBoundaries) sdb->checkpoint(cp_file);
+
+        if (efflag()) {
+            cp_file.write((char*)&pTemp, sizeof(double));
+            cp_file.write((char*)&pEFDT, sizeof(double));
+            pEField->checkpoint(cp_file);
+        }
+
+        _writeCheckpointSize(cp_file);
+        cp_file.close();
+    }
+
+    rank_cp_file.write((char*)&nHosts, sizeof(int));
+    rank_cp_file.write((char*)&myRank, sizeof(int));
+    rank_cp_file.write((char*)&nEntries, sizeof(uint));
+    uint rng_size = rng()->getBufferSize();
+    rank_cp_file.write((char*)&rng_size, sizeof(uint));
+
+    // Owned element indices, used by restore to validate the partition.
+    std::vector<uint> owned_wmvols;
+    std::vector<uint> owned_tets;
+    std::vector<uint> owned_tris;
+    _ownedElements(tetHosts, triHosts, wmHosts, owned_wmvols, owned_tets, owned_tris);
+    std::vector<uint> mesh_tets;
+    std::vector<uint> mesh_tris;
+    _meshIndices(owned_tets, owned_tris, mesh_tets, mesh_tris);
+
+    uint n_wmvols = owned_wmvols.size();
+    uint n_tets = owned_tets.size();
+    uint n_tris = owned_tris.size();
+    rank_cp_file.write((char*)&n_wmvols, sizeof(uint));
+    rank_cp_file.write((char*)&n_tets, sizeof(uint));
+    rank_cp_file.write((char*)&n_tris, sizeof(uint));
+    rank_cp_file.write((char*)owned_wmvols.data(), sizeof(uint) * n_wmvols);
+    rank_cp_file.write((char*)mesh_tets.data(), sizeof(uint) * n_tets);
+    rank_cp_file.write((char*)mesh_tris.data(), sizeof(uint) * n_tris);
+
+    for (uint idx : owned_wmvols) pWmVols[idx]->checkpoint(rank_cp_file);
+    for (uint idx : owned_tets) _tet(idx)->checkpoint(rank_cp_file);
+    for (uint idx : owned_tris) _tri(idx)->checkpoint(rank_cp_file);
+
+    // Remote kprocs are stored as null pointers.
+    for (auto kp : pKProcs) {
+        if (kp != nullptr) kp->checkpoint(rank_cp_file);
+    }
+
+    rank_cp_file.write((char*)&diffExtent, sizeof(double));
+    rank_cp_file.write((char*)&reacExtent, sizeof(double));
+    rank_cp_file.write((char*)&nIteration, sizeof(double));
 
     // checkpoint CR SSA
 
-    cp_file.write((char*)&pSum, sizeof(double));
-    cp_file.write((char*)&nSum, sizeof(double));
-    cp_file.write((char*)&pA0, sizeof(double));
-
-    uint n_ngroups = nGroups.size();
-    uint n_pgroups = pGroups.size();
-
-    cp_file.write((char*)&n_ngroups, sizeof(uint));
-    cp_file.write((char*)&n_pgroups, sizeof(uint));
+    pCRSched.checkpoint(rank_cp_file, [](KProc * kp) { return kp->schedIDX(); });
 
-    for (uint i = 0; i < n_ngroups; i++) {
-        CRGroup* group = nGroups[i];
-        cp_file.write((char*)&(group->capacity), sizeof(unsigned));
-        cp_file.write((char*)&(group->size), sizeof(unsigned));
-        cp_file.write((char*)&(group->max), sizeof(double));
-        cp_file.write((char*)&(group->sum), sizeof(double));
+    rng()->checkpoint(rank_cp_file);
 
-        for (uint j = 0; j < group->size; j++) {
-            uint idx = group->indices[j]->schedIDX();
-            cp_file.write((char*)&idx, sizeof(uint));
-        }
-    }
+    _writeCheckpointSize(rank_cp_file);
+    rank_cp_file.close();
 
-    for (uint i = 0; i < n_pgroups; i++) {
-        CRGroup* group = pGroups[i];
-        cp_file.write((char*)&(group->capacity), sizeof(unsigned));
-        cp_file.write((char*)&(group->size), sizeof(unsigned));
-        cp_file.write((char*)&(group->max), sizeof(double));
-        cp_file.write((char*)&(group->sum), sizeof(double));
-
-        for (uint j = 0; j < group->size; j++) {
-            uint idx = group->indices[j]->schedIDX();
-            cp_file.write((char*)&idx, sizeof(uint));
-        }
+    // close() fails if the buffered data could not be flushed
+    bool written = !rank_cp_file.fail() && (myRank != 0 || !cp_file.fail());
+    if (_maxErrorCode(written ? 0 : 1) != 0) {
+        std::ostringstream os;
+        os << "Unable to write checkpoint file " << file_name;
+        os << (written ? " on another process." : " or " + rank_file_name + ".");
+        IOErrLog(os.str());
     }
-
-    cp_file.close();
-    //CLOG(INFO, "general_log") << "complete.\n";
-
-    */
 }
 
-///////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
 void smtos::TetOpSplitP::restore(std::string const & file_name)
 {
-    std::ostringstream os;
-    os << "This function has not been implemented!";
-    NotImplErrLog(os.str());
-    
-    /*
-    CLOG(INFO, "general_log") << "Restore from " << file_name << "...";
+    if (myRank == 0) {
+        CLOG(INFO, "general_log") << "Restore from " << file_name << "...";
+    }
+
+    std::string rank_file_name = _rankCheckpointFile(file_name);
     std::fstream cp_file;
+    std::fstream rank_cp_file;
 
     cp_file.open(file_name.c_str(),
                 std::fstream::in | std::fstream::binary);
+    rank_cp_file.open(rank_file_name.c_str(),
+                std::fstream::in | std::fstream::binary);
 
-    cp_file.seekg(0);
-
-    statedef()->restore(cp_file);
+    // Validate both files and the partition on every rank before touching
+    // any state, so that all ranks either restore or fail together: 2 for
+    // a missing or truncated file, 1 for a checkpoint of another setup.
+    int error = 0;
+    std::ostringstream reason;
 
-    CompPVecCI comp_e = pComps.end();
-    for (CompPVecCI c = pComps.begin(); c != comp_e; ++c) (*c)->restore(cp_file);
+    int stored_hosts = -1;
+    int rank_stored_hosts = -1;
+    int stored_rank = -1;
+    uint stored_entries = 0;
+    uint rank_stored_entries = 0;
+    uint stored_rng_size = 0;
+
+    std::vector<uint> stored_tet_hosts;
+    std::map<uint, uint> stored_tri_hosts;
+    std::vector<uint> stored_wm_hosts;
+
+    std::vector<uint> owned_wmvols;
+    std::vector<uint> owned_tets;
+    std::vector<uint> owned_tris;
+
+    if (!cp_file.good() || !rank_cp_file.good()) {
+        error = 2;
+        reason << "cannot open " << file_name << " or " << rank_file_name;
+    }
+    else if (!_checkCheckpointSize(cp_file)) {
+        error = 2;
+        reason << file_name << " is truncated";
+    }
+    else if (!_checkCheckpointSize(rank_cp_file)) {
+        error = 2;
+        reason << rank_file_name << " is truncated";
+    }
+
+    if (error == 0) {
+        cp_file.read((char*)&stored_hosts, sizeof(int));
+        cp_file.read((char*)&stored_entries, sizeof(uint));
+        rank_cp_file.read((char*)&rank_stored_hosts, sizeof(int));
+        rank_cp_file.read((char*)&stored_rank, sizeof(int));
+        rank_cp_file.read((char*)&rank_stored_entries, sizeof(uint));
+        rank_cp_file.read((char*)&stored_rng_size, sizeof(uint));
+        if (stored_hosts != nHosts || rank_stored_hosts != nHosts || stored_rank != myRank) {
+            error = 1;
+            reason << "it was written with " << stored_hosts << " processes, ";
+            reason << "the current run uses " << nHosts;
+        }
+        // each rank of a distributed mesh has the kprocs of its own part
+        else if ((stored_entries != nEntries && (!pDistMesh || myRank == 0))
+            || rank_stored_entries != nEntries) {
+            error = 1;
+            reason << "it does not match the current model";
+        }
+        else if (stored_rng_size != rng()->getBufferSize()) {
+            error = 1;
+            reason << "it was written with a random number buffer of " << stored_rng_size;
+            reason << ", the current one holds " << rng()->getBufferSize();
+        }
+    }
+
+    if (error == 0) {
+        // a distributed mesh keeps its partition, which is checked below
+        uint n_tet_hosts = 0;
+        cp_file.read((char*)&n_tet_hosts, sizeof(uint));
+        if (pDistMesh) {
+            if (n_tet_hosts == 0) stored_tet_hosts = tetHosts;
+        }
+        else if (n_tet_hosts == tetHosts.size()) {
+            stored_tet_hosts.resize(n_tet_hosts);
+            cp_file.read((char*)stored_tet_hosts.data(), sizeof(uint) * n_tet_hosts);
+        }
+        uint n_tri_hosts = 0;
+        cp_file.read((char*)&n_tri_hosts, sizeof(uint));
+        if (pDistMesh) {
+            if (n_tri_hosts == 0) stored_tri_hosts = triHosts;
+        }
+        else if (n_tri_hosts == triHosts.size()) {
+            for (uint i = 0; i < n_tri_hosts; i++) {
+                uint tri = 0;
+                uint host = 0;
+                cp_file.read((char*)&tri, sizeof(uint));
+                cp_file.read((char*)&host, sizeof(uint));
+                stored_tri_hosts[tri] = host;
+            }
+        }
+        uint n_wm_hosts = 0;
+        cp_file.read((char*)&n_wm_hosts, sizeof(uint));
+        if (n_wm_hosts == wmHosts.size()) {
+            stored_wm_hosts.resize(n_wm_hosts);
+            cp_file.read((char*)stored_wm_hosts.data(), sizeof(uint) * n_wm_hosts);
+        }
 
-    PatchPVecCI patch_e = pPatches.end();
-    for (PatchPVecCI p = pPatches.begin(); p != patch_e; ++p) (*p)->restore(cp_file);
+        bool same = cp_file.good() && stored_tet_hosts.size() == tetHosts.size()
+            && stored_tri_hosts.size() == triHosts.size() && stored_wm_hosts.size() == wmHosts.size();
+        for (auto const & tri_host : stored_tri_hosts) {
+            same = same && triHosts.count(tri_host.first) && tri_host.second < static_cast<uint>(nHosts);
+        }
+        // hosts of elements outside the compartments are never used
+        for (auto tet : pTets) {
+            same = same && (tet == nullptr || stored_tet_hosts[tet->idx()] < static_cast<uint>(nHosts));
+        }
+        uint nwmvols = pWmVols.size();
+        for (uint i = 0; i < nwmvols; i++) {
+            same = same && (pWmVols[i] == nullptr || stored_wm_hosts[i] < static_cast<uint>(nHosts));
+        }
 
-    DiffBoundaryPVecCI db_e = pDiffBoundaries.end();
-    for (DiffBoundaryPVecCI db = pDiffBoundaries.begin(); db != db_e; ++db) {
-        (*db)->restore(cp_file);
+        if (!same) {
+            error = 1;
+            reason << "it does not match the current mesh";
+        }
+        else {
+            _ownedElements(stored_tet_hosts, stored_tri_hosts, stored_wm_hosts,
+                owned_wmvols, owned_tets, owned_tris);
+        }
     }
 
-    SDiffBoundaryPVecCI sdb_e = pSDiffBoundaries.end();
-    for (SDiffBoundaryPVecCI sdb = pSDiffBoundaries.begin(); sdb != sdb_e; ++sdb) {
-        (*sdb)->restore(cp_file);
-    }
+    if (error == 0) {
+        uint n_wmvols = 0;
+        uint n_tets = 0;
+        uint n_tris = 0;
+        rank_cp_file.read((char*)&n_wmvols, sizeof(uint));
+        rank_cp_file.read((char*)&n_tets, sizeof(uint));
+        rank_cp_file.read((char*)&n_tris, sizeof(uint));
 
-    WmVolPVecCI wmv_e = pWmVols.end();
-    for (WmVolPVecCI wmv = pWmVols.begin(); wmv != wmv_e; ++wmv)
-    {
-        if ((*wmv) != 0) {
-            (*wmv)->restore(cp_file);
-        }
-    }
+        bool same = (n_wmvols == owned_wmvols.size() && n_tets == owned_tets.size()
+            && n_tris == owned_tris.size());
 
-    TetPVecCI tet_e = pTets.end();
-    for (TetPVecCI t = pTets.begin(); t != tet_e; ++t)
-    {
-        if ((*t) != 0) {
-            (*t)->restore(cp_file);
+        if (same) {
+            std::vector<uint> stored_wmvols(n_wmvols);
+            std::vector<uint> stored_tets(n_tets);
+            std::vector<uint> stored_tris(n_tris);
+            rank_cp_file.read((char*)stored_wmvols.data(), sizeof(uint) * n_wmvols);
+            rank_cp_file.read((char*)stored_tets.data(), sizeof(uint) * n_tets);
+            rank_cp_file.read((char*)stored_tris.data(), sizeof(uint) * n_tris);
+
+            std::vector<uint> mesh_tets;
+            std::vector<uint> mesh_tris;
+            _meshIndices(owned_tets, owned_tris, mesh_tets, mesh_tris);
+            same = stored_wmvols == owned_wmvols && stored_tets == mesh_tets
+                && stored_tris == mesh_tris;
         }
-    }
-    TriPVecCI tri_e = pTris.end();
-    for (TriPVecCI t = pTris.begin(); t != tri_e; ++t)
-    {
-        if ((*t) != 0) {
-            (*t)->restore(cp_file);
+        if (!same) {
+            error = 1;
+            reason << "it does not match the stored mesh partition";
         }
     }
 
-    KProcPVecCI e = pKProcs.end();
-    for (KProcPVecCI i = pKProcs.begin(); i != e; ++i) (*i)->restore(cp_file);
+    int all_error = _maxErrorCode(error);
+    if (all_error != 0) {
+        std::ostringstream os;
+        os << "Unable to restore checkpoint " << file_name << ": ";
+        if (error != 0) os << reason.str() << ".";
+        else os << "it is invalid on another process.";
+        if (all_error == 2) IOErrLog(os.str());
+        else ArgErrLog(os.str());
+    }
+
+    // every rank read the same manifest, so all of them take this together
+    if (stored_tet_hosts != tetHosts || stored_tri_hosts != triHosts || stored_wm_hosts != wmHosts) {
+        _repartition(stored_tet_hosts, stored_tri_hosts, stored_wm_hosts);
+    }
 
+    statedef()->restore(cp_file);
 
+    for (auto c : pComps) c->restore(cp_file);
+    for (auto p : pPatches) p->restore(cp_file);
+    for (auto db : pDiffBoundaries) db->restore(cp_file);
+    for (auto sdb : pSDiffBoundaries) sdb->restore(cp_file);
 
     if (efflag()) {
         cp_file.read((char*)&pTemp, sizeof(double));
         cp_file.read((char*)&pEFDT, sizeof(double));
         pEField->restore(cp_file);
+        pEFTrisVStale = true;
     }
 
-    uint stored_entries = 0;
-    cp_file.read((char*)&stored_entries, sizeof(uint));
+    bool read = cp_file.good();
+    cp_file.close();
 
-    if (stored_entries != nEntries) {
-        std::ostringstream os;
-        os << "Unknown Restore Error!";
-        ArgErrLog(os.str());
+    for (uint idx : owned_wmvols) pWmVols[idx]->restore(rank_cp_file);
+    for (uint idx : owned_tets) _tet(idx)->restore(rank_cp_file);
+    for (uint idx : owned_tris) _tri(idx)->restore(rank_cp_file);
+
+    for (auto kp : pKProcs) {
+        if (kp != nullptr) kp->restore(rank_cp_file);
     }
 
+    rank_cp_file.read((char*)&diffExtent, sizeof(double));
+    rank_cp_file.read((char*)&reacExtent, sizeof(double));
+    rank_cp_file.read((char*)&nIteration, sizeof(double));
+
+    // diffusion rates were restored with the kprocs
+    _rebuildActiveDiffs();
+
     // restore CR SSA
-    cp_file.read((char*)&pSum, sizeof(double));
-    cp_file.read((char*)&nSum, sizeof(double));
-    cp_file.read((char*)&pA0, sizeof(double));
+    pCRSched.restore(rank_cp_file, [this](uint idx) {
+        AssertLog(idx < pKProcs.size() && pKProcs[idx] != nullptr);
+        return pKProcs[idx];
+    });
+    _updateSum();
+
+    rng()->restore(rank_cp_file);
 
-    uint n_ngroups;
-    uint n_pgroups;
+    read = read && rank_cp_file.good();
+    rank_cp_file.close();
+
+    // the sizes were checked, so this only fails on a read error
+    if (_maxErrorCode(read ? 0 : 2) != 0) {
+        std::ostringstream os;
+        os << "Unable to read checkpoint " << file_name;
+        os << (read ? " on another process." : " or " + rank_file_name + ".");
+        IOErrLog(os.str());
+    }
 
-    cp_file.read((char*)&n_ngroups, sizeof(uint));
-    cp_file.read((char*)&n_pgroups, sizeof(uint));
+    // Diffusion constants may have been restored to different values.
+    recomputeUpdPeriod = true;
+}
 
-    nGroups.resize(n_ngroups);
-    pGroups.resize(n_pgroups);
+////////////////////////////////////////////////////////////////////////////////
 
-    for (uint i = 0; i < n_ngroups; i++) {
-        unsigned capacity;
-        unsigned size;
-        double max;
-        double sum;
+void smtos::TetOpSplitP::_writeCheckpointSize(std::fstream & cp_file)
+{
+    uint64_t size = static_cast<uint64_t>(cp_file.tellp());
+    cp_file.write((char*)&size, sizeof(uint64_t));
+}
 
-        cp_file.read((char*)&capacity, sizeof(unsigned));
-        cp_file.read((char*)&size, sizeof(unsigned));
-        cp_file.read((char*)&max, sizeof(double));
-        cp_file.read((char*)&sum, sizeof(double));
+////////////////////////////////////////////////////////////////////////////////
 
-        nGroups[i] = new CRGroup(0, capacity);
-        nGroups[i]->size = size;
-        nGroups[i]->max = max;
-        nGroups[i]->sum = sum;
+bool smtos::TetOpSplitP::_checkCheckpointSize(std::fstream & cp_file)
+{
+    cp_file.seekg(0, std::fstream::end);
+    std::streamoff end = cp_file.tellg();
+    if (!cp_file.good() || end < static_cast<std::streamoff>(sizeof(uint64_t))) return false;
 
-        for (uint j = 0; j < size; j++) {
-            uint idx;
-            cp_file.read((char*)&idx, sizeof(uint));
-            nGroups[i]->indices[j] = pKProcs[idx];
-        }
-    }
+    uint64_t size = 0;
+    cp_file.seekg(end - static_cast<std::streamoff>(sizeof(uint64_t)));
+    cp_file.read((char*)&size, sizeof(uint64_t));
+    bool complete = cp_file.good() && size + sizeof(uint64_t) == static_cast<uint64_t>(end);
 
-    for (uint i = 0; i < n_pgroups; i++) {
-        unsigned capacity;
-        unsigned size;
-        double max;
-        double sum;
+    cp_file.seekg(0);
+    return complete && cp_file.good();
+}
 
-        cp_file.read((char*)&capacity, sizeof(unsigned));
-        cp_file.read((char*)&size, sizeof(unsigned));
-        cp_file.read((char*)&max, sizeof(double));
-        cp_file.read((char*)&sum, sizeof(double));
+////////////////////////////////////////////////////////////////////////////////
 
-        pGroups[i] = new CRGroup(0, capacity);
-        pGroups[i]->size = size;
-        pGroups[i]->max = max;
-        pGroups[i]->sum = sum;
+int smtos::TetOpSplitP::_maxErrorCode(int code) const
+{
+    int max_code = 0;
+    MPI_Allreduce(&code, &max_code, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    return max_code;
+}
 
-        for (uint j = 0; j < size; j++) {
-            uint idx;
-            cp_file.read((char*)&idx, sizeof(uint));
-            pGroups[i]->indices[j] = pKProcs[idx];
-        }
+////////////////////////////////////////////////////////////////////////////////
+
+std::string smtos::TetOpSplitP::_rankCheckpointFile(std::string const & file_name) const
+{
+    std::ostringstream os;
+    os << file_name << ".rank" << myRank;
+    return os.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_ownedElements(std::vector<uint> const & tet_hosts,
+    std::map<uint, uint> const & tri_hosts, std::vector<uint> const & wm_hosts,
+    std::vector<uint> & wmvols, std::vector<uint> & tets, std::vector<uint> & tris) const
+{
+    wmvols.clear();
+    tets.clear();
+    tris.clear();
+
+    uint nwmvols = pWmVols.size();
+    for (uint i = 0; i < nwmvols; i++) {
+        if (pWmVols[i] != nullptr && wm_hosts[i] == static_cast<uint>(myRank)) wmvols.push_back(i);
     }
 
-    cp_file.close();
+    for (auto tet : pTets) {
+        if (tet != nullptr && tet_hosts[tet->idx()] == static_cast<uint>(myRank)) tets.push_back(tet->idx());
+    }
 
-    //CLOG(INFO, "general_log") << "complete.\n";
+    for (auto tri : pTris) {
+        if (tri == nullptr) continue;
+        auto host = tri_hosts.find(tri->idx());
+        if (host != tri_hosts.end() && host->second == static_cast<uint>(myRank)) tris.push_back(tri->idx());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-    */
+void smtos::TetOpSplitP::_meshIndices(std::vector<uint> const & tets,
+    std::vector<uint> const & tris, std::vector<uint> & mesh_tets, std::vector<uint> & mesh_tris) const
+{
+    mesh_tets.clear();
+    mesh_tris.clear();
+    for (uint idx : tets) mesh_tets.push_back(_tetGIdx(idx));
+    for (uint idx : tris) mesh_tris.push_back(_triGIdx(idx));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -506,15 +710,17 @@ void smtos::TetOpSplitP::_setup()
         ArgErrLog("Geometry description to steps::solver::Tetexact solver "
                 "constructor is not a valid steps::tetmesh::Tetmesh object.");
 
+    if (tetHosts.empty()) _defaultHosts();
+
     // First initialise the pTets, pTris vector, because
     // want tets and tris to maintain indexing from Geometry
     uint ntets = mesh()->countTets();
     uint ntris = mesh()->countTris();
     uint ncomps = mesh()->_countComps();
 
+    pWmVols.assign(ncomps, NULL);
     pTets.assign(ntets, NULL);
     pTris.assign(ntris, NULL);
-    pWmVols.assign(ncomps, NULL);
     diffSep = 0;
     sdiffSep = 0;
     // Now create the actual compartments.
@@ -556,6 +762,13 @@ void smtos::TetOpSplitP::_setup()
     AssertLog(mesh()->_countPatches() == npatches);
     int rk; MPI_Comm_rank(MPI_COMM_WORLD, &rk);
 
+    // Create a map between edges and adjacent tris in all patches.
+    // We need to go through all patches to record bar2tri mapping
+    // for all connected triangle neighbors even they are in different
+    // patches, because their information is needed for surface diffusion boundary
+    std::map<uint, std::vector<uint> > bar2tri;
+    _patchBarTris(bar2tri);
+
     for (uint p = 0; p < npatches; ++p)
     {
         // Add the tris for this patch
@@ -582,25 +795,6 @@ void smtos::TetOpSplitP::_setup()
         for (uint tri: tmpatch->_getAllTriIndices()) 
         ***/
 
-        // Create a map between edges and adjacent tris in this patch
-        std::map<uint, std::vector<uint> > bar2tri;
-
-        // We need to go through all patches to record bar2tri mapping
-        // for all connected triangle neighbors even they are in different
-        // patches, because their information is needed for surface diffusion boundary
-
-        for (uint bar_p = 0; bar_p < npatches; ++bar_p) {
-
-            steps::tetmesh::TmPatch *bar_patch = dynamic_cast<steps::tetmesh::TmPatch*>(pMesh->_getPatch(bar_p));
-
-            for (uint tri: bar_patch->_getAllTriIndices())
-            {
-                const uint *bars = pMesh->_getTriBars(tri);
-                for (int i = 0; i < 3; ++i)
-                    bar2tri[bars[i]].push_back(tri);
-            }
-        }
-
         auto tri_idxs = tmpatch->_getAllTriIndices();
 
 #pragma omp parallel for
@@ -716,9 +910,11 @@ void smtos::TetOpSplitP::_setup()
 
                 for (uint tri: comp_opatch->_getAllTriIndices())
                 {
-                    pTris[tri]->setInnerTet(pWmVols[c]);
+                    smtos::Tri * localtri = _tri(tri);
+                    if (localtri == nullptr) continue;
+                    localtri->setInnerTet(pWmVols[c]);
                     // Add triangle to WmVols' table of neighbouring triangles.
-                    pWmVols[c]->setNextTri(pTris[tri]);
+                    pWmVols[c]->setNextTri(localtri);
                 }
             }
 
@@ -735,9 +931,11 @@ void smtos::TetOpSplitP::_setup()
 
                 for (uint tri: comp_ipatch->_getAllTriIndices())
                 {
-                    pTris[tri]->setOuterTet(pWmVols[c]);
+                    smtos::Tri * localtri = _tri(tri);
+                    if (localtri == nullptr) continue;
+                    localtri->setOuterTet(pWmVols[c]);
                     // Add triangle to WmVols' table of neighbouring triangles.
-                    pWmVols[c]->setNextTri(pTris[tri]);
+                    pWmVols[c]->setNextTri(localtri);
                 }
             }
         }
@@ -752,27 +950,31 @@ void smtos::TetOpSplitP::_setup()
     AssertLog(ntets == pTets.size());
     // pTets member size of all tets in geometry, but may not be filled with
     // local tets if they have not been added to a compartment
-    for (uint t = 0; t < ntets; ++t)
+    for (auto localtet : pTets)
     {
-        if (pTets[t] == 0) continue;
+        if (localtet == 0) continue;
 
         for (uint j = 0; j < 4; ++j) {
-            int tet = pTets[t]->tet(j);
-            if (tet >= 0 && pTets[tet] != 0) pTets[t]->setNextTet(j, pTets[tet]);
+            int tet = localtet->tet(j);
+            if (tet < 0) continue;
+            smtos::Tet * next = _tet(tet);
+            if (next != 0) localtet->setNextTet(j, next);
         }
         // Not setting Tet triangles at this point- only want to set
         // for surface triangles
     }
     AssertLog(ntris == pTris.size());
 
-    for (uint t = 0; t < ntris; ++t)
+    for (auto localtri : pTris)
     {
         // Looping over all possible tris, but only some have been added to a patch
-        if (pTris[t] == 0) continue;
+        if (localtri == 0) continue;
 
         for (uint j = 0; j < 3; ++j) {
-            int tri = pTris[t]->tri(j);
-            if (tri >= 0 && pTris[tri] != 0) pTris[t]->setNextTri(j, pTris[tri]);
+            int tri = localtri->tri(j);
+            if (tri < 0) continue;
+            smtos::Tri * next = _tri(tri);
+            if (next != 0) localtri->setNextTri(j, next);
         }
 
         // By convention, triangles in a patch should have an inner tetrahedron defined
@@ -780,8 +982,8 @@ void smtos::TetOpSplitP::_setup()
         // but not necessarily an outer tet
         // 17/3/10- actually this is not the case any more with well-mixed compartments
         //
-        int tetinner = pTris[t]->tet(0);
-        int tetouter = pTris[t]->tet(1);
+        int tetinner = localtri->tet(0);
+        int tetouter = localtri->tet(1);
 
 
         // Now inside and outside tetrahedrons may be normal tetrahedrons, which
@@ -795,13 +997,14 @@ void smtos::TetOpSplitP::_setup()
             // surface) but tets may not belong to a compartment, even inner tets now
             // since they may be well-mixed compartments
             //
-            if (pTets[tetinner] != 0)
+            smtos::Tet * tet_in = _tet(tetinner);
+            if (tet_in != 0)
             {
                 // A triangle may already have an inner tet defined as a well-mixed
                 // volume, but that should not be the case here:
-                AssertLog(pTris[t]->iTet() == 0);
+                AssertLog(localtri->iTet() == 0);
 
-                pTris[t]->setInnerTet(pTets[tetinner]);
+                localtri->setInnerTet(tet_in);
                 // Now add this triangle to inner tet's list of neighbours
                 for (uint i=0; i <= 4; ++i)
                 {
@@ -823,11 +1026,10 @@ void smtos::TetOpSplitP::_setup()
 
                     // Now with diffusion boundaries, meaning tets can have neighbours that
                     // are in different comps, we must check the compartment
-                    steps::mpi::tetopsplit::Tet * tet_in = pTets[tetinner];
                     if (tet_in->nextTet(i) != 0 && tet_in->compdef() == tet_in->nextTet(i)->compdef()) continue;
 
                     if (tet_in->nextTri(i) != 0) continue;
-                    tet_in->setNextTri(i, pTris[t]);
+                    tet_in->setNextTri(i, localtri);
                     break;
                 }
             }
@@ -837,25 +1039,24 @@ void smtos::TetOpSplitP::_setup()
         // Now correct check, previously didn't allow for tet index == 0
         if (tetouter >= 0)
         {
-            if (pTets[tetouter] != 0)
+            smtos::Tet * tet_out = _tet(tetouter);
+            if (tet_out != 0)
             {
                 // A triangle may already have an inner tet defined as a well-mixed
                 // volume, but that should not be the case here:
-                AssertLog(pTris[t]->oTet() == 0);
+                AssertLog(localtri->oTet() == 0);
 
-                pTris[t]->setOuterTet(pTets[tetouter]);
+                localtri->setOuterTet(tet_out);
                 // Add this triangle to outer tet's list of neighbours
                 for (uint i=0; i <= 4; ++i)
                 {
                     AssertLog(i < 4);
 
                     // See above in that tets now store tets from different comps
-                    steps::mpi::tetopsplit::Tet * tet_out = pTets[tetouter];
-
                     if (tet_out->nextTet(i) != 0 && tet_out->compdef() == tet_out->nextTet(i)->compdef()) continue;
 
                     if (tet_out->nextTri(i) != 0) continue;
-                    tet_out->setNextTri(i, pTris[t]);
+                    tet_out->setNextTri(i, localtri);
                     break;
                 }
             }
@@ -1044,6 +1245,9 @@ void smtos::TetOpSplitP::_setup()
             _tri(tris[t])->setSDiffBndDirection(tris_direction[t]);
     }
 
+    // no rank holds all of a compartment or patch of a distributed mesh
+    if (pDistMesh) _sumDistMeshSizes();
+
     for (auto t: pTets)
         if (t) t->setupKProcs(this);
 
@@ -1092,6 +1296,10 @@ void smtos::TetOpSplitP::_setup()
     nEntries = pKProcs.size();
     diffSep=pDiffs.size();
     sdiffSep=pSDiffs.size();
+    _partitionDiffs();
+    _setupNeighbComm();
+    _setupSSAGroups();
+    pKProcWork.assign(nEntries, 0.0);
     _updateLocal();
     
 }
@@ -1113,9 +1321,19 @@ void smtos::TetOpSplitP::_setupEField()
     case EF_DV_BDSYS:
         pEField = make_EField<dVSolverBanded>();
         break;
+    case EF_DV_CG:
+        pEField = make_EField<dVSolverCG>();
+        break;
     case EF_DV_SLUSYS:
         pEField = make_EField<dVSolverSLU>(MPI_COMM_WORLD);
         break;
+    case EF_DV_DIST:
+    {
+        std::unique_ptr<dVSolverDist> impl(new dVSolverDist(MPI_COMM_WORLD));
+        pEFDistSolver = impl.get();
+        pEField.reset(new EField(std::move(impl)));
+        break;
+    }
 #ifdef USE_PETSC 
     case EF_DV_PETSC:
         pEField = make_EField<dVSolverPETSC>();
@@ -1162,6 +1380,7 @@ void smtos::TetOpSplitP::_setupEField()
     pEFVert_GtoL = new int[nverts];
     for (uint i=0; i < nverts; ++i) { pEFVert_GtoL[i] = -1;
 }
+
     pEFTri_GtoL = new int[ntris];
     for (uint i=0; i< ntris; ++i) { pEFTri_GtoL[i] = -1;
 }
@@ -1227,10 +1446,6 @@ void smtos::TetOpSplitP::_setupEField()
     EFTrisI_permuted.resize(pEFNTris);
     EFTrisI_idx.resize(pEFNTris);
 
-    EFTrisI_offset.assign(nHosts,0);
-    EFTrisI_count.assign(nHosts,0);
-
-    std::vector<int> local_eftri_indices;
     for (uint eft = 0; eft < pEFNTris; ++eft)
     {
         uint triidx = membtris[eft];
@@ -1259,8 +1474,24 @@ void smtos::TetOpSplitP::_setupEField()
         // Extremely important for larger meshes, orders of magnitude times faster
         smtos::Tri *tri_p = pTris[triidx];
         pEFTris_vec[eft] = tri_p;
+    }
+
+    _setupEFTriHosts();
+    
+    pEField->initMesh(pEFNVerts, &(pEFVerts.front()), pEFNTris, &(pEFTris.front()), pEFNTets, &(pEFTets.front()), memb->_getOpt_method(), memb->_getOpt_file_name(), memb->_getSearch_percent());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_setupEFTriHosts()
+{
+    EFTrisI_offset.assign(nHosts,0);
+    EFTrisI_count.assign(nHosts,0);
 
-        int tri_host = tri_p->getHost();
+    std::vector<int> local_eftri_indices;
+    for (uint eft = 0; eft < pEFNTris; ++eft)
+    {
+        int tri_host = pEFTris_vec[eft]->getHost();
         ++EFTrisI_count[tri_host];
         if (myRank == tri_host) local_eftri_indices.push_back(eft);
     }
@@ -1272,8 +1503,43 @@ void smtos::TetOpSplitP::_setupEField()
 
     MPI_Allgatherv(&local_eftri_indices[0], (int)local_eftri_indices.size(), MPI_INT,
             &EFTrisI_idx[0], &EFTrisI_count[0], &EFTrisI_offset[0], MPI_INT, MPI_COMM_WORLD);
-    
-    pEField->initMesh(pEFNVerts, &(pEFVerts.front()), pEFNTris, &(pEFTris.front()), pEFNTets, &(pEFTets.front()), memb->_getOpt_method(), memb->_getOpt_file_name(), memb->_getSearch_percent());
+
+    if (pEFDistSolver != nullptr) _setupEFDistPartition();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_setupEFDistPartition()
+{
+    std::vector<int> vert_hosts(pEFNVerts, -1);
+    std::vector<int> tri_hosts(pEFNTris);
+
+    uint ntets = mesh()->countTets();
+    for (uint t = 0; t < ntets; ++t)
+    {
+        if (pEFTet_GtoL[t] == -1) continue;
+        const uint * verts = mesh()->_getTet(t);
+        for (uint j = 0; j < 4; ++j)
+        {
+            int efv = pEFVert_GtoL[verts[j]];
+            if (vert_hosts[efv] == -1) vert_hosts[efv] = tetHosts[t];
+        }
+    }
+
+    for (uint eft = 0; eft < pEFNTris; ++eft)
+    {
+        tri_hosts[eft] = pEFTris_vec[eft]->getHost();
+        // membrane vertices outside the conduction volume follow a triangle
+        const uint * verts = mesh()->_getTri(pEFTri_LtoG[eft]);
+        for (uint j = 0; j < 3; ++j)
+        {
+            int efv = pEFVert_GtoL[verts[j]];
+            if (vert_hosts[efv] == -1) vert_hosts[efv] = tri_hosts[eft];
+        }
+    }
+    for (auto & h : vert_hosts) if (h == -1) h = 0;
+
+    pEFDistSolver->setPartition(vert_hosts, tri_hosts);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1401,62 +1667,325 @@ void smtos::TetOpSplitP::_addTri(uint triidx, steps::mpi::tetopsplit::Patch * pa
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::reset()
+void smtos::TetOpSplitP::_patchBarTris(std::map<uint, std::vector<uint> > & bar2tri) const
 {
-    std::for_each(pComps.begin(), pComps.end(), std::mem_fun(&Comp::reset));
-    std::for_each(pPatches.begin(), pPatches.end(), std::mem_fun(&Patch::reset));
-
-    TetPVecCI tet_end = pTets.end();
-    for (TetPVecCI tet = pTets.begin(); tet != tet_end; ++tet)
+    bar2tri.clear();
+    uint npatches = mesh()->_countPatches();
+    for (uint p = 0; p < npatches; ++p)
     {
-        if (*tet == 0) continue;
-        (*tet)->reset();
-    }
+        steps::tetmesh::TmPatch *tmpatch = dynamic_cast<steps::tetmesh::TmPatch*>(pMesh->_getPatch(p));
+        if (!tmpatch) continue;
 
-    WmVolPVecCI wmvol_end = pWmVols.end();
-    for (WmVolPVecCI wmvol = pWmVols.begin(); wmvol != wmvol_end; ++wmvol)
-    {
-        if ((*wmvol) == 0) continue;
-        (*wmvol)->reset();
+        for (uint tri: tmpatch->_getAllTriIndices())
+        {
+            const uint *bars = pMesh->_getTriBars(tri);
+            for (int i = 0; i < 3; ++i)
+                bar2tri[bars[i]].push_back(tri);
+        }
     }
+}
 
-    TriPVecCI tri_end = pTris.end();
-    for (TriPVecCI t = pTris.begin(); t != tri_end; ++t)
-    {
-        if ((*t) == 0) continue;
-        (*t)->reset();
-    }
+////////////////////////////////////////////////////////////////////////////////
 
-    uint ngroups = nGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(nGroups[i]->indices);
-        delete nGroups[i];
-    }
-    nGroups.clear();
+smtos::Tet * smtos::TetOpSplitP::_globalTet(uint tidx) const
+{
+    if (!pDistMesh) return pTets[tidx];
+    auto local = pTetG2L.find(tidx);
+    return local == pTetG2L.end() ? nullptr : pTets[local->second];
+}
 
-    ngroups = pGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(pGroups[i]->indices);
-        delete pGroups[i];
-    }
-    pGroups.clear();
+////////////////////////////////////////////////////////////////////////////////
 
-    pSum = 0.0;
-    nSum = 0.0;
-    pA0 = 0.0;
-    
-    reacExtent = 0.0;
-    diffExtent = 0.0;
-    nIteration = 0.0;
-    
+smtos::Tri * smtos::TetOpSplitP::_globalTri(uint tidx) const
+{
+    if (!pDistMesh) return pTris[tidx];
+    auto local = pTriG2L.find(tidx);
+    return local == pTriG2L.end() ? nullptr : pTris[local->second];
+}
 
-    
-    statedef()->resetTime();
-    statedef()->resetNSteps();
-	_updateLocal();
-    
-    compTime = 0.0;
-    syncTime = 0.0;
+////////////////////////////////////////////////////////////////////////////////
+
+ssolver::Compdef * smtos::TetOpSplitP::_tetCompdef(uint tidx) const
+{
+    if (pDistMesh) return _tetCompdefs(&tidx, 1)[0];
+    smtos::Tet * tet = pTets[tidx];
+    return tet == nullptr ? nullptr : tet->compdef();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ssolver::Patchdef * smtos::TetOpSplitP::_triPatchdef(uint tidx) const
+{
+    if (pDistMesh) return _triPatchdefs(&tidx, 1)[0];
+    smtos::Tri * tri = pTris[tidx];
+    return tri == nullptr ? nullptr : tri->patchdef();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<ssolver::Compdef *> smtos::TetOpSplitP::_tetCompdefs(uint const * tets, uint ntets) const
+{
+    // the compartment is known to the ranks holding the tet, and found out
+    // of range indices are left to the caller to report
+    std::vector<int> local_cidx(ntets, -1);
+    for (uint t = 0; t < ntets; t++) {
+        if (!pDistMesh && tets[t] >= pTets.size()) continue;
+        smtos::Tet * tet = _globalTet(tets[t]);
+        if (tet != nullptr) local_cidx[t] = tet->compdef()->gidx();
+    }
+    std::vector<int> cidx(ntets, -1);
+    if (pDistMesh) {
+        MPI_Allreduce(local_cidx.data(), cidx.data(), ntets, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    }
+    else {
+        cidx.swap(local_cidx);
+    }
+
+    std::vector<ssolver::Compdef *> cdefs(ntets, nullptr);
+    for (uint t = 0; t < ntets; t++) {
+        if (cidx[t] >= 0) cdefs[t] = statedef()->compdef(cidx[t]);
+    }
+    return cdefs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<ssolver::Patchdef *> smtos::TetOpSplitP::_triPatchdefs(uint const * tris, uint ntris) const
+{
+    std::vector<int> local_pidx(ntris, -1);
+    for (uint t = 0; t < ntris; t++) {
+        if (!pDistMesh && tris[t] >= pTris.size()) continue;
+        smtos::Tri * tri = _globalTri(tris[t]);
+        if (tri != nullptr) local_pidx[t] = tri->patchdef()->gidx();
+    }
+    std::vector<int> pidx(ntris, -1);
+    if (pDistMesh) {
+        MPI_Allreduce(local_pidx.data(), pidx.data(), ntris, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    }
+    else {
+        pidx.swap(local_pidx);
+    }
+
+    std::vector<ssolver::Patchdef *> pdefs(ntris, nullptr);
+    for (uint t = 0; t < ntris; t++) {
+        if (pidx[t] >= 0) pdefs[t] = statedef()->patchdef(pidx[t]);
+    }
+    return pdefs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int smtos::TetOpSplitP::_tetHost(uint tidx) const
+{
+    if (!pDistMesh) return tetHosts[tidx];
+    int local_host = -1;
+    auto local = pTetG2L.find(tidx);
+    if (local != pTetG2L.end()) local_host = tetHosts[local->second];
+    int host = -1;
+    MPI_Allreduce(&local_host, &host, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    return host;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int smtos::TetOpSplitP::_triHost(uint tidx) const
+{
+    uint lidx = tidx;
+    bool held = true;
+    if (pDistMesh) {
+        auto local = pTriG2L.find(tidx);
+        held = (local != pTriG2L.end());
+        if (held) lidx = local->second;
+    }
+    int local_host = -1;
+    if (held) {
+        auto host = triHosts.find(lidx);
+        if (host != triHosts.end()) local_host = host->second;
+    }
+    if (!pDistMesh) return local_host;
+    int host = -1;
+    MPI_Allreduce(&local_host, &host, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    return host;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_setupDistMesh(std::vector<uint> const & tet_gidx, std::vector<uint> const & tri_gidx)
+{
+    auto * local_mesh = dynamic_cast<steps::tetmesh::Tetmesh *>(geom());
+    if (local_mesh == nullptr)
+        ArgErrLog("Geometry description to steps::solver::TetOpSplitP solver "
+                "constructor is not a valid steps::tetmesh::Tetmesh object.");
+    if (pEFoption != EF_NONE)
+        NotImplErrLog("Membrane potential is not supported with a distributed mesh.");
+    if (local_mesh->_countDiffBoundaries() != 0 || local_mesh->_countSDiffBoundaries() != 0)
+        NotImplErrLog("Diffusion boundaries are not supported with a distributed mesh.");
+
+    uint ntets = local_mesh->countTets();
+    uint ntris = local_mesh->countTris();
+
+    pDistMesh = true;
+    pTetGIdx = tet_gidx;
+    pTriGIdx = tri_gidx;
+    pTetG2L.clear();
+    pTriG2L.clear();
+
+    std::ostringstream os;
+    if (tet_gidx.size() != ntets || tetHosts.size() != ntets || tri_gidx.size() != ntris) {
+        os << "A distributed mesh needs a host and a mesh index for each of its ";
+        os << ntets << " tetrahedrons and a mesh index for each of its " << ntris << " triangles.\n";
+    }
+    for (auto const & tri_host : triHosts) {
+        if (os.tellp() == 0 && tri_host.first >= ntris) {
+            os << "Host given for triangle " << tri_host.first << " outside the local mesh.\n";
+        }
+    }
+
+    uint max_tets = 0;
+    uint max_tris = 0;
+    if (os.tellp() == 0) {
+        pTetG2L.reserve(ntets);
+        for (uint t = 0; t < ntets; t++) {
+            if (!pTetG2L.emplace(tet_gidx[t], t).second) {
+                os << "Tetrahedron " << tet_gidx[t] << " appears twice in the local mesh.\n";
+                break;
+            }
+            max_tets = std::max(max_tets, tet_gidx[t] + 1);
+        }
+        pTriG2L.reserve(ntris);
+        for (uint t = 0; t < ntris; t++) {
+            if (!pTriG2L.emplace(tri_gidx[t], t).second) {
+                os << "Triangle " << tri_gidx[t] << " appears twice in the local mesh.\n";
+                break;
+            }
+            max_tris = std::max(max_tris, tri_gidx[t] + 1);
+        }
+    }
+
+    int error = os.tellp() == 0 ? 0 : 1;
+    if (_maxErrorCode(error) != 0) {
+        if (error == 0) os << "Invalid distributed mesh on another process.\n";
+        ArgErrLog(os.str());
+    }
+
+    MPI_Allreduce(&max_tets, &pGlobalTets, 1, MPI_UNSIGNED, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(&max_tris, &pGlobalTris, 1, MPI_UNSIGNED, MPI_MAX, MPI_COMM_WORLD);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_sumDistMeshSizes()
+{
+    uint ncomps = pComps.size();
+    uint npatches = pPatches.size();
+    std::vector<double> local_sizes(ncomps + npatches, 0.0);
+    for (uint c = 0; c < ncomps; c++) {
+        WmVolPVecCI t_end = pComps[c]->endTet();
+        for (WmVolPVecCI t = pComps[c]->bgnTet(); t != t_end; ++t) {
+            if ((*t)->getInHost()) local_sizes[c] += (*t)->vol();
+        }
+    }
+    for (uint p = 0; p < npatches; p++) {
+        TriPVecCI t_end = pPatches[p]->endTri();
+        for (TriPVecCI t = pPatches[p]->bgnTri(); t != t_end; ++t) {
+            if ((*t)->getInHost()) local_sizes[ncomps + p] += (*t)->area();
+        }
+    }
+    std::vector<double> sizes(ncomps + npatches, 0.0);
+    MPI_Allreduce(local_sizes.data(), sizes.data(), ncomps + npatches, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    // well-mixed compartments are whole on every rank
+    for (uint c = 0; c < ncomps; c++) {
+        if (pWmVols[c] == nullptr) pComps[c]->def()->setVol(sizes[c]);
+    }
+    for (uint p = 0; p < npatches; p++) pPatches[p]->def()->setArea(sizes[ncomps + p]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_requireReplicatedMesh(std::string const & method) const
+{
+    if (!pDistMesh) return;
+    std::ostringstream os;
+    os << method << " is not supported with a distributed mesh.\n";
+    NotImplErrLog(os.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename ElemIter, typename Weight>
+void smtos::TetOpSplitP::_distributeHosted(double n, ElemIter bgn, ElemIter end, uint slidx, Weight weight)
+{
+    using ElemP = typename std::iterator_traits<ElemIter>::value_type;
+    std::vector<ElemP> hosted;
+    double hosted_weight = 0.0;
+    for (ElemIter e = bgn; e != end; ++e) {
+        if (!(*e)->getInHost()) continue;
+        hosted.push_back(*e);
+        hosted_weight += weight(*e);
+    }
+
+    std::vector<double> rank_weights(myRank == 0 ? nHosts : 0, 0.0);
+    MPI_Gather(&hosted_weight, 1, MPI_DOUBLE, rank_weights.data(), 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    std::vector<uint> rank_counts(myRank == 0 ? nHosts : 0, 0);
+    if (myRank == 0) {
+        auto set_share = [](uint & share, uint c) { share = c; };
+        auto inc_share = [](uint & share, int c) { share += c; };
+        auto rank_weight = [&](uint const & share) { return rank_weights[&share - rank_counts.data()]; };
+        steps::util::distribute_quantity(n, rank_counts.begin(), rank_counts.end(), rank_weight, set_share, inc_share, *rng());
+    }
+    uint share = 0;
+    MPI_Scatter(rank_counts.data(), 1, MPI_UNSIGNED, &share, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+
+    auto set_count = [slidx](ElemP e, uint c) { e->setCount(slidx, c); };
+    auto inc_count = [slidx](ElemP e, int c) { e->incCount(slidx, c, 0.0, true); };
+    steps::util::distribute_quantity(share, hosted.begin(), hosted.end(), weight, set_count, inc_count, *rng(), hosted_weight);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::reset()
+{
+    std::for_each(pComps.begin(), pComps.end(), std::mem_fun(&Comp::reset));
+    std::for_each(pPatches.begin(), pPatches.end(), std::mem_fun(&Patch::reset));
+
+    TetPVecCI tet_end = pTets.end();
+    for (TetPVecCI tet = pTets.begin(); tet != tet_end; ++tet)
+    {
+        if (*tet == 0) continue;
+        (*tet)->reset();
+    }
+
+    WmVolPVecCI wmvol_end = pWmVols.end();
+    for (WmVolPVecCI wmvol = pWmVols.begin(); wmvol != wmvol_end; ++wmvol)
+    {
+        if ((*wmvol) == 0) continue;
+        (*wmvol)->reset();
+    }
+
+    TriPVecCI tri_end = pTris.end();
+    for (TriPVecCI t = pTris.begin(); t != tri_end; ++t)
+    {
+        if ((*t) == 0) continue;
+        (*t)->reset();
+    }
+
+    pCRSched.reset();
+    pA0 = 0.0;
+    
+    reacExtent = 0.0;
+    diffExtent = 0.0;
+    nIteration = 0.0;
+    
+
+    
+    statedef()->resetTime();
+    statedef()->resetNSteps();
+	_updateLocal();
+    
+    compTime = 0.0;
+    syncTime = 0.0;
     idleTime = 0.0;
 
     efieldTime = 0.0;
@@ -1482,6 +2011,271 @@ void smtos::TetOpSplitP::run(double endtime)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// the element whose pool a (surface) diffusion draws from
+static inline smtos::Tet * diffusionElement(smtos::Diff * d) { return d->getTet(); }
+static inline smtos::Tri * diffusionElement(smtos::SDiff * d) { return d->getTri(); }
+
+// call f(pos) for each set bit pos of bits in [bgn, end), in order
+template <typename F>
+static inline void forEachActive(std::vector<uint64_t> const & bits, uint bgn, uint end, F f)
+{
+    if (bgn >= end) return;
+    uint wlast = (end - 1) / 64;
+    for (uint w = bgn / 64; w <= wlast; w++) {
+        uint64_t word = bits[w];
+        if (w == bgn / 64) word &= ~uint64_t(0) << (bgn % 64);
+        if (w == wlast && end % 64 != 0) word &= ~(~uint64_t(0) << (end % 64));
+        while (word != 0) {
+            f(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+}
+
+// diffusions whose binomials are drawn together
+static const uint DIFF_BATCH_SIZE = 256;
+
+// Stream ids of the diffusion rules, keys after the one of the
+// reactions; tets and tris have separate index spaces.
+static inline uint elementStreamID(smtos::Diff * d) { return d->def()->gidx() << 1; }
+static inline uint elementStreamID(smtos::SDiff * d) { return (d->def()->gidx() << 1) | 1u; }
+
+// Mesh index of the tet or tri a diffusion moves molecules out of.
+static inline uint elementStreamIdx(smtos::TetOpSplitP const * sol, smtos::Diff * d)
+{ return sol->_tetGIdx(d->getTet()->idx()); }
+static inline uint elementStreamIdx(smtos::TetOpSplitP const * sol, smtos::SDiff * d)
+{ return sol->_triGIdx(d->getTri()->idx()); }
+
+template <typename DiffT>
+steps::rng::RNG * smtos::TetOpSplitP::_elementStream(DiffT * d)
+{
+    uint tid = 0;
+    #ifdef _OPENMP
+    tid = omp_get_thread_num();
+    #endif
+    steps::rng::R123 * r = pElementRNGs[tid].get();
+    uint64_t iteration = static_cast<uint64_t>(nIteration);
+    r->setStream(pElementRNGKeys[1 + elementStreamID(d)], static_cast<uint>(iteration),
+                 static_cast<uint>(iteration >> 32), elementStreamIdx(this, d));
+    return r;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename DiffT>
+bool smtos::TetOpSplitP::_diffusionTrials(DiffT * d, double update_period, double endtime, steps::rng::RNG * r,
+                                          uint & mean_n, double & t1)
+{
+    double rate = d->crData.rate;
+    if (rate == 0) return false;
+    // rate is the rate (scaled_dcst * population)
+    double scaleddcst = d->getScaledDcst();
+
+    // The number of molecules available for diffusion for this diffusion rule
+    double population = rate/scaleddcst;
+
+    // t1, AKA 'X', is a fractional number between 0 and 1: the update period divided
+    // by the local mean single-molecule dwellperiod. This fraction gives the mean
+    // proportion of molecules to diffuse.
+    t1 = update_period * scaleddcst;
+    
+    
+    if (t1>=1.0) {
+        t1=1.0;
+    }
+    
+    // Calculate the occupancy, that is the integrated molecules over the period (units s).
+    // update_period is the window of the level of d, which may span several
+    // update periods; the occupancy is kept over the same window.
+    double occupancy = diffusionElement(d)->getWindowOccupancy(d->getLigLidx(), endtime);
+    
+    // n is, correctly, a binomial, but the binomial function requires rounding to
+    // an integer.
+    
+    // occupancy/update_period gives the mean number of molecules during the period
+    double n_double = occupancy/update_period;
+
+    // could be higher than those available - a source of error
+    if (n_double > population) n_double = population;
+
+    double n_int = std::floor(n_double);
+    double n_frc = n_double - n_int;
+    mean_n = static_cast<uint>(n_int);
+
+    // deal linearly with the fraction
+    if (n_frc > 0.0)
+    {
+        double rand01 = r->getUnfIE();
+        if (rand01 < n_frc) mean_n++;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename DiffT>
+uint smtos::TetOpSplitP::_moveMolecules(DiffT * d, uint nmolcs, double endtime, steps::rng::RNG * r,
+                                        std::vector<KProc*> & applied_diffs, std::vector<int> & directions)
+{
+    if (nmolcs == 0) return 0;
+    
+    // we apply here
+    if (nmolcs > diffApplyThreshold)
+    {
+        int direction = d->apply(r, nmolcs, endtime);
+        if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
+            applied_diffs.push_back(d);
+            directions.push_back(direction);
+        }
+    }
+    else
+    {
+        for (uint ai = 0; ai < nmolcs; ++ai)
+        {
+            int direction = d->apply(r, endtime);
+            if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
+                applied_diffs.push_back(d);
+                directions.push_back(direction);
+            }
+        }
+        
+    }
+    pKProcWork[d->schedIDX()] += nmolcs;
+    return nmolcs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename DiffT>
+uint smtos::TetOpSplitP::_applyDiffusion(DiffT * d, double update_period, double endtime,
+                                         std::vector<KProc*> & applied_diffs, std::vector<int> & directions)
+{
+    steps::rng::RNG * r = _elementStream(d);
+    uint mean_n;
+    double t1;
+    if (!_diffusionTrials(d, update_period, endtime, r, mean_n, t1)) return 0;
+
+    // Find the binomial n
+    uint nmolcs = r->getBinom(mean_n, t1);
+    return _moveMolecules(d, nmolcs, endtime, r, applied_diffs, directions);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename DiffT>
+uint smtos::TetOpSplitP::_applyDiffusionBatch(std::vector<DiffT*> const & diffs,
+                                              std::vector<unsigned char> const & levels,
+                                              std::vector<double> const & level_periods, double endtime,
+                                              steps::rng::RNG * r, DiffBatch & batch,
+                                              std::vector<KProc*> & applied_diffs, std::vector<int> & directions)
+{
+    // The mean counts and probabilities only depend on the occupancies
+    // and rates, which moving molecules at endtime leaves unchanged, so
+    // all binomials of the batch can be drawn first.
+    uint npos = batch.pos.size();
+    batch.n.resize(npos);
+    batch.p.resize(npos);
+    batch.nmolcs.resize(npos);
+    uint k = 0;
+    for (uint i = 0; i < npos; i++) {
+        uint pos = batch.pos[i];
+        if (!_diffusionTrials(diffs[pos], level_periods[levels[pos]], endtime, r, batch.n[k], batch.p[k])) continue;
+        batch.pos[k++] = pos;
+    }
+    r->getBinomBatch(batch.n.data(), batch.p.data(), batch.nmolcs.data(), k);
+
+    uint nsteps = 0;
+    for (uint i = 0; i < k; i++) {
+        nsteps += _moveMolecules(diffs[batch.pos[i]], batch.nmolcs[i], endtime, r, applied_diffs, directions);
+    }
+    batch.pos.clear();
+    return nsteps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename DiffT>
+uint smtos::TetOpSplitP::_applyDiffusions(std::vector<DiffT*> const & diffs, std::vector<uint64_t> const & active,
+                                          std::vector<unsigned char> const & levels, uint bgn, uint end,
+                                          std::vector<double> const & level_periods, uint max_level, double endtime,
+                                          steps::rng::RNG * r, DiffBatch & batch, bool poll,
+                                          std::vector<KProc*> & applied_diffs, std::vector<int> & directions)
+{
+    // per-element streams draw each update from its own stream
+    uint nsteps = 0;
+    if (pElementRNG) {
+        uint nvisited = 0;
+        forEachActive(active, bgn, end, [&](uint pos) {
+            uint l = levels[pos];
+            if (l > max_level) return;
+            nsteps += _applyDiffusion(diffs[pos], level_periods[l], endtime, applied_diffs, directions);
+            if (poll && ++nvisited % DIFF_BATCH_SIZE == 0) _progressRemoteSync();
+        });
+        return nsteps;
+    }
+
+    forEachActive(active, bgn, end, [&](uint pos) {
+        if (levels[pos] > max_level) return;
+        batch.pos.push_back(pos);
+        if (batch.pos.size() < DIFF_BATCH_SIZE) return;
+        nsteps += _applyDiffusionBatch(diffs, levels, level_periods, endtime, r, batch, applied_diffs, directions);
+        if (poll) _progressRemoteSync();
+    });
+    nsteps += _applyDiffusionBatch(diffs, levels, level_periods, endtime, r, batch, applied_diffs, directions);
+    return nsteps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename DiffT>
+uint smtos::TetOpSplitP::_applyDiffusionByColour(std::vector<DiffT*> const & diffs,
+                                                 std::vector<uint64_t> const & active,
+                                                 std::vector<unsigned char> const & levels,
+                                                 std::vector<uint> const & colour_sep,
+                                                 std::vector<double> const & level_periods, uint max_level, double endtime,
+                                                 std::vector<KProc*> & applied_diffs, std::vector<int> & directions)
+{
+    uint nsteps = 0;
+    uint ncolours = colour_sep.size() - 1;
+    for (uint c = 0; c < ncolours; c++) {
+        uint bgn = colour_sep[c];
+        uint end = colour_sep[c + 1];
+
+        #pragma omp parallel num_threads(pDiffThreads) reduction(+:nsteps)
+        {
+            uint tid = 0;
+            uint nthreads = 1;
+            #ifdef _OPENMP
+            tid = omp_get_thread_num();
+            nthreads = omp_get_num_threads();
+            #endif
+            steps::rng::RNG * r = pThreadRNGs[tid].get();
+            std::vector<KProc*> & thread_diffs = pThreadAppliedDiffs[tid];
+            std::vector<int> & thread_directions = pThreadDirections[tid];
+
+            // a fixed share of the positions per thread, as with static
+            // scheduling, keeps the draws of each thread reproducible
+            uint lo = bgn + static_cast<uint64_t>(end - bgn) * tid / nthreads;
+            uint hi = bgn + static_cast<uint64_t>(end - bgn) * (tid + 1) / nthreads;
+            nsteps += _applyDiffusions(diffs, active, levels, lo, hi, level_periods, max_level, endtime,
+                                       r, pDiffBatches[tid], false, thread_diffs, thread_directions);
+        }
+
+        // only this thread talks to MPI
+        _progressRemoteSync();
+    }
+
+    for (uint t = 0; t < pDiffThreads; t++) {
+        applied_diffs.insert(applied_diffs.end(), pThreadAppliedDiffs[t].begin(), pThreadAppliedDiffs[t].end());
+        directions.insert(directions.end(), pThreadDirections[t].begin(), pThreadDirections[t].end());
+        pThreadAppliedDiffs[t].clear();
+        pThreadDirections[t].clear();
+    }
+    return nsteps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void smtos::TetOpSplitP::_runWithoutEField(double sim_endtime)
 {
     MPI_Barrier(MPI_COMM_WORLD);
@@ -1498,8 +2292,20 @@ void smtos::TetOpSplitP::_runWithoutEField(double sim_endtime)
     
     double update_period = updPeriod;
     
-    
-    MPI_Request* requests = NULL;
+    // time since each rate level was last applied; the count of update
+    // periods in this run decides which levels are due
+    std::vector<double> level_periods(pDiffRateLevels, 0.0);
+    uint level_step = 0;
+
+    // every window starts here, and occupancies of earlier runs (or of
+    // a time before a reset or restore) must not carry over
+    pDiffLevelStart.assign(pDiffRateLevels, statedef()->time());
+    for (auto tet : pTets) {
+        if (tet != nullptr) tet->resetPoolOccupancy();
+    }
+    for (auto tri : pTris) {
+        if (tri != nullptr) tri->resetPoolOccupancy();
+    }
     
     // here we assume that all molecule counts have been updated so the rates are accurate
     while (statedef()->time() < sim_endtime and not aligned) {
@@ -1514,33 +2320,43 @@ void smtos::TetOpSplitP::_runWithoutEField(double sim_endtime)
             aligned=true;
         }
 
+        // fresh thread streams every update period, drawn from the main one,
+        // so that neither checkpoints nor the way run() is split matter
+        for (auto & r : pThreadRNGs) {
+            ulong seed = static_cast<ulong>(rng()->get()) << 32;
+            r->initialize(seed | rng()->get());
+        }
+
         // *********************** Operator Split: SSA *********************************
         
         // Run SSA for the update period
         
-        double cumulative_dt=0.0;
-        
-        // Store a sequence of kprocs actually applied
-        std::set<smtos::KProc*> applied_ssa_kprocs;
-        while(1)
-        {
-            smtos::KProc * kp = _getNext();
-            if (kp == 0) break;
-                          
-            double a0 = getA0();
-            if (a0 == 0.0) break;
-            
-            double dt=rng()->getExp(a0);
-            if (cumulative_dt +dt > update_period) break;
-            cumulative_dt += dt;
+        // per-element streams run a separate SSA for each group of elements
+        if (pElementRNG) {
+            _runElementSSA(pre_ssa_time, update_period);
+        }
+        else {
+            double cumulative_dt=0.0;
             
+            while(1)
+            {
+                smtos::KProc * kp = _getNext();
+                if (kp == 0) break;
+                              
+                double a0 = getA0();
+                if (a0 == 0.0) break;
+                
+                double dt=rng()->getExp(a0);
+                if (cumulative_dt +dt > update_period) break;
+                cumulative_dt += dt;
+                
 
-            _executeStep(kp, dt, cumulative_dt);                
-            reacExtent +=1;
-
-            
-            applied_ssa_kprocs.insert(kp);
-            
+                // occupancies are integrated in simulation time, as the
+                // window of a level can span several update periods
+                _executeStep(kp, dt, pre_ssa_time + cumulative_dt);
+                pKProcWork[kp->schedIDX()] += 1.0;
+                reacExtent +=1;
+            }
         }
 
         // Now for each process advance to jump time and get jump randomly
@@ -1549,6 +2365,21 @@ void smtos::TetOpSplitP::_runWithoutEField(double sim_endtime)
         // *********************** Operator Split: Diffusion ***************************
 
         // Apply diffusion after the update period
+
+        // Levels 0 to max_level are due: level l every 2^l periods, and
+        // all of them in the last period so that none is left pending.
+        level_step++;
+        uint max_level = pDiffRateLevels - 1;
+        if (pre_ssa_time + updPeriod < sim_endtime) {
+            max_level = 0;
+            while (max_level < pDiffRateLevels - 1 && level_step % (2u << max_level) == 0) max_level++;
+        }
+        for (auto & p : level_periods) p += update_period;
+        double diff_time = pre_ssa_time + update_period;
+
+        // boundary diffusions of due levels are the only source of
+        // remote changes, so otherwise there is nothing to exchange
+        bool exchange = (max_level >= pBndDiffLevel);
         
         #ifdef MPI_PROFILING
         double endtime = MPI_Wtime();
@@ -1556,15 +2387,6 @@ void smtos::TetOpSplitP::_runWithoutEField(double sim_endtime)
         starttime = MPI_Wtime();
         #endif
 
-        // wait until previous loop finishes sending diffusion data
-        if (requests != NULL) {
-            MPI_Waitall(nNeighbHosts, requests, MPI_STATUSES_IGNORE);
-            delete[] requests;
-        }
-        
-        // create new requests for this loop
-        requests = new MPI_Request[nNeighbHosts];
-        
         for (auto neighbor : neighbHosts) {
             remoteChanges[neighbor].clear();
         }
@@ -1583,194 +2405,106 @@ void smtos::TetOpSplitP::_runWithoutEField(double sim_endtime)
         std::vector<KProc*> applied_diffs;
         std::vector<int> directions;
         
-        for (uint pos = 0; pos < diffSep; pos++)
-        {
-            Diff* d = pDiffs[pos];
-            double rate = d->crData.rate;
-            if (rate == 0) continue;
-            // rate is the rate (scaled_dcst * population)
-            double scaleddcst = d->getScaledDcst();
-
-            // The number of molecules available for diffusion for this diffusion rule
-            double population = rate/scaleddcst;
-
-            // t1, AKA 'X', is a fractional number between 0 and 1: the update period divided
-            // by the local mean single-molecule dwellperiod. This fraction gives the mean
-            // proportion of molecules to diffuse.
-            double t1 = update_period * scaleddcst;
-            
-            
-            if (t1>=1.0) {
-                t1=1.0;
-            }
-            
-            // Calculate the occupancy, that is the integrated molecules over the period (units s)
-            double occupancy = d->getTet()->getPoolOccupancy(d->getLigLidx()) + population* (update_period - d->getTet()->getLastUpdate(d->getLigLidx()) );
-            
-            // n is, correctly, a binomial, but the binomial function requires rounding to
-            // an integer.
-            
-            // occupancy/update_period gives the mean number of molecules during the period
-            double n_double = occupancy/update_period;
-
-            // could be higher than those available - a source of error
-            if (n_double > population) n_double = population;
-
-            double n_int = std::floor(n_double);
-            double n_frc = n_double - n_int;
-            uint mean_n = static_cast<uint>(n_int);
-
-            // deal linearly with the fraction
-            if (n_frc > 0.0)
-            {
-                double rand01 = rng()->getUnfIE();
-                if (rand01 < n_frc) mean_n++;
-            }
-            
-            // Find the binomial n
-            uint nmolcs = rng()->getBinom(mean_n, t1);
-            
-            if (nmolcs == 0) continue;
-            
-            // we apply here
-            if (nmolcs > diffApplyThreshold)
-            {
-                int direction = d->apply(rng(), nmolcs);
-                if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
-                    applied_diffs.push_back(d);
-                    directions.push_back(direction);
-                }
-            }
-            else
-            {
-                for (uint ai = 0; ai < nmolcs; ++ai)
-                {
-                    int direction = d->apply(rng());
-                    if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
-                        applied_diffs.push_back(d);
-                        directions.push_back(direction);
-                    }
-                }
-                
-            }
-            nsteps += nmolcs;
-            diffExtent += nmolcs;
-        }
+        // Boundary diffusions go first: they are the only ones that can
+        // move molecules to other ranks, so the exchange can start while
+        // the interior diffusions are computed. Only diffusions with a
+        // nonzero rate are visited.
+        DiffBatch & batch = pDiffBatches[0];
+        nsteps += _applyDiffusions(pDiffs, pActiveDiffs, pDiffLevel, 0, diffBndSep, level_periods, max_level,
+                                   diff_time, rng(), batch, false, applied_diffs, directions);
+        nsteps += _applyDiffusions(pSDiffs, pActiveSDiffs, pSDiffLevel, 0, sdiffBndSep, level_periods, max_level,
+                                   diff_time, rng(), batch, false, applied_diffs, directions);
         
-        // surface diffusion
+        #ifdef MPI_PROFILING
+        endtime = MPI_Wtime();
+        compTime += (endtime - starttime);
+        #endif
         
-        for (uint pos = 0; pos < sdiffSep; pos++)
-        {
-            SDiff* d = pSDiffs[pos];
-            double rate = d->crData.rate;
-
-            if (rate == 0) continue;
-            // rate is the rate (scaled_dcst * population)
-            double scaleddcst = d->getScaledDcst();
-
-            // The number of molecules available for diffusion for this diffusion rule
-            double population = rate/scaleddcst;
-
-            // t1, AKA 'X', is a fractional number between 0 and 1: the update period divided
-            // by the local mean single-molecule dwellperiod. This fraction gives the mean
-            // proportion of molecules to diffuse.
-            double t1 = update_period * scaleddcst;
-            
-            if (t1>=1.0)
-            {
-                t1=1.0;
-            }
-
-            double occupancy = d->getTri()->getPoolOccupancy(d->getLigLidx()) + population* (update_period-  d->getTri()->getLastUpdate(d->getLigLidx()) );
-
-            // n is, correctly, a binomial, but the binomial function requires rounding to
-            // an integer.
-            
-            // occupancy/update_period gives the mean number of molecules during the period
-            double n_double = occupancy/update_period;
-
-            // could be higher than those available - a source of error
-            if (n_double > population) n_double = population;
-
-            double n_int = std::floor(n_double);
-            double n_frc = n_double - n_int;
-            uint mean_n = static_cast<uint>(n_int);
-
-            // deal linearly with the fraction
-            if (n_frc > 0.0)
-            {
-                double rand01 = rng()->getUnfIE();
-                if (rand01 < n_frc) mean_n++;
-            }
-            
-            // Find the binomial n
-            uint nmolcs = rng()->getBinom(mean_n, t1);
-            
-            if (nmolcs == 0) continue;
-            
-            // we apply here
-            if (nmolcs > diffApplyThreshold)
-            {
-                int direction = d->apply(rng(), nmolcs);
-                if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
-                    applied_diffs.push_back(d);
-                    directions.push_back(direction);
-                }
-            }
-            else
-            {
-                for (uint ai = 0; ai < nmolcs; ++ai)
-                {
-                    int direction = d->apply(rng());
-                    if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
-                        applied_diffs.push_back(d);
-                        directions.push_back(direction);
-                    }
-                }
-            }
-            nsteps += nmolcs;
-            diffExtent += nmolcs;
+        if (exchange) _startRemoteSync();
+        
+        #ifdef MPI_PROFILING
+        starttime = MPI_Wtime();
+        #endif
+        
+        // interior diffusions, polling the exchange after every batch so
+        // the data transfer is posted as soon as the sizes have arrived
+        if (pDiffColourSep.empty()) {
+            nsteps += _applyDiffusions(pDiffs, pActiveDiffs, pDiffLevel, diffBndSep, diffSep, level_periods, max_level,
+                                       diff_time, rng(), batch, true, applied_diffs, directions);
+            nsteps += _applyDiffusions(pSDiffs, pActiveSDiffs, pSDiffLevel, sdiffBndSep, sdiffSep, level_periods, max_level,
+                                       diff_time, rng(), batch, true, applied_diffs, directions);
+        }
+        else {
+            nsteps += _applyDiffusionByColour(pDiffs, pActiveDiffs, pDiffLevel, pDiffColourSep,
+                                              level_periods, max_level, diff_time, applied_diffs, directions);
+            nsteps += _applyDiffusionByColour(pSDiffs, pActiveSDiffs, pSDiffLevel, pSDiffColourSep,
+                                              level_periods, max_level, diff_time, applied_diffs, directions);
         }
+        diffExtent += nsteps;
         
         #ifdef MPI_PROFILING
         endtime = MPI_Wtime();
         compTime += (endtime - starttime);
         #endif
         
-        _remoteSyncAndUpdate(requests, applied_diffs, directions);
+        _finishRemoteSync(applied_diffs, directions, diff_time);
+
+        // the applied levels start a new window
+        for (uint l = 0; l <= max_level; l++) {
+            level_periods[l] = 0.0;
+            pDiffLevelStart[l] = diff_time;
+        }
         
-        // *********************** Operator Split: SSA *********************************
         #ifdef MPI_PROFILING
         starttime = MPI_Wtime();
         #endif
         
-        KProcPSetCI akp_end = applied_ssa_kprocs.end();
-        for (KProcPSetCI akp = applied_ssa_kprocs.begin(); akp != akp_end; ++akp)
-        {
-            (*akp)->resetOccupancies();
-        }
-        
         statedef()->setTime(pre_ssa_time + update_period);
         if (nsteps > 0) statedef()->incNSteps(nsteps);
 
         nIteration += 1;
         
+        ++pItersSinceRebalance;
+        // only when every level has been applied, so that no window
+        // is open across the migration
+        if (pRebalanceInterval > 0 && pItersSinceRebalance >= pRebalanceInterval
+            && max_level == pDiffRateLevels - 1) {
+            // every rank runs the same number of iterations, so all
+            // of them take this decision together; each diffusion kproc
+            // costs one unit per update period on top of the measured work
+            double local_work = std::accumulate(pKProcWork.begin(), pKProcWork.end(), 0.0);
+            local_work += static_cast<double>(diffSep + sdiffSep) * pItersSinceRebalance;
+            double max_work = 0.0;
+            double sum_work = 0.0;
+            MPI_Allreduce(&local_work, &max_work, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            MPI_Allreduce(&local_work, &sum_work, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+            if (sum_work > 0.0 && max_work * nHosts > pRebalanceThreshold * sum_work) {
+                rebalance();
+            }
+            else {
+                std::fill(pKProcWork.begin(), pKProcWork.end(), 0.0);
+                pItersSinceRebalance = 0;
+            }
+        }
+        
         #ifdef MPI_PROFILING
         endtime = MPI_Wtime();
         compTime += (endtime - starttime);
         #endif
     }
-    if (requests != NULL) {
-        MPI_Waitall(nNeighbHosts, requests, MPI_STATUSES_IGNORE);
-        delete[] requests;
-    }
     MPI_Barrier(MPI_COMM_WORLD);
 
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::_refreshEFTrisV() {
+void smtos::TetOpSplitP::_refreshEFTrisV(bool local) {
+    if (local) {
+        int i_begin = EFTrisI_offset[myRank];
+        int i_end = i_begin + EFTrisI_count[myRank];
+        for (int i = i_begin; i < i_end; ++i) EFTrisV[EFTrisI_idx[i]] = pEField->getTriV(EFTrisI_idx[i]);
+        return;
+    }
     for (uint tlidx = 0; tlidx < pEFNTris; tlidx++) EFTrisV[tlidx] = pEField->getTriV(tlidx);
     pEFTrisVStale = false;
 }
@@ -1822,44 +2556,66 @@ void smtos::TetOpSplitP::_runWithEField(double endtime)
         efieldTime += (timing_end - timing_start);
         #endif
 
-        #ifdef MPI_PROFILING
-        timing_start = MPI_Wtime();
-        #endif
-        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
-                &EFTrisI_permuted[0], &EFTrisI_count[0], &EFTrisI_offset[0], MPI_DOUBLE, MPI_COMM_WORLD);
+        if (pEFDistSolver != nullptr) {
+            // the distributed solver sums the currents into the
+            // vertex owners itself
+            for (int i = i_begin; i < i_end; ++i)
+                pEField->setTriI(EFTrisI_idx[i], EFTrisI_permuted[i]);
 
-        #ifdef MPI_PROFILING
-        timing_end = MPI_Wtime();
-        dataExchangeTime += (timing_end - timing_start);
-        #endif
+            #ifdef MPI_PROFILING
+            timing_start = MPI_Wtime();
+            #endif
 
-        #ifdef MPI_PROFILING
-        timing_start = MPI_Wtime();
-        #endif
+            pEField->advance(sttime-t0);
+            _refreshEFTrisV(true);
+        }
+        else {
+            #ifdef MPI_PROFILING
+            timing_start = MPI_Wtime();
+            #endif
+            MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                    &EFTrisI_permuted[0], &EFTrisI_count[0], &EFTrisI_offset[0], MPI_DOUBLE, MPI_COMM_WORLD);
 
-        for (uint i = 0; i < pEFNTris; i++)
-                pEField->setTriI(EFTrisI_idx[i], EFTrisI_permuted[i]);
+            #ifdef MPI_PROFILING
+            timing_end = MPI_Wtime();
+            dataExchangeTime += (timing_end - timing_start);
+            #endif
 
-        pEField->advance(sttime-t0);
-        _refreshEFTrisV();
+            #ifdef MPI_PROFILING
+            timing_start = MPI_Wtime();
+            #endif
+
+            for (uint i = 0; i < pEFNTris; i++)
+                    pEField->setTriI(EFTrisI_idx[i], EFTrisI_permuted[i]);
+
+            pEField->advance(sttime-t0);
+            _refreshEFTrisV();
+        }
 
         #ifdef MPI_PROFILING
         timing_end = MPI_Wtime();
         efieldTime += (timing_end - timing_start);
         #endif
-        // TODO: Replace this with something that only resets voltage-dependent things
 
         #ifdef MPI_PROFILING
         timing_start = MPI_Wtime();
         #endif
 
-        _updateLocal();
+        // Only voltage-dependent propensities can have changed
+        _updateLocal(pVDepKProcs);
 
         #ifdef MPI_PROFILING
         timing_end = MPI_Wtime();
         rdTime += (timing_end - timing_start);
         #endif
     }
+
+    // potentials are only exchanged between neighbours while running;
+    // bring every rank up to date for the getters and checkpointing
+    if (pEFDistSolver != nullptr) {
+        pEFDistSolver->gatherPotential();
+        _refreshEFTrisV();
+    }
     MPI_Barrier(MPI_COMM_WORLD);
 }
 
@@ -1939,7 +2695,7 @@ double smtos::TetOpSplitP::_getCompVol(uint cidx) const
     AssertLog(statedef()->countComps() == pComps.size());
     smtos::Comp * comp = _comp(cidx);
     AssertLog(comp != 0);
-    return comp->vol();
+    return comp->def()->vol();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1959,14 +2715,17 @@ double smtos::TetOpSplitP::_getCompCount(uint cidx, uint sidx) const
         ArgErrLog(os.str());
     }
 
-    uint total_count = 0;
+    // each rank sums the tets it hosts, so that halo or absent tets
+    // of a distributed mesh are never counted twice
+    uint local_count = 0;
     WmVolPVecCI t_end = comp->endTet();
     for (WmVolPVecCI t = comp->bgnTet(); t != t_end; ++t)
     {
-        uint svol_count = (*t)->pools()[slidx];
-        MPI_Bcast(&svol_count, 1, MPI_UNSIGNED, (*t)->getHost(), MPI_COMM_WORLD);
-        total_count += svol_count;
+        if (!(*t)->getInHost()) continue;
+        local_count += (*t)->pools()[slidx];
     }
+    uint total_count = 0;
+    MPI_Allreduce(&local_count, &total_count, 1, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD);
 
     return total_count;
 }
@@ -1997,6 +2756,16 @@ void smtos::TetOpSplitP::_setCompCount(uint cidx, uint sidx, double n)
         ArgErrLog(os.str());
     }
 
+    if (pDistMesh) {
+        // no rank holds all the tets
+        _distributeHosted(n, comp->bgnTet(), comp->endTet(), slidx, [](WmVol *tet) { return tet->vol(); });
+        WmVolPVecCI t_end = comp->endTet();
+        for (WmVolPVecCI t = comp->bgnTet(); t != t_end; ++t) _updateSpec((*t), sidx);
+        _updateSum();
+        MPI_Barrier(MPI_COMM_WORLD);
+        return;
+    }
+
     // only do the distribution in rank 0
     // then bcast to other ranks
     
@@ -2414,7 +3183,7 @@ double smtos::TetOpSplitP::_getPatchArea(uint pidx) const
     AssertLog(statedef()->countPatches() == pPatches.size());
     smtos::Patch * patch = _patch(pidx);
     AssertLog(patch != 0);
-    return patch->area();
+    return patch->def()->area();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2434,15 +3203,16 @@ double smtos::TetOpSplitP::_getPatchCount(uint pidx, uint sidx) const
         ArgErrLog(os.str());
     }
 
-    uint total_count = 0;
+    uint local_count = 0;
     TriPVecCI t_end = patch->endTri();
     for (TriPVecCI t = patch->bgnTri(); t != t_end; ++t)
     {
-        uint svol_count = (*t)->pools()[slidx];
-        MPI_Bcast(&svol_count, 1, MPI_UNSIGNED, (*t)->getHost(), MPI_COMM_WORLD);
-        total_count += svol_count;
+        if (!(*t)->getInHost()) continue;
+        local_count += (*t)->pools()[slidx];
     }
-    
+    uint total_count = 0;
+    MPI_Allreduce(&local_count, &total_count, 1, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD);
+
     return total_count;
 }
 
@@ -2473,6 +3243,15 @@ void smtos::TetOpSplitP::_setPatchCount(uint pidx, uint sidx, double n)
 		ArgErrLog(os.str());
 	}
 
+    if (pDistMesh) {
+        _distributeHosted(n, patch->bgnTri(), patch->endTri(), slidx, [](Tri *tri) { return tri->area(); });
+        TriPVecCI t_end = patch->endTri();
+        for (TriPVecCI t = patch->bgnTri(); t != t_end; ++t) _updateSpec((*t), sidx);
+        _updateSum();
+        MPI_Barrier(MPI_COMM_WORLD);
+        return;
+    }
+
     // only do the distribution in rank 0
     // then bcast to other ranks
     
@@ -3141,132 +3920,11 @@ uint smtos::TetOpSplitP::addKProc(steps::mpi::tetopsplit::KProc * kp)
 
 steps::mpi::tetopsplit::KProc * smtos::TetOpSplitP::_getNext() const
 {
-
     AssertLog(pA0 >= 0.0);
     // Quick check to see whether nothing is there.
     if (pA0 == 0.0) return NULL;
 
-    double selector = pA0 * rng()->getUnfII();
-
-    double partial_sum = 0.0;
-
-    uint n_neg_groups = nGroups.size();
-    uint n_pos_groups = pGroups.size();
-
-    for (uint i = 0; i < n_neg_groups; i++) {
-        CRGroup* group = nGroups[i];
-        if (group->size == 0) continue;
-
-        if (selector > partial_sum + group->sum) {
-            partial_sum += group->sum;
-
-            continue;
-        }
-
-        double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
-        uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
-        KProc* random_kp = group->indices[random_pos];
-
-        while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
-            random_kp = group->indices[random_pos];
-        }
-
-        return random_kp;
-    }
-
-    for (uint i = 0; i < n_pos_groups; i++) {
-        CRGroup* group = pGroups[i];
-        if (group->size == 0) continue;
-
-        if (selector > partial_sum + group->sum) {
-            partial_sum += group->sum;
-            continue;
-        }
-
-        double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
-        uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
-        KProc* random_kp = group->indices[random_pos];
-
-
-        while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
-            random_kp = group->indices[random_pos];
-        }
-
-        return random_kp;
-    }
-
-    // Precision rounding error force clean up
-    // Force the search in the last non-empty group
-    for (int i = n_pos_groups - 1; i >= 0; i--) {
-        CRGroup* group = pGroups[i];
-        if (group->size == 0) continue;
-
-        double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
-        uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
-        KProc* random_kp = group->indices[random_pos];
-
-
-        while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
-            random_kp = group->indices[random_pos];
-
-        }
-
-        return random_kp;
-    }
-
-    for (int i = n_neg_groups - 1; i >= 0; i--) {
-        CRGroup* group = nGroups[i];
-        if (group->size == 0) continue;
-
-        double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
-        uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
-        KProc* random_kp = group->indices[random_pos];
-
-
-        while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
-            random_kp = group->indices[random_pos];
-
-        }
-
-        return random_kp;
-    }
-
-    // Precision rounding error force clean up - Complete
-
-    std::ostringstream os;
-
-    os << "Cannot find any suitable entry.\n";
-    os << "A0: " << std::setprecision (15) << pA0 << "\n";
-    os << "Selector: " << std::setprecision (15) << selector << "\n";
-    os << "Current Partial Sum: " << std::setprecision (15) << partial_sum << "\n";
-
-    os << "Distribution of group sums\n";
-    os << "Negative groups\n";
-
-    for (uint i = 0; i < n_neg_groups; i++) {
-        os <<  i << ": " << std::setprecision (15) << nGroups[i]->sum << "\n";
-    }
-    os << "Positive groups\n";
-    for (uint i = 0; i < n_pos_groups; i++) {
-        os << i << ": " << std::setprecision (15) << pGroups[i]->sum << "\n";
-    }
-    ProgErrLog(os.str());
+    return pCRSched.select(rng());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3364,7 +4022,6 @@ double smtos::TetOpSplitP::_getCompReacH(uint cidx, uint ridx) const
 
     WmVolPVecCI t_bgn = lcomp->bgnTet();
     WmVolPVecCI t_end = lcomp->endTet();
-    if (t_bgn == t_end) return 0.0;
 
     double local_h = 0.0;
     for (WmVolPVecCI t = t_bgn; t != t_end; ++t)
@@ -3400,7 +4057,6 @@ double smtos::TetOpSplitP::_getCompReacC(uint cidx, uint ridx) const
 
     WmVolPVecCI t_bgn = lcomp->bgnTet();
     WmVolPVecCI t_end = lcomp->endTet();
-    if (t_bgn == t_end) return 0.0;
     double local_c = 0.0;
     double local_v = 0.0;
     for (WmVolPVecCI t = t_bgn; t != t_end; ++t)
@@ -3440,7 +4096,6 @@ double smtos::TetOpSplitP::_getCompReacA(uint cidx, uint ridx) const
 
     WmVolPVecCI t_bgn = lcomp->bgnTet();
     WmVolPVecCI t_end = lcomp->endTet();
-    if (t_bgn == t_end) return 0.0;
 
     double local_a = 0.0;
     for (WmVolPVecCI t = t_bgn; t != t_end; ++t)
@@ -3476,9 +4131,8 @@ uint smtos::TetOpSplitP::_getCompReacExtent(uint cidx, uint ridx) const
 
     WmVolPVecCI t_bgn = lcomp->bgnTet();
     WmVolPVecCI t_end = lcomp->endTet();
-    if (t_bgn == t_end) return 0.0;
 
-    uint local_x = 0.0;
+    double local_x = 0.0;
     for (WmVolPVecCI t = t_bgn; t != t_end; ++t)
     {
         if (!(*t)->getInHost()) continue;
@@ -3513,7 +4167,6 @@ void smtos::TetOpSplitP::_resetCompReacExtent(uint cidx, uint ridx)
 
     WmVolPVecCI t_bgn = lcomp->bgnTet();
     WmVolPVecCI t_end = lcomp->endTet();
-    if (t_bgn == t_end) return;
 
     for (WmVolPVecCI t = t_bgn; t != t_end; ++t)
     {
@@ -3544,7 +4197,6 @@ double smtos::TetOpSplitP::_getPatchSReacH(uint pidx, uint ridx) const
 
     TriPVecCI t_bgn = lpatch->bgnTri();
     TriPVecCI t_end = lpatch->endTri();
-    if (t_bgn == t_end) return 0.0;
 
     double local_h = 0.0;
     for (TriPVecCI t = t_bgn; t != t_end; ++t)
@@ -3580,7 +4232,6 @@ double smtos::TetOpSplitP::_getPatchSReacC(uint pidx, uint ridx) const
 
     TriPVecCI t_bgn = lpatch->bgnTri();
     TriPVecCI t_end = lpatch->endTri();
-    if (t_bgn == t_end) return 0.0;
 
     double local_c = 0.0;
     double local_a = 0.0;
@@ -3620,7 +4271,6 @@ double smtos::TetOpSplitP::_getPatchSReacA(uint pidx, uint ridx) const
 
     TriPVecCI t_bgn = lpatch->bgnTri();
     TriPVecCI t_end = lpatch->endTri();
-    if (t_bgn == t_end) return 0.0;
 
     double local_a = 0.0;
     for (TriPVecCI t = t_bgn; t != t_end; ++t)
@@ -3655,7 +4305,6 @@ uint smtos::TetOpSplitP::_getPatchSReacExtent(uint pidx, uint ridx) const
 
     TriPVecCI t_bgn = lpatch->bgnTri();
     TriPVecCI t_end = lpatch->endTri();
-    if (t_bgn == t_end) return 0;
 
     double local_x = 0.0;
     for (TriPVecCI t = t_bgn; t != t_end; ++t)
@@ -3690,7 +4339,6 @@ void smtos::TetOpSplitP::_resetPatchSReacExtent(uint pidx, uint ridx)
 
     TriPVecCI t_bgn = lpatch->bgnTri();
     TriPVecCI t_end = lpatch->endTri();
-    if (t_bgn == t_end) return;
 
     for (TriPVecCI t = t_bgn; t != t_end; ++t)
     {
@@ -3702,16 +4350,31 @@ void smtos::TetOpSplitP::_resetPatchSReacExtent(uint pidx, uint ridx)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+uint smtos::TetOpSplitP::_countTets() const
+{
+    if (pDistMesh) return pGlobalTets;
+    return API::_countTets();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 double smtos::TetOpSplitP::_getTetVol(uint tidx) const
 {
-    AssertLog(tidx < pTets.size());
-    if (pTets[tidx] == 0)
+    AssertLog(tidx < _countTets());
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.";
         ArgErrLog(os.str());
     }
-    return pTets[tidx]->vol();
+    if (!pDistMesh) return mesh()->getTetVol(tidx);
+
+    // every rank holding the tet knows its volume
+    smtos::Tet * tet = _globalTet(tidx);
+    double local_vol = (tet != nullptr) ? tet->vol() : 0.0;
+    double vol = 0.0;
+    MPI_Allreduce(&local_vol, &vol, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return vol;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3727,13 +4390,12 @@ void smtos::TetOpSplitP::_setTetVol(uint tidx, double vol)
 
 bool smtos::TetOpSplitP::_getTetSpecDefined(uint tidx, uint sidx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(sidx < statedef()->countSpecs());
 
-    if (pTets[tidx] == 0) return false;
+    if (_tetCompdef(tidx) == nullptr) return false;
 
-    smtos::Tet * tet = pTets[tidx];
-    uint lsidx = tet->compdef()->specG2L(sidx);
+    uint lsidx = _tetCompdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED) return false;
     else return true;
 }
@@ -3743,18 +4405,18 @@ bool smtos::TetOpSplitP::_getTetSpecDefined(uint tidx, uint sidx) const
 double smtos::TetOpSplitP::_getTetCount(uint tidx, uint sidx) const
 {
     MPI_Barrier(MPI_COMM_WORLD);
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(sidx < statedef()->countSpecs());
 
-    if (pTets[tidx] == 0)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tet * tet = pTets[tidx];
-    uint lsidx = tet->compdef()->specG2L(sidx);
+    smtos::Tet * tet = _globalTet(tidx);
+    uint lsidx = _tetCompdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -3762,8 +4424,9 @@ double smtos::TetOpSplitP::_getTetCount(uint tidx, uint sidx) const
         ArgErrLog(os.str());
     }
 
-    uint count = tet->pools()[lsidx];
-    MPI_Bcast(&count, 1, MPI_UNSIGNED, tetHosts[tidx], MPI_COMM_WORLD);
+    uint count = 0;
+    if (tet != nullptr && tet->getInHost()) count = tet->pools()[lsidx];
+    MPI_Bcast(&count, 1, MPI_UNSIGNED, _tetHost(tidx), MPI_COMM_WORLD);
 	MPI_Barrier(MPI_COMM_WORLD);
     return count;
 }
@@ -3773,10 +4436,10 @@ double smtos::TetOpSplitP::_getTetCount(uint tidx, uint sidx) const
 void smtos::TetOpSplitP::_setTetCount(uint tidx, uint sidx, double n)
 {
     MPI_Barrier(MPI_COMM_WORLD);
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(sidx < statedef()->countSpecs());
     AssertLog(n >= 0.0);
-    if (pTets[tidx] == 0)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
@@ -3790,9 +4453,9 @@ void smtos::TetOpSplitP::_setTetCount(uint tidx, uint sidx, double n)
         ArgErrLog(os.str());
     }
     
-    smtos::Tet * tet = pTets[tidx];
+    smtos::Tet * tet = _globalTet(tidx);
     
-    uint lsidx = tet->compdef()->specG2L(sidx);
+    uint lsidx = _tetCompdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -3818,8 +4481,11 @@ void smtos::TetOpSplitP::_setTetCount(uint tidx, uint sidx, double n)
     MPI_Bcast(&count, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
     
     // don't need sync
-    tet->setCount(lsidx, count);
-    _updateSpec(tet, sidx);
+    if (tet != nullptr)
+    {
+        tet->setCount(lsidx, count);
+        _updateSpec(tet, sidx);
+    }
     _updateSum();
     MPI_Barrier(MPI_COMM_WORLD);
 }
@@ -3849,8 +4515,7 @@ double smtos::TetOpSplitP::_getTetConc(uint tidx, uint sidx) const
 {
     // following method does all necessary argument checking
     double count = _getTetCount(tidx, sidx);
-    smtos::Tet * tet = pTets[tidx];
-    double vol = tet->vol();
+    double vol = _getTetVol(tidx);
     return (count/(1.0e3 * vol * steps::math::AVOGADRO));
 }
 
@@ -3859,17 +4524,16 @@ double smtos::TetOpSplitP::_getTetConc(uint tidx, uint sidx) const
 void smtos::TetOpSplitP::_setTetConc(uint tidx, uint sidx, double c)
 {
     AssertLog(c >= 0.0);
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
 
-    if (pTets[tidx] == 0)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.";
         ArgErrLog(os.str());
     }
 
-    smtos::Tet * tet = pTets[tidx];
-    double count = c * (1.0e3 * tet->vol() * steps::math::AVOGADRO);
+    double count = c * (1.0e3 * _getTetVol(tidx) * steps::math::AVOGADRO);
     // the following method does all the necessary argument checking
     _setTetCount(tidx, sidx, count);
 }
@@ -3878,19 +4542,19 @@ void smtos::TetOpSplitP::_setTetConc(uint tidx, uint sidx, double c)
 
 bool smtos::TetOpSplitP::_getTetClamped(uint tidx, uint sidx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(sidx < statedef()->countSpecs());
 
-    if (pTets[tidx] == 0)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tet * tet = pTets[tidx];
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lsidx = tet->compdef()->specG2L(sidx);
+    uint lsidx = _tetCompdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -3905,19 +4569,19 @@ bool smtos::TetOpSplitP::_getTetClamped(uint tidx, uint sidx) const
 
 void smtos::TetOpSplitP::_setTetClamped(uint tidx, uint sidx, bool buf)
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(sidx < statedef()->countSpecs());
 
-    if (pTets[tidx] == 0)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tet * tet = pTets[tidx];
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lsidx = tet->compdef()->specG2L(sidx);
+    uint lsidx = _tetCompdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -3925,28 +4589,28 @@ void smtos::TetOpSplitP::_setTetClamped(uint tidx, uint sidx, bool buf)
         ArgErrLog(os.str());
     }
 
-    tet->setClamped(lsidx, buf);
+    if (tet != nullptr) tet->setClamped(lsidx, buf);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 double smtos::TetOpSplitP::_getTetReacK(uint tidx, uint ridx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(ridx < statedef()->countReacs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
     
-    int host = tetHosts[tidx];
+    int host = _tetHost(tidx);
     
-    smtos::Tet * tet = pTets[tidx];
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lridx = tet->compdef()->reacG2L(ridx);
+    uint lridx = _tetCompdef(tidx)->reacG2L(ridx);
     if (lridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -3954,7 +4618,7 @@ double smtos::TetOpSplitP::_getTetReacK(uint tidx, uint ridx) const
         ArgErrLog(os.str());
     }
     double kcst = 0;
-    if (tet->getInHost()) {
+    if (tet != nullptr && tet->getInHost()) {
         kcst = tet->reac(lridx)->kcst();
     }
     MPI_Bcast(&kcst, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
@@ -3965,20 +4629,20 @@ double smtos::TetOpSplitP::_getTetReacK(uint tidx, uint ridx) const
 
 void smtos::TetOpSplitP::_setTetReacK(uint tidx, uint ridx, double kf)
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(ridx < statedef()->countReacs());
     AssertLog(kf >= 0.0);
 
-    if (pTets[tidx] == 0  && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
     
-    smtos::Tet * tet = pTets[tidx];
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lridx = tet->compdef()->reacG2L(ridx);
+    uint lridx = _tetCompdef(tidx)->reacG2L(ridx);
     if (lridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -3986,7 +4650,7 @@ void smtos::TetOpSplitP::_setTetReacK(uint tidx, uint ridx, double kf)
         ArgErrLog(os.str());
     }
 
-    if (!tet->getInHost()) return;
+    if (tet == nullptr || !tet->getInHost()) return;
     tet->reac(lridx)->setKcst(kf);
     _updateElement(tet->reac(lridx));
     _updateSum();
@@ -3996,19 +4660,19 @@ void smtos::TetOpSplitP::_setTetReacK(uint tidx, uint ridx, double kf)
 
 bool smtos::TetOpSplitP::_getTetReacActive(uint tidx, uint ridx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(ridx < statedef()->countReacs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
-    int host = tetHosts[tidx];
-    smtos::Tet * tet = pTets[tidx];
+    int host = _tetHost(tidx);
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lridx = tet->compdef()->reacG2L(ridx);
+    uint lridx = _tetCompdef(tidx)->reacG2L(ridx);
     if (lridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4017,7 +4681,7 @@ bool smtos::TetOpSplitP::_getTetReacActive(uint tidx, uint ridx) const
     }
     
     bool active = false;
-    if (tet->getInHost()) {
+    if (tet != nullptr && tet->getInHost()) {
         if (tet->reac(lridx)->inactive() == true) active = false;
         else active = true;
     }
@@ -4029,26 +4693,26 @@ bool smtos::TetOpSplitP::_getTetReacActive(uint tidx, uint ridx) const
 
 void smtos::TetOpSplitP::_setTetReacActive(uint tidx, uint ridx, bool act)
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(ridx < statedef()->countReacs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tet * tet = pTets[tidx];
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lridx = tet->compdef()->reacG2L(ridx);
+    uint lridx = _tetCompdef(tidx)->reacG2L(ridx);
     if (lridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
         os << "Reaction undefined in tetrahedron.\n";
         ArgErrLog(os.str());
     }
-    if (!tet->getInHost()) return;
+    if (tet == nullptr || !tet->getInHost()) return;
     tet->reac(lridx)->setActive(act);
     _updateElement(tet->reac(lridx));
     _updateSum();
@@ -4058,19 +4722,19 @@ void smtos::TetOpSplitP::_setTetReacActive(uint tidx, uint ridx, bool act)
 
 double smtos::TetOpSplitP::_getTetDiffD(uint tidx, uint didx, uint direction_tet) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(didx < statedef()->countDiffs());
     
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
-    int host = tetHosts[tidx];
-    smtos::Tet * tet = pTets[tidx];
+    int host = _tetHost(tidx);
+    smtos::Tet * tet = _globalTet(tidx);
     
-    uint ldidx = tet->compdef()->diffG2L(didx);
+    uint ldidx = _tetCompdef(tidx)->diffG2L(didx);
     if (ldidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4078,7 +4742,7 @@ double smtos::TetOpSplitP::_getTetDiffD(uint tidx, uint didx, uint direction_tet
         ArgErrLog(os.str());
     }
     double dcst = 0.0;
-    if (tet->getInHost()) {
+    if (tet != nullptr && tet->getInHost()) {
         if (direction_tet == std::numeric_limits<uint>::max()) {
             dcst = tet->diff(ldidx)->dcst();
         }
@@ -4102,19 +4766,19 @@ double smtos::TetOpSplitP::_getTetDiffD(uint tidx, uint didx, uint direction_tet
 void smtos::TetOpSplitP::_setTetDiffD(uint tidx, uint didx, double dk, uint direction_tet)
 {
     
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(didx < statedef()->countDiffs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
     recomputeUpdPeriod = true;
-    smtos::Tet * tet = pTets[tidx];
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint ldidx = tet->compdef()->diffG2L(didx);
+    uint ldidx = _tetCompdef(tidx)->diffG2L(didx);
     if (ldidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4122,7 +4786,7 @@ void smtos::TetOpSplitP::_setTetDiffD(uint tidx, uint didx, double dk, uint dire
         ArgErrLog(os.str());
     }
     
-    if (!tet->getInHost()) return;
+    if (tet == nullptr || !tet->getInHost()) return;
     
     if (direction_tet == std::numeric_limits<uint>::max()) {
         tet->diff(ldidx)->setDcst(dk);
@@ -4147,19 +4811,19 @@ void smtos::TetOpSplitP::_setTetDiffD(uint tidx, uint didx, double dk, uint dire
 
 bool smtos::TetOpSplitP::_getTetDiffActive(uint tidx, uint didx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(didx < statedef()->countDiffs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
-    int host = tetHosts[tidx];
-    smtos::Tet * tet = pTets[tidx];
+    int host = _tetHost(tidx);
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint ldidx = tet->compdef()->diffG2L(didx);
+    uint ldidx = _tetCompdef(tidx)->diffG2L(didx);
     if (ldidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4167,7 +4831,7 @@ bool smtos::TetOpSplitP::_getTetDiffActive(uint tidx, uint didx) const
         ArgErrLog(os.str());
     }
     bool active = false;
-    if (tet->getInHost()) {
+    if (tet != nullptr && tet->getInHost()) {
         if (tet->diff(ldidx)->inactive() == true) active = false;
         else active = true;
     }
@@ -4179,26 +4843,26 @@ bool smtos::TetOpSplitP::_getTetDiffActive(uint tidx, uint didx) const
 
 void smtos::TetOpSplitP::_setTetDiffActive(uint tidx, uint didx, bool act)
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(didx < statedef()->countDiffs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tet * tet = pTets[tidx];
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint ldidx = tet->compdef()->diffG2L(didx);
+    uint ldidx = _tetCompdef(tidx)->diffG2L(didx);
     if (ldidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
         os << "Diffusion rule undefined in tetrahedron.\n";
         ArgErrLog(os.str());
     }
-    if (!tet->getInHost()) return;
+    if (tet == nullptr || !tet->getInHost()) return;
     tet->diff(ldidx)->setActive(act);
 
     recomputeUpdPeriod = true;
@@ -4211,19 +4875,19 @@ void smtos::TetOpSplitP::_setTetDiffActive(uint tidx, uint didx, bool act)
 
 double smtos::TetOpSplitP::_getTetReacH(uint tidx, uint ridx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(ridx < statedef()->countReacs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
-    int host = tetHosts[tidx];
-    smtos::Tet * tet = pTets[tidx];
+    int host = _tetHost(tidx);
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lridx = tet->compdef()->reacG2L(ridx);
+    uint lridx = _tetCompdef(tidx)->reacG2L(ridx);
     if (lridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4231,7 +4895,7 @@ double smtos::TetOpSplitP::_getTetReacH(uint tidx, uint ridx) const
         ArgErrLog(os.str());
     }
     double h = 0;
-    if (tet->getInHost()) {
+    if (tet != nullptr && tet->getInHost()) {
         h = tet->reac(lridx)->h();
     }
     MPI_Bcast(&h, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
@@ -4242,19 +4906,19 @@ double smtos::TetOpSplitP::_getTetReacH(uint tidx, uint ridx) const
 
 double smtos::TetOpSplitP::_getTetReacC(uint tidx, uint ridx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(ridx < statedef()->countReacs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
-    int host = tetHosts[tidx];
-    smtos::Tet * tet = pTets[tidx];
+    int host = _tetHost(tidx);
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lridx = tet->compdef()->reacG2L(ridx);
+    uint lridx = _tetCompdef(tidx)->reacG2L(ridx);
     if (lridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4263,7 +4927,7 @@ double smtos::TetOpSplitP::_getTetReacC(uint tidx, uint ridx) const
     }
 
     double c = 0;
-    if (tet->getInHost()) {
+    if (tet != nullptr && tet->getInHost()) {
         c = tet->reac(lridx)->c();
     }
     MPI_Bcast(&c, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
@@ -4274,19 +4938,19 @@ double smtos::TetOpSplitP::_getTetReacC(uint tidx, uint ridx) const
 
 double smtos::TetOpSplitP::_getTetReacA(uint tidx, uint ridx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(ridx < statedef()->countReacs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
-    int host = tetHosts[tidx];
-    smtos::Tet * tet = pTets[tidx];
+    int host = _tetHost(tidx);
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint lridx = tet->compdef()->reacG2L(ridx);
+    uint lridx = _tetCompdef(tidx)->reacG2L(ridx);
     if (lridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4294,7 +4958,7 @@ double smtos::TetOpSplitP::_getTetReacA(uint tidx, uint ridx) const
         ArgErrLog(os.str());
     }
     double a = 0;
-    if (tet->getInHost()) {
+    if (tet != nullptr && tet->getInHost()) {
         a = tet->reac(lridx)->rate();
     }
     MPI_Bcast(&a, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
@@ -4305,19 +4969,19 @@ double smtos::TetOpSplitP::_getTetReacA(uint tidx, uint ridx) const
 
 double smtos::TetOpSplitP::_getTetDiffA(uint tidx, uint didx) const
 {
-    AssertLog(tidx < pTets.size());
+    AssertLog(tidx < _countTets());
     AssertLog(didx < statedef()->countDiffs());
 
-    if (pTets[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_tetCompdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
         ArgErrLog(os.str());
     }
-    int host = tetHosts[tidx];
-    smtos::Tet * tet = pTets[tidx];
+    int host = _tetHost(tidx);
+    smtos::Tet * tet = _globalTet(tidx);
 
-    uint ldidx = tet->compdef()->diffG2L(didx);
+    uint ldidx = _tetCompdef(tidx)->diffG2L(didx);
     if (ldidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4325,7 +4989,7 @@ double smtos::TetOpSplitP::_getTetDiffA(uint tidx, uint didx) const
         ArgErrLog(os.str());
     }
     double a = 0;
-    if (tet->getInHost()) {
+    if (tet != nullptr && tet->getInHost()) {
         a = tet->diff(ldidx)->rate();
     }
     MPI_Bcast(&a, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
@@ -4334,18 +4998,31 @@ double smtos::TetOpSplitP::_getTetDiffA(uint tidx, uint didx) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+uint smtos::TetOpSplitP::_countTris() const
+{
+    if (pDistMesh) return pGlobalTris;
+    return API::_countTris();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 double smtos::TetOpSplitP::_getTriArea(uint tidx) const
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
 
-    if (pTris[tidx] == 0)
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.";
         ArgErrLog(os.str());
     }
+    if (!pDistMesh) return mesh()->getTriArea(tidx);
 
-    return pTris[tidx]->area();
+    smtos::Tri * tri = _globalTri(tidx);
+    double local_area = (tri != nullptr) ? tri->area() : 0.0;
+    double area = 0.0;
+    MPI_Allreduce(&local_area, &area, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return area;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4359,13 +5036,12 @@ void smtos::TetOpSplitP::_setTriArea(uint tidx, double area)
 
 bool smtos::TetOpSplitP::_getTriSpecDefined(uint tidx, uint sidx) const
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(sidx < statedef()->countSpecs());
 
-    if (pTris[tidx] == 0) return false;
+    if (_triPatchdef(tidx) == nullptr) return false;
 
-    smtos::Tri * tri = pTris[tidx];
-    uint lsidx = tri->patchdef()->specG2L(sidx);
+    uint lsidx = _triPatchdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED) return false;
     else return true;
 }
@@ -4376,18 +5052,18 @@ bool smtos::TetOpSplitP::_getTriSpecDefined(uint tidx, uint sidx) const
 double smtos::TetOpSplitP::_getTriCount(uint tidx, uint sidx) const
 {
     MPI_Barrier(MPI_COMM_WORLD);
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(sidx < statedef()->countSpecs());
 
-    if (pTris[tidx] == 0)
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
-    uint lsidx = tri->patchdef()->specG2L(sidx);
+    smtos::Tri * tri = _globalTri(tidx);
+    uint lsidx = _triPatchdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4395,15 +5071,16 @@ double smtos::TetOpSplitP::_getTriCount(uint tidx, uint sidx) const
         ArgErrLog(os.str());
     }
 
-    uint count = tri->pools()[lsidx];
-    std::map<uint,uint>::const_iterator it = triHosts.find(tidx);
-    if (it == triHosts.end()) {
+    uint count = 0;
+    if (tri != nullptr && tri->getInHost()) count = tri->pools()[lsidx];
+    int host = _triHost(tidx);
+    if (host < 0) {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a host.\n";
         ArgErrLog(os.str());
     }
     
-    MPI_Bcast(&count, 1, MPI_UNSIGNED, it->second, MPI_COMM_WORLD);
+    MPI_Bcast(&count, 1, MPI_UNSIGNED, host, MPI_COMM_WORLD);
     MPI_Barrier(MPI_COMM_WORLD);
     return count;
 }
@@ -4413,11 +5090,11 @@ double smtos::TetOpSplitP::_getTriCount(uint tidx, uint sidx) const
 void smtos::TetOpSplitP::_setTriCount(uint tidx, uint sidx, double n)
 {
     MPI_Barrier(MPI_COMM_WORLD);
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(sidx < statedef()->countSpecs());
     AssertLog(n >= 0.0);
 
-    if (pTris[tidx] == 0)
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
@@ -4431,8 +5108,8 @@ void smtos::TetOpSplitP::_setTriCount(uint tidx, uint sidx, double n)
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
-    uint lsidx = tri->patchdef()->specG2L(sidx);
+    smtos::Tri * tri = _globalTri(tidx);
+    uint lsidx = _triPatchdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4455,8 +5132,11 @@ void smtos::TetOpSplitP::_setTriCount(uint tidx, uint sidx, double n)
 
     MPI_Bcast(&count, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
     
-    tri->setCount(lsidx, count);
-    _updateSpec(tri, sidx);
+    if (tri != nullptr)
+    {
+        tri->setCount(lsidx, count);
+        _updateSpec(tri, sidx);
+    }
     _updateSum();
     MPI_Barrier(MPI_COMM_WORLD);
 }
@@ -4486,19 +5166,19 @@ void smtos::TetOpSplitP::_setTriAmount(uint tidx, uint sidx, double m)
 
 bool smtos::TetOpSplitP::_getTriClamped(uint tidx, uint sidx) const
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(sidx < statedef()->countSpecs());
 
-    if (pTris[tidx] == 0)
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsidx = tri->patchdef()->specG2L(sidx);
+    uint lsidx = _triPatchdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4513,19 +5193,19 @@ bool smtos::TetOpSplitP::_getTriClamped(uint tidx, uint sidx) const
 
 void smtos::TetOpSplitP::_setTriClamped(uint tidx, uint sidx, bool buf)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(sidx < statedef()->countSpecs());
 
-    if (pTris[tidx] == 0)
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsidx = tri->patchdef()->specG2L(sidx);
+    uint lsidx = _triPatchdef(tidx)->specG2L(sidx);
     if (lsidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4533,26 +5213,26 @@ void smtos::TetOpSplitP::_setTriClamped(uint tidx, uint sidx, bool buf)
         ArgErrLog(os.str());
     }
 
-    tri->setClamped(lsidx, buf);
+    if (tri != nullptr) tri->setClamped(lsidx, buf);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 double smtos::TetOpSplitP::_getTriSReacK(uint tidx, uint ridx)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(ridx < statedef()->countSReacs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    uint host = triHosts[tidx];
-    smtos::Tri * tri = pTris[tidx];
+    uint host = _triHost(tidx);
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsridx = tri->patchdef()->sreacG2L(ridx);
+    uint lsridx = _triPatchdef(tidx)->sreacG2L(ridx);
     if (lsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4560,7 +5240,7 @@ double smtos::TetOpSplitP::_getTriSReacK(uint tidx, uint ridx)
         ArgErrLog(os.str());
     }
     double kcst = 0;
-    if (tri->getInHost()) {
+    if (tri != nullptr && tri->getInHost()) {
         kcst = tri->sreac(lsridx)->kcst();
     }
     MPI_Bcast(&kcst, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
@@ -4571,25 +5251,25 @@ double smtos::TetOpSplitP::_getTriSReacK(uint tidx, uint ridx)
 
 void smtos::TetOpSplitP::_setTriSReacK(uint tidx, uint ridx, double kf)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(ridx < statedef()->countSReacs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsridx = tri->patchdef()->sreacG2L(ridx);
+    uint lsridx = _triPatchdef(tidx)->sreacG2L(ridx);
     if (lsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
         os << "Surface reaction undefined in triangle.\n";
         ArgErrLog(os.str());
     }
-    if (!tri->getInHost()) return;
+    if (tri == nullptr || !tri->getInHost()) return;
     
     tri->sreac(lsridx)->setKcst(kf);
     _updateElement(tri->sreac(lsridx));
@@ -4601,19 +5281,19 @@ void smtos::TetOpSplitP::_setTriSReacK(uint tidx, uint ridx, double kf)
 
 bool smtos::TetOpSplitP::_getTriSReacActive(uint tidx, uint ridx)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(ridx < statedef()->countSReacs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    uint host = triHosts[tidx];
-    smtos::Tri * tri = pTris[tidx];
+    uint host = _triHost(tidx);
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsridx = tri->patchdef()->sreacG2L(ridx);
+    uint lsridx = _triPatchdef(tidx)->sreacG2L(ridx);
     if (lsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4621,7 +5301,7 @@ bool smtos::TetOpSplitP::_getTriSReacActive(uint tidx, uint ridx)
         ArgErrLog(os.str());
     }
     bool active = false;
-    if (tri->getInHost()) {
+    if (tri != nullptr && tri->getInHost()) {
         if (tri->sreac(lsridx)->inactive() == true)  active = false;
         else  active = true;
     }
@@ -4633,26 +5313,26 @@ bool smtos::TetOpSplitP::_getTriSReacActive(uint tidx, uint ridx)
 
 void smtos::TetOpSplitP::_setTriSReacActive(uint tidx, uint ridx, bool act)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(ridx < statedef()->countSReacs());
 
-    if (pTris[tidx] == 0 && tetHosts[tidx] == -1)
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsridx = tri->patchdef()->sreacG2L(ridx);
+    uint lsridx = _triPatchdef(tidx)->sreacG2L(ridx);
     if (lsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
         os << "Surface reaction undefined in triangle.\n";
         ArgErrLog(os.str());
     }
-    if (!tri->getInHost()) return;
+    if (tri == nullptr || !tri->getInHost()) return;
     tri->sreac(lsridx)->setActive(act);
     _updateElement(tri->sreac(lsridx));
     _updateSum();
@@ -4662,19 +5342,19 @@ void smtos::TetOpSplitP::_setTriSReacActive(uint tidx, uint ridx, bool act)
 
 double smtos::TetOpSplitP::_getTriSDiffD(uint tidx, uint didx, uint direction_tri)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(didx < statedef()->countSurfDiffs());
     
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    uint host = triHosts[tidx];
-    smtos::Tri * tri = pTris[tidx];
+    uint host = _triHost(tidx);
+    smtos::Tri * tri = _globalTri(tidx);
     
-    uint ldidx = tri->patchdef()->surfdiffG2L(didx);
+    uint ldidx = _triPatchdef(tidx)->surfdiffG2L(didx);
     if (ldidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4682,7 +5362,7 @@ double smtos::TetOpSplitP::_getTriSDiffD(uint tidx, uint didx, uint direction_tr
         ArgErrLog(os.str());
     }
     double dcst = 0.0;
-    if (tri->getInHost()) {
+    if (tri != nullptr && tri->getInHost()) {
         if (direction_tri == std::numeric_limits<uint>::max()) {
             dcst = tri->sdiff(ldidx)->dcst();
             
@@ -4706,19 +5386,19 @@ double smtos::TetOpSplitP::_getTriSDiffD(uint tidx, uint didx, uint direction_tr
 
 void smtos::TetOpSplitP::_setTriSDiffD(uint tidx, uint didx, double dk, uint direction_tri)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(didx < statedef()->countSurfDiffs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint ldidx = tri->patchdef()->surfdiffG2L(didx);
+    uint ldidx = _triPatchdef(tidx)->surfdiffG2L(didx);
     if (ldidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4726,7 +5406,7 @@ void smtos::TetOpSplitP::_setTriSDiffD(uint tidx, uint didx, double dk, uint dir
         ArgErrLog(os.str());
     }
     recomputeUpdPeriod = true;
-    if (!tri->getInHost()) return;
+    if (tri == nullptr || !tri->getInHost()) return;
     
     if (direction_tri == std::numeric_limits<uint>::max()) {
         tri->sdiff(ldidx)->setDcst(dk);
@@ -4750,19 +5430,19 @@ void smtos::TetOpSplitP::_setTriSDiffD(uint tidx, uint didx, double dk, uint dir
 
 bool smtos::TetOpSplitP::_getTriVDepSReacActive(uint tidx, uint vsridx)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(vsridx < statedef()->countVDepSReacs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    uint host = triHosts[tidx];
-    smtos::Tri * tri = pTris[tidx];
+    uint host = _triHost(tidx);
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lvsridx = tri->patchdef()->vdepsreacG2L(vsridx);
+    uint lvsridx = _triPatchdef(tidx)->vdepsreacG2L(vsridx);
     if (lvsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4770,7 +5450,7 @@ bool smtos::TetOpSplitP::_getTriVDepSReacActive(uint tidx, uint vsridx)
         ArgErrLog(os.str());
     }
     bool active = false;
-    if (tri->getInHost()) {
+    if (tri != nullptr && tri->getInHost()) {
         if (tri->vdepsreac(lvsridx)->inactive() == true)  active = false;
         else  active = true;
     }
@@ -4782,26 +5462,26 @@ bool smtos::TetOpSplitP::_getTriVDepSReacActive(uint tidx, uint vsridx)
 
 void smtos::TetOpSplitP::_setTriVDepSReacActive(uint tidx, uint vsridx, bool act)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(vsridx < statedef()->countVDepSReacs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    uint host = triHosts[tidx];
-    smtos::Tri * tri = pTris[tidx];
+    uint host = _triHost(tidx);
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lvsridx = tri->patchdef()->vdepsreacG2L(vsridx);
+    uint lvsridx = _triPatchdef(tidx)->vdepsreacG2L(vsridx);
     if (lvsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
         os << "Voltage-dependent surface reaction undefined in triangle.\n";
         ArgErrLog(os.str());
     }
-    if (!tri->getInHost()) return;
+    if (tri == nullptr || !tri->getInHost()) return;
     tri->vdepsreac(lvsridx)->setActive(act);
     _updateElement(tri->vdepsreac(lvsridx));
     _updateSum();
@@ -4811,19 +5491,19 @@ void smtos::TetOpSplitP::_setTriVDepSReacActive(uint tidx, uint vsridx, bool act
 
 double smtos::TetOpSplitP::_getTriSReacH(uint tidx, uint ridx)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(ridx < statedef()->countSReacs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    uint host = triHosts[tidx];
-    smtos::Tri * tri = pTris[tidx];
+    uint host = _triHost(tidx);
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsridx = tri->patchdef()->sreacG2L(ridx);
+    uint lsridx = _triPatchdef(tidx)->sreacG2L(ridx);
     if (lsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4831,7 +5511,7 @@ double smtos::TetOpSplitP::_getTriSReacH(uint tidx, uint ridx)
         ArgErrLog(os.str());
     }
     double h = 0;
-    if (tri->getInHost()) h = tri->sreac(lsridx)->h();
+    if (tri != nullptr && tri->getInHost()) h = tri->sreac(lsridx)->h();
     MPI_Bcast(&h, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
     return h;
 }
@@ -4840,19 +5520,19 @@ double smtos::TetOpSplitP::_getTriSReacH(uint tidx, uint ridx)
 
 double smtos::TetOpSplitP::_getTriSReacC(uint tidx, uint ridx)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(ridx < statedef()->countSReacs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    uint host = triHosts[tidx];
-    smtos::Tri * tri = pTris[tidx];
+    uint host = _triHost(tidx);
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsridx = tri->patchdef()->sreacG2L(ridx);
+    uint lsridx = _triPatchdef(tidx)->sreacG2L(ridx);
     if (lsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4861,7 +5541,7 @@ double smtos::TetOpSplitP::_getTriSReacC(uint tidx, uint ridx)
     }
 
     double c = 0;
-    if (tri->getInHost()) c = tri->sreac(lsridx)->c();
+    if (tri != nullptr && tri->getInHost()) c = tri->sreac(lsridx)->c();
     MPI_Bcast(&c, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
     return c;
 }
@@ -4870,19 +5550,19 @@ double smtos::TetOpSplitP::_getTriSReacC(uint tidx, uint ridx)
 
 double smtos::TetOpSplitP::_getTriSReacA(uint tidx, uint ridx)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(ridx < statedef()->countSReacs());
 
-    if (pTris[tidx] == 0 && triHosts.find(tidx) == triHosts.end())
+    if (_triPatchdef(tidx) == nullptr)
     {
         std::ostringstream os;
         os << "Triangle " << tidx << " has not been assigned to a patch.\n";
         ArgErrLog(os.str());
     }
-    uint host = triHosts[tidx];
-    smtos::Tri * tri = pTris[tidx];
+    uint host = _triHost(tidx);
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint lsridx = tri->patchdef()->sreacG2L(ridx);
+    uint lsridx = _triPatchdef(tidx)->sreacG2L(ridx);
     if (lsridx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -4891,7 +5571,7 @@ double smtos::TetOpSplitP::_getTriSReacA(uint tidx, uint ridx)
     }
 
     double a = 0;
-    if (tri->getInHost()) a =  tri->sreac(lsridx)->rate();
+    if (tri != nullptr && tri->getInHost()) a =  tri->sreac(lsridx)->rate();
     MPI_Bcast(&a, 1, MPI_DOUBLE, host, MPI_COMM_WORLD);
     return a;
 }
@@ -5099,7 +5779,7 @@ double smtos::TetOpSplitP::_getTriOhmicI(uint tidx)
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
 
     int loctidx = pEFTri_GtoL[tidx];
     if (loctidx == -1)
@@ -5108,9 +5788,9 @@ double smtos::TetOpSplitP::_getTriOhmicI(uint tidx)
         os << "Triangle index " << tidx << " not assigned to a membrane.";
         ArgErrLog(os.str());
     }
-    int tri_host = triHosts[tidx];
+    int tri_host = _triHost(tidx);
     double cur = 0.0;
-    if (tri->getInHost()) {
+    if (tri != nullptr && tri->getInHost()) {
         cur = tri->getOhmicI(EFTrisV[loctidx], efdt());
     }
     MPI_Bcast(&cur, 1, MPI_DOUBLE, tri_host, MPI_COMM_WORLD);
@@ -5121,7 +5801,7 @@ double smtos::TetOpSplitP::_getTriOhmicI(uint tidx)
 
 double smtos::TetOpSplitP::_getTriOhmicI(uint tidx, uint ocidx)
 {
-    AssertLog(tidx < pTris.size());
+    AssertLog(tidx < _countTris());
     AssertLog(ocidx < statedef()->countOhmicCurrs());
 
     int loctidx = pEFTri_GtoL[tidx];
@@ -5132,18 +5812,18 @@ double smtos::TetOpSplitP::_getTriOhmicI(uint tidx, uint ocidx)
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint locidx = tri->patchdef()->ohmiccurrG2L(ocidx);
+    uint locidx = _triPatchdef(tidx)->ohmiccurrG2L(ocidx);
     if (locidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
         os << "Ohmic current undefined in triangle.\n";
         ArgErrLog(os.str());
     }
-    int tri_host = triHosts[tidx];
+    int tri_host = _triHost(tidx);
     double cur = 0.0;
-    if (tri->getInHost()) {
+    if (tri != nullptr && tri->getInHost()) {
         cur = tri->getOhmicI(locidx, EFTrisV[loctidx], efdt());
     }
     MPI_Bcast(&cur, 1, MPI_DOUBLE, tri_host, MPI_COMM_WORLD);
@@ -5161,11 +5841,11 @@ double smtos::TetOpSplitP::_getTriGHKI(uint tidx)
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
     
-    int tri_host = triHosts[tidx];
+    int tri_host = _triHost(tidx);
     double cur = 0.0;
-    if (tri->getInHost()) {
+    if (tri != nullptr && tri->getInHost()) {
         cur = tri->getGHKI(efdt());
     }
     MPI_Bcast(&cur, 1, MPI_DOUBLE, tri_host, MPI_COMM_WORLD);
@@ -5183,9 +5863,9 @@ double smtos::TetOpSplitP::_getTriGHKI(uint tidx, uint ghkidx)
         ArgErrLog(os.str());
     }
 
-    smtos::Tri * tri = pTris[tidx];
+    smtos::Tri * tri = _globalTri(tidx);
 
-    uint locidx = tri->patchdef()->ghkcurrG2L(ghkidx);
+    uint locidx = _triPatchdef(tidx)->ghkcurrG2L(ghkidx);
     if (locidx == ssolver::LIDX_UNDEFINED)
     {
         std::ostringstream os;
@@ -5193,9 +5873,9 @@ double smtos::TetOpSplitP::_getTriGHKI(uint tidx, uint ghkidx)
         ArgErrLog(os.str());
     }
 
-    int tri_host = triHosts[tidx];
+    int tri_host = _triHost(tidx);
     double cur = 0.0;
-    if (tri->getInHost()) {
+    if (tri != nullptr && tri->getInHost()) {
         cur = tri->getGHKI(locidx, efdt());
     }
     MPI_Bcast(&cur, 1, MPI_DOUBLE, tri_host, MPI_COMM_WORLD);
@@ -5489,261 +6169,126 @@ void smtos::TetOpSplitP::_computeUpdPeriod()
     }
     updPeriod = 1.0 / global_max_rate;
     recomputeUpdPeriod = false;
+    _assignDiffLevels();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::_updateLocal(std::set<KProc*> const & upd_entries) {
-    for (auto kp : upd_entries) {
-        AssertLog(kp != NULL);
-        _updateElement(kp);
-    }
-    
-    _updateSum();
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void smtos::TetOpSplitP::_updateLocal(std::vector<KProc*> const & upd_entries) {
-    for (auto kp : upd_entries) {
-        AssertLog(kp != NULL);
-        _updateElement(kp);
-    }
-    
-    _updateSum();
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void smtos::TetOpSplitP::_updateLocal(std::vector<uint> const & upd_entries) {
-    for (auto upd_idx : upd_entries) {
-        KProc* kp = pKProcs[upd_idx];
-        if (kp != NULL)
-        {
-            _updateElement(kp);
-        }
-    }
-    
-    _updateSum();
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void smtos::TetOpSplitP::_updateLocal() {
-    for (uint i = 0; i < nEntries; i++) {
-        KProc* kp = pKProcs[i];
-        if (kp != NULL)
-        {
-            _updateElement(kp);
-        }
-    }
-    _updateSum();
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-smtos::CRGroup* smtos::TetOpSplitP::_getGroup(int pow) {
-    if (pow >= 0) {
-        return pGroups[pow];
-    }
-    else {
-        return nGroups[-pow];
-    }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void smtos::TetOpSplitP::_extendPGroups(uint new_size) {
-    uint curr_size = pGroups.size();
-
-    while (curr_size < new_size) {
-        pGroups.push_back(new CRGroup(curr_size));
-        curr_size ++;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void smtos::TetOpSplitP::_extendNGroups(uint new_size) {
-
-    uint curr_size = nGroups.size();
-
-    while (curr_size < new_size) {
-        nGroups.push_back(new CRGroup(-curr_size));
-        curr_size ++;
-    }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void smtos::TetOpSplitP::_extendGroup(CRGroup* group, uint size) {
-    group->capacity += size;
-    KProc** old_ptr = group->indices;
-    group->indices = (KProc**)realloc(group->indices,
-                                      sizeof(KProc*) * group->capacity);
-    if (group->indices == NULL) {
-        SysErrLog("DirectCR: unable to allocate memory for SSA group.");
-    }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-void smtos::TetOpSplitP::_updateSum() {
-    pA0 = 0.0;
-
-    uint n_neg_groups = nGroups.size();
-    uint n_pos_groups = pGroups.size();
-
-    for (uint i = 0; i < n_neg_groups; i++) {
-        pA0 += nGroups[i]->sum;
-    }
-
-    for (uint i = 0; i < n_pos_groups; i++) {
-        pA0 += pGroups[i]->sum;
-    }
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-
-void smtos::TetOpSplitP::_updateElement(KProc* kp)
+void smtos::TetOpSplitP::_assignDiffLevels()
 {
-    
-    if (kp->getType() == KP_DIFF || kp->getType() == KP_SDIFF) {
-        kp->crData.rate = kp->rate(this);
-        return;
-    }
-
-    double new_rate = kp->rate(this);
-
-    CRKProcData & data = kp->crData;
-    double old_rate = data.rate;
-
-    data.rate = new_rate;
-
-    if (old_rate == new_rate)  return;
-
-
-    // new rate in positive groups
-    if (new_rate >= 0.5) {
-
-        // pow is the same
-        int old_pow = data.pow;
-        int new_pow;
-        double temp = frexp(new_rate, &new_pow);
-
-        if (old_pow == new_pow && data.recorded) {
-
-            CRGroup* old_group = _getGroup(old_pow);
-
-            old_group->sum += (new_rate - old_rate);
-        }
-        // pow is not the same
-        else {
-            data.pow = new_pow;
+    // The level of a diffusion is the largest l < pDiffRateLevels with
+    // 2^l * updPeriod at most its own dwell time 1 / scaleddcst, so
+    // that the fraction diffused per application stays below one.
+    uint top = pDiffRateLevels - 1;
+    auto level = [this, top](double scaleddcst, bool active) {
+        if (!active || scaleddcst <= 0.0) return top;
+        double ratio = 1.0 / (updPeriod * scaleddcst);
+        uint l = 0;
+        while (l < top && std::ldexp(1.0, l + 1) <= ratio) l++;
+        return l;
+    };
 
+    uint local_bnd_level = pDiffRateLevels;
 
-            if (data.recorded) {
-
-                // remove old
-                CRGroup* old_group = _getGroup(old_pow);
-                (old_group->size) --;
-
-                if (old_group->size == 0) old_group->sum = 0.0;
-                else {
-                    old_group->sum -= old_rate;
-
-                    KProc* last = old_group->indices[old_group->size];
-                    old_group->indices[data.pos] = last;
-                    last->crData.pos = data.pos;
-                }
-            }
-
-            // add new
-            if (pGroups.size() <= new_pow) _extendPGroups(new_pow + 1);
-
-            CRGroup* new_group = pGroups[new_pow];
-
-            AssertLog(new_group != NULL);
-            if (new_group->size == new_group->capacity) _extendGroup(new_group);
-            uint pos = new_group->size;
-            new_group->indices[pos] = kp;
-            new_group->size++;
-            new_group->sum += new_rate;
-            data.pos = pos;
-
-        }
-        data.recorded = true;
-
+    pDiffLevel.resize(pDiffs.size());
+    for (uint pos = 0; pos < pDiffs.size(); pos++) {
+        Diff * d = pDiffs[pos];
+        pDiffLevel[pos] = level(d->getScaledDcst(), d->active());
+        diffusionElement(d)->setPoolLevel(d->getLigLidx(), pDiffLevel[pos]);
+        if (pos < diffBndSep && d->active()) local_bnd_level = std::min<uint>(local_bnd_level, pDiffLevel[pos]);
+    }
+    pSDiffLevel.resize(pSDiffs.size());
+    for (uint pos = 0; pos < pSDiffs.size(); pos++) {
+        SDiff * d = pSDiffs[pos];
+        pSDiffLevel[pos] = level(d->getScaledDcst(), d->active());
+        diffusionElement(d)->setPoolLevel(d->getLigLidx(), pSDiffLevel[pos]);
+        if (pos < sdiffBndSep && d->active()) local_bnd_level = std::min<uint>(local_bnd_level, pSDiffLevel[pos]);
     }
-    // new rate in negative group
-    else if (new_rate < 0.5 && new_rate > 1e-20) {
-        int old_pow = data.pow;
-        int new_pow;
-        double temp = frexp(new_rate, &new_pow);
-
-        if (old_pow == new_pow && data.recorded) {
-
-            CRGroup* old_group = _getGroup(old_pow);
 
-            old_group->sum += (new_rate - old_rate);
-        }
-        // pow is not the same
-        else {
-            data.pow = new_pow;
+    MPI_Allreduce(&local_bnd_level, &pBndDiffLevel, 1, MPI_UNSIGNED, MPI_MIN, MPI_COMM_WORLD);
+}
 
-            if (data.recorded) {
-                CRGroup* old_group = _getGroup(old_pow);
-                (old_group->size) --;
+////////////////////////////////////////////////////////////////////////////////
 
-                if (old_group->size == 0) old_group->sum = 0.0;
-                else {
-                    old_group->sum -= old_rate;
+void smtos::TetOpSplitP::setDiffusionRateLevels(uint nlevels)
+{
+    if (nlevels == 0 || nlevels > 16)
+    {
+        std::ostringstream os;
+        os << "Number of diffusion rate levels must be between 1 and 16.\n";
+        ArgErrLog(os.str());
+    }
+    pDiffRateLevels = nlevels;
+    recomputeUpdPeriod = true;
+}
 
-                    KProc* last = old_group->indices[old_group->size];
-                    old_group->indices[data.pos] = last;
-                    last->crData.pos = data.pos;
-                }
-            }
+////////////////////////////////////////////////////////////////////////////////
 
-            // add new
+void smtos::TetOpSplitP::_updateLocal(std::set<KProc*> const & upd_entries) {
+    for (auto kp : upd_entries) {
+        AssertLog(kp != NULL);
+        _updateElement(kp);
+    }
+    
+    _updateSum();
+}
 
-            if (nGroups.size() <= -new_pow) _extendNGroups(-new_pow + 1);
+////////////////////////////////////////////////////////////////////////////////
 
-            CRGroup* new_group = nGroups[-new_pow];
+void smtos::TetOpSplitP::_updateLocal(std::vector<KProc*> const & upd_entries) {
+    for (auto kp : upd_entries) {
+        AssertLog(kp != NULL);
+        _updateElement(kp);
+    }
+    
+    _updateSum();
+}
 
-            if (new_group->size == new_group->capacity) _extendGroup(new_group);
-            uint pos = new_group->size;
-            new_group->indices[pos] = kp;
-            new_group->size++;
-            new_group->sum += new_rate;
-            data.pos = pos;
+////////////////////////////////////////////////////////////////////////////////
 
+void smtos::TetOpSplitP::_updateLocal(std::vector<uint> const & upd_entries) {
+    for (auto upd_idx : upd_entries) {
+        KProc* kp = pKProcs[upd_idx];
+        if (kp != NULL)
+        {
+            _updateElement(kp);
         }
-        data.recorded = true;
     }
+    
+    _updateSum();
+}
 
-    else {
+////////////////////////////////////////////////////////////////////////////////
 
-        if (data.recorded) {
+void smtos::TetOpSplitP::_updateLocal() {
+    for (uint i = 0; i < nEntries; i++) {
+        KProc* kp = pKProcs[i];
+        if (kp != NULL)
+        {
+            _updateElement(kp);
+        }
+    }
+    _updateSum();
+}
 
-            CRGroup* old_group = _getGroup(data.pow);
+////////////////////////////////////////////////////////////////////////////////
 
-            // remove old
-            old_group->size --;
+void smtos::TetOpSplitP::_updateSum() {
+    pA0 = pCRSched.getA0();
+}
 
-            if (old_group->size == 0) old_group->sum = 0.0;
-            else {
-                old_group->sum -= old_rate;
+////////////////////////////////////////////////////////////////////////////////
 
-                KProc* last = old_group->indices[old_group->size];
-                old_group->indices[data.pos] = last;
-                last->crData.pos = data.pos;
-            }
-        }
-        data.recorded = false;
+void smtos::TetOpSplitP::_updateElement(KProc* kp)
+{
+    // Diffusions are handled by the operator-split diffusion step and
+    // only need their rate kept current.
+    if (kp->getType() == KP_DIFF || kp->getType() == KP_SDIFF) {
+        _setDiffRate(kp, kp->rate(this));
+        return;
     }
 
+    pCRSched.update(kp, kp->rate(this));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -5766,32 +6311,33 @@ std::vector<double> smtos::TetOpSplitP::getBatchTetCounts(std::vector<uint> cons
     std::vector<double> local_counts(ntets, 0.0);
     std::vector<double> global_counts(ntets, 0.0);
 
+    std::vector<ssolver::Compdef *> cdefs = _tetCompdefs(tets.data(), ntets);
     for (uint t = 0; t < ntets; t++) {
         uint tidx = tets[t];
 
-        if (tidx >= pTets.size())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
 
-        if (pTets[tidx] == 0)
+        if (cdefs[t] == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
 
-        smtos::Tet * tet = pTets[tidx];
-        uint slidx = tet->compdef()->specG2L(sgidx);
+        smtos::Tet * tet = _globalTet(tidx);
+        uint slidx = cdefs[t]->specG2L(sgidx);
         if (slidx == ssolver::LIDX_UNDEFINED)
         {
             spec_undefined << tidx << " ";
             has_spec_warning = true;
             continue;
         }
-        if (tet->getInHost()) {
+        if (tet != nullptr && tet->getInHost()) {
             local_counts[t] = tet->pools()[slidx];
         }
         
@@ -5824,32 +6370,33 @@ std::vector<double> smtos::TetOpSplitP::getBatchTriCounts(std::vector<uint> cons
     uint sgidx = statedef()->getSpecIdx(s);
     std::vector<double> local_counts(ntris, 0.0);
     std::vector<double> global_counts(ntris, 0.0);
+    std::vector<ssolver::Patchdef *> pdefs = _triPatchdefs(tris.data(), ntris);
     for (uint t = 0; t < ntris; t++) {
         uint tidx = tris[t];
 
-        if (tidx >= pTris.size())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
 
-        if (pTris[tidx] == 0)
+        if (pdefs[t] == nullptr)
         {
             tri_not_assign << tidx << " ";
             has_tri_warning = true;
             continue;
         }
 
-        smtos::Tri * tri = pTris[tidx];
-        uint slidx = tri->patchdef()->specG2L(sgidx);
+        smtos::Tri * tri = _globalTri(tidx);
+        uint slidx = pdefs[t]->specG2L(sgidx);
         if (slidx == ssolver::LIDX_UNDEFINED)
         {
             spec_undefined << tidx << " ";
             has_spec_warning = true;
             continue;
         }
-        if (tri->getInHost()) {
+        if (tri != nullptr && tri->getInHost()) {
             local_counts[t] = tri->pools()[slidx];
         }
         
@@ -5888,25 +6435,26 @@ void smtos::TetOpSplitP::getBatchTetCountsNP(unsigned int* indices, int input_si
     
     uint sgidx = statedef()->getSpecIdx(s);
 
+    std::vector<ssolver::Compdef *> cdefs = _tetCompdefs(indices, input_size);
     for (int t = 0; t < input_size; t++) {
         uint tidx = indices[t];
 
-        if (tidx >= pTets.size())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
 
-        if (pTets[tidx] == 0)
+        if (cdefs[t] == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
 
-        smtos::Tet * tet = pTets[tidx];
-        uint slidx = tet->compdef()->specG2L(sgidx);
+        smtos::Tet * tet = _globalTet(tidx);
+        uint slidx = cdefs[t]->specG2L(sgidx);
         if (slidx == ssolver::LIDX_UNDEFINED)
         {
             spec_undefined << tidx << " ";
@@ -5914,7 +6462,7 @@ void smtos::TetOpSplitP::getBatchTetCountsNP(unsigned int* indices, int input_si
             continue;
         }
         
-        if (tet->getInHost()) {
+        if (tet != nullptr && tet->getInHost()) {
             local_counts[t] = tet->pools()[slidx];
         }
         
@@ -5951,32 +6499,33 @@ void smtos::TetOpSplitP::getBatchTriCountsNP(unsigned int* indices, int input_si
 
     uint sgidx = statedef()->getSpecIdx(s);
     std::vector<double> local_counts(input_size, 0.0);
+    std::vector<ssolver::Patchdef *> pdefs = _triPatchdefs(indices, input_size);
     for (int t = 0; t < input_size; t++) {
         uint tidx = indices[t];
 
-        if (tidx >= pTris.size())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
 
-        if (pTris[tidx] == 0)
+        if (pdefs[t] == nullptr)
         {
             tri_not_assign << tidx << " ";
             has_tri_warning = true;
             continue;
         }
 
-        smtos::Tri * tri = pTris[tidx];
-        uint slidx = tri->patchdef()->specG2L(sgidx);
+        smtos::Tri * tri = _globalTri(tidx);
+        uint slidx = pdefs[t]->specG2L(sgidx);
         if (slidx == ssolver::LIDX_UNDEFINED)
         {
             spec_undefined << tidx << " ";
             has_spec_warning = true;
             continue;
         }
-        if (tri->getInHost()) {
+        if (tri != nullptr && tri->getInHost()) {
             local_counts[t] = tri->pools()[slidx];
         }
         
@@ -6004,25 +6553,26 @@ double smtos::TetOpSplitP::sumBatchTetCountsNP(unsigned int* indices, int input_
     
     uint sgidx = statedef()->getSpecIdx(s);
     double partial_sum = 0.0;
+    std::vector<ssolver::Compdef *> cdefs = _tetCompdefs(indices, input_size);
     for (int t = 0; t < input_size; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (cdefs[t] == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint slidx = tet->compdef()->specG2L(sgidx);
+        smtos::Tet * tet = _globalTet(tidx);
+        uint slidx = cdefs[t]->specG2L(sgidx);
         if (slidx == ssolver::LIDX_UNDEFINED)
         {
             spec_undefined << tidx << " ";
@@ -6030,7 +6580,7 @@ double smtos::TetOpSplitP::sumBatchTetCountsNP(unsigned int* indices, int input_
             continue;
         }
         
-        if (tet->getInHost()) {
+        if (tet != nullptr && tet->getInHost()) {
             partial_sum += tet->pools()[slidx];
         }
     }
@@ -6061,140 +6611,416 @@ double smtos::TetOpSplitP::sumBatchTriCountsNP(unsigned int* indices, int input_
     double partial_sum = 0.0;
     uint sgidx = statedef()->getSpecIdx(s);
     
+    std::vector<ssolver::Patchdef *> pdefs = _triPatchdefs(indices, input_size);
     for (int t = 0; t < input_size; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTris.size())
+        if (tidx >= _countTris())
+        {
+            std::ostringstream os;
+            os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
+            ArgErrLog(os.str());
+        }
+        
+        if (pdefs[t] == nullptr)
+        {
+            tri_not_assign << tidx << " ";
+            has_tri_warning = true;
+            continue;
+        }
+        
+        smtos::Tri * tri = _globalTri(tidx);
+        uint slidx = pdefs[t]->specG2L(sgidx);
+        if (slidx == ssolver::LIDX_UNDEFINED)
+        {
+            spec_undefined << tidx << " ";
+            has_spec_warning = true;
+            continue;
+        }
+        if (tri != nullptr && tri->getInHost()) {
+            partial_sum += tri->pools()[slidx];
+        }
+    }
+    
+    if (has_tri_warning) {
+        CLOG(WARNING, "general_log") << "The following triangles have not been assigned to a patch, fill in zeros at target positions:\n";
+        CLOG(WARNING, "general_log") << tri_not_assign.str() << "\n";
+    }
+    
+    if (has_spec_warning) {
+        CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following triangles, fill in zeros at target positions:\n";
+        CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
+    }
+    
+    double global_sum = 0.0;
+    MPI_Allreduce(&partial_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return global_sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double smtos::TetOpSplitP::sumBatchTriGHKIsNP(unsigned int* indices, int input_size, std::string const & ghk)
+{
+    if (efflag() != true)
+    {
+        std::ostringstream os;
+        os << "Method not available: EField calculation not included in simulation.";
+        ArgErrLog(os.str());
+    }
+    // the following may raise exception if string is unknown
+    uint ghkidx = statedef()->getGHKcurrIdx(ghk);
+    
+    
+    double partial_sum = 0.0;
+    
+    std::vector<ssolver::Patchdef *> pdefs = _triPatchdefs(indices, input_size);
+    for (uint t = 0; t < input_size; t++) {
+        uint tidx = indices[t];
+        
+        if (tidx >= _countTris())
+        {
+            std::ostringstream os;
+            os << "Triangle index out of range.";
+            ArgErrLog(os.str());
+        }
+        
+        smtos::Tri * tri = _globalTri(tidx);
+        
+        uint locidx = pdefs[t]->ghkcurrG2L(ghkidx);
+        if (locidx == ssolver::LIDX_UNDEFINED)
+        {
+            std::ostringstream os;
+            os << "GHK current undefined in triangle.\n";
+            ArgErrLog(os.str());
+        }
+        
+        if (tri != nullptr && tri->getInHost()) {
+            partial_sum += tri->getGHKI(locidx, efdt());
+        }
+    }
+    double global_sum = 0.0;
+    MPI_Allreduce(&partial_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return global_sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double smtos::TetOpSplitP::sumBatchTriOhmicIsNP(unsigned int* indices, int input_size, std::string const & oc)
+{
+    if (efflag() != true)
+    {
+        std::ostringstream os;
+        os << "Method not available: EField calculation not included in simulation.";
+        ArgErrLog(os.str());
+    }
+    
+    // the following may raise exception if string is unknown
+    uint ocidx = statedef()->getOhmicCurrIdx(oc);
+    
+    
+    double partial_sum = 0.0;
+    
+    std::vector<ssolver::Patchdef *> pdefs = _triPatchdefs(indices, input_size);
+    for (uint t = 0; t < input_size; t++) {
+        uint tidx = indices[t];
+        int loctidx = pEFTri_GtoL[tidx];
+        if (tidx >= _countTris())
+        {
+            std::ostringstream os;
+            os << "Triangle index out of range.";
+            ArgErrLog(os.str());
+        }
+        
+        smtos::Tri * tri = _globalTri(tidx);
+        
+        uint locidx = pdefs[t]->ohmiccurrG2L(ocidx);
+        if (locidx == ssolver::LIDX_UNDEFINED)
+        {
+            std::ostringstream os;
+            os << "Ohmic current undefined in triangle.\n";
+            ArgErrLog(os.str());
+        }
+        
+        if (tri != nullptr && tri->getInHost()) {
+            partial_sum += tri->getOhmicI(locidx, EFTrisV[loctidx], efdt());
+        }
+    }
+    double global_sum = 0.0;
+    MPI_Allreduce(&partial_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    return global_sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint smtos::TetOpSplitP::addTetCountObservable(std::vector<uint> const & tets, std::string const & s)
+{
+    return _addObservable(tets, s, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint smtos::TetOpSplitP::addTriCountObservable(std::vector<uint> const & tris, std::string const & s)
+{
+    return _addObservable(tris, s, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint smtos::TetOpSplitP::_addObservable(std::vector<uint> const & elems, std::string const & s, bool on_tris)
+{
+    if (!pObsPendingTimes.empty())
+    {
+        std::ostringstream os;
+        os << "Cannot add an observable while samples are buffered, ";
+        os << "call flushObservables() first.\n";
+        ArgErrLog(os.str());
+    }
+
+    uint nelems = on_tris ? _countTris() : _countTets();
+    for (uint idx : elems)
+    {
+        if (idx >= nelems)
+        {
+            std::ostringstream os;
+            os << "Error (Index Overbound): There is no ";
+            os << (on_tris ? "triangle" : "tetrahedron") << " with index " << idx << ".\n";
+            ArgErrLog(os.str());
+        }
+    }
+
+    Observable obs;
+    obs.onTris = on_tris;
+    // the following may raise exception if string is unknown
+    obs.sgidx = statedef()->getSpecIdx(s);
+    obs.elems = elems;
+    _setupObservable(obs);
+
+    // Samples flushed before this observable existed have no data for it.
+    if (myRank == 0) obs.data.assign(pObsTimes.size() * elems.size(), 0.0);
+    obs.localData.assign(pObsTimes.size() * obs.localPos.size(), 0.0);
+
+    pObservables.push_back(obs);
+    return pObservables.size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_setupObservable(Observable & obs)
+{
+    obs.localPos.clear();
+    obs.localLidx.clear();
+
+    // Unassigned elements and elements without the species are left out
+    // and read as zero, as in the batch getters.
+    uint nelems = obs.elems.size();
+    for (uint k = 0; k < nelems; k++)
+    {
+        uint idx = obs.elems[k];
+        uint lidx = ssolver::LIDX_UNDEFINED;
+        if (obs.onTris)
+        {
+            smtos::Tri * tri = _globalTri(idx);
+            if (tri == 0 || !tri->getInHost()) continue;
+            lidx = tri->patchdef()->specG2L(obs.sgidx);
+        }
+        else
+        {
+            smtos::Tet * tet = _globalTet(idx);
+            if (tet == 0 || !tet->getInHost()) continue;
+            lidx = tet->compdef()->specG2L(obs.sgidx);
+        }
+        if (lidx == ssolver::LIDX_UNDEFINED) continue;
+
+        obs.localPos.push_back(k);
+        obs.localLidx.push_back(lidx);
+    }
+
+    int nlocal = obs.localPos.size();
+    obs.rankCounts.assign(myRank == 0 ? nHosts : 0, 0);
+    MPI_Gather(&nlocal, 1, MPI_INT, obs.rankCounts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (myRank == 0)
+    {
+        obs.rankDispls.assign(nHosts, 0);
+        for (int r = 1; r < nHosts; r++) obs.rankDispls[r] = obs.rankDispls[r - 1] + obs.rankCounts[r - 1];
+        obs.rankPos.assign(obs.rankDispls[nHosts - 1] + obs.rankCounts[nHosts - 1], 0);
+    }
+    else
+    {
+        obs.rankDispls.clear();
+        obs.rankPos.clear();
+    }
+    MPI_Gatherv(obs.localPos.data(), nlocal, MPI_UNSIGNED, obs.rankPos.data(),
+        obs.rankCounts.data(), obs.rankDispls.data(), MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::recordObservables()
+{
+    pObsPendingTimes.push_back(statedef()->time());
+
+    for (auto const & obs : pObservables)
+    {
+        uint nlocal = obs.localPos.size();
+        for (uint i = 0; i < nlocal; i++)
+        {
+            uint idx = obs.elems[obs.localPos[i]];
+            uint * pools = obs.onTris ? _globalTri(idx)->pools() : _globalTet(idx)->pools();
+            pObsBuffer.push_back(pools[obs.localLidx[i]]);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::runAndRecord(std::vector<double> const & times)
+{
+    for (double t : times)
+    {
+        if (t < statedef()->time())
+        {
+            std::ostringstream os;
+            os << "Recording time " << t << " is before the current simulation time.\n";
+            ArgErrLog(os.str());
+        }
+        run(t);
+        recordObservables();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::flushObservables(bool rank_local)
+{
+    uint nsamples = pObsPendingTimes.size();
+
+    if (rank_local)
+    {
+        uint pos = 0;
+        for (uint s = 0; s < nsamples; s++)
         {
-            std::ostringstream os;
-            os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
-            ArgErrLog(os.str());
+            for (auto & obs : pObservables)
+            {
+                uint nlocal = obs.localPos.size();
+                obs.localData.insert(obs.localData.end(),
+                    pObsBuffer.begin() + pos, pObsBuffer.begin() + pos + nlocal);
+                pos += nlocal;
+            }
         }
-        
-        if (pTris[tidx] == 0)
+    }
+    else
+    {
+        // Every rank buffers the same number of samples, so rank 0 knows
+        // the layout of each contribution from the registered ownership.
+        std::vector<int> counts;
+        std::vector<int> displs;
+        std::vector<double> recv;
+        if (myRank == 0)
         {
-            tri_not_assign << tidx << " ";
-            has_tri_warning = true;
-            continue;
+            counts.assign(nHosts, 0);
+            displs.assign(nHosts, 0);
+            for (auto const & obs : pObservables)
+            {
+                for (int r = 0; r < nHosts; r++) counts[r] += nsamples * obs.rankCounts[r];
+            }
+            for (int r = 1; r < nHosts; r++) displs[r] = displs[r - 1] + counts[r - 1];
+            recv.resize(displs[nHosts - 1] + counts[nHosts - 1]);
         }
-        
-        smtos::Tri * tri = pTris[tidx];
-        uint slidx = tri->patchdef()->specG2L(sgidx);
-        if (slidx == ssolver::LIDX_UNDEFINED)
+
+        MPI_Gatherv(pObsBuffer.data(), pObsBuffer.size(), MPI_DOUBLE, recv.data(),
+            counts.data(), displs.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+        if (myRank == 0)
         {
-            spec_undefined << tidx << " ";
-            has_spec_warning = true;
-            continue;
-        }
-        if (tri->getInHost()) {
-            partial_sum += tri->pools()[slidx];
+            uint base = pObsTimes.size();
+            for (auto & obs : pObservables)
+            {
+                obs.data.resize((base + nsamples) * obs.elems.size(), 0.0);
+            }
+
+            uint pos = 0;
+            for (int r = 0; r < nHosts; r++)
+            {
+                for (uint s = 0; s < nsamples; s++)
+                {
+                    for (auto & obs : pObservables)
+                    {
+                        uint nelems = obs.elems.size();
+                        uint first = obs.rankDispls[r];
+                        uint last = first + obs.rankCounts[r];
+                        double * row = &obs.data[(base + s) * nelems];
+                        for (uint k = first; k < last; k++) row[obs.rankPos[k]] = recv[pos++];
+                    }
+                }
+            }
         }
     }
-    
-    if (has_tri_warning) {
-        CLOG(WARNING, "general_log") << "The following triangles have not been assigned to a patch, fill in zeros at target positions:\n";
-        CLOG(WARNING, "general_log") << tri_not_assign.str() << "\n";
-    }
-    
-    if (has_spec_warning) {
-        CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following triangles, fill in zeros at target positions:\n";
-        CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
+
+    pObsFlushLocal = rank_local;
+    pObsTimes.insert(pObsTimes.end(), pObsPendingTimes.begin(), pObsPendingTimes.end());
+    // keep both layouts row-aligned with the times, samples flushed the
+    // other way read zero
+    for (auto & obs : pObservables)
+    {
+        if (myRank == 0) obs.data.resize(pObsTimes.size() * obs.elems.size(), 0.0);
+        obs.localData.resize(pObsTimes.size() * obs.localPos.size(), 0.0);
     }
-    
-    double global_sum = 0.0;
-    MPI_Allreduce(&partial_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-    return global_sum;
+    pObsPendingTimes.clear();
+    pObsBuffer.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-double smtos::TetOpSplitP::sumBatchTriGHKIsNP(unsigned int* indices, int input_size, std::string const & ghk)
+std::vector<double> smtos::TetOpSplitP::getObservableData(uint obs) const
 {
-    if (efflag() != true)
+    if (obs >= pObservables.size())
     {
         std::ostringstream os;
-        os << "Method not available: EField calculation not included in simulation.";
+        os << "Error (Index Overbound): There is no observable with index " << obs << ".\n";
         ArgErrLog(os.str());
     }
-    // the following may raise exception if string is unknown
-    uint ghkidx = statedef()->getGHKcurrIdx(ghk);
-    
-    
-    double partial_sum = 0.0;
-    
-    for (uint t = 0; t < input_size; t++) {
-        uint tidx = indices[t];
-        
-        if (tidx >= mesh()->countTris())
-        {
-            std::ostringstream os;
-            os << "Triangle index out of range.";
-            ArgErrLog(os.str());
-        }
-        
-        smtos::Tri * tri = pTris[tidx];
-        
-        uint locidx = tri->patchdef()->ghkcurrG2L(ghkidx);
-        if (locidx == ssolver::LIDX_UNDEFINED)
-        {
-            std::ostringstream os;
-            os << "GHK current undefined in triangle.\n";
-            ArgErrLog(os.str());
-        }
-        
-        if (tri->getInHost()) {
-            partial_sum += tri->getGHKI(locidx, efdt());
-        }
+    return pObservables[obs].data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint> smtos::TetOpSplitP::getObservableLocalPositions(uint obs) const
+{
+    if (obs >= pObservables.size())
+    {
+        std::ostringstream os;
+        os << "Error (Index Overbound): There is no observable with index " << obs << ".\n";
+        ArgErrLog(os.str());
     }
-    double global_sum = 0.0;
-    MPI_Allreduce(&partial_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-    return global_sum;
+    return pObservables[obs].localPos;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-double smtos::TetOpSplitP::sumBatchTriOhmicIsNP(unsigned int* indices, int input_size, std::string const & oc)
+std::vector<double> smtos::TetOpSplitP::getObservableLocalData(uint obs) const
 {
-    if (efflag() != true)
+    if (obs >= pObservables.size())
     {
         std::ostringstream os;
-        os << "Method not available: EField calculation not included in simulation.";
+        os << "Error (Index Overbound): There is no observable with index " << obs << ".\n";
         ArgErrLog(os.str());
     }
-    
-    // the following may raise exception if string is unknown
-    uint ocidx = statedef()->getOhmicCurrIdx(oc);
-    
-    
-    double partial_sum = 0.0;
-    
-    for (uint t = 0; t < input_size; t++) {
-        uint tidx = indices[t];
-        int loctidx = pEFTri_GtoL[tidx];
-        if (tidx >= mesh()->countTris())
-        {
-            std::ostringstream os;
-            os << "Triangle index out of range.";
-            ArgErrLog(os.str());
-        }
-        
-        smtos::Tri * tri = pTris[tidx];
-        
-        uint locidx = tri->patchdef()->ohmiccurrG2L(ocidx);
-        if (locidx == ssolver::LIDX_UNDEFINED)
-        {
-            std::ostringstream os;
-            os << "Ohmic current undefined in triangle.\n";
-            ArgErrLog(os.str());
-        }
-        
-        if (tri->getInHost()) {
-            partial_sum += tri->getOhmicI(locidx, EFTrisV[loctidx], efdt());
-        }
+    return pObservables[obs].localData;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::clearObservableData()
+{
+    for (auto & obs : pObservables)
+    {
+        obs.data.clear();
+        obs.localData.clear();
     }
-    double global_sum = 0.0;
-    MPI_Allreduce(&partial_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-    return global_sum;
+    pObsTimes.clear();
+    pObsPendingTimes.clear();
+    pObsBuffer.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -6207,6 +7033,7 @@ double smtos::TetOpSplitP::sumBatchTriOhmicIsNP(unsigned int* indices, int input
 
 std::vector<double> smtos::TetOpSplitP::getROITetCounts(std::string ROI_id, std::string const & s) const
 {
+    _requireReplicatedMesh("getROITetCounts");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TET)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6221,6 +7048,7 @@ std::vector<double> smtos::TetOpSplitP::getROITetCounts(std::string ROI_id, std:
 
 std::vector<double> smtos::TetOpSplitP::getROITriCounts(std::string ROI_id, std::string const & s) const
 {
+    _requireReplicatedMesh("getROITriCounts");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TRI)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6235,6 +7063,7 @@ std::vector<double> smtos::TetOpSplitP::getROITriCounts(std::string ROI_id, std:
 
 void smtos::TetOpSplitP::getROITetCountsNP(std::string ROI_id, std::string const & s, double* counts, int output_size) const
 {
+    _requireReplicatedMesh("getROITetCountsNP");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TET)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6247,6 +7076,7 @@ void smtos::TetOpSplitP::getROITetCountsNP(std::string ROI_id, std::string const
 
 void smtos::TetOpSplitP::getROITriCountsNP(std::string ROI_id, std::string const & s, double* counts, int output_size) const
 {
+    _requireReplicatedMesh("getROITriCountsNP");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TRI)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6259,6 +7089,7 @@ void smtos::TetOpSplitP::getROITriCountsNP(std::string ROI_id, std::string const
 
 double smtos::TetOpSplitP::getROIVol(std::string ROI_id) const
 {
+    _requireReplicatedMesh("getROIVol");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TET)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6266,7 +7097,7 @@ double smtos::TetOpSplitP::getROIVol(std::string ROI_id) const
     
     double sum = 0.0;
     for (uint t = 0; t < datasize; t++) {
-        sum += pTets[indices[t]]->vol();
+        sum += mesh()->getTetVol(indices[t]);
     }
     return sum;
 }
@@ -6275,6 +7106,7 @@ double smtos::TetOpSplitP::getROIVol(std::string ROI_id) const
 
 double smtos::TetOpSplitP::getROIArea(std::string ROI_id) const
 {
+    _requireReplicatedMesh("getROIArea");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TRI)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6282,7 +7114,7 @@ double smtos::TetOpSplitP::getROIArea(std::string ROI_id) const
     
     double sum = 0.0;
     for (uint t = 0; t < datasize; t++) {
-        sum += pTris[indices[t]]->area();
+        sum += mesh()->getTriArea(indices[t]);
     }
     return sum;
 }
@@ -6291,6 +7123,7 @@ double smtos::TetOpSplitP::getROIArea(std::string ROI_id) const
 
 double smtos::TetOpSplitP::getROICount(std::string ROI_id, std::string const & s) const
 {
+    _requireReplicatedMesh("getROICount");
     steps::tetmesh::ElementType type = mesh()->getROIType(ROI_id);
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6309,22 +7142,22 @@ double smtos::TetOpSplitP::getROICount(std::string ROI_id, std::string const & s
         for (uint t = 0; t < datasize; t++) {
             uint tidx = indices[t];
             
-            if (tidx >= pTris.size())
+            if (tidx >= mesh()->countTris())
             {
                 std::ostringstream os;
                 os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
                 ArgErrLog(os.str());
             }
             
-            if (pTris[tidx] == 0)
+            if (_triPatchdef(tidx) == nullptr)
             {
                 tri_not_assign << tidx << " ";
                 has_tri_warning = true;
                 continue;
             }
             
-            smtos::Tri * tri = pTris[tidx];
-            uint slidx = tri->patchdef()->specG2L(sgidx);
+            smtos::Tri * tri = _tri(tidx);
+            uint slidx = _triPatchdef(tidx)->specG2L(sgidx);
             if (slidx == ssolver::LIDX_UNDEFINED)
             {
                 spec_undefined << tidx << " ";
@@ -6333,7 +7166,7 @@ double smtos::TetOpSplitP::getROICount(std::string ROI_id, std::string const & s
             }
             
             // compute local sum for each process
-            if (tri->getInHost()) local_sum += tri->pools()[slidx];
+            if (tri != nullptr && tri->getInHost()) local_sum += tri->pools()[slidx];
         }
         
         // gather global sum
@@ -6361,22 +7194,22 @@ double smtos::TetOpSplitP::getROICount(std::string ROI_id, std::string const & s
         for (uint t = 0; t < datasize; t++) {
             uint tidx = indices[t];
             
-            if (tidx >= pTets.size())
+            if (tidx >= mesh()->countTets())
             {
                 std::ostringstream os;
                 os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
                 ArgErrLog(os.str());
             }
             
-            if (pTets[tidx] == 0)
+            if (_tetCompdef(tidx) == nullptr)
             {
                 tet_not_assign << tidx << " ";
                 has_tet_warning = true;
                 continue;
             }
             
-            smtos::Tet * tet = pTets[tidx];
-            uint slidx = tet->compdef()->specG2L(sgidx);
+            smtos::Tet * tet = _tet(tidx);
+            uint slidx = _tetCompdef(tidx)->specG2L(sgidx);
             if (slidx == ssolver::LIDX_UNDEFINED)
             {
                 spec_undefined << tidx << " ";
@@ -6385,7 +7218,7 @@ double smtos::TetOpSplitP::getROICount(std::string ROI_id, std::string const & s
             }
             
             // compute local sum for each process
-            if (tet->getInHost()) local_sum += tet->pools()[slidx];
+            if (tet != nullptr && tet->getInHost()) local_sum += tet->pools()[slidx];
         }
         
         // gather global sum
@@ -6416,6 +7249,7 @@ double smtos::TetOpSplitP::getROICount(std::string ROI_id, std::string const & s
 // WEILIANG: Can we apply Sam's set count method (as in e.g. setCompCount) here?
 void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s, double count)
 {
+    _requireReplicatedMesh("setROICount");
     MPI_Barrier(MPI_COMM_WORLD);
     if (count > std::numeric_limits<unsigned int>::max( ))
     {
@@ -6444,22 +7278,21 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
         for (uint t = 0; t < datasize; t++) {
             uint tidx = indices[t];
             
-            if (tidx >= pTris.size())
+            if (tidx >= mesh()->countTris())
             {
                 std::ostringstream os;
                 os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
                 ArgErrLog(os.str());
             }
             
-            if (pTris[tidx] == 0)
+            if (_triPatchdef(tidx) == nullptr)
             {
                 tri_not_assign << tidx << " ";
                 has_tri_warning = true;
                 continue;
             }
             
-            smtos::Tri * tri = pTris[tidx];
-            uint slidx = tri->patchdef()->specG2L(sgidx);
+            uint slidx = _triPatchdef(tidx)->specG2L(sgidx);
             if (slidx == ssolver::LIDX_UNDEFINED)
             {
                 spec_undefined << tidx << " ";
@@ -6468,7 +7301,7 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
             }
             
             apply_indices.push_back(tidx);
-            totalarea += tri->area();
+            totalarea += mesh()->getTriArea(tidx);
         }
         
         if (has_tri_warning) {
@@ -6493,11 +7326,10 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
             for (uint t = 0; t < ind_size; t++)
             {
                 uint tidx = apply_indices[t];
-                smtos::Tri * tri = pTris[tidx];
                 
                 if ((count == 0.0) || (nremoved == c)) break;
                 
-                double fract = static_cast<double>(c) * (tri->area() / totalarea);
+                double fract = static_cast<double>(c) * (mesh()->getTriArea(tidx) / totalarea);
                 uint n3 = static_cast<uint>(std::floor(fract));
                 
                 double n3_frac = fract - static_cast<double>(n3);
@@ -6526,8 +7358,7 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
                 for (uint t = 0; t < ind_size; t++)
                 {
                     uint tidx = apply_indices[t];
-                    smtos::Tri * tri = pTris[tidx];
-                    accum += tri->area();
+                    accum += mesh()->getTriArea(tidx);
                     if (selector < accum) {
                         apply_count[t] += 1.0;
                         break;
@@ -6543,9 +7374,10 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
         for (uint t = 0; t < ind_size; t++)
         {
             uint tidx = apply_indices[t];
-            smtos::Tri * tri = pTris[tidx];
+            smtos::Tri * tri = _tri(tidx);
+            if (tri == nullptr) continue;
             
-            uint slidx = tri->patchdef()->specG2L(sgidx);
+            uint slidx = _triPatchdef(tidx)->specG2L(sgidx);
             tri->setCount(slidx, apply_count[t]);
             _updateSpec(tri, slidx);
         }
@@ -6563,22 +7395,21 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
         for (uint t = 0; t < datasize; t++) {
             uint tidx = indices[t];
             
-            if (tidx >= pTets.size())
+            if (tidx >= mesh()->countTets())
             {
                 std::ostringstream os;
                 os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
                 ArgErrLog(os.str());
             }
             
-            if (pTets[tidx] == 0)
+            if (_tetCompdef(tidx) == nullptr)
             {
                 tet_not_assign << tidx << " ";
                 has_tet_warning = true;
                 continue;
             }
             
-            smtos::Tet * tet = pTets[tidx];
-            uint slidx = tet->compdef()->specG2L(sgidx);
+            uint slidx = _tetCompdef(tidx)->specG2L(sgidx);
             if (slidx == ssolver::LIDX_UNDEFINED)
             {
                 spec_undefined << tidx << " ";
@@ -6587,7 +7418,7 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
             }
             
             apply_indices.push_back(tidx);
-            totalvol += tet->vol();
+            totalvol += mesh()->getTetVol(tidx);
         }
         
         if (has_tet_warning) {
@@ -6612,11 +7443,10 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
             for (uint t = 0; t < ind_size; t++)
             {
                 uint tidx = apply_indices[t];
-                smtos::Tet * tet = pTets[tidx];
                 
                 if ((count == 0.0) || (nremoved == c)) break;
                 
-                double fract = static_cast<double>(c) * (tet->vol() / totalvol);
+                double fract = static_cast<double>(c) * (mesh()->getTetVol(tidx) / totalvol);
                 uint n3 = static_cast<uint>(std::floor(fract));
                 
                 double n3_frac = fract - static_cast<double>(n3);
@@ -6645,8 +7475,7 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
                 for (uint t = 0; t < ind_size; t++)
                 {
                     uint tidx = apply_indices[t];
-                    smtos::Tet * tet = pTets[tidx];
-                    accum += tet->vol();
+                    accum += mesh()->getTetVol(tidx);
                     if (selector < accum) {
                         apply_count[t] += 1.0;
                         break;
@@ -6662,8 +7491,9 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
         for (uint t = 0; t < ind_size; t++)
         {
             uint tidx = apply_indices[t];
-            smtos::Tet * tet = pTets[tidx];
-            uint slidx = tet->compdef()->specG2L(sgidx);
+            smtos::Tet * tet = _tet(tidx);
+            if (tet == nullptr) continue;
+            uint slidx = _tetCompdef(tidx)->specG2L(sgidx);
             tet->setCount(slidx, apply_count[t]);
             _updateSpec(tet, slidx);
         }
@@ -6682,6 +7512,7 @@ void smtos::TetOpSplitP::setROICount(std::string ROI_id, std::string const & s,
 
 double smtos::TetOpSplitP::getROIAmount(std::string ROI_id, std::string const & s) const
 {
+    _requireReplicatedMesh("getROIAmount");
     double count = getROICount(ROI_id, s);
     return (count / smath::AVOGADRO);
 }
@@ -6690,6 +7521,7 @@ double smtos::TetOpSplitP::getROIAmount(std::string ROI_id, std::string const &
 // WEILIANG: Can we apply Sam's set count method (as in e.g. setCompCount) here?
 void smtos::TetOpSplitP::setROIConc(std::string ROI_id, std::string const & s, double conc)
 {
+    _requireReplicatedMesh("setROIConc");
     if (conc > std::numeric_limits<unsigned int>::max( ))
     {
         std::ostringstream os;
@@ -6715,22 +7547,21 @@ void smtos::TetOpSplitP::setROIConc(std::string ROI_id, std::string const & s, d
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint slidx = tet->compdef()->specG2L(sgidx);
+        uint slidx = _tetCompdef(tidx)->specG2L(sgidx);
         if (slidx == ssolver::LIDX_UNDEFINED)
         {
             spec_undefined << tidx << " ";
@@ -6739,7 +7570,7 @@ void smtos::TetOpSplitP::setROIConc(std::string ROI_id, std::string const & s, d
         }
         
         apply_indices.push_back(tidx);
-        totalvol += tet->vol();
+        totalvol += mesh()->getTetVol(tidx);
     }
     
     if (has_tet_warning) {
@@ -6761,6 +7592,7 @@ void smtos::TetOpSplitP::setROIConc(std::string ROI_id, std::string const & s, d
 
 double smtos::TetOpSplitP::getROIConc(std::string ROI_id, std::string const & s) const
 {
+    _requireReplicatedMesh("getROIConc");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TET)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     double count = getROICount(ROI_id, s);
     double vol = getROIVol(ROI_id);
@@ -6771,6 +7603,7 @@ double smtos::TetOpSplitP::getROIConc(std::string ROI_id, std::string const & s)
 
 void smtos::TetOpSplitP::setROIClamped(std::string ROI_id, std::string const & s, bool b)
 {
+    _requireReplicatedMesh("setROIClamped");
     steps::tetmesh::ElementType type = mesh()->getROIType(ROI_id);
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6787,29 +7620,29 @@ void smtos::TetOpSplitP::setROIClamped(std::string ROI_id, std::string const & s
         for (uint t = 0; t < datasize; t++) {
             uint tidx = indices[t];
             
-            if (tidx >= pTris.size())
+            if (tidx >= mesh()->countTris())
             {
                 std::ostringstream os;
                 os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
                 ArgErrLog(os.str());
             }
             
-            if (pTris[tidx] == 0)
+            if (_triPatchdef(tidx) == nullptr)
             {
                 tri_not_assign << tidx << " ";
                 has_tri_warning = true;
                 continue;
             }
             
-            smtos::Tri * tri = pTris[tidx];
-            uint slidx = tri->patchdef()->specG2L(sgidx);
+            smtos::Tri * tri = _tri(tidx);
+            uint slidx = _triPatchdef(tidx)->specG2L(sgidx);
             if (slidx == ssolver::LIDX_UNDEFINED)
             {
                 spec_undefined << tidx << " ";
                 has_spec_warning = true;
                 continue;
             }
-            if (tri->getInHost()) tri->setClamped(slidx, b);
+            if (tri != nullptr && tri->getInHost()) tri->setClamped(slidx, b);
         }
         
         if (has_tri_warning) {
@@ -6833,22 +7666,22 @@ void smtos::TetOpSplitP::setROIClamped(std::string ROI_id, std::string const & s
         for (uint t = 0; t < datasize; t++) {
             uint tidx = indices[t];
             
-            if (tidx >= pTets.size())
+            if (tidx >= mesh()->countTets())
             {
                 std::ostringstream os;
                 os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
                 ArgErrLog(os.str());
             }
             
-            if (pTets[tidx] == 0)
+            if (_tetCompdef(tidx) == nullptr)
             {
                 tet_not_assign << tidx << " ";
                 has_tet_warning = true;
                 continue;
             }
             
-            smtos::Tet * tet = pTets[tidx];
-            uint slidx = tet->compdef()->specG2L(sgidx);
+            smtos::Tet * tet = _tet(tidx);
+            uint slidx = _tetCompdef(tidx)->specG2L(sgidx);
             if (slidx == ssolver::LIDX_UNDEFINED)
             {
                 spec_undefined << tidx << " ";
@@ -6856,7 +7689,7 @@ void smtos::TetOpSplitP::setROIClamped(std::string ROI_id, std::string const & s
                 continue;
             }
             
-            if (tet->getInHost()) tet->setClamped(slidx, b);
+            if (tet != nullptr && tet->getInHost()) tet->setClamped(slidx, b);
         }
         
         if (has_tet_warning) {
@@ -6880,6 +7713,7 @@ void smtos::TetOpSplitP::setROIClamped(std::string ROI_id, std::string const & s
 
 void smtos::TetOpSplitP::setROIReacK(std::string ROI_id, std::string const & r, double kf)
 {
+    _requireReplicatedMesh("setROIReacK");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TET)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6895,22 +7729,22 @@ void smtos::TetOpSplitP::setROIReacK(std::string ROI_id, std::string const & r,
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint rlidx = tet->compdef()->reacG2L(rgidx);
+        smtos::Tet * tet = _tet(tidx);
+        uint rlidx = _tetCompdef(tidx)->reacG2L(rgidx);
         if (rlidx == ssolver::LIDX_UNDEFINED)
         {
             reac_undefined << tidx << " ";
@@ -6918,7 +7752,7 @@ void smtos::TetOpSplitP::setROIReacK(std::string ROI_id, std::string const & r,
             continue;
         }
         
-        if (tet->getInHost()) tet->reac(rlidx)->setKcst(kf);
+        if (tet != nullptr && tet->getInHost()) tet->reac(rlidx)->setKcst(kf);
     }
     
     if (has_tet_warning) {
@@ -6938,6 +7772,7 @@ void smtos::TetOpSplitP::setROIReacK(std::string ROI_id, std::string const & r,
 
 void smtos::TetOpSplitP::setROISReacK(std::string ROI_id, std::string const & sr, double kf)
 {
+    _requireReplicatedMesh("setROISReacK");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TRI)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -6953,22 +7788,22 @@ void smtos::TetOpSplitP::setROISReacK(std::string ROI_id, std::string const & sr
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTris.size())
+        if (tidx >= mesh()->countTris())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTris[tidx] == 0)
+        if (_triPatchdef(tidx) == nullptr)
         {
             tri_not_assign << tidx << " ";
             has_tri_warning = true;
             continue;
         }
         
-        smtos::Tri * tri = pTris[tidx];
-        uint srlidx = tri->patchdef()->sreacG2L(srgidx);
+        smtos::Tri * tri = _tri(tidx);
+        uint srlidx = _triPatchdef(tidx)->sreacG2L(srgidx);
         if (srlidx == ssolver::LIDX_UNDEFINED)
         {
             sreac_undefined << tidx << " ";
@@ -6976,7 +7811,7 @@ void smtos::TetOpSplitP::setROISReacK(std::string ROI_id, std::string const & sr
             continue;
         }
         
-        if (tri->getInHost()) tri->sreac(srlidx)->setKcst(kf);
+        if (tri != nullptr && tri->getInHost()) tri->sreac(srlidx)->setKcst(kf);
     }
     
     if (has_tri_warning) {
@@ -6996,6 +7831,7 @@ void smtos::TetOpSplitP::setROISReacK(std::string ROI_id, std::string const & sr
 
 void smtos::TetOpSplitP::setROIDiffD(std::string ROI_id, std::string const & d, double dk)
 {
+    _requireReplicatedMesh("setROIDiffD");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TET)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -7011,22 +7847,22 @@ void smtos::TetOpSplitP::setROIDiffD(std::string ROI_id, std::string const & d,
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint dlidx = tet->compdef()->diffG2L(dgidx);
+        smtos::Tet * tet = _tet(tidx);
+        uint dlidx = _tetCompdef(tidx)->diffG2L(dgidx);
         if (dlidx == ssolver::LIDX_UNDEFINED)
         {
             diff_undefined << tidx << " ";
@@ -7034,7 +7870,7 @@ void smtos::TetOpSplitP::setROIDiffD(std::string ROI_id, std::string const & d,
             continue;
         }
         
-        if (tet->getInHost()) tet->diff(dlidx)->setDcst(dk);
+        if (tet != nullptr && tet->getInHost()) tet->diff(dlidx)->setDcst(dk);
     }
     
     if (has_tet_warning) {
@@ -7056,6 +7892,7 @@ void smtos::TetOpSplitP::setROIDiffD(std::string ROI_id, std::string const & d,
 
 void smtos::TetOpSplitP::setROIReacActive(std::string ROI_id, std::string const & r, bool a)
 {
+    _requireReplicatedMesh("setROIReacActive");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TET)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -7071,22 +7908,22 @@ void smtos::TetOpSplitP::setROIReacActive(std::string ROI_id, std::string const
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint rlidx = tet->compdef()->reacG2L(rgidx);
+        smtos::Tet * tet = _tet(tidx);
+        uint rlidx = _tetCompdef(tidx)->reacG2L(rgidx);
         if (rlidx == ssolver::LIDX_UNDEFINED)
         {
             reac_undefined << tidx << " ";
@@ -7094,7 +7931,7 @@ void smtos::TetOpSplitP::setROIReacActive(std::string ROI_id, std::string const
             continue;
         }
         
-        if (tet->getInHost()) tet->reac(rlidx)->setActive(a);
+        if (tet != nullptr && tet->getInHost()) tet->reac(rlidx)->setActive(a);
     }
     
     if (has_tet_warning) {
@@ -7114,6 +7951,7 @@ void smtos::TetOpSplitP::setROIReacActive(std::string ROI_id, std::string const
 
 void smtos::TetOpSplitP::setROISReacActive(std::string ROI_id, std::string const & sr, bool a)
 {
+    _requireReplicatedMesh("setROISReacActive");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TRI)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -7129,22 +7967,22 @@ void smtos::TetOpSplitP::setROISReacActive(std::string ROI_id, std::string const
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTris.size())
+        if (tidx >= mesh()->countTris())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTris[tidx] == 0)
+        if (_triPatchdef(tidx) == nullptr)
         {
             tri_not_assign << tidx << " ";
             has_tri_warning = true;
             continue;
         }
         
-        smtos::Tri * tri = pTris[tidx];
-        uint srlidx = tri->patchdef()->sreacG2L(srgidx);
+        smtos::Tri * tri = _tri(tidx);
+        uint srlidx = _triPatchdef(tidx)->sreacG2L(srgidx);
         if (srlidx == ssolver::LIDX_UNDEFINED)
         {
             sreac_undefined << tidx << " ";
@@ -7152,7 +7990,7 @@ void smtos::TetOpSplitP::setROISReacActive(std::string ROI_id, std::string const
             continue;
         }
         
-        if (tri->getInHost()) tri->sreac(srlidx)->setActive(a);
+        if (tri != nullptr && tri->getInHost()) tri->sreac(srlidx)->setActive(a);
     }
     
     if (has_tri_warning) {
@@ -7172,6 +8010,7 @@ void smtos::TetOpSplitP::setROISReacActive(std::string ROI_id, std::string const
 
 void smtos::TetOpSplitP::setROIDiffActive(std::string ROI_id, std::string const & d, bool a)
 {
+    _requireReplicatedMesh("setROIDiffActive");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TET)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -7187,22 +8026,22 @@ void smtos::TetOpSplitP::setROIDiffActive(std::string ROI_id, std::string const
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint dlidx = tet->compdef()->diffG2L(dgidx);
+        smtos::Tet * tet = _tet(tidx);
+        uint dlidx = _tetCompdef(tidx)->diffG2L(dgidx);
         if (dlidx == ssolver::LIDX_UNDEFINED)
         {
             diff_undefined << tidx << " ";
@@ -7210,7 +8049,7 @@ void smtos::TetOpSplitP::setROIDiffActive(std::string ROI_id, std::string const
             continue;
         }
         
-        if (tet->getInHost()) tet->diff(dlidx)->setActive(a);
+        if (tet != nullptr && tet->getInHost()) tet->diff(dlidx)->setActive(a);
     }
     
     if (has_tet_warning) {
@@ -7232,6 +8071,7 @@ void smtos::TetOpSplitP::setROIDiffActive(std::string ROI_id, std::string const
 
 void smtos::TetOpSplitP::setROIVDepSReacActive(std::string ROI_id, std::string const & vsr, bool a)
 {
+    _requireReplicatedMesh("setROIVDepSReacActive");
     if (!mesh()->checkROI(ROI_id, steps::tetmesh::ELEM_TRI)) ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
     
     uint *indices = mesh()->_getROIData(ROI_id);
@@ -7247,22 +8087,22 @@ void smtos::TetOpSplitP::setROIVDepSReacActive(std::string ROI_id, std::string c
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTris.size())
+        if (tidx >= mesh()->countTris())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTris[tidx] == 0)
+        if (_triPatchdef(tidx) == nullptr)
         {
             tri_not_assign << tidx << " ";
             has_tri_warning = true;
             continue;
         }
         
-        smtos::Tri * tri = pTris[tidx];
-        uint vsrlidx = tri->patchdef()->vdepsreacG2L(vsrgidx);
+        smtos::Tri * tri = _tri(tidx);
+        uint vsrlidx = _triPatchdef(tidx)->vdepsreacG2L(vsrgidx);
         if (vsrlidx == ssolver::LIDX_UNDEFINED)
         {
             vsreac_undefined << tidx << " ";
@@ -7270,7 +8110,7 @@ void smtos::TetOpSplitP::setROIVDepSReacActive(std::string ROI_id, std::string c
             continue;
         }
         
-        if (tri->getInHost()) tri->vdepsreac(vsrlidx)->setActive(a);
+        if (tri != nullptr && tri->getInHost()) tri->vdepsreac(vsrlidx)->setActive(a);
     }
     
     if (has_tri_warning) {
@@ -7289,6 +8129,7 @@ void smtos::TetOpSplitP::setROIVDepSReacActive(std::string ROI_id, std::string c
 
 uint smtos::TetOpSplitP::getROIReacExtent(std::string ROI_id, std::string const & r) const
 {
+    _requireReplicatedMesh("getROIReacExtent");
     std::ostringstream os;
     os << "This function has not been implemented!";
     NotImplErrLog(os.str());
@@ -7310,22 +8151,22 @@ uint smtos::TetOpSplitP::getROIReacExtent(std::string ROI_id, std::string const
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint rlidx = tet->compdef()->reacG2L(rgidx);
+        smtos::Tet * tet = _tet(tidx);
+        uint rlidx = _tetCompdef(tidx)->reacG2L(rgidx);
         if (rlidx == ssolver::LIDX_UNDEFINED)
         {
             reac_undefined << tidx << " ";
@@ -7353,6 +8194,7 @@ uint smtos::TetOpSplitP::getROIReacExtent(std::string ROI_id, std::string const
 
 void smtos::TetOpSplitP::resetROIReacExtent(std::string ROI_id, std::string const & r)
 {
+    _requireReplicatedMesh("resetROIReacExtent");
     std::ostringstream os;
     os << "This function has not been implemented!";
     NotImplErrLog(os.str());
@@ -7372,22 +8214,22 @@ void smtos::TetOpSplitP::resetROIReacExtent(std::string ROI_id, std::string cons
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint rlidx = tet->compdef()->reacG2L(rgidx);
+        smtos::Tet * tet = _tet(tidx);
+        uint rlidx = _tetCompdef(tidx)->reacG2L(rgidx);
         if (rlidx == ssolver::LIDX_UNDEFINED)
         {
             reac_undefined << tidx << " ";
@@ -7413,6 +8255,7 @@ void smtos::TetOpSplitP::resetROIReacExtent(std::string ROI_id, std::string cons
 
 uint smtos::TetOpSplitP::getROISReacExtent(std::string ROI_id, std::string const & sr) const
 {
+    _requireReplicatedMesh("getROISReacExtent");
     std::ostringstream os;
     os << "This function has not been implemented!";
     NotImplErrLog(os.str());
@@ -7434,22 +8277,22 @@ uint smtos::TetOpSplitP::getROISReacExtent(std::string ROI_id, std::string const
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTris.size())
+        if (tidx >= mesh()->countTris())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTris[tidx] == 0)
+        if (_triPatchdef(tidx) == nullptr)
         {
             tri_not_assign << tidx << " ";
             has_tri_warning = true;
             continue;
         }
         
-        smtos::Tri * tri = pTris[tidx];
-        uint srlidx = tri->patchdef()->sreacG2L(srgidx);
+        smtos::Tri * tri = _tri(tidx);
+        uint srlidx = _triPatchdef(tidx)->sreacG2L(srgidx);
         if (srlidx == ssolver::LIDX_UNDEFINED)
         {
             sreac_undefined << tidx << " ";
@@ -7477,6 +8320,7 @@ uint smtos::TetOpSplitP::getROISReacExtent(std::string ROI_id, std::string const
 
 void smtos::TetOpSplitP::resetROISReacExtent(std::string ROI_id, std::string const & sr)
 {
+    _requireReplicatedMesh("resetROISReacExtent");
     std::ostringstream os;
     os << "This function has not been implemented!";
     NotImplErrLog(os.str());
@@ -7496,22 +8340,22 @@ void smtos::TetOpSplitP::resetROISReacExtent(std::string ROI_id, std::string con
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTris.size())
+        if (tidx >= mesh()->countTris())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no triangle with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTris[tidx] == 0)
+        if (_triPatchdef(tidx) == nullptr)
         {
             tri_not_assign << tidx << " ";
             has_tri_warning = true;
             continue;
         }
         
-        smtos::Tri * tri = pTris[tidx];
-        uint srlidx = tri->patchdef()->sreacG2L(srgidx);
+        smtos::Tri * tri = _tri(tidx);
+        uint srlidx = _triPatchdef(tidx)->sreacG2L(srgidx);
         if (srlidx == ssolver::LIDX_UNDEFINED)
         {
             sreac_undefined << tidx << " ";
@@ -7537,6 +8381,7 @@ void smtos::TetOpSplitP::resetROISReacExtent(std::string ROI_id, std::string con
 
 uint smtos::TetOpSplitP::getROIDiffExtent(std::string ROI_id, std::string const & d) const
 {
+    _requireReplicatedMesh("getROIDiffExtent");
     std::ostringstream os;
     os << "This function has not been implemented!";
     NotImplErrLog(os.str());
@@ -7558,22 +8403,22 @@ uint smtos::TetOpSplitP::getROIDiffExtent(std::string ROI_id, std::string const
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint dlidx = tet->compdef()->diffG2L(dgidx);
+        smtos::Tet * tet = _tet(tidx);
+        uint dlidx = _tetCompdef(tidx)->diffG2L(dgidx);
         if (dlidx == ssolver::LIDX_UNDEFINED)
         {
             diff_undefined << tidx << " ";
@@ -7601,6 +8446,7 @@ uint smtos::TetOpSplitP::getROIDiffExtent(std::string ROI_id, std::string const
 
 void smtos::TetOpSplitP::resetROIDiffExtent(std::string ROI_id, std::string const & d)
 {
+    _requireReplicatedMesh("resetROIDiffExtent");
     std::ostringstream os;
     os << "This function has not been implemented!";
     NotImplErrLog(os.str());
@@ -7620,253 +8466,702 @@ void smtos::TetOpSplitP::resetROIDiffExtent(std::string ROI_id, std::string cons
     for (uint t = 0; t < datasize; t++) {
         uint tidx = indices[t];
         
-        if (tidx >= pTets.size())
+        if (tidx >= mesh()->countTets())
         {
             std::ostringstream os;
             os << "Error (Index Overbound): There is no tetrahedron with index " << tidx << ".\n";
             ArgErrLog(os.str());
         }
         
-        if (pTets[tidx] == 0)
+        if (_tetCompdef(tidx) == nullptr)
         {
             tet_not_assign << tidx << " ";
             has_tet_warning = true;
             continue;
         }
         
-        smtos::Tet * tet = pTets[tidx];
-        uint dlidx = tet->compdef()->diffG2L(dgidx);
+        smtos::Tet * tet = _tet(tidx);
+        uint dlidx = _tetCompdef(tidx)->diffG2L(dgidx);
         if (dlidx == ssolver::LIDX_UNDEFINED)
         {
             diff_undefined << tidx << " ";
             has_diff_warning = true;
             continue;
         }
-        
-        tet->diff(dlidx)->resetExtent();
-    }
-    
-    if (has_tet_warning) {
-        CLOG(WARNING, "general_log") << "The following tetrahedrons have not been assigned to a compartment, no change is applied to them:\n";
-        CLOG(WARNING, "general_log") << tet_not_assign.str() << "\n";
-    }
-    
-    if (has_diff_warning) {
-        CLOG(WARNING, "general_log") << "Diff " << d << " has not been defined in the following tetrahedrons, no change is applied to them:\n";
-        CLOG(WARNING, "general_log") << diff_undefined.str() << "\n";
+        
+        tet->diff(dlidx)->resetExtent();
+    }
+    
+    if (has_tet_warning) {
+        CLOG(WARNING, "general_log") << "The following tetrahedrons have not been assigned to a compartment, no change is applied to them:\n";
+        CLOG(WARNING, "general_log") << tet_not_assign.str() << "\n";
+    }
+    
+    if (has_diff_warning) {
+        CLOG(WARNING, "general_log") << "Diff " << d << " has not been defined in the following tetrahedrons, no change is applied to them:\n";
+        CLOG(WARNING, "general_log") << diff_undefined.str() << "\n";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint smtos::TetOpSplitP::getTetHostRank(uint tidx)
+{
+    return _tetHost(tidx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint smtos::TetOpSplitP::getTriHostRank(uint tidx)
+{
+    return _triHost(tidx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint smtos::TetOpSplitP::getWMVolHostRank(uint idx)
+{
+    return wmHosts[idx];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_updateLocal(uint* upd_entries, uint buffer_size) {
+    for (uint i = 0; i < buffer_size; i++) {
+        if (pKProcs[upd_entries[i]] != NULL)
+        {
+            _updateElement(pKProcs[upd_entries[i]]);
+        }
+    }
+    
+    _updateSum();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::addDiff(Diff* diff)
+{
+    diff->crData.pos = pDiffs.size();
+    pDiffs.push_back(diff);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_updateDiff(Diff* diff)
+{
+    _setDiffRate(diff, diff->rate(this));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::addSDiff(SDiff* sdiff)
+{
+    sdiff->crData.pos = pSDiffs.size();
+    pSDiffs.push_back(sdiff);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::addVDepKProc(KProc* kp)
+{
+    pVDepKProcs.push_back(kp);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_updateSDiff(SDiff* sdiff)
+{
+    _setDiffRate(sdiff, sdiff->rate(this));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::addNeighHost(int host)
+{
+    neighbHosts.insert(host);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::registerBoundaryTet(smtos::Tet* tet)
+{
+    boundaryTets.insert(tet);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::registerBoundaryTri(smtos::Tri* tri)
+{
+    boundaryTris.insert(tri);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint smtos::TetOpSplitP::registerRemoteMoleculeChange(int svol_host, uint loc, SubVolType svol_type, uint idx, uint slidx, uint change)
+{
+    // the receiving rank knows the element by its mesh index
+    if (svol_type == SUB_TET) idx = _tetGIdx(idx);
+    else if (svol_type == SUB_TRI) idx = _triGIdx(idx);
+
+    uint new_loc = remoteChanges[svol_host].size();
+
+    if (new_loc == 0 || new_loc - 4 < loc) {
+        remoteChanges[svol_host].push_back(svol_type);
+        remoteChanges[svol_host].push_back(idx);
+        remoteChanges[svol_host].push_back(slidx);
+        remoteChanges[svol_host].push_back(change);
+    }
+    else {
+        uint stored_type = remoteChanges[svol_host][loc];
+        uint stored_idx = remoteChanges[svol_host][loc + 1];
+        uint stored_slidx = remoteChanges[svol_host][loc + 2];
+
+        if (stored_type == svol_type && stored_idx ==idx && stored_slidx == slidx) {
+            remoteChanges[svol_host][loc + 3] += change;
+            new_loc = loc;
+        }
+        else {
+            remoteChanges[svol_host].push_back(svol_type);
+            remoteChanges[svol_host].push_back(idx);
+            remoteChanges[svol_host].push_back(slidx);
+            remoteChanges[svol_host].push_back(change);
+        }
     }
+    return new_loc;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-uint smtos::TetOpSplitP::getTetHostRank(uint tidx)
+void smtos::TetOpSplitP::_setupNeighbComm()
 {
-    return tetHosts[tidx];
+    _freeNeighbComm();
+
+    pNeighbList.assign(neighbHosts.begin(), neighbHosts.end());
+    int degree = pNeighbList.size();
+
+    // neighbour relations are symmetric, so sources and destinations
+    // are the same list, in the same order
+    MPI_Comm * comm = new MPI_Comm;
+    MPI_Dist_graph_create_adjacent(MPI_COMM_WORLD,
+                                   degree, pNeighbList.data(), MPI_UNWEIGHTED,
+                                   degree, pNeighbList.data(), MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, 0, comm);
+    pNeighbComm = comm;
+    pSyncRequests = new MPI_Request[2];
+    pSyncStage = 0;
+
+    pSendCounts.assign(degree, 0);
+    pSendDispls.assign(degree, 0);
+    pRecvCounts.assign(degree, 0);
+    pRecvDispls.assign(degree, 0);
+
+    pKProcUpdEpoch.assign(pKProcs.size(), 0);
+    pUpdEpoch = 0;
+    pRemoteUpdKProcs.clear();
+    pRemoteUpdKProcs.reserve(pKProcs.size());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-uint smtos::TetOpSplitP::getTriHostRank(uint tidx)
+void smtos::TetOpSplitP::_freeNeighbComm()
 {
-    return triHosts[tidx];
+    if (pNeighbComm == nullptr) return;
+
+    MPI_Comm * comm = static_cast<MPI_Comm*>(pNeighbComm);
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) MPI_Comm_free(comm);
+    delete comm;
+    pNeighbComm = nullptr;
+    delete[] static_cast<MPI_Request*>(pSyncRequests);
+    pSyncRequests = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-uint smtos::TetOpSplitP::getWMVolHostRank(uint idx)
+void smtos::TetOpSplitP::_partitionDiffs()
 {
-    return wmHosts[idx];
+    auto bnd_diff = [this](Diff * d) {
+        for (uint i = 0; i < 4; ++i) {
+            smtos::Tet * next = d->getTet()->nextTet(i);
+            if (next != nullptr && next->getHost() != myRank) return true;
+        }
+        return false;
+    };
+    auto bnd_sdiff = [this](SDiff * d) {
+        for (uint i = 0; i < 3; ++i) {
+            smtos::Tri * next = d->getTri()->nextTri(i);
+            if (next != nullptr && next->getHost() != myRank) return true;
+        }
+        return false;
+    };
+
+    auto dsep = std::stable_partition(pDiffs.begin(), pDiffs.begin() + diffSep, bnd_diff);
+    diffBndSep = dsep - pDiffs.begin();
+
+    auto sdsep = std::stable_partition(pSDiffs.begin(), pSDiffs.begin() + sdiffSep, bnd_sdiff);
+    sdiffBndSep = sdsep - pSDiffs.begin();
+
+    _colourDiffs();
+
+    for (uint pos = 0; pos < pDiffs.size(); pos++) pDiffs[pos]->crData.pos = pos;
+    for (uint pos = 0; pos < pSDiffs.size(); pos++) pSDiffs[pos]->crData.pos = pos;
+
+    _rebuildActiveDiffs();
+
+    // levels follow the positions; before the first run they are
+    // assigned together with the update period
+    if (!recomputeUpdPeriod) _assignDiffLevels();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::_updateLocal(uint* upd_entries, uint buffer_size) {
-    for (uint i = 0; i < buffer_size; i++) {
-        if (pKProcs[upd_entries[i]] != NULL)
-        {
-            _updateElement(pKProcs[upd_entries[i]]);
-        }
-    }
-    
-    _updateSum();
+void smtos::TetOpSplitP::_setDiffRate(KProc* kp, double rate)
+{
+    kp->crData.rate = rate;
+
+    std::vector<uint64_t> & active = (kp->getType() == KP_DIFF) ? pActiveDiffs : pActiveSDiffs;
+    // before the first _rebuildActiveDiffs() the rates are picked up by it
+    uint pos = kp->crData.pos;
+    if (pos / 64 >= active.size()) return;
+    uint64_t bit = uint64_t(1) << (pos % 64);
+    if (rate != 0.0) active[pos / 64] |= bit;
+    else active[pos / 64] &= ~bit;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::addDiff(Diff* diff)
+void smtos::TetOpSplitP::_rebuildActiveDiffs()
 {
-    diff->crData.pos = pDiffs.size();
-    pDiffs.push_back(diff);
+    pActiveDiffs.assign((pDiffs.size() + 63) / 64, 0);
+    for (auto d : pDiffs) _setDiffRate(d, d->crData.rate);
+
+    pActiveSDiffs.assign((pSDiffs.size() + 63) / 64, 0);
+    for (auto d : pSDiffs) _setDiffRate(d, d->crData.rate);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::_updateDiff(Diff* diff)
+static inline smtos::Tet * nextElement(smtos::Tet * tet, uint i) { return tet->nextTet(i); }
+static inline smtos::Tri * nextElement(smtos::Tri * tri, uint i) { return tri->nextTri(i); }
+
+// Sort diffs[bgn, end) by a greedy distance-2 colouring of their source
+// elements and return the colour boundaries. A diffusion changes its own
+// element and the nneighbs neighbours, so two elements of one colour
+// share none of the pools either of them changes.
+template <typename DiffT>
+static std::vector<uint> colourByElement(std::vector<DiffT*> & diffs, uint bgn, uint end, uint nneighbs)
 {
-    double new_rate = diff->rate(this);
+    typedef decltype(diffusionElement(diffs[0])) ElemT;
+    const uint NO_COLOUR = std::numeric_limits<uint>::max();
+
+    std::unordered_map<ElemT, uint> colour;
+    std::vector<ElemT> elems;
+    for (uint pos = bgn; pos < end; pos++) {
+        ElemT e = diffusionElement(diffs[pos]);
+        if (colour.emplace(e, NO_COLOUR).second) elems.push_back(e);
+    }
+
+    uint ncolours = 0;
+    std::vector<char> used;
+    for (auto e : elems) {
+        used.assign(ncolours + 1, 0);
+        auto mark = [&colour, &used, NO_COLOUR](ElemT m) {
+            auto c = colour.find(m);
+            if (c != colour.end() && c->second != NO_COLOUR) used[c->second] = 1;
+        };
+        for (uint i = 0; i < nneighbs; i++) {
+            ElemT n1 = nextElement(e, i);
+            if (n1 == nullptr) continue;
+            mark(n1);
+            for (uint j = 0; j < nneighbs; j++) {
+                ElemT n2 = nextElement(n1, j);
+                if (n2 != nullptr) mark(n2);
+            }
+        }
+        uint c = 0;
+        while (used[c]) c++;
+        colour[e] = c;
+        ncolours = std::max(ncolours, c + 1);
+    }
+
+    std::stable_sort(diffs.begin() + bgn, diffs.begin() + end,
+        [&colour](DiffT * a, DiffT * b) {
+            return colour[diffusionElement(a)] < colour[diffusionElement(b)];
+        });
 
-    diff->crData.rate = new_rate;
+    std::vector<uint> sep(1, bgn);
+    for (uint pos = bgn; pos < end; pos++) {
+        uint c = colour[diffusionElement(diffs[pos])];
+        while (sep.size() <= c) sep.push_back(pos);
+    }
+    sep.push_back(end);
+    return sep;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::addSDiff(SDiff* sdiff)
+void smtos::TetOpSplitP::_colourDiffs()
 {
-    sdiff->crData.pos = pSDiffs.size();
-    pSDiffs.push_back(sdiff);
+    pDiffColourSep.clear();
+    pSDiffColourSep.clear();
+    if (pDiffThreads <= 1) return;
+
+    pDiffColourSep = colourByElement(pDiffs, diffBndSep, diffSep, 4);
+    pSDiffColourSep = colourByElement(pSDiffs, sdiffBndSep, sdiffSep, 3);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::_updateSDiff(SDiff* sdiff)
+void smtos::TetOpSplitP::setDiffusionThreads(uint nthreads)
 {
-    double new_rate = sdiff->rate(this);
+    if (nthreads == 0)
+    {
+        std::ostringstream os;
+        os << "Number of diffusion threads must be at least 1.\n";
+        ArgErrLog(os.str());
+    }
+#ifndef _OPENMP
+    if (nthreads > 1)
+    {
+        std::ostringstream os;
+        os << "Cannot use " << nthreads << " diffusion threads, ";
+        os << "STEPS was built without OpenMP.\n";
+        ArgErrLog(os.str());
+    }
+#endif
+    int provided;
+    MPI_Query_thread(&provided);
+    if (nthreads > 1 && provided < MPI_THREAD_FUNNELED)
+    {
+        std::ostringstream os;
+        os << "Cannot use " << nthreads << " diffusion threads, ";
+        os << "the MPI library does not provide MPI_THREAD_FUNNELED.\n";
+        ArgErrLog(os.str());
+    }
+
+    pDiffThreads = nthreads;
+    pThreadRNGs.clear();
+    if (nthreads > 1) {
+        for (uint t = 0; t < nthreads; t++) pThreadRNGs.emplace_back(new steps::rng::R123(1024));
+    }
+    pThreadAppliedDiffs.assign(nthreads, std::vector<KProc*>());
+    pThreadDirections.assign(nthreads, std::vector<int>());
+    pDiffBatches.assign(nthreads, DiffBatch());
+    _createElementRNGs();
 
-    sdiff->crData.rate = new_rate;
+    _partitionDiffs();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::addNeighHost(int host)
+void smtos::TetOpSplitP::setElementRNG(bool enable, ulong seed)
 {
-    neighbHosts.insert(host);
+    pElementRNG = enable;
+    pElementRNGSeed = seed;
+    pElementRNGKeys.clear();
+    if (enable) {
+        uint nkeys = 1 + 2 * std::max(statedef()->countDiffs(), statedef()->countSurfDiffs());
+        for (uint k = 0; k < nkeys; k++) pElementRNGKeys.push_back(steps::rng::R123::streamKey(seed, k));
+    }
+    _createElementRNGs();
+    _setupSSAGroups();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::registerBoundaryTet(smtos::Tet* tet)
+void smtos::TetOpSplitP::_createElementRNGs()
 {
-    boundaryTets.insert(tet);
+    pElementRNGs.clear();
+    if (!pElementRNG) return;
+    // a diffusion update takes a few numbers, so the buffer is one block
+    for (uint t = 0; t < pDiffThreads; t++) pElementRNGs.emplace_back(new steps::rng::R123(4));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP::registerBoundaryTri(smtos::Tri* tri)
+void smtos::TetOpSplitP::_setupSSAGroups()
 {
-    boundaryTris.insert(tri);
+    pSSAGroupKProcs.clear();
+    pSSAGroupSep.clear();
+    pSSAGroupKey.clear();
+    if (!pElementRNG) return;
+
+    // elements in one index space: tets, tris, well-mixed compartments
+    uint ntets = pTets.size();
+    uint ntris = pTris.size();
+    uint nelems = ntets + ntris + pWmVols.size();
+    // and their index in the whole mesh, the same unless it is distributed
+    uint mesh_tets = pDistMesh ? pGlobalTets : ntets;
+    uint mesh_tris = pDistMesh ? pGlobalTris : ntris;
+    auto meshIdx = [&](uint e) -> uint {
+        if (e < ntets) return _tetGIdx(e);
+        if (e < ntets + ntris) return mesh_tets + _triGIdx(e - ntets);
+        return mesh_tets + mesh_tris + (e - ntets - ntris);
+    };
+    std::vector<uint> order(nelems);
+    std::iota(order.begin(), order.end(), 0u);
+    if (pDistMesh) {
+        std::sort(order.begin(), order.end(), [&](uint a, uint b) { return meshIdx(a) < meshIdx(b); });
+    }
+    auto volIdx = [&](WmVol * v) -> uint {
+        Tet * tet = dynamic_cast<Tet*>(v);
+        return tet != nullptr ? tet->idx() : ntets + ntris + v->idx();
+    };
+    auto hosted = [&](uint e) -> bool {
+        if (e < ntets) return pTets[e] != nullptr && pTets[e]->getInHost();
+        if (e < ntets + ntris) return pTris[e - ntets] != nullptr && pTris[e - ntets]->getInHost();
+        return pWmVols[e - ntets - ntris] != nullptr && pWmVols[e - ntets - ntris]->getInHost();
+    };
+    auto countKProcs = [&](uint e) -> uint {
+        if (e < ntets) return pTets[e]->countKProcs();
+        if (e < ntets + ntris) return pTris[e - ntets]->countKProcs();
+        return pWmVols[e - ntets - ntris]->countKProcs();
+    };
+    auto getKProc = [&](uint e, uint k) -> KProc * {
+        if (e < ntets) return pTets[e]->getKProc(k);
+        if (e < ntets + ntris) return pTris[e - ntets]->getKProc(k);
+        return pWmVols[e - ntets - ntris]->getKProc(k);
+    };
+    auto isSSA = [](KProc * kp) -> bool {
+        return kp != nullptr && kp->getType() != KP_DIFF && kp->getType() != KP_SDIFF;
+    };
+
+    // Join each tri with surface reactions to the volumes next to it.
+    // Roots are the element of a group with the smallest mesh index, so
+    // the groups and their keys do not depend on the partition.
+    std::vector<uint> root(nelems);
+    std::iota(root.begin(), root.end(), 0u);
+    auto find = [&](uint e) -> uint {
+        while (root[e] != e) e = root[e] = root[root[e]];
+        return e;
+    };
+    for (uint t = 0; t < ntris; t++) {
+        Tri * tri = pTris[t];
+        if (tri == nullptr || !tri->getInHost()) continue;
+        bool surface = false;
+        for (uint k = 0; k < tri->countKProcs(); k++) surface = surface || isSSA(tri->getKProc(k));
+        if (!surface) continue;
+        for (WmVol * v : {tri->iTet(), tri->oTet()}) {
+            if (v == nullptr || !v->getInHost()) continue;
+            uint a = find(ntets + t);
+            uint b = find(volIdx(v));
+            if (meshIdx(a) < meshIdx(b)) root[b] = a;
+            else root[a] = b;
+        }
+    }
+
+    // count the kprocs of each group, then fill them in element order
+    std::vector<uint> group_count(nelems, 0);
+    for (uint e : order) {
+        if (!hosted(e)) continue;
+        uint nk = countKProcs(e);
+        for (uint k = 0; k < nk; k++) {
+            if (isSSA(getKProc(e, k))) group_count[find(e)]++;
+        }
+    }
+    std::vector<uint> group_pos(nelems, 0);
+    pSSAGroupSep.push_back(0);
+    for (uint e : order) {
+        if (group_count[e] == 0) continue;
+        group_pos[e] = pSSAGroupSep.back();
+        pSSAGroupSep.push_back(pSSAGroupSep.back() + group_count[e]);
+        pSSAGroupKey.push_back(meshIdx(e));
+    }
+    pSSAGroupKProcs.resize(pSSAGroupSep.back());
+    for (uint e : order) {
+        if (!hosted(e)) continue;
+        uint nk = countKProcs(e);
+        for (uint k = 0; k < nk; k++) {
+            KProc * kp = getKProc(e, k);
+            if (isSSA(kp)) pSSAGroupKProcs[group_pos[find(e)]++] = kp;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_runElementSSA(double pre_ssa_time, double update_period)
+{
+    steps::rng::R123 * r = pElementRNGs[0].get();
+    uint64_t iteration = static_cast<uint64_t>(nIteration);
+    uint ngroups = pSSAGroupKey.size();
+    for (uint g = 0; g < ngroups; g++) {
+        r->setStream(pElementRNGKeys[0], static_cast<uint>(iteration),
+                     static_cast<uint>(iteration >> 32), pSSAGroupKey[g]);
+        KProc ** bgn = pSSAGroupKProcs.data() + pSSAGroupSep[g];
+        KProc ** end = pSSAGroupKProcs.data() + pSSAGroupSep[g + 1];
+
+        // direct method over the few kprocs of the group
+        double group_dt = 0.0;
+        while (true) {
+            double a0 = 0.0;
+            for (KProc ** k = bgn; k != end; ++k) a0 += (*k)->crData.rate;
+            if (a0 <= 0.0) break;
+
+            double dt = r->getExp(a0);
+            if (group_dt + dt > update_period) break;
+
+            double selector = r->getUnfIE() * a0;
+            KProc * kp = nullptr;
+            for (KProc ** k = bgn; k != end; ++k) {
+                double rate = (*k)->crData.rate;
+                if (rate <= 0.0) continue;
+                kp = *k;
+                if (selector < rate) break;
+                selector -= rate;
+            }
+
+            kp->apply(r, dt, pre_ssa_time + group_dt, pre_ssa_time + group_dt + dt);
+            group_dt += dt;
+            for (auto upd : kp->getLocalUpdVec()) _updateElement(upd);
+            statedef()->incNSteps(1);
+            pKProcWork[kp->schedIDX()] += 1.0;
+            reacExtent += 1;
+        }
+    }
+    _updateSum();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-uint smtos::TetOpSplitP::registerRemoteMoleculeChange(int svol_host, uint loc, SubVolType svol_type, uint idx, uint slidx, uint change)
+void smtos::TetOpSplitP::_startRemoteSync()
 {
-    uint new_loc = remoteChanges[svol_host].size();
+    #ifdef MPI_PROFILING
+    double starttime = MPI_Wtime();
+    #endif
 
-    if (new_loc == 0 || new_loc - 4 < loc) {
-        remoteChanges[svol_host].push_back(svol_type);
-        remoteChanges[svol_host].push_back(idx);
-        remoteChanges[svol_host].push_back(slidx);
-        remoteChanges[svol_host].push_back(change);
+    MPI_Comm comm = *static_cast<MPI_Comm*>(pNeighbComm);
+    MPI_Request * reqs = static_cast<MPI_Request*>(pSyncRequests);
+    uint nneighbs = pNeighbList.size();
+
+    // pack the per-neighbour change buffers in communicator order
+    int send_total = 0;
+    for (uint n = 0; n < nneighbs; n++) {
+        pSendDispls[n] = send_total;
+        pSendCounts[n] = remoteChanges[pNeighbList[n]].size();
+        send_total += pSendCounts[n];
+    }
+    if (pSendBuf.size() < static_cast<uint>(send_total)) pSendBuf.resize(send_total);
+    for (uint n = 0; n < nneighbs; n++) {
+        std::vector<uint> const & changes = remoteChanges[pNeighbList[n]];
+        std::copy(changes.begin(), changes.end(), pSendBuf.begin() + pSendDispls[n]);
     }
-    else {
-        uint stored_type = remoteChanges[svol_host][loc];
-        uint stored_idx = remoteChanges[svol_host][loc + 1];
-        uint stored_slidx = remoteChanges[svol_host][loc + 2];
 
-        if (stored_type == svol_type && stored_idx ==idx && stored_slidx == slidx) {
-            remoteChanges[svol_host][loc + 3] += change;
-            new_loc = loc;
-        }
-        else {
-            remoteChanges[svol_host].push_back(svol_type);
-            remoteChanges[svol_host].push_back(idx);
-            remoteChanges[svol_host].push_back(slidx);
-            remoteChanges[svol_host].push_back(change);
+    MPI_Ineighbor_alltoall(pSendCounts.data(), 1, MPI_INT,
+                           pRecvCounts.data(), 1, MPI_INT, comm, &reqs[0]);
+    pSyncStage = 1;
+
+    #ifdef MPI_PROFILING
+    syncTime += (MPI_Wtime() - starttime);
+    #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_progressRemoteSync()
+{
+    MPI_Request * reqs = static_cast<MPI_Request*>(pSyncRequests);
+
+    if (pSyncStage == 1) {
+        int done = 0;
+        MPI_Test(&reqs[0], &done, MPI_STATUS_IGNORE);
+        if (!done) return;
+
+        uint nneighbs = pNeighbList.size();
+        int recv_total = 0;
+        for (uint n = 0; n < nneighbs; n++) {
+            pRecvDispls[n] = recv_total;
+            recv_total += pRecvCounts[n];
         }
+        // the receive buffer only grows, so steady state runs do not allocate
+        if (pRecvBuf.size() < static_cast<uint>(recv_total)) pRecvBuf.resize(recv_total);
+
+        MPI_Comm comm = *static_cast<MPI_Comm*>(pNeighbComm);
+        MPI_Ineighbor_alltoallv(pSendBuf.data(), pSendCounts.data(), pSendDispls.data(), MPI_UNSIGNED,
+                                pRecvBuf.data(), pRecvCounts.data(), pRecvDispls.data(), MPI_UNSIGNED,
+                                comm, &reqs[1]);
+        pSyncStage = 2;
+    }
+    else if (pSyncStage == 2) {
+        // let the MPI library advance the transfer
+        int done = 0;
+        MPI_Test(&reqs[1], &done, MPI_STATUS_IGNORE);
     }
-    return new_loc;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::TetOpSplitP:: _remoteSyncAndUpdate(void* requests, std::vector<KProc*> & applied_diffs, std::vector<int> & directions)
+void smtos::TetOpSplitP::_finishRemoteSync(std::vector<KProc*> & applied_diffs, std::vector<int> & directions,
+                                           double period)
 {
-
     #ifdef MPI_PROFILING
     double starttime = MPI_Wtime();
     #endif
 
-    MPI_Request* requestsPtr = static_cast<MPI_Request*>(requests);
-    
-    uint request_count = 0;
-    for (auto dest : neighbHosts) {
-
-        MPI_Isend(&remoteChanges[dest].front(), remoteChanges[dest].size(), MPI_UNSIGNED, dest, OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, &(requestsPtr[request_count]));
-        request_count ++;
+    // nothing was received if no exchange was started
+    bool exchanged = (pSyncStage != 0);
+    MPI_Request * reqs = static_cast<MPI_Request*>(pSyncRequests);
+    if (pSyncStage == 1) {
+        MPI_Wait(&reqs[0], MPI_STATUS_IGNORE);
+        _progressRemoteSync();
     }
-    
-    uint remain_comfirm = nNeighbHosts;
-    MPI_Status status;
-    std::set<KProc*> upd_kprocs;
-    
-    std::set<int> await_neighbors(neighbHosts);
-    
+    if (exchanged) MPI_Wait(&reqs[1], MPI_STATUS_IGNORE);
+    pSyncStage = 0;
+
     #ifdef MPI_PROFILING
     double endtime = MPI_Wtime();
-    syncTime += (endtime - starttime);
+    idleTime += (endtime - starttime);
+    starttime = MPI_Wtime();
     #endif
-    
-    while (!await_neighbors.empty()) {
-        #ifdef MPI_PROFILING
-        starttime = MPI_Wtime();
-        #endif
-        int flag = 0;
-        int data_source = 0;
-        for (auto neighbor : await_neighbors) {
-            MPI_Iprobe(neighbor, OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, &flag, &status);
-            if (flag) {
-                data_source = neighbor;
-                break;
-            }
-        }
-        #ifdef MPI_PROFILING
-        endtime = MPI_Wtime();
-        idleTime += (endtime - starttime);
-        #endif
-        if (!flag) continue;
 
-        #ifdef MPI_PROFILING
-        starttime = MPI_Wtime();
-        #endif
-        // receive data
-        int change_size = 0;
-        MPI_Get_count(&status, MPI_UNSIGNED, &change_size);
-        std::vector<uint> changes(change_size);
-        MPI_Recv(&changes.front(), change_size, MPI_UNSIGNED, status.MPI_SOURCE, OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    uint recv_total = 0;
+    if (exchanged) {
+        for (auto c : pRecvCounts) recv_total += c;
+    }
 
-        
-        // apply changes
-        uint nchanges = change_size / 4;
-        for (uint c = 0; c < nchanges; c++) {
-            uint type = changes[c * 4];
-            uint idx = changes[c * 4 + 1];
-            uint slidx = changes[c * 4 + 2];
-            uint value = changes[c * 4 + 3];
+    // new epoch for the kproc update stamps; on wrap-around clear them
+    if (++pUpdEpoch == 0) {
+        std::fill(pKProcUpdEpoch.begin(), pKProcUpdEpoch.end(), 0);
+        pUpdEpoch = 1;
+    }
+    pRemoteUpdKProcs.clear();
 
-            
-            if (type == SUB_WM) {
-                pWmVols[idx]->incCount(slidx, value);
-            }
-            if (type == SUB_TET) {
-                pTets[idx]->incCount(slidx, value);
-                std::vector<smtos::KProc*> const & remote_upd = pTets[idx]->getSpecUpdKProcs(slidx);
-                upd_kprocs.insert(remote_upd.begin(), remote_upd.end());
-            }
-            if (type == SUB_TRI) {
-                pTris[idx]->incCount(slidx, value);
-                std::vector<smtos::KProc*> const & remote_upd = pTris[idx]->getSpecUpdKProcs(slidx);
-                upd_kprocs.insert(remote_upd.begin(), remote_upd.end());
-            }
+    // apply changes
+    uint nchanges = recv_total / 4;
+    for (uint c = 0; c < nchanges; c++) {
+        uint type = pRecvBuf[c * 4];
+        uint idx = pRecvBuf[c * 4 + 1];
+        uint slidx = pRecvBuf[c * 4 + 2];
+        uint value = pRecvBuf[c * 4 + 3];
+
+        std::vector<smtos::KProc*> const * remote_upd = nullptr;
+        if (type == SUB_WM) {
+            pWmVols[idx]->incCount(slidx, value);
+        }
+        if (type == SUB_TET) {
+            smtos::Tet * tet = _globalTet(idx);
+            tet->incCount(slidx, value, period);
+            remote_upd = &(tet->getSpecUpdKProcs(slidx));
+        }
+        if (type == SUB_TRI) {
+            smtos::Tri * tri = _globalTri(idx);
+            tri->incCount(slidx, value, period);
+            remote_upd = &(tri->getSpecUpdKProcs(slidx));
+        }
+        if (remote_upd == nullptr) continue;
+
+        for (auto kp : *remote_upd) {
+            uint & stamp = pKProcUpdEpoch[kp->schedIDX()];
+            if (stamp == pUpdEpoch) continue;
+            stamp = pUpdEpoch;
+            pRemoteUpdKProcs.push_back(kp);
         }
-        
-        await_neighbors.erase(data_source);
-        #ifdef MPI_PROFILING
-        endtime = MPI_Wtime();
-        syncTime += (endtime - starttime);
-        #endif
     }
-    
+
     #ifdef MPI_PROFILING
+    endtime = MPI_Wtime();
+    syncTime += (endtime - starttime);
     starttime = MPI_Wtime();
     #endif
     
@@ -7884,7 +9179,7 @@ void smtos::TetOpSplitP:: _remoteSyncAndUpdate(void* requests, std::vector<KProc
     }
     
     // update kprocs caused by remote molecule changes
-    for (auto & upd_kp : upd_kprocs) {
+    for (auto & upd_kp : pRemoteUpdKProcs) {
         _updateElement(upd_kp);
     }
     _updateSum();
@@ -7899,36 +9194,39 @@ void smtos::TetOpSplitP:: _remoteSyncAndUpdate(void* requests, std::vector<KProc
 
 void smtos::TetOpSplitP::repartitionAndReset(std::vector<uint> const &tet_hosts, std::map<uint, uint> const &tri_hosts,  std::vector<uint> const &wm_hosts)
 {
+    _requireReplicatedMesh("repartitionAndReset");
+    _repartition(tet_hosts, tri_hosts, wm_hosts);
+    reset();
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_repartition(std::vector<uint> const &tet_hosts, std::map<uint, uint> const &tri_hosts,  std::vector<uint> const &wm_hosts)
+{
+    // buffered samples are laid out by the old ownership
+    if (!pObsPendingTimes.empty()) flushObservables(pObsFlushLocal);
+
     pKProcs.clear();
+    pVDepKProcs.clear();
     pDiffs.clear();
     pSDiffs.clear();
+    pActiveDiffs.clear();
+    pActiveSDiffs.clear();
     neighbHosts.clear();
     boundaryTets.clear();
     boundaryTris.clear();
     
-    uint ngroups = nGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(nGroups[i]->indices);
-        delete nGroups[i];
-    }
-    nGroups.clear();
-    
-    ngroups = pGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(pGroups[i]->indices);
-        delete pGroups[i];
-    }
-    pGroups.clear();
+    pCRSched.reset();
     
     tetHosts.assign(tet_hosts.begin(), tet_hosts.end());
     triHosts.clear();
     triHosts.insert(tri_hosts.begin(), tri_hosts.end());
     wmHosts.assign(wm_hosts.begin(), wm_hosts.end());
     
-    uint ntets = pTets.size();
-    for (uint t = 0; t < ntets; ++t) {
-        if (pTets[t] == 0) continue;
-        pTets[t]->repartition(this, myRank, tetHosts[t]);
+    for (auto t: pTets) {
+        if (t == 0) continue;
+        t->repartition(this, myRank, tetHosts[t->idx()]);
     }
     
     uint nwms = pWmVols.size();
@@ -7962,10 +9260,12 @@ void smtos::TetOpSplitP::repartitionAndReset(std::vector<uint> const &tet_hosts,
         tri->setupBufferLocations();
     }
     
-    if (efflag() == true) {
-        std::ostringstream os;
-        os << "Repartition of EField is not implemented:\n";
-        ArgErrLog(os.str());
+    // the EField mesh itself is replicated, only the ranks computing
+    // the membrane currents change; the distributed solver has gathered
+    // the potentials, so pick up those of the newly owned triangles
+    if (efflag()) {
+        _setupEFTriHosts();
+        if (pEFDistSolver != nullptr) _refreshEFTrisV();
     }
     
     neighbHosts.erase(myRank);
@@ -7977,15 +9277,191 @@ void smtos::TetOpSplitP::repartitionAndReset(std::vector<uint> const &tet_hosts,
         remoteChanges[neighbor] = std::vector<uint> ();
     }
     
+    // rank-local data refers to positions owned under the old partition,
+    // keep the rows aligned with the times but zero them
+    int dropped = 0;
+    for (auto & obs : pObservables) {
+        _setupObservable(obs);
+        for (double v : obs.localData) {
+            if (v != 0.0) { dropped = 1; break; }
+        }
+        obs.localData.assign(pObsTimes.size() * obs.localPos.size(), 0.0);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &dropped, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (dropped && myRank == 0) {
+        CLOG(WARNING, "general_log") << "Repartitioning moved the observed elements, rank-local observable data flushed so far now reads zero.\n";
+    }
+    
     nEntries = pKProcs.size();
     diffSep=pDiffs.size();
     sdiffSep=pSDiffs.size();
-    reset();
+    _partitionDiffs();
+    _setupNeighbComm();
+    _setupSSAGroups();
+    pKProcWork.assign(nEntries, 0.0);
+    pItersSinceRebalance = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::setRebalanceInterval(uint interval, double threshold)
+{
+    if (threshold < 1.0)
+    {
+        std::ostringstream os;
+        os << "Rebalance threshold " << threshold << " is below 1.0.\n";
+        ArgErrLog(os.str());
+    }
+    if (interval != 0) _requireReplicatedMesh("Load rebalancing");
+    pRebalanceInterval = interval;
+    pRebalanceThreshold = threshold;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::rebalance()
+{
+    _requireReplicatedMesh("rebalance");
+
+    std::vector<double> tet_work;
+    std::vector<double> tri_work;
+    _elementWork(tet_work, tri_work);
+
+    std::vector<uint> new_tet_hosts;
+    std::map<uint, uint> new_tri_hosts;
+    _balancedHosts(tet_work, tri_work, new_tet_hosts, new_tri_hosts);
+
+    // Pack the state of the hosted elements that move, per destination:
+    // a (type, index) header followed by the element record.
+    std::vector<std::vector<double> > out(nHosts);
+    for (auto t : pTets) {
+        if (t == nullptr || !t->getInHost()) continue;
+        int dest = new_tet_hosts[t->idx()];
+        if (dest == myRank) continue;
+        out[dest].push_back(SUB_TET);
+        out[dest].push_back(t->idx());
+        t->packState(out[dest]);
+    }
+    for (auto t : pTris) {
+        if (t == nullptr || !t->getInHost()) continue;
+        int dest = new_tri_hosts.at(t->idx());
+        if (dest == myRank) continue;
+        out[dest].push_back(SUB_TRI);
+        out[dest].push_back(t->idx());
+        t->packState(out[dest]);
+    }
+
+    std::vector<int> sendcounts(nHosts, 0);
+    std::vector<int> senddispls(nHosts, 0);
+    std::vector<double> sendbuf;
+    for (int r = 0; r < nHosts; ++r) {
+        senddispls[r] = sendbuf.size();
+        sendcounts[r] = out[r].size();
+        sendbuf.insert(sendbuf.end(), out[r].begin(), out[r].end());
+    }
+    std::vector<int> recvcounts(nHosts, 0);
+    std::vector<int> recvdispls(nHosts, 0);
+    MPI_Alltoall(sendcounts.data(), 1, MPI_INT, recvcounts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    std::partial_sum(recvcounts.begin(), recvcounts.end() - 1, recvdispls.begin() + 1);
+    std::vector<double> recvbuf(recvdispls.back() + recvcounts.back());
+    MPI_Alltoallv(sendbuf.data(), sendcounts.data(), senddispls.data(), MPI_DOUBLE,
+                  recvbuf.data(), recvcounts.data(), recvdispls.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+
+    _repartition(new_tet_hosts, new_tri_hosts, wmHosts);
+
+    // the kprocs of received elements exist now, so their constants,
+    // flags and extents can be restored together with the pools
+    double const * rec = recvbuf.data();
+    double const * rec_end = rec + recvbuf.size();
+    while (rec != rec_end) {
+        uint type = static_cast<uint>(*rec++);
+        uint idx = static_cast<uint>(*rec++);
+        if (type == SUB_TET) rec = _tet(idx)->unpackState(rec);
+        else rec = _tri(idx)->unpackState(rec);
+    }
+
+    _updateLocal();
+    pRebalanceCount++;
     MPI_Barrier(MPI_COMM_WORLD);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::TetOpSplitP::_elementWork(std::vector<double> & tet_work, std::vector<double> & tri_work) const
+{
+    std::vector<double> local_tet(mesh()->countTets(), 0.0);
+    std::vector<double> local_tri(mesh()->countTris(), 0.0);
+
+    for (auto t : pTets) {
+        if (t == nullptr || !t->getInHost()) continue;
+        uint start = t->getStartKProcIdx();
+        uint n = t->countKProcs();
+        for (uint k = 0; k < n; ++k) local_tet[t->idx()] += pKProcWork[start + k];
+    }
+    for (auto t : pTris) {
+        if (t == nullptr || !t->getInHost()) continue;
+        uint start = t->getStartKProcIdx();
+        uint n = t->countKProcs();
+        for (uint k = 0; k < n; ++k) local_tri[t->idx()] += pKProcWork[start + k];
+    }
+    // fixed cost of visiting the diffusion kprocs every update period
+    double iters = pItersSinceRebalance;
+    for (uint pos = 0; pos < diffSep; ++pos) local_tet[pDiffs[pos]->getTet()->idx()] += iters;
+    for (uint pos = 0; pos < sdiffSep; ++pos) local_tri[pSDiffs[pos]->getTri()->idx()] += iters;
+
+    tet_work.assign(local_tet.size(), 0.0);
+    tri_work.assign(local_tri.size(), 0.0);
+    MPI_Allreduce(local_tet.data(), tet_work.data(), local_tet.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(local_tri.data(), tri_work.data(), local_tri.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_defaultHosts()
+{
+    if (!triHosts.empty())
+    {
+        std::ostringstream os;
+        os << "Triangle hosts are given without tetrahedron hosts.\n";
+        ArgErrLog(os.str());
+    }
+
+    uint ntets = mesh()->countTets();
+    std::vector<double> tet_weights(ntets, 0.0);
+    for (uint t = 0; t < ntets; ++t)
+    {
+        steps::tetmesh::TmComp * comp = mesh()->getTetComp(t);
+        if (comp == nullptr) continue;
+        ssolver::Compdef * cdef = statedef()->compdef(statedef()->getCompIdx(comp));
+        tet_weights[t] = cdef->countReacs() + cdef->countDiffs();
+    }
+
+    std::map<uint, double> tri_weights;
+    uint ntris = mesh()->countTris();
+    for (uint t = 0; t < ntris; ++t)
+    {
+        steps::tetmesh::TmPatch * patch = mesh()->getTriPatch(t);
+        if (patch == nullptr) continue;
+        ssolver::Patchdef * pdef = statedef()->patchdef(statedef()->getPatchIdx(patch));
+        tri_weights[t] = pdef->countSReacs() + pdef->countSurfDiffs()
+                       + pdef->countGHKcurrs() + pdef->countVDepSReacs();
+    }
+
+    steps::tetmesh::partitionMesh(*mesh(), tet_weights, tri_weights, nHosts, tetHosts, triHosts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::TetOpSplitP::_balancedHosts(std::vector<double> const & tet_work, std::vector<double> const & tri_work,
+                                        std::vector<uint> & tet_hosts, std::map<uint, uint> & tri_hosts) const
+{
+    std::map<uint, double> tri_weights;
+    for (auto const & th : triHosts) tri_weights[th.first] = tri_work[th.first];
+    steps::tetmesh::partitionMesh(*mesh(), tet_work, tri_weights, nHosts, tet_hosts, tri_hosts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void smtos::TetOpSplitP::setDiffApplyThreshold(int threshold)
 {
     diffApplyThreshold = threshold;
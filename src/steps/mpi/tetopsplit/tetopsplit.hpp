@@ -30,11 +30,13 @@
 
 
 // STL headers.
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <fstream>
 #include <memory>
 #include <random>
@@ -52,7 +54,8 @@
 #include "steps/mpi/tetopsplit/patch.hpp"
 #include "steps/mpi/tetopsplit/diffboundary.hpp"
 #include "steps/mpi/tetopsplit/sdiffboundary.hpp"
-#include "steps/mpi/tetopsplit/crstruct.hpp"
+#include "steps/solver/crscheduler.hpp"
+#include "steps/rng/r123.hpp"
 
 
 #include "steps/solver/efield/efield.hpp"
@@ -61,6 +64,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace steps{
+namespace solver{
+namespace efield{
+class dVSolverDist;
+}
+}
+
 namespace mpi{
 namespace tetopsplit{
 
@@ -95,10 +104,20 @@ class TetOpSplitP: public steps::solver::API
 {
 public:
 
+    /// By default g is the whole mesh on every rank and the hosts are
+    /// indexed by its tets and tris. With tet_gidx given, g is instead this
+    /// rank's part of a distributed mesh: the tets and patch tris it hosts
+    /// plus a halo of the tets and tris next to them, with the hosts and
+    /// tet_gidx (tri_gidx) indexed by its own tets (tris) and the latter
+    /// giving their index in the whole mesh, by which all per-element
+    /// methods are then called. Each rank's g must have the same
+    /// compartments and patches in the same order.
     TetOpSplitP(steps::model::Model *m, steps::wm::Geom *g, steps::rng::RNG *r,
             int calcMembPot = EF_NONE, std::vector<uint> const &tet_hosts = std::vector<uint>(),
             std::map<uint, uint> const &tri_hosts = std::map<uint, uint>(),
-            std::vector<uint> const &wm_hosts = std::vector<uint>());
+            std::vector<uint> const &wm_hosts = std::vector<uint>(),
+            std::vector<uint> const &tet_gidx = std::vector<uint>(),
+            std::vector<uint> const &tri_gidx = std::vector<uint>());
     ~TetOpSplitP();
 
 
@@ -120,6 +139,11 @@ public:
     void advance(double adv);
     void step();
 
+    // file_name receives a manifest written by rank 0, holding the mesh
+    // partition, and every rank writes its owned state to file_name.rank<N>.
+    // Restore requires the same number of processes and moves the elements
+    // back to the stored partition. Both are collective and raise the same
+    // error on every rank, restore before changing any state.
     void checkpoint(std::string const & file_name);
     void restore(std::string const & file_name);
     ////////////////////////// ADDED FOR EFIELD ////////////////////////////
@@ -256,6 +280,8 @@ public:
     //      TETRAHEDRAL VOLUME ELEMENTS
     ////////////////////////////////////////////////////////////////////////
 
+    uint _countTets() const;
+
     double _getTetVol(uint tidx) const;
     void _setTetVol(uint tidx, double vol);
 
@@ -306,6 +332,8 @@ public:
     //      TRIANGULAR SURFACE ELEMENTS
     ////////////////////////////////////////////////////////////////////////
 
+    uint _countTris() const;
+
     double _getTriArea(uint tidx) const;
     void _setTriArea(uint tidx, double area);
 
@@ -386,6 +414,10 @@ public:
 
     void addDiff(Diff* diff);
     void addSDiff(SDiff* sdiff);
+
+    // Register a local KProc whose propensity depends on the membrane
+    // potential, so that only these are refreshed after each EField step.
+    void addVDepKProc(KProc* kp);
     inline uint countKProcs() const
     { return pKProcs.size(); }
 
@@ -423,15 +455,50 @@ public:
         return pSDiffBoundaries[sdbidx];
     }
 
+    /// Tetrahedron of local index tidx, which is the mesh index unless
+    /// the mesh is distributed.
     inline steps::mpi::tetopsplit::Tet * _tet(uint tidx) const
     { return pTets[tidx]; }
 
     inline steps::mpi::tetopsplit::Tri * _tri(uint tidx) const
     { return pTris[tidx]; }
 
+    /// Local object of mesh tetrahedron tidx, null if this rank holds none.
+    steps::mpi::tetopsplit::Tet * _globalTet(uint tidx) const;
+
+    /// Local object of mesh triangle tidx, null if this rank holds none.
+    steps::mpi::tetopsplit::Tri * _globalTri(uint tidx) const;
+
+    /// Mesh index of the local tetrahedron (triangle) tidx.
+    inline uint _tetGIdx(uint tidx) const
+    { return pDistMesh ? pTetGIdx[tidx] : tidx; }
+
+    inline uint _triGIdx(uint tidx) const
+    { return pDistMesh ? pTriGIdx[tidx] : tidx; }
+
+    /// Compartment of mesh tetrahedron tidx on every rank, null if none.
+    /// Collective with a distributed mesh, like the rest below.
+    steps::solver::Compdef * _tetCompdef(uint tidx) const;
+
+    /// Patch of mesh triangle tidx on every rank, null if none.
+    steps::solver::Patchdef * _triPatchdef(uint tidx) const;
+
+    /// The above for ntets (ntris) mesh elements in one call.
+    std::vector<steps::solver::Compdef *> _tetCompdefs(uint const * tets, uint ntets) const;
+    std::vector<steps::solver::Patchdef *> _triPatchdefs(uint const * tris, uint ntris) const;
+
+    /// Host rank of mesh tetrahedron (triangle) tidx, -1 if it has none.
+    int _tetHost(uint tidx) const;
+    int _triHost(uint tidx) const;
+
     inline double a0() const
     { return pA0; }
 
+    /// Simulation time at which the current window of diffusion rate
+    /// level l began.
+    inline double getDiffLevelStart(uint l) const
+    { return pDiffLevelStart[l]; }
+
     //inline bool built()
     //{ return pBuilt; }
 
@@ -461,10 +528,14 @@ public:
     // by constructor
     void _setup();
 
+    // map from bar to the patch triangles around it
+    void _patchBarTris(std::map<uint, std::vector<uint> > & bar2tri) const;
+
     void _runWithoutEField(double endtime);
     void _runWithEField(double endtime);
     //void _build();
-    void _refreshEFTrisV();
+    // local only refreshes the triangles hosted on this rank
+    void _refreshEFTrisV(bool local = false);
 
     double _getRate(uint i) const
     { return pKProcs[i]->rate(); }
@@ -494,6 +565,14 @@ public:
 
     void _setupEField();
 
+    // rank layout of the membrane triangle currents, recomputed
+    // whenever the triangle hosts change
+    void _setupEFTriHosts();
+
+    // vertex and triangle owners for the distributed dV solver: a vertex
+    // goes with the first conduction volume tet containing it
+    void _setupEFDistPartition();
+
     inline uint neftets() const
     { return pEFNTets; }
 
@@ -523,6 +602,56 @@ public:
     
     double sumBatchTriOhmicIsNP(unsigned int* indices, int input_size, std::string const & oc);
     
+    ////////////////////////////////////////////////////////////////////////
+    // Recorded Observables
+    ////////////////////////////////////////////////////////////////////////
+
+    // An observable is a count query (element set, species) declared once
+    // and sampled many times. Sampling only reads the pools owned by each
+    // rank; buffered samples reach rank 0 in a single MPI_Gatherv when
+    // flushed, so recording needs no per-value collectives.
+
+    /// Declare the counts of species s in tetrahedrons tets as an
+    /// observable and return its index. Collective.
+    uint addTetCountObservable(std::vector<uint> const & tets, std::string const & s);
+
+    /// Declare the counts of species s in triangles tris as an observable
+    /// and return its index. Collective.
+    uint addTriCountObservable(std::vector<uint> const & tris, std::string const & s);
+
+    uint countObservables() const
+    { return pObservables.size(); }
+
+    /// Sample all observables at the current time. Local to each rank, but
+    /// every rank must call it the same number of times between flushes.
+    void recordObservables();
+
+    /// Run to each of the ascending times and sample all observables there.
+    void runAndRecord(std::vector<double> const & times);
+
+    /// Move the buffered samples into the observable data, either gathered
+    /// on rank 0 or kept on the owning rank if rank_local. Collective.
+    void flushObservables(bool rank_local = false);
+
+    /// Times of the flushed samples.
+    std::vector<double> getObservableTimes() const
+    { return pObsTimes; }
+
+    /// Flushed samples of observable obs gathered on rank 0, one row of
+    /// query-ordered counts per sample. Empty on other ranks.
+    std::vector<double> getObservableData(uint obs) const;
+
+    /// Positions in the query of observable obs owned by this rank.
+    std::vector<uint> getObservableLocalPositions(uint obs) const;
+
+    /// Samples of observable obs flushed with rank_local, one row of counts
+    /// at getObservableLocalPositions() per sample. Rows flushed before a
+    /// repartition or rebalance read zero, as the owned positions change.
+    std::vector<double> getObservableLocalData(uint obs) const;
+
+    /// Drop all buffered and flushed samples. Observables stay declared.
+    void clearObservableData();
+
     ////////////////////////////////////////////////////////////////////////
     // ROI Data Access
     ////////////////////////////////////////////////////////////////////////
@@ -587,6 +716,54 @@ public:
     void repartitionAndReset(std::vector<uint> const &tet_hosts,
                      std::map<uint, uint> const &tri_hosts  = std::map<uint, uint>(),
                      std::vector<uint> const &wm_hosts = std::vector<uint>());
+
+    // Automatic load rebalancing. Every interval diffusion update periods
+    // the measured per-rank work is compared; if the maximum exceeds the
+    // mean by more than threshold, the mesh is repartitioned by measured
+    // work and the simulation state migrated without a reset.
+    // An interval of 0 disables it.
+    void setRebalanceInterval(uint interval, double threshold = 1.2);
+
+    // Repartition by the work measured since the last rebalance. Elements
+    // that stay on their rank keep their kprocs; the moved tetrahedrons
+    // and triangles take their pools, rate constants, active flags and
+    // extents along.
+    void rebalance();
+
+    uint getRebalanceCount() const {return pRebalanceCount;}
+
+    // Number of OpenMP threads applying the diffusions of tets and tris
+    // without a neighbour on another rank. With more than one thread
+    // these are ordered by a colouring of their elements so that
+    // concurrently processed elements never change the same pools, and
+    // each thread draws from its own counter-based random stream, reseeded
+    // every update period. Needs MPI_THREAD_FUNNELED.
+    void setDiffusionThreads(uint nthreads);
+    uint getDiffusionThreads() const {return pDiffThreads;}
+
+    // Number of power-of-two update periods the diffusions are binned
+    // into by their own scaled diffusion constant. A diffusion of level
+    // l is applied every 2^l update periods, from the occupancy of its
+    // species over those periods, and molecule changes are only
+    // exchanged in periods where a level with
+    // diffusions on a rank boundary is applied. All levels are applied
+    // in the last period of a run, and automatic rebalancing waits for
+    // such a period. One level (the default) is the single-rate scheme.
+    void setDiffusionRateLevels(uint nlevels);
+    uint getDiffusionRateLevels() const {return pDiffRateLevels;}
+
+    // Draw the random numbers of each diffusion update and of the
+    // reactions from their own Random123 streams, keyed by seed (the same
+    // on all ranks) and counted from the iteration and the tet or tri.
+    // Reactions run as a separate SSA per group of elements sharing
+    // pools (a tri with its surface reactions and the tets next to it),
+    // which is always hosted on one rank. Runs then give the same result
+    // for any partition and number of diffusion threads, at a fixed number
+    // of rate levels (which decides the iterations applying each
+    // diffusion). With a membrane potential, runs only match as far as
+    // the potentials computed for the partitions compared do.
+    void setElementRNG(bool enable, ulong seed = 0);
+    bool getElementRNG() const {return pElementRNG;}
     
     double getCompTime();
     double getSyncTime();
@@ -644,6 +821,10 @@ private:
 
     // separator for non-zero and zero propensity diffusions
     uint                                        diffSep;
+
+    // pDiffs[0, diffBndSep) are the diffusions of tets with a neighbour
+    // on another rank, the only ones that produce remote changes
+    uint                                        diffBndSep;
     
     ////////////////////////////////////////////////////////////////////////
     // Surface Diffusion Data and Methods
@@ -655,17 +836,95 @@ private:
     // separator for non-zero and zero propensity diffusions
     uint                                        sdiffSep;
 
+    // as diffBndSep, for surface diffusions
+    uint                                        sdiffBndSep;
+
+    // order boundary (s)diffusions before interior ones and set the
+    // separators above
+    void _partitionDiffs();
+
+    // Occupancy bitmaps of pDiffs and pSDiffs by position. The bit of a
+    // diffusion is set iff its rate is nonzero, so that the diffusion
+    // step visits only occupied ones, still in position order.
+    std::vector<uint64_t>                       pActiveDiffs;
+    std::vector<uint64_t>                       pActiveSDiffs;
+
+    // set the rate of a (surface) diffusion and its occupancy bit
+    void _setDiffRate(KProc* kp, double rate);
+
+    // rebuild the bitmaps from the rates, after positions have changed
+    // or rates were set directly
+    void _rebuildActiveDiffs();
+
+    // Scratch of a batch of diffusion updates whose binomials are drawn
+    // together: positions, then trials, probabilities and results.
+    struct DiffBatch
+    {
+        std::vector<uint>                       pos;
+        std::vector<uint>                       n;
+        std::vector<double>                     p;
+        std::vector<uint>                       nmolcs;
+    };
+
+    // the mean number of molecules and the probability that one of them
+    // moves, for the window of the level of d which ends at endtime;
+    // false if d has no molecules
+    template <typename DiffT>
+    bool _diffusionTrials(DiffT * d, double update_period, double endtime, steps::rng::RNG * r,
+                          uint & mean_n, double & t1);
+
+    // move nmolcs molecules of d and record the applied directions,
+    // returns nmolcs
+    template <typename DiffT>
+    uint _moveMolecules(DiffT * d, uint nmolcs, double endtime, steps::rng::RNG * r,
+                        std::vector<KProc*> & applied_diffs, std::vector<int> & directions);
+
+    // sample and apply one diffusion kproc from its per-element stream,
+    // returns the number of molecules moved
+    template <typename DiffT>
+    uint _applyDiffusion(DiffT * d, double update_period, double endtime,
+                         std::vector<KProc*> & applied_diffs, std::vector<int> & directions);
+
+    // sample the binomials of the diffusions at batch.pos with one
+    // getBinomBatch() call, then apply them; empties the batch
+    template <typename DiffT>
+    uint _applyDiffusionBatch(std::vector<DiffT*> const & diffs, std::vector<unsigned char> const & levels,
+                              std::vector<double> const & level_periods, double endtime,
+                              steps::rng::RNG * r, DiffBatch & batch,
+                              std::vector<KProc*> & applied_diffs, std::vector<int> & directions);
+
+    // apply the active diffusions in positions [bgn, end) of levels up
+    // to max_level, in batches of DIFF_BATCH_SIZE, polling the remote
+    // exchange after each batch if poll is set; returns the number of
+    // molecules moved
+    template <typename DiffT>
+    uint _applyDiffusions(std::vector<DiffT*> const & diffs, std::vector<uint64_t> const & active,
+                          std::vector<unsigned char> const & levels, uint bgn, uint end,
+                          std::vector<double> const & level_periods, uint max_level, double endtime,
+                          steps::rng::RNG * r, DiffBatch & batch, bool poll,
+                          std::vector<KProc*> & applied_diffs, std::vector<int> & directions);
+
+    // apply the active interior diffusions of levels up to max_level
+    // colour by colour on pDiffThreads threads, returns the number of
+    // molecules moved
+    template <typename DiffT>
+    uint _applyDiffusionByColour(std::vector<DiffT*> const & diffs, std::vector<uint64_t> const & active,
+                                 std::vector<unsigned char> const & levels, std::vector<uint> const & colour_sep,
+                                 std::vector<double> const & level_periods, uint max_level, double endtime,
+                                 std::vector<KProc*> & applied_diffs, std::vector<int> & directions);
+
     ////////////////////////////////////////////////////////////////////////
     // CR SSA Kernel Data and Methods
     ////////////////////////////////////////////////////////////////////////
     uint                                        nEntries;
-    double                                      pSum;
-    double                                      nSum;
     double                                      pA0;
 
     std::vector<KProc*>                         pKProcs;
-    std::vector<CRGroup*>                       nGroups;
-    std::vector<CRGroup*>                       pGroups;
+    // Subset of pKProcs whose rate depends on the membrane potential
+    std::vector<KProc*>                         pVDepKProcs;
+    // CR scheduler over the local kprocs; their scheduling state lives
+    // in KProc::crData.
+    steps::solver::CRScheduler<steps::solver::CRMemberStore<KProc> > pCRSched;
 
     ////////////////////////////////////////////////////////////////////////////////
     
@@ -675,12 +934,29 @@ private:
     void _updateLocal(std::vector<uint> const & upd_entries);
     void _updateLocal(uint* upd_entries, uint buffer_size);
     void _updateLocal();
-    CRGroup* _getGroup(int pow);
-    void _extendPGroups(uint new_size);
-    void _extendNGroups(uint new_size);
-    void _extendGroup(CRGroup* group, uint size = 1024);
     void _updateSum();
     void _updateElement(KProc* kp);
+
+    ////////////////////////////////////////////////////////////////////////
+    // Checkpointing
+    ////////////////////////////////////////////////////////////////////////
+
+    // Name of the per-rank checkpoint file next to the manifest file_name.
+    std::string _rankCheckpointFile(std::string const & file_name) const;
+    // Indices of the wmvols, tets and tris the given hosts assign to this rank.
+    void _ownedElements(std::vector<uint> const & tet_hosts, std::map<uint, uint> const & tri_hosts,
+        std::vector<uint> const & wm_hosts, std::vector<uint> & wmvols, std::vector<uint> & tets,
+        std::vector<uint> & tris) const;
+    // Mesh indices of the given local tets and tris, which the rank files
+    // store so that they do not depend on how a distributed mesh is held.
+    void _meshIndices(std::vector<uint> const & tets, std::vector<uint> const & tris,
+        std::vector<uint> & mesh_tets, std::vector<uint> & mesh_tris) const;
+    // Every checkpoint file ends with the size of what precedes it, so that
+    // restore can reject a truncated file before reading any state.
+    static void _writeCheckpointSize(std::fstream & cp_file);
+    static bool _checkCheckpointSize(std::fstream & cp_file);
+    // Largest of the error codes of all ranks, 0 if none failed. Collective.
+    int _maxErrorCode(int code) const;
     ////////////////////////////////////////////////////////////////////////
 
     // Keeps track of whether _build() has been called
@@ -700,6 +976,10 @@ private:
     // Pointer to the EField object
     std::unique_ptr<steps::solver::efield::EField> pEField;
 
+    // The solver of pEField if it is EF_DV_DIST, otherwise null. Each rank
+    // then supplies only the currents of its own triangles.
+    steps::solver::efield::dVSolverDist *       pEFDistSolver;
+
     // The Efield time-step
     double                                      pEFDT;
 
@@ -770,8 +1050,79 @@ private:
     std::set<steps::mpi::tetopsplit::Tri *>     boundaryTris;
     
     std::map<int, std::vector<uint> >           remoteChanges;
+
+    // Distributed graph communicator over neighbHosts, used for the
+    // molecule change exchange. Held as an opaque MPI_Comm * so this
+    // header does not depend on mpi.h.
+    void *                                      pNeighbComm;
+    std::vector<int>                            pNeighbList;
+    std::vector<int>                            pSendCounts;
+    std::vector<int>                            pSendDispls;
+    std::vector<int>                            pRecvCounts;
+    std::vector<int>                            pRecvDispls;
+    std::vector<uint>                           pSendBuf;
+    std::vector<uint>                           pRecvBuf;
+    // MPI_Request[2] for the size and data exchanges in flight, and how
+    // far the current exchange has got (0 idle, 1 sizes, 2 data posted)
+    void *                                      pSyncRequests;
+    int                                         pSyncStage;
+
+    // Per-kproc (by schedIDX) stamp of the last exchange that queued it
+    // for update, so remote changes are deduplicated without a set.
+    std::vector<uint>                           pKProcUpdEpoch;
+    uint                                        pUpdEpoch;
+    std::vector<KProc *>                        pRemoteUpdKProcs;
+
+    ////////////////////////////////////////////////////////////////////////
+    // Recorded Observables
+    ////////////////////////////////////////////////////////////////////////
+
+    struct Observable
+    {
+        bool                                    onTris;
+        uint                                    sgidx;
+        std::vector<uint>                       elems;
+        // Query positions owned by this rank and the local species index
+        // of each.
+        std::vector<uint>                       localPos;
+        std::vector<uint>                       localLidx;
+        // On rank 0: query positions owned by each rank, concatenated in
+        // rank order, how many belong to each rank and where each rank's
+        // run starts in rankPos.
+        std::vector<uint>                       rankPos;
+        std::vector<int>                        rankCounts;
+        std::vector<int>                        rankDispls;
+        std::vector<double>                     data;
+        std::vector<double>                     localData;
+    };
+
+    uint _addObservable(std::vector<uint> const & elems, std::string const & s, bool on_tris);
+    // Resolve local ownership of obs and tell rank 0. Collective.
+    void _setupObservable(Observable & obs);
+
+    std::vector<Observable>                     pObservables;
+    // Samples recorded since the last flush: per sample, the local values
+    // of every observable in declaration order.
+    std::vector<double>                         pObsPendingTimes;
+    std::vector<double>                         pObsBuffer;
+    std::vector<double>                         pObsTimes;
+    // mode of the last flush, reused when a repartition has to flush
+    bool                                        pObsFlushLocal;
     
-    void _remoteSyncAndUpdate(void* requests, std::vector<KProc*> & applied_diffs, std::vector<int> & directions);
+    // The molecule change exchange is split so that it can run while
+    // interior diffusion is computed: start posts the size exchange,
+    // progress posts the data exchange once sizes have arrived, and
+    // finish waits, applies remote changes at time period and updates
+    // kproc rates.
+    void _startRemoteSync();
+    void _progressRemoteSync();
+    void _finishRemoteSync(std::vector<KProc*> & applied_diffs, std::vector<int> & directions,
+                           double period);
+
+    // (re)create the neighbour communicator and exchange buffers
+    // after neighbHosts has been set up
+    void _setupNeighbComm();
+    void _freeNeighbComm();
     
     //void _applyRemoteMoleculeChanges(std::vector<MPI_Request> & requests);
     //void _syncPoolCounts();
@@ -779,6 +1130,150 @@ private:
     // send, receive and process remote upadtes
     //void _updateRemoteKProcRates(std::vector<MPI_Request> & requests);
     
+    ////////////////////////////////////////////////////////////////////////
+    // Load rebalancing
+    ////////////////////////////////////////////////////////////////////////
+
+    // Work per kproc (by schedIDX) since the last rebalance: SSA events
+    // plus molecules moved by diffusion.
+    std::vector<double>                         pKProcWork;
+    uint                                        pItersSinceRebalance;
+    uint                                        pRebalanceInterval;
+    double                                      pRebalanceThreshold;
+    uint                                        pRebalanceCount;
+
+    // rebuild kprocs, dependencies and exchange structures for new hosts,
+    // keeping pools; the caller resets or migrates the state
+    void _repartition(std::vector<uint> const &tet_hosts, std::map<uint, uint> const &tri_hosts,
+                      std::vector<uint> const &wm_hosts);
+
+    // measured work of the hosted tets and tris, indexed by mesh index
+    // and summed over all ranks
+    void _elementWork(std::vector<double> & tet_work, std::vector<double> & tri_work) const;
+
+    // partition the mesh by the expected number of kprocs of each tet
+    // and patch tri, used when no tet hosts are given to the constructor
+    void _defaultHosts();
+
+    // work-balanced hosts for the mesh tets and patch tris
+    void _balancedHosts(std::vector<double> const & tet_work, std::vector<double> const & tri_work,
+                        std::vector<uint> & tet_hosts, std::map<uint, uint> & tri_hosts) const;
+
+    ////////////////////////////////////////////////////////////////////////
+    // Thread-parallel diffusion
+    ////////////////////////////////////////////////////////////////////////
+
+    uint                                        pDiffThreads;
+
+    // With more than one thread, colour c of the interior diffusions is
+    // pDiffs[pDiffColourSep[c], pDiffColourSep[c + 1]), from diffBndSep
+    // to diffSep; empty otherwise. Likewise for surface diffusions.
+    std::vector<uint>                           pDiffColourSep;
+    std::vector<uint>                           pSDiffColourSep;
+
+    // per-thread random streams, reseeded from rng() on every run,
+    // and applied diffusion lists
+    std::vector<std::unique_ptr<steps::rng::RNG> > pThreadRNGs;
+    std::vector<std::vector<KProc*> >           pThreadAppliedDiffs;
+    std::vector<std::vector<int> >              pThreadDirections;
+
+    // per-thread diffusion batches
+    std::vector<DiffBatch>                      pDiffBatches;
+
+    // order the interior (s)diffusions by colour and set the separators
+    void _colourDiffs();
+
+    ////////////////////////////////////////////////////////////////////////
+    // Multi-rate diffusion
+    ////////////////////////////////////////////////////////////////////////
+
+    uint                                        pDiffRateLevels;
+
+    // rate level of pDiffs and pSDiffs by position
+    std::vector<unsigned char>                  pDiffLevel;
+    std::vector<unsigned char>                  pSDiffLevel;
+
+    // lowest level of an active boundary (s)diffusion on any rank, or
+    // pDiffRateLevels if there is none
+    uint                                        pBndDiffLevel;
+
+    // start time of the current window of each level; pool occupancies
+    // are integrated from the window start of their species' level
+    std::vector<double>                         pDiffLevelStart;
+
+    // assign the levels above from updPeriod, and to the pools of the
+    // diffused species (collective)
+    void _assignDiffLevels();
+
+    ////////////////////////////////////////////////////////////////////////
+    // Distributed mesh
+    ////////////////////////////////////////////////////////////////////////
+
+    // With a distributed mesh pTets, pTris and the host tables are indexed
+    // by this rank's own Tetmesh, and these map its tets and tris to and
+    // from the indices of the whole mesh, which has pGlobalTets tets and
+    // pGlobalTris tris.
+    bool                                        pDistMesh;
+    std::vector<uint>                           pTetGIdx;
+    std::vector<uint>                           pTriGIdx;
+    std::unordered_map<uint, uint>              pTetG2L;
+    std::unordered_map<uint, uint>              pTriG2L;
+    uint                                        pGlobalTets;
+    uint                                        pGlobalTris;
+
+    // check the partitioned input and build the maps above (collective)
+    void _setupDistMesh(std::vector<uint> const & tet_gidx, std::vector<uint> const & tri_gidx);
+
+    // set the compartment volumes and patch areas to the sums over the
+    // elements hosted on every rank (collective)
+    void _sumDistMeshSizes();
+
+    // reject a method that needs the whole mesh on every rank
+    void _requireReplicatedMesh(std::string const & method) const;
+
+    // distribute n molecules of species slidx over the elements in
+    // [bgn, end) hosted on every rank in proportion to weight: rank 0
+    // splits n between the ranks by their hosted weight, then each rank
+    // splits its share (collective)
+    template <typename ElemIter, typename Weight>
+    void _distributeHosted(double n, ElemIter bgn, ElemIter end, uint slidx, Weight weight);
+
+    ////////////////////////////////////////////////////////////////////////
+    // Per-element random streams
+    ////////////////////////////////////////////////////////////////////////
+
+    bool                                        pElementRNG;
+    ulong                                       pElementRNGSeed;
+
+    // one generator per diffusion thread, switched to the stream of each
+    // diffusion it samples
+    std::vector<std::unique_ptr<steps::rng::R123> > pElementRNGs;
+
+    // stream keys: the reactions at 0, the diffusion rules after that
+    std::vector<ulong>                          pElementRNGKeys;
+
+    // Reaction and surface reaction kprocs of the hosted elements, by
+    // group of elements sharing pools and in element order within a
+    // group. Group g spans [pSSAGroupSep[g], pSSAGroupSep[g + 1]) and
+    // draws from the stream of its element with the smallest mesh index,
+    // pSSAGroupKey[g] (tets, then tris, then well-mixed compartments).
+    std::vector<KProc*>                         pSSAGroupKProcs;
+    std::vector<uint>                           pSSAGroupSep;
+    std::vector<uint>                           pSSAGroupKey;
+
+    void _createElementRNGs();
+
+    // build the groups above for the current partition
+    void _setupSSAGroups();
+
+    // the SSA of the update period from pre_ssa_time, run per group
+    void _runElementSSA(double pre_ssa_time, double update_period);
+
+    // the generator of the calling thread at the stream of d for the
+    // current iteration
+    template <typename DiffT>
+    steps::rng::RNG * _elementStream(DiffT * d);
+
     // STL random number generator - also Mersenne twister
     std::random_device                          rd;
     std::mt19937                                gen;
@@ -85,6 +85,7 @@ smtos::Tri::Tri(uint idx, steps::solver::Patchdef * patchdef, double area,
 , pOCtime_upd(nullptr)
 , pPoolOccupancy(nullptr)
 , pLastUpdate(nullptr)
+, pPoolLevel(nullptr)
 , myRank(rank)
 , hostRank(host_rank)
 {
@@ -136,6 +137,8 @@ smtos::Tri::Tri(uint idx, steps::solver::Patchdef * patchdef, double area,
     std::fill_n(pPoolOccupancy, nspecs, 0.0);
     pLastUpdate = new double[nspecs];
     std::fill_n(pLastUpdate, nspecs, 0.0);
+    pPoolLevel = new unsigned char[nspecs];
+    std::fill_n(pPoolLevel, nspecs, 0);
 
     std::fill_n(pSDiffBndDirection, 3, false);
 }
@@ -151,6 +154,7 @@ smtos::Tri::~Tri()
     delete[] pOCtime_upd;
     delete[] pPoolOccupancy;
     delete[] pLastUpdate;
+    delete[] pPoolLevel;
 
     KProcPVecCI e = pKProcs.end();
     for (std::vector<smtos::KProc *>::const_iterator i = pKProcs.begin();
@@ -199,6 +203,45 @@ void smtos::Tri::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::Tri::packState(std::vector<double> & buf) const
+{
+    uint nspecs = patchdef()->countSpecs();
+    buf.insert(buf.end(), pPoolCount, pPoolCount + nspecs);
+    buf.insert(buf.end(), pPoolFlags, pPoolFlags + nspecs);
+
+    uint nghkcurrs = pPatchdef->countGHKcurrs();
+    buf.insert(buf.end(), pECharge, pECharge + nghkcurrs);
+    buf.insert(buf.end(), pECharge_last, pECharge_last + nghkcurrs);
+
+    uint nohmcurrs = pPatchdef->countOhmicCurrs();
+    buf.insert(buf.end(), pOCchan_timeintg, pOCchan_timeintg + nohmcurrs);
+    buf.insert(buf.end(), pOCtime_upd, pOCtime_upd + nohmcurrs);
+
+    for (auto kp : pKProcs) kp->packState(buf);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double const * smtos::Tri::unpackState(double const * buf)
+{
+    uint nspecs = patchdef()->countSpecs();
+    for (uint i = 0; i < nspecs; ++i) pPoolCount[i] = static_cast<uint>(*buf++);
+    for (uint i = 0; i < nspecs; ++i) pPoolFlags[i] = static_cast<uint>(*buf++);
+
+    uint nghkcurrs = pPatchdef->countGHKcurrs();
+    for (uint i = 0; i < nghkcurrs; ++i) pECharge[i] = static_cast<int>(*buf++);
+    for (uint i = 0; i < nghkcurrs; ++i) pECharge_last[i] = static_cast<int>(*buf++);
+
+    uint nohmcurrs = pPatchdef->countOhmicCurrs();
+    for (uint i = 0; i < nohmcurrs; ++i) pOCchan_timeintg[i] = *buf++;
+    for (uint i = 0; i < nohmcurrs; ++i) pOCtime_upd[i] = *buf++;
+
+    for (auto kp : pKProcs) buf = kp->unpackState(buf);
+    return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void smtos::Tri::setInnerTet(smtos::WmVol * t)
 {
     pInnerTet = t;
@@ -282,6 +325,7 @@ void smtos::Tri::setupKProcs(smtos::TetOpSplitP * tex, bool efield)
                 pKProcs[j++] = vdt;
                 uint idx = tex->addKProc(vdt);
                 vdt->setSchedIDX(idx);
+                tex->addVDepKProc(vdt);
             }
 
             uint nvdsreacs = patchdef()->countVDepSReacs();
@@ -293,6 +337,7 @@ void smtos::Tri::setupKProcs(smtos::TetOpSplitP * tex, bool efield)
                 pKProcs[j++] = vdsr;
                 uint idx = tex->addKProc(vdsr);
                 vdsr->setSchedIDX(idx);
+                tex->addVDepKProc(vdsr);
             }
 
             uint nghkcurrs = patchdef()->countGHKcurrs();
@@ -304,6 +349,7 @@ void smtos::Tri::setupKProcs(smtos::TetOpSplitP * tex, bool efield)
                 pKProcs[j++] = ghk;
                 uint idx = tex->addKProc(ghk);
                 ghk->setSchedIDX(idx);
+                tex->addVDepKProc(ghk);
             }
         }
     }
@@ -592,11 +638,7 @@ void smtos::Tri::setCount(uint lidx, uint count, double period)
 	if (period == 0.0) { return;
 }
 	// Count has changed,
-	double lastupdate = pLastUpdate[lidx];
-	AssertLog(period >= lastupdate);
-	pPoolOccupancy[lidx] += oldcount*(period-lastupdate);
-
-	pLastUpdate[lidx] = period;
+	_updateOccupancy(lidx, oldcount, period);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -629,12 +671,7 @@ void smtos::Tri::incCount(uint lidx, int inc, double period, bool local_change)
 		if (period == 0.0 || local_change) { return;
 }
 		// Count has changed,
-		double lastupdate = pLastUpdate[lidx];
-		AssertLog(period >= lastupdate);
-		pPoolOccupancy[lidx] += oldcount*(period-lastupdate);
-
-		pLastUpdate[lidx] = period;
-	
+		_updateOccupancy(lidx, oldcount, period);
     }
 }
 
@@ -883,6 +920,40 @@ void smtos::Tri::resetPoolOccupancy()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::Tri::setPoolLevel(uint lidx, uint level)
+{
+    AssertLog(lidx < patchdef()->countSpecs());
+    pPoolLevel[lidx] = static_cast<unsigned char>(level);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::Tri::_updateOccupancy(uint lidx, double oldcount, double period)
+{
+    double start = pSol->getDiffLevelStart(pPoolLevel[lidx]);
+    double lastupdate = pLastUpdate[lidx];
+    if (lastupdate <= start) {
+        pPoolOccupancy[lidx] = 0.0;
+        lastupdate = start;
+    }
+    AssertLog(period >= lastupdate);
+    pPoolOccupancy[lidx] += oldcount*(period-lastupdate);
+    pLastUpdate[lidx] = period;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double smtos::Tri::getWindowOccupancy(uint lidx, double period)
+{
+    AssertLog(lidx < patchdef()->countSpecs());
+    double start = pSol->getDiffLevelStart(pPoolLevel[lidx]);
+    double lastupdate = pLastUpdate[lidx];
+    if (lastupdate <= start) return pPoolCount[lidx] * (period - start);
+    return pPoolOccupancy[lidx] + pPoolCount[lidx] * (period - lastupdate);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 std::vector<smtos::KProc*> const & smtos::Tri::getSpecUpdKProcs(uint slidx)
 {
     return localSpecUpdKProcs[slidx];
@@ -893,14 +964,38 @@ std::vector<smtos::KProc*> const & smtos::Tri::getSpecUpdKProcs(uint slidx)
 
 void smtos::Tri::repartition(smtos::TetOpSplitP * tex, int rank, int host_rank)
 {
+    bool stays = (hostRank == myRank && host_rank == rank);
     myRank = rank;
     hostRank = host_rank;
     
-    // Delete reaction rules.
-    KProcPVecCI e = pKProcs.end();
-    for (KProcPVecCI i = pKProcs.begin(); i != e; ++i) delete *i;
-    
-    setupKProcs(tex);
+    // The kprocs of a triangle that stays on this rank keep their
+    // constants, flags and extents; they only get new solver indices.
+    if (stays) {
+        startKProcIdx = tex->countKProcs();
+        for (auto kp : pKProcs) {
+            kp->crData = steps::solver::CRKProcData();
+            kp->setSchedIDX(tex->addKProc(kp));
+            switch (kp->getType()) {
+                case KP_SDIFF:
+                    tex->addSDiff(static_cast<smtos::SDiff*>(kp));
+                    break;
+                case KP_VDEPTRANS:
+                case KP_VDEPSREAC:
+                case KP_GHK:
+                    tex->addVDepKProc(kp);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    else {
+        // Delete reaction rules.
+        KProcPVecCI e = pKProcs.end();
+        for (KProcPVecCI i = pKProcs.begin(); i != e; ++i) delete *i;
+        
+        setupKProcs(tex, hasEfield);
+    }
     
     localSpecUpdKProcs.clear();
     bufferLocations.clear();
@@ -96,6 +96,13 @@ public:
     /// restore data
     void restore(std::fstream & cp_file);
 
+    /// append pool counts, flags, current state and the kproc states
+    /// to buf, for migration to another rank
+    void packState(std::vector<double> & buf) const;
+
+    /// read back what packState wrote, returns the end of the record
+    double const * unpackState(double const * buf);
+
     ////////////////////////////////////////////////////////////////////////
     // SETUP
     ////////////////////////////////////////////////////////////////////////
@@ -272,6 +279,14 @@ public:
 	double getLastUpdate(uint lidx);
 	void resetPoolOccupancy();
 
+    // Diffusion rate level of species lidx, whose window its occupancy
+    // covers.
+    void setPoolLevel(uint lidx, uint level);
+
+    // Count of species lidx integrated from the start of the current
+    // window of its level up to period.
+    double getWindowOccupancy(uint lidx, double period);
+
     std::vector<smtos::KProc*> const & getSpecUpdKProcs(uint slidx);
     
     void repartition(smtos::TetOpSplitP * tex, int rank, int host_rank);
@@ -348,6 +363,12 @@ private:
     double                            * pPoolOccupancy;
     /// Structure to store time since last update, used to calculate occupancy
     double 							  *	pLastUpdate;
+    /// Diffusion rate level of each species
+    unsigned char                     * pPoolLevel;
+
+    // add the occupancy of oldcount up to period, dropping what is left
+    // of an earlier window
+    void _updateOccupancy(uint lidx, double oldcount, double period);
     
     std::vector<uint>                   bufferLocations;
     std::vector<std::vector<smtos::KProc *>> localSpecUpdKProcs;
@@ -331,15 +331,11 @@ double smtos::VDepSReac::rate(steps::mpi::tetopsplit::TetOpSplitP * solver)
 
         double h_mu = 1.0;
 
-        uint * lhs_s_vec = pdef->vdepsreac_lhs_S_bgn(lidx);
         uint * cnt_s_vec = pTri->pools();
-        uint nspecs_s = pdef->countSpecs();
-        for (uint s = 0; s < nspecs_s; ++s)
+        for (auto const & sc : pdef->vdepsreac_lhs_S_sparse(lidx))
         {
-            uint lhs = lhs_s_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_s_vec[s];
+            uint lhs = sc.coeff;
+            uint cnt = cnt_s_vec[sc.lidx];
             if (lhs > cnt)
             {
                 return 0.0;
@@ -373,15 +369,11 @@ double smtos::VDepSReac::rate(steps::mpi::tetopsplit::TetOpSplitP * solver)
 
         if (pVDepSReacdef->inside())
         {
-            uint * lhs_i_vec = pdef->vdepsreac_lhs_I_bgn(lidx);
             uint * cnt_i_vec = pTri->iTet()->pools();
-            uint nspecs_i = pdef->countSpecs_I();
-            for (uint s = 0; s < nspecs_i; ++s)
+            for (auto const & sc : pdef->vdepsreac_lhs_I_sparse(lidx))
             {
-                uint lhs = lhs_i_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_i_vec[s];
+                uint lhs = sc.coeff;
+                uint cnt = cnt_i_vec[sc.lidx];
                 if (lhs > cnt)
                 {
                     return 0.0;
@@ -415,15 +407,11 @@ double smtos::VDepSReac::rate(steps::mpi::tetopsplit::TetOpSplitP * solver)
         }
         else if (pVDepSReacdef->outside())
         {
-            uint * lhs_o_vec = pdef->vdepsreac_lhs_O_bgn(lidx);
             uint * cnt_o_vec = pTri->oTet()->pools();
-            uint nspecs_o = pdef->countSpecs_O();
-            for (uint s = 0; s < nspecs_o; ++s)
+            for (auto const & sc : pdef->vdepsreac_lhs_O_sparse(lidx))
             {
-                uint lhs = lhs_o_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_o_vec[s];
+                uint lhs = sc.coeff;
+                uint cnt = cnt_o_vec[sc.lidx];
                 if (lhs > cnt)
                 {
                     return 0.0;
@@ -497,14 +485,12 @@ void smtos::VDepSReac::apply(steps::rng::RNG * rng, double dt, double simtime, d
     }
 
     // Update triangle pools.
-    uint nspecs_s = pdef->countSpecs();
-    for (uint s = 0; s < nspecs_s; ++s)
+    for (auto const & sc : pdef->vdepsreac_upd_S_sparse(lidx))
     {
+        uint s = sc.lidx;
         if (pTri->clamped(s) == true) { continue;
 }
-        int upd = upd_s_vec[s];
-        if (upd == 0) { continue;
-}
+        int upd = sc.coeff;
         int nc = static_cast<int>(cnt_s_vec[s]) + upd;
         AssertLog(nc >= 0);
         pTri->setCount(s, static_cast<uint>(nc), period);
@@ -514,16 +500,13 @@ void smtos::VDepSReac::apply(steps::rng::RNG * rng, double dt, double simtime, d
     smtos::WmVol * itet = pTri->iTet();
     if (itet != nullptr)
     {
-        int * upd_i_vec = pdef->vdepsreac_upd_I_bgn(lidx);
         uint * cnt_i_vec = itet->pools();
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
+        for (auto const & sc : pdef->vdepsreac_upd_I_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (itet->clamped(s) == true) { continue;
 }
-            int upd = upd_i_vec[s];
-            if (upd == 0) { continue;
-}
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_i_vec[s]) + upd;
             AssertLog(nc >= 0);
             itet->setCount(s, static_cast<uint>(nc), period);
@@ -534,16 +517,13 @@ void smtos::VDepSReac::apply(steps::rng::RNG * rng, double dt, double simtime, d
     smtos::WmVol * otet = pTri->oTet();
     if (otet != nullptr)
     {
-        int * upd_o_vec = pdef->vdepsreac_upd_O_bgn(lidx);
         uint * cnt_o_vec = otet->pools();
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
+        for (auto const & sc : pdef->vdepsreac_upd_O_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (otet->clamped(s) == true) { continue;
 }
-            int upd = upd_o_vec[s];
-            if (upd == 0) { continue;
-}
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_o_vec[s]) + upd;
             AssertLog(nc >= 0);
             otet->setCount(s, static_cast<uint>(nc), period);
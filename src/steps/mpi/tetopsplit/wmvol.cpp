@@ -119,6 +119,27 @@ void smtos::WmVol::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::WmVol::packState(std::vector<double> & buf) const
+{
+    uint nspecs = compdef()->countSpecs();
+    buf.insert(buf.end(), pPoolCount, pPoolCount + nspecs);
+    buf.insert(buf.end(), pPoolFlags, pPoolFlags + nspecs);
+    for (auto kp : pKProcs) kp->packState(buf);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double const * smtos::WmVol::unpackState(double const * buf)
+{
+    uint nspecs = compdef()->countSpecs();
+    for (uint i = 0; i < nspecs; ++i) pPoolCount[i] = static_cast<uint>(*buf++);
+    for (uint i = 0; i < nspecs; ++i) pPoolFlags[i] = static_cast<uint>(*buf++);
+    for (auto kp : pKProcs) buf = kp->unpackState(buf);
+    return buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void smtos::WmVol::setNextTri(smtos::Tri * t)
 {
     uint index = pNextTris.size();
@@ -308,9 +329,21 @@ void smtos::WmVol::resetPoolOccupancy()
 
 void smtos::WmVol::repartition(smtos::TetOpSplitP * tex, int rank, int host_rank)
 {
+    bool stays = (hostRank == myRank && host_rank == rank);
     myRank = rank;
     hostRank = host_rank;
     
+    // The reactions of a compartment that stays on this rank keep their
+    // constants, flags and extents; they only get new solver indices.
+    if (stays) {
+        startKProcIdx = tex->countKProcs();
+        for (auto kp : pKProcs) {
+            kp->crData = steps::solver::CRKProcData();
+            kp->setSchedIDX(tex->addKProc(kp));
+        }
+        return;
+    }
+    
     // Delete reaction rules.
     KProcPVecCI e = pKProcs.end();
     for (KProcPVecCI i = pKProcs.begin(); i != e; ++i) delete *i;
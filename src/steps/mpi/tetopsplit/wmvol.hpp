@@ -98,6 +98,13 @@ public:
     /// restore data
     virtual void restore(std::fstream & cp_file);
 
+    /// append pool counts, flags and the kproc states to buf, for
+    /// migration to another rank
+    void packState(std::vector<double> & buf) const;
+
+    /// read back what packState wrote, returns the end of the record
+    double const * unpackState(double const * buf);
+
     ////////////////////////////////////////////////////////////////////////
     // SETUP
     ////////////////////////////////////////////////////////////////////////
@@ -26,11 +26,19 @@
 
 
 // Standard library & STL headers.
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <sstream>
 #include <string>
 
+// Multi-lane kernels need the x86 intrinsics and GCC-style function
+// targets; other platforms use the scalar generator only.
+#if defined(__x86_64__) && defined(__GNUC__)
+#define STEPS_R123_SIMD 1
+#include <immintrin.h>
+#endif
+
 // STEPS headers.
 #include "steps/common.h"
 #include "steps/error.hpp"
@@ -64,20 +72,227 @@ void R123::concreteInitialize(ulong seed)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-/// Fills the buffer with random numbers on [0,0xffffffff]-interval.
-void R123::concreteFillBuffer()
+void R123::setStream(ulong stream_key, uint c1, uint c2, uint c3)
+{
+    key[0] = stream_key;
+    key[1] = stream_key >> 32;
+    ctr[0] = 0;
+    ctr[1] = c1;
+    ctr[2] = c2;
+    ctr[3] = c3;
+    rNext = rEnd;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ulong R123::streamKey(ulong seed, uint id)
+{
+    r123_type::key_type k = {{static_cast<uint>(seed), static_cast<uint>(seed >> 32)}};
+    r123_type::ctr_type c = {{id, 0u, 0u, 0u}};
+    r123_type::ctr_type rn = r123_type()(c, k);
+    return (static_cast<ulong>(rn[1]) << 32) | rn[0];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Philox4x32-8 over several counters at once. The lanes of a vector
+// hold the same word of consecutive blocks; mulhilo32 is done on the
+// even and odd 32-bit lanes separately, as the SIMD multiply gives
+// 64-bit products of every other lane.
+
+typedef R123::r123_type::ctr_type r123_ctr;
+typedef R123::r123_type::key_type r123_key;
+
+static uint philoxBlocksScalar(r123_ctr & ctr, r123_key const & key, uint * out, uint nblocks)
 {
-    uint* b;
-    for (b = rBuffer; b+4 <= rEnd; b+=4) {
-        /// Getting 4 new random numbers
-        r123_type::ctr_type rn = r(ctr, key);
+    R123::r123_type r;
+    for (uint i = 0; i < nblocks; ++i, out += 4) {
+        r123_ctr rn = r(ctr, key);
         ctr_increment(ctr);
-        b[0] = rn[0];
-        b[1] = rn[1];
-        b[2] = rn[2];
-        b[3] = rn[3];
+        out[0] = rn[0];
+        out[1] = rn[1];
+        out[2] = rn[2];
+        out[3] = rn[3];
+    }
+    return nblocks;
+}
+
+#ifdef STEPS_R123_SIMD
+
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("avx2")))
+static inline void mulhilo8(__m256i m, __m256i x, __m256i & lo, __m256i & hi)
+{
+    __m256i even = _mm256_mul_epu32(m, x);
+    __m256i odd = _mm256_mul_epu32(m, _mm256_srli_epi64(x, 32));
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+// Store words c0..c3 of eight blocks as 32 consecutive numbers.
+__attribute__((target("avx2")))
+static inline void storeBlocks8(__m256i c0, __m256i c1, __m256i c2, __m256i c3, uint * out)
+{
+    __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+    __m256i t1 = _mm256_unpackhi_epi32(c0, c1);
+    __m256i t2 = _mm256_unpacklo_epi32(c2, c3);
+    __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i * o = reinterpret_cast<__m256i*>(out);
+    _mm256_storeu_si256(o, _mm256_permute2x128_si256(u0, u1, 0x20));
+    _mm256_storeu_si256(o + 1, _mm256_permute2x128_si256(u2, u3, 0x20));
+    _mm256_storeu_si256(o + 2, _mm256_permute2x128_si256(u0, u1, 0x31));
+    _mm256_storeu_si256(o + 3, _mm256_permute2x128_si256(u2, u3, 0x31));
+}
+
+__attribute__((target("avx2")))
+static uint philoxBlocks8(r123_ctr & ctr, r123_key const & key, uint * out, uint nblocks)
+{
+    const __m256i m0 = _mm256_set1_epi32(PHILOX_M4x32_0);
+    const __m256i m1 = _mm256_set1_epi32(PHILOX_M4x32_1);
+    uint64_t x = ctr[0] + (static_cast<uint64_t>(ctr[1]) << 32);
+    alignas(32) uint32_t lo[8];
+    alignas(32) uint32_t hi[8];
+
+    uint done = 0;
+    for (; done + 8 <= nblocks; done += 8, out += 32) {
+        for (uint i = 0; i < 8; ++i) {
+            lo[i] = static_cast<uint32_t>(x + i);
+            hi[i] = static_cast<uint32_t>((x + i) >> 32);
+        }
+        x += 8;
+
+        __m256i c0 = _mm256_load_si256(reinterpret_cast<__m256i*>(lo));
+        __m256i c1 = _mm256_load_si256(reinterpret_cast<__m256i*>(hi));
+        __m256i c2 = _mm256_set1_epi32(ctr[2]);
+        __m256i c3 = _mm256_set1_epi32(ctr[3]);
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+        for (uint round = 0; round < 8; ++round) {
+            if (round > 0) {
+                k0 += PHILOX_W32_0;
+                k1 += PHILOX_W32_1;
+            }
+            __m256i lo0, hi0, lo1, hi1;
+            mulhilo8(m0, c0, lo0, hi0);
+            mulhilo8(m1, c2, lo1, hi1);
+            c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(k0));
+            c1 = lo1;
+            c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(k1));
+            c3 = lo0;
+        }
+        storeBlocks8(c0, c1, c2, c3, out);
     }
+    // avoid SSE transition penalties in the caller (not done by -O0/-O1)
+    _mm256_zeroupper();
+
+    ctr[0] = static_cast<uint32_t>(x);
+    ctr[1] = static_cast<uint32_t>(x >> 32);
+    return done;
+}
 
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("avx512f")))
+static inline void mulhilo16(__m512i m, __m512i x, __m512i & lo, __m512i & hi)
+{
+    __m512i even = _mm512_mul_epu32(m, x);
+    __m512i odd = _mm512_mul_epu32(m, _mm512_srli_epi64(x, 32));
+    lo = _mm512_mask_blend_epi32(0xAAAA, even, _mm512_slli_epi64(odd, 32));
+    hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+}
+
+__attribute__((target("avx512f")))
+static uint philoxBlocks16(r123_ctr & ctr, r123_key const & key, uint * out, uint nblocks)
+{
+    const __m512i m0 = _mm512_set1_epi32(PHILOX_M4x32_0);
+    const __m512i m1 = _mm512_set1_epi32(PHILOX_M4x32_1);
+    uint64_t x = ctr[0] + (static_cast<uint64_t>(ctr[1]) << 32);
+    alignas(64) uint32_t lo[16];
+    alignas(64) uint32_t hi[16];
+
+    uint done = 0;
+    for (; done + 16 <= nblocks; done += 16, out += 64) {
+        for (uint i = 0; i < 16; ++i) {
+            lo[i] = static_cast<uint32_t>(x + i);
+            hi[i] = static_cast<uint32_t>((x + i) >> 32);
+        }
+        x += 16;
+
+        __m512i c0 = _mm512_load_si512(lo);
+        __m512i c1 = _mm512_load_si512(hi);
+        __m512i c2 = _mm512_set1_epi32(ctr[2]);
+        __m512i c3 = _mm512_set1_epi32(ctr[3]);
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+        for (uint round = 0; round < 8; ++round) {
+            if (round > 0) {
+                k0 += PHILOX_W32_0;
+                k1 += PHILOX_W32_1;
+            }
+            __m512i lo0, hi0, lo1, hi1;
+            mulhilo16(m0, c0, lo0, hi0);
+            mulhilo16(m1, c2, lo1, hi1);
+            c0 = _mm512_xor_si512(_mm512_xor_si512(hi1, c1), _mm512_set1_epi32(k0));
+            c1 = lo1;
+            c2 = _mm512_xor_si512(_mm512_xor_si512(hi0, c3), _mm512_set1_epi32(k1));
+            c3 = lo0;
+        }
+        // blocks 0-7 are in the lower halves, 8-15 in the upper ones
+        storeBlocks8(_mm512_castsi512_si256(c0), _mm512_castsi512_si256(c1),
+                     _mm512_castsi512_si256(c2), _mm512_castsi512_si256(c3), out);
+        storeBlocks8(_mm512_extracti64x4_epi64(c0, 1), _mm512_extracti64x4_epi64(c1, 1),
+                     _mm512_extracti64x4_epi64(c2, 1), _mm512_extracti64x4_epi64(c3, 1), out + 32);
+    }
+    _mm256_zeroupper();
+
+    ctr[0] = static_cast<uint32_t>(x);
+    ctr[1] = static_cast<uint32_t>(x >> 32);
+    return done;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Widest kernel the CPU supports, checked once.
+static uint availableLanes()
+{
+    static const uint lanes = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return 16u;
+        if (__builtin_cpu_supports("avx2")) return 8u;
+        return 1u;
+    }();
+    return lanes;
+}
+
+#endif // STEPS_R123_SIMD
+
+////////////////////////////////////////////////////////////////////////////////
+
+void steps::rng::philoxFill(r123_ctr & ctr, r123_key const & key, uint * out, uint nblocks, uint max_lanes)
+{
+    uint done = 0;
+#ifdef STEPS_R123_SIMD
+    uint lanes = std::min(max_lanes, availableLanes());
+    if (lanes >= 16) done += philoxBlocks16(ctr, key, out, nblocks);
+    if (lanes >= 8) done += philoxBlocks8(ctr, key, out + 4 * done, nblocks - done);
+#endif
+    philoxBlocksScalar(ctr, key, out + 4 * done, nblocks - done);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Fills the buffer with random numbers on [0,0xffffffff]-interval.
+void R123::concreteFillBuffer()
+{
+    uint nblocks = (rEnd - rBuffer) / 4;
+    philoxFill(ctr, key, rBuffer, nblocks);
+
+    uint* b = rBuffer + 4 * nblocks;
     if (b == rEnd) {
         return;
     }
@@ -92,4 +307,20 @@ void R123::concreteFillBuffer()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void R123::concreteCheckpoint(std::fstream & cp_file) const
+{
+    cp_file.write((char*)key.data(), sizeof(r123_type::key_type::value_type) * key.size());
+    cp_file.write((char*)ctr.data(), sizeof(r123_type::ctr_type::value_type) * ctr.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void R123::concreteRestore(std::fstream & cp_file)
+{
+    cp_file.read((char*)key.data(), sizeof(r123_type::key_type::value_type) * key.size());
+    cp_file.read((char*)ctr.data(), sizeof(r123_type::ctr_type::value_type) * ctr.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // END
@@ -94,6 +94,19 @@ public:
     ///
     virtual ~R123() {}
 
+    /// Restart at the Philox counter {0, c1, c2, c3} under the 64-bit
+    /// stream_key and drop the buffered numbers. The following numbers are
+    /// those of the consecutive blocks from there, which gives independent
+    /// counter-based streams, e.g. per simulation element and time step.
+    ///
+    void setStream(ulong stream_key, uint c1, uint c2, uint c3);
+
+    /// Key for setStream() derived from seed and a stream id: the first
+    /// two words of the Philox block at counter {id, 0, 0, 0} under seed,
+    /// so that streams of different ids use unrelated keys.
+    ///
+    static ulong streamKey(ulong seed, uint id);
+
 protected:
 
     /// Initialize the generator with seed.
@@ -105,6 +118,9 @@ protected:
     ///
     virtual void concreteFillBuffer();
 
+    virtual void concreteCheckpoint(std::fstream & cp_file) const;
+    virtual void concreteRestore(std::fstream & cp_file);
+
 private:
 
     r123_type::key_type key;
@@ -115,6 +131,16 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Write nblocks consecutive Philox4x32-8 blocks for ctr and key to out,
+/// four numbers per block, and advance ctr past them as R123 does.
+/// Up to max_lanes blocks (16, 8 or 1) are computed at once, limited to
+/// what the CPU supports (AVX-512F, AVX2); all widths give the same
+/// numbers.
+void philoxFill(R123::r123_type::ctr_type & ctr, R123::r123_type::key_type const & key,
+                uint * out, uint nblocks, uint max_lanes = 16);
+
+////////////////////////////////////////////////////////////////////////////////
+
 }
 }
 
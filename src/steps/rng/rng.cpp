@@ -28,8 +28,10 @@
 // Standard library & STL headers.
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <random>
+#include <sstream>
 #include <string>
 
 // STEPS headers.
@@ -50,6 +52,12 @@ using std::string;
 namespace smath = steps::math;
 using steps::rng::RNG;
 
+// Method selection of RNG::getBinom() for t trials with probability
+// p <= 0.5 (see the sampler functions).
+static const uint   BINOM_TRIALS_MAX_T = 16;
+static const double BINOM_TRIALS_MIN_P = 1.0 / 4096.0;
+static const double BINOM_INVERSION_MAX_MEAN = 30.0;
+
 ////////////////////////////////////////////////////////////////////////////////
 RNG::RNG(uint bufsize)
 : rBuffer(nullptr)
@@ -60,6 +68,8 @@ RNG::RNG(uint bufsize)
 {
     rBuffer = new uint[rSize];
     rNext = rEnd = rBuffer + rSize;
+    pBTPE.n = 0;
+    pBTPE.p = -1.0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -83,7 +93,11 @@ void RNG::initialize(ulong const & seed)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-float RNG::getStdExp()
+#ifdef STEPS_LEGACY_RNG_SAMPLERS
+
+// Single-precision samplers of earlier releases. They keep their working
+// variables in function statics and are therefore not thread-safe.
+static float legacyStdExp(RNG & rng)
 {
     static float q[8] =
     {
@@ -94,7 +108,7 @@ float RNG::getStdExp()
     static float sexpo, a, u, ustar, umin;
     static float *q1 = q;
     a = 0.0;
-    u = getUnfEE();
+    u = rng.getUnfEE();
     goto S30;
 S20:
     a += *q1;
@@ -114,10 +128,10 @@ S30:
     return sexpo;
 S60:
     i = 1;
-    ustar = getUnfEE();
+    ustar = rng.getUnfEE();
     umin = ustar;
 S70:
-    ustar = getUnfEE();
+    ustar = rng.getUnfEE();
     if(ustar < umin) { umin = ustar;
 }
     i += 1;
@@ -129,6 +143,289 @@ S70:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// FOR DETAILS SEE:
+//     AHRENS, J.H. AND DIETER, U.
+//     EXTENSIONS OF FORSYTHE'S METHOD FOR RANDOM
+//     SAMPLING FROM THE NORMAL DISTRIBUTION.
+//     MATH. COMPUT., 27,124 (OCT. 1973), 927 - 937.
+//
+// ALL STATEMENT NUMBERS CORRESPOND TO THE STEPS OF ALGORITHM 'FL'
+// (M=5) IN THE ABOVE PAPER     (SLIGHTLY MODIFIED IMPLEMENTATION)
+//
+// Modified by Barry W. Brown, Feb 3, 1988 to use RANF instead of
+// SUNIF.  The argument IR thus goes away.
+//
+// THE DEFINITIONS OF THE CONSTANTS A(K), D(K), T(K) AND
+// H(K) ARE ACCORDING TO THE ABOVEMENTIONED ARTICLE
+static float legacyStdNrm(RNG & rng)
+{
+    static float a[32] =
+    {
+        0.0000000,      3.917609E-2,    7.841241E-2,    0.11777,
+        0.1573107,      0.1970991,      0.2372021,      0.2776904,
+        0.3186394,      0.36013,        0.4022501,      0.4450965,
+        0.4887764,      0.5334097,      0.5791322,      0.626099,
+        0.6744898,      0.7245144,      0.7764218,      0.8305109,
+        0.8871466,      0.9467818,      1.00999,        1.077516,
+        1.150349,       1.229859,       1.318011,       1.417797,
+        1.534121,       1.67594,        1.862732,       2.153875
+    };
+    static float d[31] = {
+        0.0,            0.0,            0.0,            0.0,
+        0.0,            0.2636843,      0.2425085,      0.2255674,
+        0.2116342,      0.1999243,      0.1899108,      0.1812252,
+        0.1736014,      0.1668419,      0.1607967,      0.1553497,
+        0.1504094,      0.1459026,      0.14177,        0.1379632,
+        0.1344418,      0.1311722,      0.128126,       0.1252791,
+        0.1226109,      0.1201036,      0.1177417,      0.1155119,
+        0.1134023,      0.1114027,      0.1095039
+    };
+    static float t[31] = {
+        7.673828E-4,    2.30687E-3,     3.860618E-3,    5.438454E-3,
+        7.0507E-3,      8.708396E-3,    1.042357E-2,    1.220953E-2,
+        1.408125E-2,    1.605579E-2,    1.81529E-2,     2.039573E-2,
+        2.281177E-2,    2.543407E-2,    2.830296E-2,    3.146822E-2,
+        3.499233E-2,    3.895483E-2,    4.345878E-2,    4.864035E-2,
+        5.468334E-2,    6.184222E-2,    7.047983E-2,    8.113195E-2,
+        9.462444E-2,    0.1123001,      0.136498,       0.1716886,
+        0.2276241,      0.330498,       0.5847031
+    };
+    static float h[31] = {
+        3.920617E-2,    3.932705E-2,    3.951E-2,        3.975703E-2,
+        4.007093E-2,    4.045533E-2,    4.091481E-2,     4.145507E-2,
+        4.208311E-2,    4.280748E-2,    4.363863E-2,     4.458932E-2,
+        4.567523E-2,    4.691571E-2,    4.833487E-2,     4.996298E-2,
+        5.183859E-2,    5.401138E-2,    5.654656E-2,     5.95313E-2,
+        6.308489E-2,    6.737503E-2,    7.264544E-2,     7.926471E-2,
+        8.781922E-2,    9.930398E-2,    0.11556,         0.1404344,
+        0.1836142,      0.2790016,      0.7010474
+    };
+    static long i;
+    static float snorm, u, s, ustar, aa, w, y, tt;
+    u = rng.getUnfEE();
+    s = 0.0;
+    if(u > 0.5) { s = 1.0;
+}
+    u += (u - s);
+    u = 32.0 * u;
+    i = (long)(u);
+    if(i == 32) { i = 31;
+}
+    if(i == 0) { goto S100;
+}
+
+    // START CENTER
+    ustar = u - (float)i;
+    aa = *(a + i - 1);
+
+S40:
+    if(ustar <= *(t + i - 1)) { goto S60;
+}
+    w = (ustar - *(t + i - 1)) * *(h + i - 1);
+
+S50:
+    // EXIT   (BOTH CASES)
+    y = aa + w;
+    snorm = y;
+    if(s == 1.0) { snorm = -y;
+}
+    return snorm;
+
+S60:
+    // CENTER CONTINUED
+    u = rng.getUnfEE();
+    w = u * (*(a + i) - aa);
+    tt = (0.5 * w + aa) * w;
+    goto S80;
+
+S70:
+    tt = u;
+    ustar = rng.getUnfEE();
+
+S80:
+    if(ustar > tt) { goto S50;
+}
+    u = rng.getUnfEE();
+    if(ustar >= u) { goto S70;
+}
+    ustar = rng.getUnfEE();
+    goto S40;
+
+S100:
+    // START TAIL
+    i = 6;
+    aa = *(a + 31);
+    goto S120;
+
+S110:
+    aa += *(d+i-1);
+    i += 1;
+
+S120:
+    u += u;
+    if(u < 1.0) { goto S110;
+}
+    u -= 1.0;
+
+S140:
+    w = u * *(d + i - 1);
+    tt = (0.5 * w + aa) * w;
+    goto S160;
+
+S150:
+    tt = u;
+
+S160:
+    ustar = rng.getUnfEE();
+    if(ustar > tt) { goto S50;
+}
+    u = rng.getUnfEE();
+    if(ustar >= u) { goto S150;
+}
+    u = rng.getUnfEE();
+    goto S140;
+}
+
+#else
+
+// Ziggurat tables of G. Marsaglia and W. W. Tsang, "The ziggurat method for
+// generating random variables", J. Stat. Softw. 5(8), 2000, scaled for 53-bit
+// uniforms. A layer i sample j * w[i] is accepted outright if j < k[i], and
+// f[i] is the density at the outer edge of layer i. Layer 0 is the base strip
+// that includes the tail beyond r.
+static const double ZIG_EXP_R = 7.697117470131487;
+static const double ZIG_EXP_V = 3.949659822581572e-3;
+static const double ZIG_NRM_R = 3.442619855899;
+static const double ZIG_NRM_V = 9.91256303526217e-3;
+
+struct Ziggurat
+{
+    Ziggurat();
+
+    uint64_t                    ke[256];
+    double                      we[256];
+    double                      fe[256];
+
+    uint64_t                    kn[128];
+    double                      wn[128];
+    double                      fn[128];
+};
+
+Ziggurat::Ziggurat()
+{
+    const double m = 9007199254740992.0;
+
+    double de = ZIG_EXP_R, te = de;
+    double q = ZIG_EXP_V / std::exp(-de);
+    ke[0] = static_cast<uint64_t>((de / q) * m);
+    ke[1] = 0;
+    we[0] = q / m;
+    we[255] = de / m;
+    fe[0] = 1.0;
+    fe[255] = std::exp(-de);
+    for (int i = 254; i >= 1; --i) {
+        de = -std::log(ZIG_EXP_V / de + std::exp(-de));
+        ke[i + 1] = static_cast<uint64_t>((de / te) * m);
+        te = de;
+        fe[i] = std::exp(-de);
+        we[i] = de / m;
+    }
+
+    double dn = ZIG_NRM_R, tn = dn;
+    q = ZIG_NRM_V / std::exp(-0.5 * dn * dn);
+    kn[0] = static_cast<uint64_t>((dn / q) * m);
+    kn[1] = 0;
+    wn[0] = q / m;
+    wn[127] = dn / m;
+    fn[0] = 1.0;
+    fn[127] = std::exp(-0.5 * dn * dn);
+    for (int i = 126; i >= 1; --i) {
+        dn = std::sqrt(-2.0 * std::log(ZIG_NRM_V / dn + std::exp(-0.5 * dn * dn)));
+        kn[i + 1] = static_cast<uint64_t>((dn / tn) * m);
+        tn = dn;
+        fn[i] = std::exp(-0.5 * dn * dn);
+        wn[i] = dn / m;
+    }
+}
+
+// The tables are built once and only read afterwards.
+static Ziggurat const & ziggurat()
+{
+    static const Ziggurat tables;
+    return tables;
+}
+
+// Uniform number on the (0,1) interval with 53-bit resolution.
+static inline double unf53EE(RNG & rng)
+{
+    return ((rng.get64() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+double RNG::getStdExp()
+{
+#ifdef STEPS_LEGACY_RNG_SAMPLERS
+    return legacyStdExp(*this);
+#else
+    Ziggurat const & z = ziggurat();
+    // the tail beyond r is again exponential, shifted by r
+    double shift = 0.0;
+    while (true) {
+        uint64_t r = get64();
+        uint i = r & 0xff;
+        uint64_t j = r >> 11;
+        double x = j * z.we[i];
+        if (j < z.ke[i]) {
+            return shift + x;
+        }
+        if (i == 0) {
+            shift += ZIG_EXP_R;
+        }
+        else if (z.fe[i] + unf53EE(*this) * (z.fe[i - 1] - z.fe[i]) < std::exp(-x)) {
+            return shift + x;
+        }
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double RNG::getStdNrm()
+{
+#ifdef STEPS_LEGACY_RNG_SAMPLERS
+    return legacyStdNrm(*this);
+#else
+    Ziggurat const & z = ziggurat();
+    while (true) {
+        uint64_t r = get64();
+        uint i = r & 0x7f;
+        bool neg = (r >> 7) & 1;
+        uint64_t j = r >> 11;
+        double x = j * z.wn[i];
+        if (j < z.kn[i]) {
+            return neg ? -x : x;
+        }
+        if (i == 0) {
+            // Marsaglia's tail method
+            double y;
+            do {
+                x = -std::log(unf53EE(*this)) / ZIG_NRM_R;
+                y = -std::log(unf53EE(*this));
+            } while (y + y < x * x);
+            return neg ? -(ZIG_NRM_R + x) : ZIG_NRM_R + x;
+        }
+        if (z.fn[i] + unf53EE(*this) * (z.fn[i - 1] - z.fn[i]) < std::exp(-0.5 * x * x)) {
+            return neg ? -x : x;
+        }
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 long RNG::getPsn(float lambda)
 {
     static float a0 = -0.5;
@@ -345,166 +642,242 @@ S180:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-// FOR DETAILS SEE:
-//     AHRENS, J.H. AND DIETER, U.
-//     EXTENSIONS OF FORSYTHE'S METHOD FOR RANDOM
-//     SAMPLING FROM THE NORMAL DISTRIBUTION.
-//     MATH. COMPUT., 27,124 (OCT. 1973), 927 - 937.
-//
-// ALL STATEMENT NUMBERS CORRESPOND TO THE STEPS OF ALGORITHM 'FL'
-// (M=5) IN THE ABOVE PAPER     (SLIGHTLY MODIFIED IMPLEMENTATION)
-//
-// Modified by Barry W. Brown, Feb 3, 1988 to use RANF instead of
-// SUNIF.  The argument IR thus goes away.
-//
-// THE DEFINITIONS OF THE CONSTANTS A(K), D(K), T(K) AND
-// H(K) ARE ACCORDING TO THE ABOVEMENTIONED ARTICLE
-float RNG::getStdNrm()
+double RNG::getExp(double lambda)
 {
-    static float a[32] =
-    {
-        0.0000000,      3.917609E-2,    7.841241E-2,    0.11777,
-        0.1573107,      0.1970991,      0.2372021,      0.2776904,
-        0.3186394,      0.36013,        0.4022501,      0.4450965,
-        0.4887764,      0.5334097,      0.5791322,      0.626099,
-        0.6744898,      0.7245144,      0.7764218,      0.8305109,
-        0.8871466,      0.9467818,      1.00999,        1.077516,
-        1.150349,       1.229859,       1.318011,       1.417797,
-        1.534121,       1.67594,        1.862732,       2.153875
-    };
-    static float d[31] = {
-        0.0,            0.0,            0.0,            0.0,
-        0.0,            0.2636843,      0.2425085,      0.2255674,
-        0.2116342,      0.1999243,      0.1899108,      0.1812252,
-        0.1736014,      0.1668419,      0.1607967,      0.1553497,
-        0.1504094,      0.1459026,      0.14177,        0.1379632,
-        0.1344418,      0.1311722,      0.128126,       0.1252791,
-        0.1226109,      0.1201036,      0.1177417,      0.1155119,
-        0.1134023,      0.1114027,      0.1095039
-    };
-    static float t[31] = {
-        7.673828E-4,    2.30687E-3,     3.860618E-3,    5.438454E-3,
-        7.0507E-3,      8.708396E-3,    1.042357E-2,    1.220953E-2,
-        1.408125E-2,    1.605579E-2,    1.81529E-2,     2.039573E-2,
-        2.281177E-2,    2.543407E-2,    2.830296E-2,    3.146822E-2,
-        3.499233E-2,    3.895483E-2,    4.345878E-2,    4.864035E-2,
-        5.468334E-2,    6.184222E-2,    7.047983E-2,    8.113195E-2,
-        9.462444E-2,    0.1123001,      0.136498,       0.1716886,
-        0.2276241,      0.330498,       0.5847031
-    };
-    static float h[31] = {
-        3.920617E-2,    3.932705E-2,    3.951E-2,        3.975703E-2,
-        4.007093E-2,    4.045533E-2,    4.091481E-2,     4.145507E-2,
-        4.208311E-2,    4.280748E-2,    4.363863E-2,     4.458932E-2,
-        4.567523E-2,    4.691571E-2,    4.833487E-2,     4.996298E-2,
-        5.183859E-2,    5.401138E-2,    5.654656E-2,     5.95313E-2,
-        6.308489E-2,    6.737503E-2,    7.264544E-2,     7.926471E-2,
-        8.781922E-2,    9.930398E-2,    0.11556,         0.1404344,
-        0.1836142,      0.2790016,      0.7010474
-    };
-    static long i;
-    static float snorm, u, s, ustar, aa, w, y, tt;
-    u = getUnfEE();
-    s = 0.0;
-    if(u > 0.5) { s = 1.0;
-}
-    u += (u - s);
-    u = 32.0 * u;
-    i = (long)(u);
-    if(i == 32) { i = 31;
-}
-    if(i == 0) { goto S100;
+     return (1.0 / lambda) * (double)getStdExp();
 }
 
-    // START CENTER
-    ustar = u - (float)i;
-    aa = *(a + i - 1);
 
-S40:
-    if(ustar <= *(t + i - 1)) { goto S60;
-}
-    w = (ustar - *(t + i - 1)) * *(h + i - 1);
+uint RNG::getBinom(uint t, double p)
+{
+#ifdef STEPS_LEGACY_RNG_SAMPLERS
+    uint t_small = 20;
 
-S50:
-    // EXIT   (BOTH CASES)
-    y = aa + w;
-    snorm = y;
-    if(s == 1.0) { snorm = -y;
-}
-    return snorm;
+    if (t<=t_small) { // for small numbers of trials, small_binomial is faster
+	small_binomial_distribution<uint> d(t,p);
+        return d(*this);
+    }
 
-S60:
-    // CENTER CONTINUED
-    u = getUnfEE();
-    w = u * (*(a + i) - aa);
-    tt = (0.5 * w + aa) * w;
-    goto S80;
+    std::binomial_distribution<uint> distribution(t, p);
+    return distribution(*this);
+#else
+    if (t == 0 || p <= 0.0) return 0;
+    if (p >= 1.0) return t;
 
-S70:
-    tt = u;
-    ustar = getUnfEE();
+    // sample the number of the less likely outcomes
+    bool flip = (p > 0.5);
+    double r = flip ? 1.0 - p : p;
 
-S80:
-    if(ustar > tt) { goto S50;
-}
-    u = getUnfEE();
-    if(ustar >= u) { goto S70;
+    uint x;
+    if (t <= BINOM_TRIALS_MAX_T && r >= BINOM_TRIALS_MIN_P) {
+        x = binomTrials(t, r);
+    }
+    else if (t * r <= BINOM_INVERSION_MAX_MEAN) {
+        x = binomInversion(t, r);
+    }
+    else {
+        x = binomBTPE(t, r);
+    }
+    return flip ? t - x : x;
+#endif
 }
-    ustar = getUnfEE();
-    goto S40;
 
-S100:
-    // START TAIL
-    i = 6;
-    aa = *(a + 31);
-    goto S120;
+////////////////////////////////////////////////////////////////////////////////
 
-S110:
-    aa += *(d+i-1);
-    i += 1;
+void RNG::getBinomBatch(const uint * n, const double * p, uint * out, size_t k)
+{
+    for (size_t i = 0; i < k; ++i) {
+        out[i] = getBinom(n[i], p[i]);
+    }
+}
 
-S120:
-    u += u;
-    if(u < 1.0) { goto S110;
+////////////////////////////////////////////////////////////////////////////////
+
+// Counts the successes of t Bernoulli trials, each a comparison of one 32-bit
+// draw with p scaled to 2^32. Fastest for the few trials of most diffusion
+// updates; p >= BINOM_TRIALS_MIN_P keeps the rounding of p below 1e-6.
+uint RNG::binomTrials(uint t, double p)
+{
+    uint32_t threshold = static_cast<uint32_t>(p * 4294967296.0 + 0.5);
+    uint x = 0;
+    for (uint i = 0; i < t; ++i) {
+        x += (get() < threshold);
+    }
+    return x;
 }
-    u -= 1.0;
 
-S140:
-    w = u * *(d + i - 1);
-    tt = (0.5 * w + aa) * w;
-    goto S160;
+////////////////////////////////////////////////////////////////////////////////
 
-S150:
-    tt = u;
+// Sequential search of the CDF from 0 with one uniform; p <= 0.5 and n * p
+// small, so that only a few terms are visited.
+uint RNG::binomInversion(uint n, double p)
+{
+    double q = 1.0 - p;
+    double qn;
+    if (n < 128) {
+        // q^n by branch-free repeated squaring, cheaper than exp(log())
+        double b = q;
+        qn = 1.0;
+        for (uint k = 0; k < 7; ++k) {
+            qn *= ((n >> k) & 1) ? b : 1.0;
+            b *= b;
+        }
+    }
+    else {
+        qn = std::exp(n * std::log1p(-p));
+    }
 
-S160:
-    ustar = getUnfEE();
-    if(ustar > tt) { goto S50;
-}
-    u = getUnfEE();
-    if(ustar >= u) { goto S150;
-}
-    u = getUnfEE();
-    goto S140;
+    double s = p / q;
+    while (true) {
+        double u = getUnfIE53();
+        double px = qn;
+        uint x = 0;
+        while (u > px) {
+            // only reached through rounding in the tail; draw again
+            if (x == n) break;
+            u -= px;
+            ++x;
+            px *= ((n - x + 1) * s) / x;
+        }
+        if (u <= px) return x;
+    }
 }
 
-double RNG::getExp(double lambda)
+////////////////////////////////////////////////////////////////////////////////
+
+// BTPE algorithm of V. Kachitvichyanukul and B. W. Schmeiser, "Binomial
+// random variate generation", Commun. ACM 31(2), 1988, for p <= 0.5 and
+// n * p > 30.
+uint RNG::binomBTPE(uint n, double p)
 {
-     return (1.0 / lambda) * (double)getStdExp();
+    BTPESetup & b = pBTPE;
+    if (b.n != n || b.p != p) {
+        b.n = n;
+        b.p = p;
+        b.r = p;
+        b.q = 1.0 - p;
+        b.nrq = n * b.r * b.q;
+        b.fm = n * b.r + b.r;
+        b.m = static_cast<long>(std::floor(b.fm));
+        b.p1 = std::floor(2.195 * std::sqrt(b.nrq) - 4.6 * b.q) + 0.5;
+        b.xm = b.m + 0.5;
+        b.xl = b.xm - b.p1;
+        b.xr = b.xm + b.p1;
+        b.c = 0.134 + 20.5 / (15.3 + b.m);
+        double a = (b.fm - b.xl) / (b.fm - b.xl * b.r);
+        b.laml = a * (1.0 + a / 2.0);
+        a = (b.xr - b.fm) / (b.xr * b.q);
+        b.lamr = a * (1.0 + a / 2.0);
+        b.p2 = b.p1 * (1.0 + 2.0 * b.c);
+        b.p3 = b.p2 + b.c / b.laml;
+        b.p4 = b.p3 + b.c / b.lamr;
+    }
+
+    while (true) {
+        double u = getUnfIE53() * b.p4;
+        double v = getUnfIE53();
+        long y;
+
+        if (u <= b.p1) {
+            // triangular region, accepted immediately
+            return static_cast<uint>(std::floor(b.xm - b.p1 * v + u));
+        }
+        if (u <= b.p2) {
+            // parallelograms
+            double x = b.xl + (u - b.p1) / b.c;
+            v = v * b.c + 1.0 - std::fabs(b.m - x + 0.5) / b.p1;
+            if (v > 1.0) continue;
+            y = static_cast<long>(std::floor(x));
+        }
+        else if (u <= b.p3) {
+            // left exponential tail
+            if (v == 0.0) continue;
+            y = static_cast<long>(std::floor(b.xl + std::log(v) / b.laml));
+            if (y < 0) continue;
+            v = v * (u - b.p2) * b.laml;
+        }
+        else {
+            // right exponential tail
+            if (v == 0.0) continue;
+            y = static_cast<long>(std::floor(b.xr - std::log(v) / b.lamr));
+            if (y > static_cast<long>(n)) continue;
+            v = v * (u - b.p3) * b.lamr;
+        }
+
+        double k = std::fabs(static_cast<double>(y - b.m));
+        if (k <= 20.0 || k >= b.nrq / 2.0 - 1.0) {
+            // explicit evaluation of f(y) / f(m)
+            double s = b.r / b.q;
+            double a = s * (n + 1);
+            double f = 1.0;
+            if (b.m < y) {
+                for (long i = b.m + 1; i <= y; ++i) f *= (a / i - s);
+            }
+            else if (b.m > y) {
+                for (long i = y + 1; i <= b.m; ++i) f /= (a / i - s);
+            }
+            if (v <= f) return static_cast<uint>(y);
+            continue;
+        }
+
+        // squeezing with the normal approximation
+        double rho = (k / b.nrq) * ((k * (k / 3.0 + 0.625) + 0.1666666666666667) / b.nrq + 0.5);
+        double t = -k * k / (2.0 * b.nrq);
+        double lv = std::log(v);
+        if (lv < t - rho) return static_cast<uint>(y);
+        if (lv > t + rho) continue;
+
+        // final acceptance with Stirling's formula
+        double x1 = y + 1.0;
+        double f1 = b.m + 1.0;
+        double z = n + 1.0 - b.m;
+        double w = n - y + 1.0;
+        double x2 = x1 * x1;
+        double f2 = f1 * f1;
+        double z2 = z * z;
+        double w2 = w * w;
+        double bound = b.xm * std::log(f1 / x1)
+            + (n - b.m + 0.5) * std::log(z / w)
+            + (y - b.m) * std::log(w * b.r / (x1 * b.q))
+            + (13680. - (462. - (132. - (99. - 140. / f2) / f2) / f2) / f2) / f1 / 166320.
+            + (13680. - (462. - (132. - (99. - 140. / z2) / z2) / z2) / z2) / z / 166320.
+            + (13680. - (462. - (132. - (99. - 140. / x2) / x2) / x2) / x2) / x1 / 166320.
+            + (13680. - (462. - (132. - (99. - 140. / w2) / w2) / w2) / w2) / w / 166320.;
+        if (lv <= bound) return static_cast<uint>(y);
+    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
 
-uint RNG::getBinom(uint t, double p)
+void RNG::checkpoint(std::fstream & cp_file) const
 {
-    uint t_small = 20;
+    uint next = static_cast<uint>(rNext - rBuffer);
+    cp_file.write((char*)&rSize, sizeof(uint));
+    cp_file.write((char*)&pInitialized, sizeof(bool));
+    cp_file.write((char*)&next, sizeof(uint));
+    cp_file.write((char*)rBuffer, sizeof(uint) * rSize);
+    concreteCheckpoint(cp_file);
+}
 
-    if (t<=t_small) { // for small numbers of trials, small_binomial is faster
-	small_binomial_distribution<uint> d(t,p);
-        return d(*this);
-    }
+////////////////////////////////////////////////////////////////////////////////
 
-    std::binomial_distribution<uint> distribution(t, p);
-    return distribution(*this);
+void RNG::restore(std::fstream & cp_file)
+{
+    uint stored_size = 0;
+    uint next = 0;
+    cp_file.read((char*)&stored_size, sizeof(uint));
+    if (stored_size != rSize) {
+        std::ostringstream os;
+        os << "RNG buffer size mismatch in checkpoint (stored ";
+        os << stored_size << ", current " << rSize << ").";
+        ArgErrLog(os.str());
+    }
+    cp_file.read((char*)&pInitialized, sizeof(bool));
+    cp_file.read((char*)&next, sizeof(uint));
+    AssertLog(next <= rSize);
+    cp_file.read((char*)rBuffer, sizeof(uint) * rSize);
+    rNext = rBuffer + next;
+    concreteRestore(cp_file);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
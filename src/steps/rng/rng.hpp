@@ -30,6 +30,9 @@
 
 
 // STL headers.
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
 #include <string>
 
 // STEPS headers.
@@ -108,8 +111,21 @@ public:
         return(a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
     }
 
+    /// Return the next two random ints of the buffer as one 64-bit number.
+    ///
+    inline uint64_t get64()
+    {
+        uint64_t hi = get();
+        return (hi << 32) | get();
+    }
+
     /// Get a standard exponentially distributed number.
-    float getStdExp();
+    ///
+    /// Uses a 256-layer ziggurat on 53-bit uniforms; the tables are shared
+    /// read-only, so generators in different threads do not interfere.
+    /// Builds with STEPS_LEGACY_RNG_SAMPLERS use the single-precision
+    /// Ahrens-Dieter sampler of earlier releases instead.
+    double getStdExp();
 
     /// Get an exponentially distributed number with mean lambda.
     ///
@@ -121,12 +137,37 @@ public:
 
     /// Get a standard normally distributed random number.
     ///
-    float getStdNrm();
+    /// Uses a 128-layer ziggurat on 53-bit uniforms (see getStdExp()).
+    double getStdNrm();
 
     /// Get a binomially distributed number with parameters t and p.
     ///
+    /// Counts single trials for t <= 16, uses inversion with one uniform
+    /// when t * min(p, 1-p) <= 30 and BTPE (Kachitvichyanukul & Schmeiser,
+    /// 1988) otherwise. The BTPE setup is cached for repeated calls with the
+    /// same t and p.
+    /// Builds with STEPS_LEGACY_RNG_SAMPLERS use std::binomial_distribution.
     uint getBinom(uint t, double p);
 
+    /// Get k binomially distributed numbers out[i] with parameters n[i]
+    /// and p[i]; equivalent to k calls of getBinom().
+    ///
+    void getBinomBatch(const uint * n, const double * p, uint * out, size_t k);
+
+    /// Return the size of the buffer, which a checkpoint must match.
+    ///
+    inline uint getBufferSize() const
+    { return rSize; }
+
+    /// Write the complete generator state, including the unconsumed part
+    /// of the buffer, to a checkpoint file.
+    ///
+    void checkpoint(std::fstream & cp_file) const;
+
+    /// Restore a generator state previously written by checkpoint().
+    ///
+    void restore(std::fstream & cp_file);
+
 protected:
 
     uint                      * rBuffer;
@@ -141,10 +182,30 @@ protected:
     ///
     virtual void concreteFillBuffer() = 0;
 
+    /// Write / read the state of the underlying engine.
+    ///
+    virtual void concreteCheckpoint(std::fstream & cp_file) const = 0;
+    virtual void concreteRestore(std::fstream & cp_file) = 0;
+
 private:
 
     bool                        pInitialized;
 
+    uint binomTrials(uint t, double p);
+    uint binomInversion(uint n, double p);
+    uint binomBTPE(uint n, double p);
+
+    // Setup of the last BTPE binomial.
+    struct BTPESetup
+    {
+        uint                    n;
+        double                  p;
+        long                    m;
+        double                  r, q, nrq, fm, xm, xl, xr, c;
+        double                  laml, lamr, p1, p2, p3, p4;
+    };
+    BTPESetup                   pBTPE;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
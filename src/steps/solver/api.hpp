@@ -71,6 +71,8 @@ public:
         EF_DV_BDSYS,
         EF_DV_SLUSYS,
         EF_DV_PETSC,
+        EF_DV_CG,
+        EF_DV_DIST,
     };
 
     /// Constructor
@@ -173,6 +175,27 @@ public:
     /// Return the number of steps.
     virtual uint getNSteps() const;
 
+    ////////////////////////////////////////////////////////////////////////
+    // NAME RESOLUTION
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Return a handle to species s, to be passed to the handle-based
+    /// overloads of the data access methods (e.g. getTetCount) so that
+    /// the name is resolved once rather than on every call.
+    ///
+    /// \param s Name of the species.
+    uint getSpecHandle(std::string const & s) const;
+
+    /// Return a handle to compartment c.
+    ///
+    /// \param c Name of the compartment.
+    uint getCompHandle(std::string const & c) const;
+
+    /// Return a handle to patch p.
+    ///
+    /// \param p Name of the patch.
+    uint getPatchHandle(std::string const & p) const;
+
     ////////////////////////////////////////////////////////////////////////
     // SOLVER CONTROLS:
     //      COMPARTMENT
@@ -199,6 +222,12 @@ public:
     /// \param s Name of the species.
     double getCompCount(std::string const & c, std::string const & s) const;
 
+    /// Returns the number of molecules of species s in compartment c.
+    ///
+    /// \param c Handle of the compartment, from getCompHandle().
+    /// \param s Handle of the species, from getSpecHandle().
+    double getCompCount(uint c, uint s) const;
+
     /// Sets the number of molecules of species s in compartment c.
     ///
     /// NOTE: in a mesh-based simulation, the total amount is equally divided
@@ -234,6 +263,13 @@ public:
     /// \param s Name of the species.
     double getCompConc(std::string const & c, std::string const & s) const;
 
+    /// Returns the concentration (in molar units) of species s in
+    /// compartment c.
+    ///
+    /// \param c Handle of the compartment, from getCompHandle().
+    /// \param s Handle of the species, from getSpecHandle().
+    double getCompConc(uint c, uint s) const;
+
     /// Sets the concentration (in molar units) of species s in compartment c.
     ///
     /// NOTE: in a mesh-based simulation, this method changes the
@@ -398,6 +434,12 @@ public:
     /// \param s Name of the species.
     double getTetCount(uint tidx, std::string const & s) const;
 
+    /// Returns the number of molecules of species s in a voxel.
+    ///
+    /// \param tidx Index of the tetrahedron.
+    /// \param s Handle of the species, from getSpecHandle().
+    double getTetCount(uint tidx, uint s) const;
+
     /// Sets the number of molecules of species s in a voxel.
     ///
     /// \param tidx Index of the tetrahedron.
@@ -424,6 +466,12 @@ public:
     /// \param s Name of the species.
     double getTetConc(uint tidx, std::string const & s) const;
 
+    /// Returns the concentration (in molar units) of species s in a voxel.
+    ///
+    /// \param tidx Index of the tetrahedron.
+    /// \param s Handle of the species, from getSpecHandle().
+    double getTetConc(uint tidx, uint s) const;
+
     /// Sets the concentration (in molar units) of species s in a voxel.
     ///
     /// \param tidx Index of the tetrahedron.
@@ -583,6 +631,12 @@ public:
     /// \param s Name of the species.
     double getPatchCount(std::string const & p, std::string const & s) const;
 
+    /// Returns the number of molecules of species s in patch p.
+    ///
+    /// \param p Handle of the patch, from getPatchHandle().
+    /// \param s Handle of the species, from getSpecHandle().
+    double getPatchCount(uint p, uint s) const;
+
     /// Sets the number of molecules of species s in patch p.
     ///
     /// NOTE: in a mesh-based simulation, the total amount is equally divided
@@ -809,6 +863,12 @@ public:
     /// \param s Name of the species.
     double getTriCount(uint tidx, std::string const & s) const;
 
+    /// Returns the number of molecules of species s in a triangle.
+    ///
+    /// \param tidx Index of the triangle.
+    /// \param s Handle of the species, from getSpecHandle().
+    double getTriCount(uint tidx, uint s) const;
+
     /// Sets the number of molecules of species s in a triangle.
     ///
     /// \param tidx Index of the triangle.
@@ -1199,6 +1259,10 @@ protected:
     //      TETRAHEDRAL VOLUME ELEMENTS
     ////////////////////////////////////////////////////////////////////////
 
+    // Number of tetrahedrons the per-tet methods can be called with, the
+    // mesh count unless the solver holds only part of the mesh.
+    virtual uint _countTets() const;
+
     virtual double _getTetVol(uint tidx) const;
     virtual void _setTetVol(uint tidx, double vol);
 
@@ -1301,6 +1365,9 @@ protected:
     //      TRIANGULAR SURFACE ELEMENTS
     ////////////////////////////////////////////////////////////////////////
 
+    // Number of triangles the per-tri methods can be called with.
+    virtual uint _countTris() const;
+
     virtual double _getTriArea(uint tidx) const;
     virtual void _setTriArea(uint tidx, double area);
 
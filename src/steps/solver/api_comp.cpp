@@ -81,6 +81,26 @@ double API::getCompCount(string const & c, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getCompCount(uint c, uint s) const
+{
+    if (c >= pStatedef->countComps())
+    {
+        std::ostringstream os;
+        os << "Invalid compartment handle.";
+        ArgErrLog(os.str());
+    }
+    if (s >= pStatedef->countSpecs())
+    {
+        std::ostringstream os;
+        os << "Invalid species handle.";
+        ArgErrLog(os.str());
+    }
+
+    return _getCompCount(c, s);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setCompCount(string const & c, string const & s, double n)
 {
     if (n < 0.0)
@@ -137,6 +157,26 @@ double API::getCompConc(string const & c, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getCompConc(uint c, uint s) const
+{
+    if (c >= pStatedef->countComps())
+    {
+        std::ostringstream os;
+        os << "Invalid compartment handle.";
+        ArgErrLog(os.str());
+    }
+    if (s >= pStatedef->countSpecs())
+    {
+        std::ostringstream os;
+        os << "Invalid species handle.";
+        ArgErrLog(os.str());
+    }
+
+    return _getCompConc(c, s);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setCompConc(string const & c, string const & s, double conc)
 {
     if (conc < 0.0)
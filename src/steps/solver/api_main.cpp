@@ -201,6 +201,30 @@ uint API::getNSteps() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+uint API::getSpecHandle(string const & s) const
+{
+    // the following may throw an exception if string is unknown
+    return pStatedef->getSpecIdx(s);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint API::getCompHandle(string const & c) const
+{
+    // the following may throw an exception if string is unknown
+    return pStatedef->getCompIdx(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint API::getPatchHandle(string const & p) const
+{
+    // the following may throw an exception if string is unknown
+    return pStatedef->getPatchIdx(p);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setTime(double time)
 {
     NotImplErrLog("");
@@ -80,6 +80,26 @@ double API::getPatchCount(string const & p, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getPatchCount(uint p, uint s) const
+{
+    if (p >= pStatedef->countPatches())
+    {
+        std::ostringstream os;
+        os << "Invalid patch handle.";
+        ArgErrLog(os.str());
+    }
+    if (s >= pStatedef->countSpecs())
+    {
+        std::ostringstream os;
+        os << "Invalid species handle.";
+        ArgErrLog(os.str());
+    }
+
+    return _getPatchCount(p, s);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setPatchCount(string const & p, string const & s, double n)
 {
     if (n < 0.0)
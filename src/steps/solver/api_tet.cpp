@@ -49,7 +49,7 @@ double API::getTetVol(uint tidx) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -72,7 +72,7 @@ void API::setTetVol(uint tidx, double vol)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -95,7 +95,7 @@ bool API::getTetSpecDefined(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -121,7 +121,7 @@ double API::getTetCount(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -142,11 +142,40 @@ double API::getTetCount(uint tidx, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getTetCount(uint tidx, uint s) const
+{
+    if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
+    {
+        if (tidx >= _countTets())
+        {
+            std::ostringstream os;
+            os << "Tetrahedron index out of range.";
+            ArgErrLog(os.str());
+        }
+        if (s >= pStatedef->countSpecs())
+        {
+            std::ostringstream os;
+            os << "Invalid species handle.";
+            ArgErrLog(os.str());
+        }
+
+        return _getTetCount(tidx, s);
+    }
+    else
+    {
+        std::ostringstream os;
+        os << "Method not available for this solver.";
+        NotImplErrLog("");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setTetCount(uint tidx, string const & s, double n)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -179,7 +208,7 @@ double API::getTetAmount(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -205,7 +234,7 @@ void API::setTetAmount(uint tidx, string const & s, double m)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -237,7 +266,7 @@ double API::getTetConc(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -259,11 +288,40 @@ double API::getTetConc(uint tidx, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getTetConc(uint tidx, uint s) const
+{
+    if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
+    {
+        if (tidx >= _countTets())
+        {
+            std::ostringstream os;
+            os << "Tetrahedron index out of range.";
+            ArgErrLog(os.str());
+        }
+        if (s >= pStatedef->countSpecs())
+        {
+            std::ostringstream os;
+            os << "Invalid species handle.";
+            ArgErrLog(os.str());
+        }
+
+        return _getTetConc(tidx, s);
+    }
+    else
+    {
+        std::ostringstream os;
+        os << "Method not available for this solver.";
+        NotImplErrLog("");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setTetConc(uint tidx, string const & s, double c)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -295,7 +353,7 @@ bool API::getTetClamped(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -321,7 +379,7 @@ void API::setTetClamped(uint tidx, string const & s, bool buf)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -347,7 +405,7 @@ double API::getTetReacK(uint tidx, string const & r) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -373,7 +431,7 @@ void API::setTetReacK(uint tidx, string const & r, double kf)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -405,7 +463,7 @@ bool API::getTetReacActive(uint tidx, string const & r) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -431,7 +489,7 @@ void API::setTetReacActive(uint tidx, string const & r, bool act)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -457,7 +515,7 @@ double API::getTetDiffD(uint tidx, string const & d, uint direction_tet) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -483,13 +541,13 @@ void API::setTetDiffD(uint tidx, string const & d, double dk, uint direction_tet
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
             ArgErrLog(os.str());
         }
-        if (direction_tet != std::numeric_limits<uint>::max() &&direction_tet >= mesh->countTets())
+        if (direction_tet != std::numeric_limits<uint>::max() &&direction_tet >= _countTets())
         {
             std::ostringstream os;
             os << "Direction tetrahedron index out of range.";
@@ -521,7 +579,7 @@ bool API::getTetDiffActive(uint tidx, string const & d) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -548,7 +606,7 @@ void API::setTetDiffActive(uint tidx, string const & d, bool act)
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
 
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -575,7 +633,7 @@ double API::getTetReacH(uint tidx, string const & r) const
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
 
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -601,7 +659,7 @@ double API::getTetReacC(uint tidx, string const & r) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -628,7 +686,7 @@ double API::getTetReacA(uint tidx, string const & r) const
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
 
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -654,7 +712,7 @@ double API::getTetDiffA(uint tidx, string const & d) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -680,7 +738,7 @@ double API::getTetV(uint tidx) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -703,7 +761,7 @@ void API::setTetV(uint tidx, double v)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -726,7 +784,7 @@ bool API::getTetVClamped(uint tidx) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -750,7 +808,7 @@ void API::setTetVClamped(uint tidx, bool cl)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTets())
+        if (tidx >= _countTets())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
@@ -770,6 +828,13 @@ void API::setTetVClamped(uint tidx, bool cl)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+uint API::_countTets() const
+{
+    return dynamic_cast<steps::tetmesh::Tetmesh*>(geom())->countTets();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 double API::_getTetVol(uint tidx) const
 {
     NotImplErrLog("");
@@ -49,7 +49,7 @@ double API::getTriArea(uint tidx) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -72,7 +72,7 @@ void API::setTriArea(uint tidx, double area)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -96,7 +96,7 @@ double API::getTriCount(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -118,11 +118,40 @@ double API::getTriCount(uint tidx, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getTriCount(uint tidx, uint s) const
+{
+    if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
+    {
+        if (tidx >= _countTris())
+        {
+            std::ostringstream os;
+            os << "Triangle index out of range.";
+            ArgErrLog(os.str());
+        }
+        if (s >= pStatedef->countSpecs())
+        {
+            std::ostringstream os;
+            os << "Invalid species handle.";
+            ArgErrLog(os.str());
+        }
+
+        return _getTriCount(tidx, s);
+    }
+    else
+    {
+        std::ostringstream os;
+        os << "Method not available for this solver.";
+        NotImplErrLog("");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool API::getTriSpecDefined(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -147,7 +176,7 @@ void API::setTriCount(uint tidx, string const & s, double n)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -179,7 +208,7 @@ double API::getTriAmount(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -205,7 +234,7 @@ void API::setTriAmount(uint tidx, string const & s, double m)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -237,7 +266,7 @@ bool API::getTriClamped(uint tidx, string const & s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -263,7 +292,7 @@ void API::setTriClamped(uint tidx, string const & s, bool buf)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -289,7 +318,7 @@ double API::getTriSReacK(uint tidx, string const & r) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -315,7 +344,7 @@ void API::setTriSReacK(uint tidx, string const & r, double kf)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -347,7 +376,7 @@ bool API::getTriSReacActive(uint tidx, string const & r) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -373,7 +402,7 @@ void API::setTriSReacActive(uint tidx, string const & r, bool act)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -400,7 +429,7 @@ double API::getTriSReacH(uint tidx, string const & r) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -426,7 +455,7 @@ double API::getTriSReacC(uint tidx, string const & r) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -452,7 +481,7 @@ double API::getTriSReacA(uint tidx, string const & r) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -485,7 +514,7 @@ double API::getTriSDiffD(uint tidx, string const & d, uint direction_tri) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -518,13 +547,13 @@ void API::setTriSDiffD(uint tidx, string const & d, double dk, uint direction_tr
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Tetrahedron index out of range.";
             ArgErrLog(os.str());
         }
-        if (direction_tri != std::numeric_limits<uint>::max() &&direction_tri >= mesh->countTris())
+        if (direction_tri != std::numeric_limits<uint>::max() &&direction_tri >= _countTris())
         {
             std::ostringstream os;
             os << "Direction tetrahedron index out of range.";
@@ -555,7 +584,7 @@ double API::getTriV(uint tidx) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -579,7 +608,7 @@ void API::setTriV(uint tidx, double v)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -603,7 +632,7 @@ bool API::getTriVClamped(uint tidx) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -627,7 +656,7 @@ void API::setTriVClamped(uint tidx, bool cl)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -651,7 +680,7 @@ double API::getTriOhmicI(uint tidx)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -675,7 +704,7 @@ double API::getTriOhmicI(uint tidx, string const & oc)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -701,7 +730,7 @@ double API::getTriGHKI(uint tidx)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -725,7 +754,7 @@ double API::getTriGHKI(uint tidx, string const & ghk)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -750,7 +779,7 @@ double API::getTriI(uint tidx) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -774,7 +803,7 @@ void API::setTriIClamp(uint tidx, double i)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -798,7 +827,7 @@ void API::setTriCapac(uint tidx, double cm)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -822,7 +851,7 @@ bool API::getTriVDepSReacActive(uint tidx, string const & vsr) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -848,7 +877,7 @@ void API::setTriVDepSReacActive(uint tidx, string const & vsr, bool act)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
     {
-        if (tidx >= mesh->countTris())
+        if (tidx >= _countTris())
         {
             std::ostringstream os;
             os << "Triangle index out of range.";
@@ -871,6 +900,13 @@ void API::setTriVDepSReacActive(uint tidx, string const & vsr, bool act)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+uint API::_countTris() const
+{
+    return dynamic_cast<steps::tetmesh::Tetmesh*>(geom())->countTris();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 double API::_getTriArea(uint tidx) const
 {
     NotImplErrLog("");
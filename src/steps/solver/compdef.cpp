@@ -72,6 +72,8 @@ ssolver::Compdef::Compdef(Statedef * sd, uint idx, steps::wm::Comp * c)
 , pReac_DEP_Spec(nullptr)
 , pReac_LHS_Spec(nullptr)
 , pReac_UPD_Spec(nullptr)
+, pReac_LHS_Sparse()
+, pReac_UPD_Sparse()
 , pDiffsN(0)
 , pDiff_G2L(nullptr)
 , pDiff_L2G(nullptr)
@@ -302,6 +304,8 @@ void ssolver::Compdef::setup_indices()
                 pReac_UPD_Spec[aridx] = rdef->upd(si);
             }
         }
+        pReac_LHS_Sparse.assign(pReac_LHS_Spec, pReacsN, pSpecsN);
+        pReac_UPD_Sparse.assign(pReac_UPD_Spec, pReacsN, pSpecsN);
     }
 
     if (pDiffsN != 0)
@@ -37,6 +37,7 @@
 #include "steps/common.h"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/api.hpp"
+#include "steps/solver/sparse_stoich.hpp"
 #include "steps/geom/comp.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -227,6 +228,20 @@ public:
     /// \param rlidx Local index of the reaction.
     int * reac_upd_end(uint rlidx) const;
 
+    /// Return the nonzero (species, order) entries of the lhs array of
+    /// reaction specified by local index argument.
+    ///
+    /// \param rlidx Local index of the reaction.
+    inline SparseStoich::Row reac_lhs_sparse(uint rlidx) const
+    { return pReac_LHS_Sparse.row(rlidx); }
+
+    /// Return the nonzero (species, change) entries of the update array of
+    /// reaction specified by local index argument.
+    ///
+    /// \param rlidx Local index of the reaction.
+    inline SparseStoich::Row reac_upd_sparse(uint rlidx) const
+    { return pReac_UPD_Sparse.row(rlidx); }
+
     /// Return the local index of species of reaction specified by
     /// local index argument.
     ///
@@ -390,6 +405,8 @@ private:
     int                               * pReac_DEP_Spec;
     uint                              * pReac_LHS_Spec;
     int                               * pReac_UPD_Spec;
+    SparseStoich                        pReac_LHS_Sparse;
+    SparseStoich                        pReac_UPD_Sparse;
 
     ////////////////////////////////////////////////////////////////////////
     // DATA: DIFFUSION RULES
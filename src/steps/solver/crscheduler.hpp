@@ -0,0 +1,598 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_SOLVER_CRSCHEDULER_HPP
+#define STEPS_SOLVER_CRSCHEDULER_HPP 1
+
+// STL headers.
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+
+// logging
+#include "third_party/easyloggingpp/src/easylogging++.h"
+
+ namespace steps {
+ namespace solver {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Composition-rejection bookkeeping of one scheduled entry: its current
+/// rate, the power-of-two group it is filed in and its position there.
+struct CRKProcData
+{
+    CRKProcData()
+    : recorded(false)
+    , pow(0)
+    , pos(0)
+    , rate(0.0)
+    {
+    }
+
+    bool                                    recorded;
+    int                                     pow;
+    unsigned                                pos;
+    double                                  rate;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Entries whose rate lies in [2^(power-1), 2^power).
+template <typename Entry>
+struct CRGroup
+{
+    CRGroup(int power, uint init_size = 1024)
+    : capacity(init_size)
+    , size(0)
+    , max(std::ldexp(1.0, power))
+    , sum(0.0)
+    , indices(static_cast<Entry*>(malloc(sizeof(Entry) * init_size)))
+    {
+        if (indices == nullptr)
+            SysErrLog("DirectCR: unable to allocate memory for SSA group.");
+    }
+
+    ~CRGroup()
+    { free(indices); }
+
+    void extend(uint n = 1024)
+    {
+        capacity += n;
+        indices = static_cast<Entry*>(realloc(indices, sizeof(Entry) * capacity));
+        if (indices == nullptr)
+            SysErrLog("DirectCR: unable to allocate memory for SSA group.");
+    }
+
+    unsigned                                capacity;
+    unsigned                                size;
+    double                                  max;
+    double                                  sum;
+    Entry*                                  indices;
+
+private:
+
+    CRGroup(CRGroup const &);
+    CRGroup & operator=(CRGroup const &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Storage policy for entries identified by a dense schedule index.
+///
+/// The CR state is kept in parallel arrays so that the rejection loop only
+/// streams through the rate buffer.
+class CRIndexStore
+{
+
+public:
+
+    typedef uint                            entry_type;
+
+    /// Append a new entry and return its index.
+    uint add()
+    {
+        uint idx = pRate.size();
+        pRate.push_back(0.0);
+        pPow.push_back(0);
+        pPos.push_back(0);
+        pRecorded.push_back(false);
+        return idx;
+    }
+
+    uint size() const
+    { return pRate.size(); }
+
+    double rate(uint e) const
+    { return pRate[e]; }
+    double & rate(uint e)
+    { return pRate[e]; }
+    int & pow(uint e)
+    { return pPow[e]; }
+    unsigned & pos(uint e)
+    { return pPos[e]; }
+    bool recorded(uint e) const
+    { return pRecorded[e]; }
+    void setRecorded(uint e, bool r)
+    { pRecorded[e] = r; }
+
+    void reset()
+    {
+        std::fill(pRate.begin(), pRate.end(), 0.0);
+        std::fill(pPow.begin(), pPow.end(), 0);
+        std::fill(pPos.begin(), pPos.end(), 0);
+        std::fill(pRecorded.begin(), pRecorded.end(), false);
+    }
+
+    void checkpoint(std::fstream & cp_file) const
+    {
+        uint n = size();
+        cp_file.write((char*)pRate.data(), sizeof(double) * n);
+        cp_file.write((char*)pPow.data(), sizeof(int) * n);
+        cp_file.write((char*)pPos.data(), sizeof(unsigned) * n);
+        cp_file.write(pRecorded.data(), sizeof(char) * n);
+    }
+
+    void restore(std::fstream & cp_file)
+    {
+        uint n = size();
+        cp_file.read((char*)pRate.data(), sizeof(double) * n);
+        cp_file.read((char*)pPow.data(), sizeof(int) * n);
+        cp_file.read((char*)pPos.data(), sizeof(unsigned) * n);
+        cp_file.read(pRecorded.data(), sizeof(char) * n);
+    }
+
+private:
+
+    std::vector<double>                     pRate;
+    std::vector<int>                        pPow;
+    std::vector<unsigned>                   pPos;
+    std::vector<char>                       pRecorded;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Storage policy for entries that carry their own CRKProcData member
+/// named crData. The entries checkpoint and reset that member themselves.
+template <typename T>
+class CRMemberStore
+{
+
+public:
+
+    typedef T*                              entry_type;
+
+    double rate(T * e) const
+    { return e->crData.rate; }
+    double & rate(T * e)
+    { return e->crData.rate; }
+    int & pow(T * e)
+    { return e->crData.pow; }
+    unsigned & pos(T * e)
+    { return e->crData.pos; }
+    bool recorded(T * e) const
+    { return e->crData.recorded; }
+    void setRecorded(T * e, bool r)
+    { e->crData.recorded = r; }
+
+    void reset()
+    { }
+    void checkpoint(std::fstream &) const
+    { }
+    void restore(std::fstream &)
+    { }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Composition-rejection SSA scheduler shared by the spatial solvers.
+///
+/// Entries are filed into groups by the binary exponent of their rate.
+/// Group sums and the total propensity are maintained by deltas as rates
+/// change; a group whose sum changed is only marked dirty, and the binary
+/// indexed tree used to select a group in O(log G) is brought up to date
+/// for the dirty groups when the next entry is drawn. Accumulated rounding
+/// is removed by an exact resummation once the number of updates since
+/// the last one exceeds the number of recorded entries.
+///
+/// \a Store decides where the per-entry state lives, see CRIndexStore
+/// and CRMemberStore.
+template <typename Store>
+class CRScheduler
+{
+
+public:
+
+    typedef typename Store::entry_type      Entry;
+    typedef CRGroup<Entry>                  Group;
+
+    CRScheduler()
+    : pStore()
+    , pGroups(NSLOTS + 1, nullptr)
+    , pTree(NSLOTS + 1, 0.0)
+    , pTreeSum(NSLOTS + 1, 0.0)
+    , pDirty()
+    , pIsDirty(NSLOTS + 1, false)
+    , pA0(0.0)
+    , pNRecorded(0)
+    , pNUpdates(0)
+    {
+    }
+
+    ~CRScheduler()
+    { _freeGroups(); }
+
+    Store & store()
+    { return pStore; }
+    Store const & store() const
+    { return pStore; }
+
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Total propensity of all recorded entries.
+    double getA0() const
+    {
+        if (pNRecorded == 0 || pA0 < 0.0) return 0.0;
+        return pA0;
+    }
+
+    /// Drop all groups. Per-entry state is reset through the store.
+    void reset()
+    {
+        _freeGroups();
+        std::fill(pTree.begin(), pTree.end(), 0.0);
+        std::fill(pTreeSum.begin(), pTreeSum.end(), 0.0);
+        std::fill(pIsDirty.begin(), pIsDirty.end(), false);
+        pDirty.clear();
+        pStore.reset();
+        pA0 = 0.0;
+        pNRecorded = 0;
+        pNUpdates = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Set the rate of entry \a e and refile it if its group changes.
+    void update(Entry e, double new_rate)
+    {
+        double old_rate = pStore.rate(e);
+        pStore.rate(e) = new_rate;
+        if (old_rate == new_rate) return;
+
+        bool recorded = pStore.recorded(e);
+        if (new_rate > 1e-20) {
+            int new_pow;
+            std::frexp(new_rate, &new_pow);
+
+            if (recorded && pStore.pow(e) == new_pow) {
+                uint slot = _slot(new_pow);
+                double delta = new_rate - old_rate;
+                pGroups[slot]->sum += delta;
+                pA0 += delta;
+                _markDirty(slot);
+            }
+            else {
+                if (recorded) _remove(e, old_rate);
+                _insert(e, new_pow, new_rate);
+            }
+        }
+        else if (recorded) {
+            _remove(e, old_rate);
+        }
+
+        if (++pNUpdates > pNRecorded + MIN_RESUM_PERIOD) resum();
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Recompute every group sum, the selection tree and A0 from the
+    /// current entry rates.
+    void resum()
+    {
+        pA0 = 0.0;
+        pTree[0] = 0.0;
+        for (uint slot = 1; slot <= NSLOTS; ++slot) {
+            double sum = 0.0;
+            Group * g = pGroups[slot];
+            if (g != nullptr) {
+                for (uint i = 0; i < g->size; ++i) sum += pStore.rate(g->indices[i]);
+                g->sum = sum;
+            }
+            pTree[slot] = sum;
+            pTreeSum[slot] = sum;
+            pIsDirty[slot] = false;
+            pA0 += sum;
+        }
+        pDirty.clear();
+        // Linear-time construction: push each node into its parent.
+        for (uint slot = 1; slot <= NSLOTS; ++slot) {
+            uint parent = slot + (slot & (~slot + 1));
+            if (parent <= NSLOTS) pTree[parent] += pTree[slot];
+        }
+        pNUpdates = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Draw the next entry to fire. Requires getA0() > 0.
+    template <typename RNG>
+    Entry select(RNG * r) const
+    {
+        _flushTree();
+
+        double selector = pA0 * r->getUnfII();
+
+        // Descend the tree to the first group whose prefix sum exceeds
+        // the selector.
+        uint pos = 0;
+        double rem = selector;
+        for (uint step = TREE_TOP; step != 0; step >>= 1) {
+            uint next = pos + step;
+            if (next <= NSLOTS && pTree[next] <= rem) {
+                pos = next;
+                rem -= pTree[next];
+            }
+        }
+
+        Group * group = (pos < NSLOTS) ? pGroups[pos + 1] : nullptr;
+
+        // Precision rounding error force clean up:
+        // force the search in the last non-empty group.
+        if (group == nullptr || group->size == 0) {
+            group = nullptr;
+            for (uint slot = NSLOTS; slot > 0 && group == nullptr; --slot) {
+                if (pGroups[slot] != nullptr && pGroups[slot]->size != 0)
+                    group = pGroups[slot];
+            }
+        }
+
+        if (group == nullptr) {
+            std::ostringstream os;
+            os << "Cannot find any suitable entry.\n";
+            os << "A0: " << std::setprecision(15) << pA0 << "\n";
+            os << "Selector: " << std::setprecision(15) << selector << "\n";
+            os << "Distribution of group sums\n";
+            for (uint slot = 1; slot <= NSLOTS; ++slot) {
+                if (pGroups[slot] == nullptr) continue;
+                os << _pow(slot) << ": " << std::setprecision(15);
+                os << pGroups[slot]->sum << "\n";
+            }
+            ProgErrLog(os.str());
+        }
+
+        double g_max = group->max;
+        uint group_size = group->size;
+        Entry e;
+        do {
+            double random_rate = g_max * r->getUnfII();
+            e = group->indices[r->get() % group_size];
+            if (pStore.rate(e) > random_rate) break;
+        } while (true);
+        return e;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+    // CHECKPOINTING
+    ////////////////////////////////////////////////////////////////////////
+
+    /// \a to_idx maps an entry to the integer written to the file.
+    template <typename ToIdx>
+    void checkpoint(std::fstream & cp_file, ToIdx to_idx) const
+    {
+        _flushTree();
+        pStore.checkpoint(cp_file);
+
+        cp_file.write((char*)&pA0, sizeof(double));
+        cp_file.write((char*)&pNRecorded, sizeof(uint));
+        cp_file.write((char*)&pNUpdates, sizeof(uint));
+        cp_file.write((char*)pTree.data(), sizeof(double) * pTree.size());
+
+        for (uint slot = 1; slot <= NSLOTS; ++slot) {
+            Group * group = pGroups[slot];
+            uint capacity = (group == nullptr) ? 0 : group->capacity;
+            cp_file.write((char*)&capacity, sizeof(uint));
+            if (group == nullptr) continue;
+
+            cp_file.write((char*)&(group->size), sizeof(unsigned));
+            cp_file.write((char*)&(group->sum), sizeof(double));
+            for (uint j = 0; j < group->size; j++) {
+                uint idx = to_idx(group->indices[j]);
+                cp_file.write((char*)&idx, sizeof(uint));
+            }
+        }
+    }
+
+    /// \a from_idx maps an integer read from the file back to an entry.
+    template <typename FromIdx>
+    void restore(std::fstream & cp_file, FromIdx from_idx)
+    {
+        _freeGroups();
+        pStore.restore(cp_file);
+
+        cp_file.read((char*)&pA0, sizeof(double));
+        cp_file.read((char*)&pNRecorded, sizeof(uint));
+        cp_file.read((char*)&pNUpdates, sizeof(uint));
+        cp_file.read((char*)pTree.data(), sizeof(double) * pTree.size());
+        std::fill(pTreeSum.begin(), pTreeSum.end(), 0.0);
+        std::fill(pIsDirty.begin(), pIsDirty.end(), false);
+        pDirty.clear();
+
+        for (uint slot = 1; slot <= NSLOTS; ++slot) {
+            uint capacity;
+            cp_file.read((char*)&capacity, sizeof(uint));
+            if (capacity == 0) continue;
+
+            Group * group = new Group(_pow(slot), capacity);
+            pGroups[slot] = group;
+
+            cp_file.read((char*)&(group->size), sizeof(unsigned));
+            cp_file.read((char*)&(group->sum), sizeof(double));
+            pTreeSum[slot] = group->sum;
+            AssertLog(group->size <= capacity);
+            for (uint j = 0; j < group->size; j++) {
+                uint idx;
+                cp_file.read((char*)&idx, sizeof(uint));
+                group->indices[j] = from_idx(idx);
+            }
+        }
+    }
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////
+
+    // Rates in (1e-20, DBL_MAX] have binary exponents in [-66, 1024];
+    // slot = exponent + SLOT_OFFSET maps them onto 1 .. NSLOTS.
+    static const int                        SLOT_OFFSET = 67;
+    static const uint                       NSLOTS = 1024 + SLOT_OFFSET;
+    // Largest power of two not exceeding NSLOTS.
+    static const uint                       TREE_TOP = 1024;
+    static const uint                       MIN_RESUM_PERIOD = 4096;
+
+    static uint _slot(int pow)
+    {
+        int slot = pow + SLOT_OFFSET;
+        AssertLog(slot > 0 && slot <= static_cast<int>(NSLOTS));
+        return static_cast<uint>(slot);
+    }
+
+    static int _pow(uint slot)
+    { return static_cast<int>(slot) - SLOT_OFFSET; }
+
+    void _markDirty(uint slot)
+    {
+        if (pIsDirty[slot]) return;
+        pIsDirty[slot] = true;
+        pDirty.push_back(slot);
+    }
+
+    /// Propagate the group sums changed since the last draw into the tree.
+    void _flushTree() const
+    {
+        for (uint slot : pDirty) {
+            double delta = pGroups[slot]->sum - pTreeSum[slot];
+            pTreeSum[slot] = pGroups[slot]->sum;
+            pIsDirty[slot] = false;
+            for (uint i = slot; i <= NSLOTS; i += i & (~i + 1)) pTree[i] += delta;
+        }
+        pDirty.clear();
+    }
+
+    void _insert(Entry e, int pow, double rate)
+    {
+        uint slot = _slot(pow);
+        Group * group = pGroups[slot];
+        if (group == nullptr) {
+            group = new Group(pow);
+            pGroups[slot] = group;
+        }
+        if (group->size == group->capacity) group->extend();
+
+        uint pos = group->size;
+        group->indices[pos] = e;
+        group->size++;
+        group->sum += rate;
+        pA0 += rate;
+        _markDirty(slot);
+
+        pStore.pow(e) = pow;
+        pStore.pos(e) = pos;
+        pStore.setRecorded(e, true);
+        pNRecorded++;
+    }
+
+    void _remove(Entry e, double old_rate)
+    {
+        uint slot = _slot(pStore.pow(e));
+        Group * group = pGroups[slot];
+        group->size--;
+
+        if (group->size == 0) {
+            pA0 -= group->sum;
+            group->sum = 0.0;
+        }
+        else {
+            pA0 -= old_rate;
+            group->sum -= old_rate;
+
+            Entry last = group->indices[group->size];
+            unsigned pos = pStore.pos(e);
+            group->indices[pos] = last;
+            pStore.pos(last) = pos;
+        }
+        _markDirty(slot);
+
+        pStore.setRecorded(e, false);
+        pNRecorded--;
+    }
+
+    void _freeGroups()
+    {
+        for (auto & g : pGroups) {
+            delete g;
+            g = nullptr;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+
+    Store                                   pStore;
+
+    // Groups indexed by slot; slot 0 is unused.
+    std::vector<Group*>                     pGroups;
+
+    // Binary indexed tree over the group sums, 1-based, and the group
+    // sums it currently holds. Slots in pDirty have changed since.
+    mutable std::vector<double>             pTree;
+    mutable std::vector<double>             pTreeSum;
+    mutable std::vector<uint>               pDirty;
+    mutable std::vector<char>               pIsDirty;
+
+    double                                  pA0;
+    uint                                    pNRecorded;
+    uint                                    pNUpdates;
+
+    CRScheduler(CRScheduler const &);
+    CRScheduler & operator=(CRScheduler const &);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif
+
+// STEPS_SOLVER_CRSCHEDULER_HPP
+
+// END
@@ -46,7 +46,7 @@ inline void swap_row(double *u,double *v,int n) {
     for (int j=0;j<n;++j) std::swap(u[j],v[j]);
 }
 
-void BDSystem::solve()
+void BDSystem::factorize()
 {
     constexpr double TINY = 1.0e-20;
 
@@ -128,13 +128,22 @@ void BDSystem::solve()
         ak += w;
         lk += h;
     }
+}
+
+void BDSystem::backsolve()
+{
+    int n = (int)pN;
+    int h = (int)pHalfBW;
+    int w = 2*h+1;
+    const double *a = pA.data(); // holds U from LU decomposition
+    const double *l = h>0?&pL[0]:0;
 
     // 2. Forward substitution, b into x.
     std::copy(pb.begin(),pb.end(),px.begin());
     double *x = &px[0];
     double *xk = x;
-    lk = l;
-    ak = a;
+    const double *lk = l;
+    const double *ak = a;
     for (int k = 0; k < n; ++k)
     {
         int i = pp[k];
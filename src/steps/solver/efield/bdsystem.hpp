@@ -99,7 +99,14 @@ public:
 
     const vector_type &x() const { return px_view; }
 
-    void solve(); // destructive: overwrites pA
+    /// LU-decompose A in place; destructive: overwrites pA.
+    void factorize();
+
+    /// Solve for x given b, using the factorization from the last
+    /// call to factorize(). Can be called repeatedly for different b.
+    void backsolve();
+
+    void solve() { factorize(); backsolve(); } // destructive: overwrites pA
 
 private:
     size_t pN,pHalfBW;
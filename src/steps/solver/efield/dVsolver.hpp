@@ -47,7 +47,7 @@ namespace efield {
 
 class dVSolverBase: public EFieldSolver {
 public:
-    dVSolverBase(): pMesh(0), pNVerts(0), pNTris(0) {}
+    dVSolverBase(): pMesh(0), pNVerts(0), pNTris(0), pMatrixStale(true) {}
 
     /** Initialize state with given mesh */
     void initMesh(TetMesh *mesh) override;
@@ -70,7 +70,10 @@ public:
     bool getClamped(int i) const override { return pVertexClamp[i]; }
 
     /** Set voltage clamped status for vertex i */
-    void setClamped(int i, bool clamped) override { pVertexClamp[i] = clamped; }
+    void setClamped(int i, bool clamped) override {
+        if (pVertexClamp[i] != clamped) pMatrixStale = true;
+        pVertexClamp[i] = clamped;
+    }
 
     /** Get current through triangle i */
     double getTriI(int i) const override { return -pTriCur[i]; }
@@ -84,10 +87,53 @@ public:
     /** Set additional current injection for area associated with vertex i to c (pA) */
     void setVertIClamp(int i, double c) override { pVertCurClamp[i] = -c; }
 
+    /** Mark the system matrix as requiring reassembly */
+    void setMatrixStale() override { pMatrixStale = true; }
+
 protected:
     /// Generic populate and solve
     template <typename LinSysImpl>
     void _advance(LinSysImpl *L, double dt) {
+        _populateMatrix(L->A(), dt);
+        _populateRHS(L->b());
+
+        L->solve();
+
+        _applyDV(L->x());
+    }
+
+    /// Populate system matrix; depends only on dt, capacitances,
+    /// conductances and clamp flags.
+    template <typename MatrixImpl>
+    void _populateMatrix(MatrixImpl &A, double dt) {
+        double oodt = 1.0/dt;
+
+        A.zero();
+        for (uint i = 0; i < pNVerts; ++i) {
+            VertexElement * ve = pMesh->getVertex(i);
+            int ind = ve->getIDX();
+
+            if (pVertexClamp[ind]) {
+                A.set(ind,ind,1.0);
+            }
+            else {
+                double Aii = ve->getCapacitance()*oodt + pGExt[ind];
+
+                for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) {
+                    int k = ve->nbrIdx(inbr);
+                    double cc = ve->getCC(inbr);
+
+                    Aii += cc;
+                    A.set(ind,k,-cc);
+                }
+                A.set(ind,ind,Aii);
+            }
+        }
+    }
+
+    /// Populate right hand side from current potentials and currents.
+    template <typename VectorImpl>
+    void _populateRHS(VectorImpl &b) {
         // Add up current clamp contributions
         std::copy(pVertCurClamp.begin(), pVertCurClamp.end(), pVertCur.begin());
         for (uint i = 0; i < pNTris; ++i) {
@@ -99,40 +145,28 @@ protected:
             pVertCur[triv[2]] += c;
         }
 
-        typename LinSysImpl::matrix_type &A=L->A();
-        typename LinSysImpl::vector_type &b=L->b();
-
-        double oodt = 1.0/dt;
-
-        A.zero();
         for (uint i = 0; i < pNVerts; ++i) {
             VertexElement * ve = pMesh->getVertex(i);
             int ind = ve->getIDX();
 
             if (pVertexClamp[ind]) {
                 b.set(ind,0);
-                A.set(ind,ind,1.0);
             }
             else {
                 double rhs = pVertCur[ind] + pGExt[ind] * (pVExt - pV[ind]);
-                double Aii = ve->getCapacitance()*oodt + pGExt[ind];
 
-                for (int inbr = 0; inbr < ve->getNCon(); ++inbr) {
+                for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) {
                     int k = ve->nbrIdx(inbr);
-                    double cc = ve->getCC(inbr);
-
-                    rhs += cc * (pV[k] - pV[ind]);
-                    Aii += cc;
-                    A.set(ind,k,-cc);
+                    rhs += ve->getCC(inbr) * (pV[k] - pV[ind]);
                 }
                 b.set(ind,rhs);
-                A.set(ind,ind,Aii);
             }
         }
-        
-        L->solve();
+    }
 
-        const typename LinSysImpl::vector_type DV=L->x();
+    /// Apply solution dV to unclamped vertices and reset triangle currents.
+    template <typename VectorImpl>
+    void _applyDV(const VectorImpl &DV) {
         for (uint i = 0; i < pNVerts; ++i)
             if (pVertexClamp[i] == false) pV[i] += DV.get(i);
 
@@ -175,21 +209,40 @@ protected:
 
     /// Current clamp through each vertex (adds to any triangle clamps.)
     std::vector<double>         pVertCurClamp;
+
+    /// Set when the system matrix must be reassembled before the next solve.
+    bool                        pMatrixStale;
 };
     
 class dVSolverBanded: public dVSolverBase {
 public:
+    dVSolverBanded(): pFactorDT(0.0) {}
+
     void initMesh(TetMesh *mesh) override {
         dVSolverBase::initMesh(mesh);
         pBDSys.reset(new BDSystem(pNVerts, meshHalfBW(mesh)));
     }
 
+    /// Reuses the LU factorization from the previous step unless dt or
+    /// any matrix parameter has changed in the meantime.
     void advance(double dt) override {
-        _advance(pBDSys.get(), dt);
+        if (pMatrixStale || dt != pFactorDT) {
+            _populateMatrix(pBDSys->A(), dt);
+            pBDSys->factorize();
+            pFactorDT = dt;
+            pMatrixStale = false;
+        }
+
+        _populateRHS(pBDSys->b());
+        pBDSys->backsolve();
+        _applyDV(pBDSys->x());
     }
 
 private:
     std::unique_ptr<BDSystem>  pBDSys;
+
+    /// dt used for the current factorization of pBDSys.
+    double                     pFactorDT;
 };
 
 
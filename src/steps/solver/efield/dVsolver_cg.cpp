@@ -0,0 +1,204 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+// STL headers.
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+#include "steps/solver/efield/dVsolver_cg.hpp"
+
+// logging
+#include "easylogging++.h"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+dVSolverCG::dVSolverCG(double rtol, uint maxiter)
+: pRTol(rtol)
+, pMaxIter(maxiter)
+, pLastIter(0)
+, pAssembledDT(0.0)
+{}
+
+void dVSolverCG::initMesh(TetMesh *mesh) {
+    dVSolverBase::initMesh(mesh);
+
+    std::vector<uint> rowlen(pNVerts, 0);
+    for (uint i = 0; i < pNVerts; ++i) {
+        VertexElement *ve = mesh->getVertex(i);
+        rowlen[ve->getIDX()] = 1 + ve->getNCon();
+    }
+
+    pRowPtr.assign(pNVerts+1, 0);
+    for (uint i = 0; i < pNVerts; ++i)
+        pRowPtr[i+1] = pRowPtr[i] + rowlen[i];
+
+    uint nnz = pRowPtr[pNVerts];
+    pColIdx.assign(nnz, 0);
+    pVal.assign(nnz, 0.0);
+
+    for (uint i = 0; i < pNVerts; ++i) {
+        VertexElement *ve = mesh->getVertex(i);
+        uint ind = ve->getIDX();
+        uint *cols = &pColIdx[pRowPtr[ind]];
+
+        cols[0] = ind;
+        for (uint inbr = 0; inbr < ve->getNCon(); ++inbr)
+            cols[1+inbr] = ve->nbrIdx(inbr);
+    }
+
+    pInvDiag.assign(pNVerts, 0.0);
+    pB.assign(pNVerts, 0.0);
+    pX.assign(pNVerts, 0.0);
+    pR.assign(pNVerts, 0.0);
+    pZ.assign(pNVerts, 0.0);
+    pP.assign(pNVerts, 0.0);
+    pQ.assign(pNVerts, 0.0);
+}
+
+void dVSolverCG::advance(double dt) {
+    if (pMatrixStale || dt != pAssembledDT) {
+        _assemble(dt);
+        pAssembledDT = dt;
+        pMatrixStale = false;
+    }
+
+    VVector b(pNVerts, &pB[0]);
+    _populateRHS(b);
+
+    _solve();
+
+    _applyDV(VVector(pNVerts, &pX[0]));
+}
+
+void dVSolverCG::_assemble(double dt) {
+    double oodt = 1.0/dt;
+
+    for (uint i = 0; i < pNVerts; ++i) {
+        VertexElement *ve = pMesh->getVertex(i);
+        uint ind = ve->getIDX();
+        double *vals = &pVal[pRowPtr[ind]];
+
+        if (pVertexClamp[ind]) {
+            vals[0] = 1.0;
+            std::fill(vals+1, vals+1+ve->getNCon(), 0.0);
+        }
+        else {
+            double Aii = ve->getCapacitance()*oodt + pGExt[ind];
+
+            for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) {
+                double cc = ve->getCC(inbr);
+                Aii += cc;
+                // dV of a clamped neighbour is zero: drop the column
+                // to keep the matrix symmetric.
+                vals[1+inbr] = pVertexClamp[ve->nbrIdx(inbr)] ? 0.0 : -cc;
+            }
+            vals[0] = Aii;
+        }
+        pInvDiag[ind] = 1.0/vals[0];
+    }
+}
+
+void dVSolverCG::_spmv(const double *x, double *y) const {
+    for (uint i = 0; i < pNVerts; ++i) {
+        double s = 0.0;
+        for (uint k = pRowPtr[i]; k < pRowPtr[i+1]; ++k)
+            s += pVal[k] * x[pColIdx[k]];
+        y[i] = s;
+    }
+}
+
+void dVSolverCG::_solve() {
+    uint n = pNVerts;
+    double *x = &pX[0];
+    double *r = &pR[0];
+    double *z = &pZ[0];
+    double *p = &pP[0];
+    double *q = &pQ[0];
+
+    double bnorm2 = 0.0;
+    for (uint i = 0; i < n; ++i) {
+        // warm start from previous dV, which must be zero when clamped
+        if (pVertexClamp[i]) x[i] = 0.0;
+        bnorm2 += pB[i]*pB[i];
+    }
+
+    pLastIter = 0;
+    if (bnorm2 == 0.0) {
+        std::fill(pX.begin(), pX.end(), 0.0);
+        return;
+    }
+    double tol2 = pRTol*pRTol*bnorm2;
+
+    _spmv(x, q);
+    double rz = 0.0, rnorm2 = 0.0;
+    for (uint i = 0; i < n; ++i) {
+        r[i] = pB[i] - q[i];
+        z[i] = pInvDiag[i] * r[i];
+        p[i] = z[i];
+        rz += r[i]*z[i];
+        rnorm2 += r[i]*r[i];
+    }
+
+    while (rnorm2 > tol2) {
+        if (pLastIter == pMaxIter) {
+            std::ostringstream os;
+            os << "dVSolverCG did not converge in " << pMaxIter << " iterations ";
+            os << "(relative residual " << std::sqrt(rnorm2/bnorm2) << ").";
+            ProgErrLog(os.str());
+        }
+        ++pLastIter;
+
+        _spmv(p, q);
+        double pq = 0.0;
+        for (uint i = 0; i < n; ++i) pq += p[i]*q[i];
+
+        double alpha = rz/pq;
+        double rz_new = 0.0;
+        rnorm2 = 0.0;
+        for (uint i = 0; i < n; ++i) {
+            x[i] += alpha*p[i];
+            r[i] -= alpha*q[i];
+            z[i] = pInvDiag[i]*r[i];
+            rz_new += r[i]*z[i];
+            rnorm2 += r[i]*r[i];
+        }
+
+        double beta = rz_new/rz;
+        rz = rz_new;
+        for (uint i = 0; i < n; ++i) p[i] = z[i] + beta*p[i];
+    }
+}
+
+}  // namespace efield
+}  // namespace solver
+}  // namespace steps
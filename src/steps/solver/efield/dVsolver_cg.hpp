@@ -0,0 +1,108 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_SOLVER_EFIELD_DVSOLVER_CG_HPP
+#define STEPS_SOLVER_EFIELD_DVSOLVER_CG_HPP 1
+
+// STL headers.
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/solver/efield/dVsolver.hpp"
+#include "steps/solver/efield/linsystem.hpp"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+/// Serial dV solver using Jacobi-preconditioned conjugate gradients
+/// on a CSR matrix. Unlike dVSolverBanded, memory scales with the number
+/// of vertex connections rather than with the mesh half-bandwidth.
+///
+/// Rows and columns of clamped vertices are eliminated from the system,
+/// keeping the matrix symmetric positive definite.
+
+class dVSolverCG: public dVSolverBase {
+public:
+    /// \param rtol Relative residual tolerance for convergence.
+    /// \param maxiter Maximum number of CG iterations per solve.
+    explicit dVSolverCG(double rtol = 1.0e-10, uint maxiter = 10000);
+
+    /// Initialize mesh and build CSR sparsity pattern
+    void initMesh(TetMesh *mesh) override;
+
+    /// Assemble and solve linear system; the matrix is only reassembled
+    /// when dt changes or it has been marked stale.
+    void advance(double dt) override;
+
+    /// Number of iterations used by the last solve.
+    inline uint lastIterations() const
+    { return pLastIter; }
+
+private:
+    /// Fill CSR values and Jacobi preconditioner for given dt.
+    void _assemble(double dt);
+
+    /// Solve pA pX = pB by PCG, using pX as initial guess.
+    void _solve();
+
+    /// y = A x
+    void _spmv(const double *x, double *y) const;
+
+    double                      pRTol;
+    uint                        pMaxIter;
+    uint                        pLastIter;
+
+    /// dt used for the current matrix values.
+    double                      pAssembledDT;
+
+    // CSR matrix. Row i holds the diagonal first, followed by the
+    // neighbours of vertex i in VertexElement order.
+    std::vector<uint>           pRowPtr;
+    std::vector<uint>           pColIdx;
+    std::vector<double>         pVal;
+
+    /// Inverse of the matrix diagonal (Jacobi preconditioner).
+    std::vector<double>         pInvDiag;
+
+    /// Right hand side and solution; pX is kept between steps as warm start.
+    std::vector<double>         pB;
+    std::vector<double>         pX;
+
+    // CG work vectors
+    std::vector<double>         pR;
+    std::vector<double>         pZ;
+    std::vector<double>         pP;
+    std::vector<double>         pQ;
+};
+
+}}} // namespace steps::efield::solver
+
+#endif // ndef STEPS_SOLVER_EFIELD_DVSOLVER_CG_HPP
+
+// END
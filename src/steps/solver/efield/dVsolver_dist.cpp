@@ -0,0 +1,473 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################
+
+ */
+
+
+// STL headers.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <sstream>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+#include "steps/solver/efield/dVsolver_dist.hpp"
+
+// logging
+#include "easylogging++.h"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+dVSolverDist::dVSolverDist(MPI_Comm comm, double rtol, uint maxiter)
+: pComm(comm)
+, pRank(0)
+, pSize(1)
+, pRTol(rtol)
+, pMaxIter(maxiter)
+, pLastIter(0)
+, pAssembledDT(0.0)
+, pNOwned(0)
+{
+    MPI_Comm_rank(pComm, &pRank);
+    MPI_Comm_size(pComm, &pSize);
+}
+
+void dVSolverDist::setPartition(std::vector<int> const & vert_hosts, std::vector<int> const & tri_hosts) {
+    // the current owners hold the only up to date potentials
+    if (pMesh != 0) gatherPotential();
+
+    pVertHosts = vert_hosts;
+    pTriHosts = tri_hosts;
+
+    if (pMesh != 0) _setupPartition();
+}
+
+void dVSolverDist::initMesh(TetMesh *mesh) {
+    dVSolverBase::initMesh(mesh);
+
+    // without a partition, split vertices and triangles into blocks
+    if (pVertHosts.empty() && pTriHosts.empty()) {
+        pVertHosts.resize(pNVerts);
+        pTriHosts.resize(pNTris);
+        for (uint i = 0; i < pNVerts; ++i)
+            pVertHosts[i] = static_cast<uint64_t>(i) * pSize / pNVerts;
+        for (uint i = 0; i < pNTris; ++i)
+            pTriHosts[i] = static_cast<uint64_t>(i) * pSize / pNTris;
+    }
+
+    _setupPartition();
+}
+
+void dVSolverDist::_setupPartition() {
+    if (pVertHosts.size() != pNVerts || pTriHosts.size() != pNTris) {
+        std::ostringstream os;
+        os << "dVSolverDist partition has " << pVertHosts.size() << " vertices and ";
+        os << pTriHosts.size() << " triangles, expected " << pNVerts << " and " << pNTris << ".";
+        ArgErrLog(os.str());
+    }
+
+    // owners by vertex IDX
+    std::vector<uint> perm = pMesh->getVertexPermutation();
+    std::vector<int> host(pNVerts);
+    for (uint i = 0; i < pNVerts; ++i) {
+        if (pVertHosts[i] < 0 || pVertHosts[i] >= pSize) {
+            std::ostringstream os;
+            os << "Vertex " << i << " is assigned to rank " << pVertHosts[i] << " out of " << pSize << ".";
+            ArgErrLog(os.str());
+        }
+        host[perm[i]] = pVertHosts[i];
+    }
+
+    std::vector<VertexElement*> by_idx(pNVerts);
+    for (uint i = 0; i < pNVerts; ++i) {
+        VertexElement *ve = pMesh->getVertex(i);
+        by_idx[ve->getIDX()] = ve;
+    }
+
+    pLocal.assign(pNVerts, -1);
+    pLocalIDX.clear();
+    pOwnedVE.clear();
+    for (uint idx = 0; idx < pNVerts; ++idx) {
+        if (host[idx] != pRank) continue;
+        pLocal[idx] = pLocalIDX.size();
+        pLocalIDX.push_back(idx);
+        pOwnedVE.push_back(by_idx[idx]);
+    }
+    pNOwned = pLocalIDX.size();
+
+    pOwnTris.clear();
+    for (uint t = 0; t < pNTris; ++t)
+        if (pTriHosts[t] == pRank) pOwnTris.push_back(t);
+
+    // ghosts: neighbours of owned vertices and vertices of own triangles
+    std::vector<char> ghost(pNVerts, 0);
+    for (auto ve : pOwnedVE)
+        for (uint inbr = 0; inbr < ve->getNCon(); ++inbr)
+            if (host[ve->nbrIdx(inbr)] != pRank) ghost[ve->nbrIdx(inbr)] = 1;
+    for (uint t : pOwnTris) {
+        uint *triv = pMesh->getTriangle(t);
+        for (uint j = 0; j < 3; ++j)
+            if (host[triv[j]] != pRank) ghost[triv[j]] = 1;
+    }
+    for (uint idx = 0; idx < pNVerts; ++idx) {
+        if (!ghost[idx]) continue;
+        pLocal[idx] = pLocalIDX.size();
+        pLocalIDX.push_back(idx);
+    }
+    uint nlocal = pLocalIDX.size();
+
+    // local rows
+    pRowPtr.assign(pNOwned+1, 0);
+    for (uint i = 0; i < pNOwned; ++i)
+        pRowPtr[i+1] = pRowPtr[i] + 1 + pOwnedVE[i]->getNCon();
+
+    pColIdx.assign(pRowPtr[pNOwned], 0);
+    pVal.assign(pRowPtr[pNOwned], 0.0);
+    pInteriorRows.clear();
+    pBoundaryRows.clear();
+    for (uint i = 0; i < pNOwned; ++i) {
+        VertexElement *ve = pOwnedVE[i];
+        uint *cols = &pColIdx[pRowPtr[i]];
+        bool boundary = false;
+
+        cols[0] = i;
+        for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) {
+            cols[1+inbr] = pLocal[ve->nbrIdx(inbr)];
+            if (cols[1+inbr] >= pNOwned) boundary = true;
+        }
+        if (boundary) pBoundaryRows.push_back(i);
+        else pInteriorRows.push_back(i);
+    }
+
+    // Ghosts are requested from their owners, which reply with the
+    // owned entries they will send.
+    std::vector<int> need_counts(pSize, 0);
+    for (uint g = pNOwned; g < nlocal; ++g) ++need_counts[host[pLocalIDX[g]]];
+    std::vector<int> need_displs(pSize, 0);
+    std::partial_sum(need_counts.begin(), need_counts.end()-1, need_displs.begin()+1);
+    // ghosts ascend by IDX, so grouping them by owner keeps that order
+    std::vector<uint> need_idx(nlocal - pNOwned);
+    std::vector<uint> need_local(nlocal - pNOwned);
+    {
+        std::vector<int> fill(need_displs);
+        for (uint g = pNOwned; g < nlocal; ++g) {
+            int r = host[pLocalIDX[g]];
+            need_idx[fill[r]] = pLocalIDX[g];
+            need_local[fill[r]] = g;
+            ++fill[r];
+        }
+    }
+
+    std::vector<int> req_counts(pSize, 0);
+    MPI_Alltoall(need_counts.data(), 1, MPI_INT, req_counts.data(), 1, MPI_INT, pComm);
+    std::vector<int> req_displs(pSize, 0);
+    std::partial_sum(req_counts.begin(), req_counts.end()-1, req_displs.begin()+1);
+    std::vector<uint> req_idx(req_displs.back() + req_counts.back());
+    MPI_Alltoallv(need_idx.data(), need_counts.data(), need_displs.data(), MPI_UNSIGNED,
+                  req_idx.data(), req_counts.data(), req_displs.data(), MPI_UNSIGNED, pComm);
+
+    pPeers.clear();
+    pSendPtr.assign(1, 0);
+    pRecvPtr.assign(1, 0);
+    pSendIdx.clear();
+    pRecvIdx.clear();
+    for (int r = 0; r < pSize; ++r) {
+        if (req_counts[r] == 0 && need_counts[r] == 0) continue;
+        pPeers.push_back(r);
+        for (int j = req_displs[r]; j < req_displs[r] + req_counts[r]; ++j) {
+            int l = pLocal[req_idx[j]];
+            if (l < 0 || static_cast<uint>(l) >= pNOwned) {
+                std::ostringstream os;
+                os << "Rank " << r << " requested vertex " << req_idx[j] << " not owned by rank " << pRank << ".";
+                ProgErrLog(os.str());
+            }
+            pSendIdx.push_back(l);
+        }
+        for (int j = need_displs[r]; j < need_displs[r] + need_counts[r]; ++j)
+            pRecvIdx.push_back(need_local[j]);
+        pSendPtr.push_back(pSendIdx.size());
+        pRecvPtr.push_back(pRecvIdx.size());
+    }
+    pSendBuf.assign(pSendIdx.size(), 0.0);
+    pRecvBuf.assign(pRecvIdx.size(), 0.0);
+    pRequests.assign(2 * pPeers.size(), MPI_REQUEST_NULL);
+
+    int nowned = pNOwned;
+    pOwnedCounts.assign(pSize, 0);
+    pOwnedDispls.assign(pSize, 0);
+    MPI_Allgather(&nowned, 1, MPI_INT, pOwnedCounts.data(), 1, MPI_INT, pComm);
+    std::partial_sum(pOwnedCounts.begin(), pOwnedCounts.end()-1, pOwnedDispls.begin()+1);
+    pAllOwnedIDX.assign(pOwnedDispls.back() + pOwnedCounts.back(), 0);
+    MPI_Allgatherv(pLocalIDX.data(), nowned, MPI_UNSIGNED,
+                   pAllOwnedIDX.data(), pOwnedCounts.data(), pOwnedDispls.data(), MPI_UNSIGNED, pComm);
+    if (pAllOwnedIDX.size() != pNVerts) {
+        std::ostringstream os;
+        os << "dVSolverDist partition owns " << pAllOwnedIDX.size() << " of " << pNVerts << " vertices.";
+        ProgErrLog(os.str());
+    }
+
+    pInvDiag.assign(pNOwned, 0.0);
+    pB.assign(pNOwned, 0.0);
+    pX.assign(pNOwned, 0.0);
+    pR.assign(pNOwned, 0.0);
+    pZ.assign(pNOwned, 0.0);
+    pQ.assign(pNOwned, 0.0);
+    pP.assign(nlocal, 0.0);
+    pW.assign(nlocal, 0.0);
+    pMatrixStale = true;
+}
+
+void dVSolverDist::advance(double dt) {
+    if (pMatrixStale || dt != pAssembledDT) {
+        _assemble(dt);
+        pAssembledDT = dt;
+        pMatrixStale = false;
+    }
+
+    _populateLocalRHS();
+
+    _solve();
+
+    for (uint i = 0; i < pNOwned; ++i) {
+        uint idx = pLocalIDX[i];
+        if (pVertexClamp[idx] == false) pV[idx] += pX[i];
+        pW[i] = pV[idx];
+    }
+
+    // bring the ghost potentials up to date for the next step
+    _startExchange(pW.data());
+    _finishExchange(pW.data());
+    for (uint g = pNOwned; g < pLocalIDX.size(); ++g) pV[pLocalIDX[g]] = pW[g];
+
+    // reset pTriCur for caller contributions
+    std::fill(pTriCur.begin(), pTriCur.end(), 0.0);
+}
+
+void dVSolverDist::gatherPotential() {
+    std::vector<double> owned(pNOwned);
+    for (uint i = 0; i < pNOwned; ++i) owned[i] = pV[pLocalIDX[i]];
+
+    std::vector<double> all(pAllOwnedIDX.size());
+    MPI_Allgatherv(owned.data(), pNOwned, MPI_DOUBLE,
+                   all.data(), pOwnedCounts.data(), pOwnedDispls.data(), MPI_DOUBLE, pComm);
+    for (uint j = 0; j < all.size(); ++j) pV[pAllOwnedIDX[j]] = all[j];
+}
+
+void dVSolverDist::_assemble(double dt) {
+    double oodt = 1.0/dt;
+
+    for (uint i = 0; i < pNOwned; ++i) {
+        VertexElement *ve = pOwnedVE[i];
+        uint ind = pLocalIDX[i];
+        double *vals = &pVal[pRowPtr[i]];
+
+        if (pVertexClamp[ind]) {
+            vals[0] = 1.0;
+            std::fill(vals+1, vals+1+ve->getNCon(), 0.0);
+        }
+        else {
+            double Aii = ve->getCapacitance()*oodt + pGExt[ind];
+
+            for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) {
+                double cc = ve->getCC(inbr);
+                Aii += cc;
+                // dV of a clamped neighbour is zero: drop the column
+                // to keep the matrix symmetric.
+                vals[1+inbr] = pVertexClamp[ve->nbrIdx(inbr)] ? 0.0 : -cc;
+            }
+            vals[0] = Aii;
+        }
+        pInvDiag[i] = 1.0/vals[0];
+    }
+}
+
+void dVSolverDist::_populateLocalRHS() {
+    // vertex currents of the own triangles, summed into the owners
+    std::fill(pW.begin(), pW.end(), 0.0);
+    for (uint t : pOwnTris) {
+        double c = (pTriCur[t] + pTriCurClamp[t]) / 3.0;
+
+        uint *triv = pMesh->getTriangle(t);
+        pW[pLocal[triv[0]]] += c;
+        pW[pLocal[triv[1]]] += c;
+        pW[pLocal[triv[2]]] += c;
+    }
+    _reduceGhosts(pW.data());
+
+    for (uint i = 0; i < pNOwned; ++i) {
+        VertexElement *ve = pOwnedVE[i];
+        uint ind = pLocalIDX[i];
+
+        if (pVertexClamp[ind]) {
+            pB[i] = 0.0;
+        }
+        else {
+            double rhs = pW[i] + pVertCurClamp[ind] + pGExt[ind] * (pVExt - pV[ind]);
+
+            for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) {
+                uint k = ve->nbrIdx(inbr);
+                rhs += ve->getCC(inbr) * (pV[k] - pV[ind]);
+            }
+            pB[i] = rhs;
+        }
+    }
+}
+
+void dVSolverDist::_startExchange(const double *values) {
+    for (uint k = 0; k < pPeers.size(); ++k) {
+        uint nrecv = pRecvPtr[k+1] - pRecvPtr[k];
+        if (nrecv == 0) continue;
+        MPI_Irecv(&pRecvBuf[pRecvPtr[k]], nrecv, MPI_DOUBLE, pPeers[k], 0, pComm, &pRequests[2*k]);
+    }
+    for (uint k = 0; k < pPeers.size(); ++k) {
+        uint nsend = pSendPtr[k+1] - pSendPtr[k];
+        if (nsend == 0) continue;
+        for (uint j = pSendPtr[k]; j < pSendPtr[k+1]; ++j) pSendBuf[j] = values[pSendIdx[j]];
+        MPI_Isend(&pSendBuf[pSendPtr[k]], nsend, MPI_DOUBLE, pPeers[k], 0, pComm, &pRequests[2*k+1]);
+    }
+}
+
+void dVSolverDist::_finishExchange(double *values) {
+    MPI_Waitall(pRequests.size(), pRequests.data(), MPI_STATUSES_IGNORE);
+    for (uint j = 0; j < pRecvIdx.size(); ++j) values[pRecvIdx[j]] = pRecvBuf[j];
+}
+
+void dVSolverDist::_reduceGhosts(double *values) {
+    // the reverse of _startExchange/_finishExchange
+    for (uint k = 0; k < pPeers.size(); ++k) {
+        uint nsend = pSendPtr[k+1] - pSendPtr[k];
+        if (nsend == 0) continue;
+        MPI_Irecv(&pSendBuf[pSendPtr[k]], nsend, MPI_DOUBLE, pPeers[k], 1, pComm, &pRequests[2*k]);
+    }
+    for (uint k = 0; k < pPeers.size(); ++k) {
+        uint nrecv = pRecvPtr[k+1] - pRecvPtr[k];
+        if (nrecv == 0) continue;
+        for (uint j = pRecvPtr[k]; j < pRecvPtr[k+1]; ++j) pRecvBuf[j] = values[pRecvIdx[j]];
+        MPI_Isend(&pRecvBuf[pRecvPtr[k]], nrecv, MPI_DOUBLE, pPeers[k], 1, pComm, &pRequests[2*k+1]);
+    }
+    MPI_Waitall(pRequests.size(), pRequests.data(), MPI_STATUSES_IGNORE);
+    for (uint j = 0; j < pSendIdx.size(); ++j) values[pSendIdx[j]] += pSendBuf[j];
+}
+
+void dVSolverDist::_allreduce(double *values, int n) const {
+    MPI_Allreduce(MPI_IN_PLACE, values, n, MPI_DOUBLE, MPI_SUM, pComm);
+}
+
+void dVSolverDist::_spmv(double *x, double *y) {
+    // interior rows are computed while the ghost entries are in flight
+    _startExchange(x);
+    for (uint i : pInteriorRows) {
+        double s = 0.0;
+        for (uint k = pRowPtr[i]; k < pRowPtr[i+1]; ++k)
+            s += pVal[k] * x[pColIdx[k]];
+        y[i] = s;
+    }
+    _finishExchange(x);
+    for (uint i : pBoundaryRows) {
+        double s = 0.0;
+        for (uint k = pRowPtr[i]; k < pRowPtr[i+1]; ++k)
+            s += pVal[k] * x[pColIdx[k]];
+        y[i] = s;
+    }
+}
+
+void dVSolverDist::_solve() {
+    uint n = pNOwned;
+    double *x = pX.data();
+    double *r = pR.data();
+    double *z = pZ.data();
+    double *p = pP.data();
+    double *q = pQ.data();
+
+    double bnorm2 = 0.0;
+    for (uint i = 0; i < n; ++i) {
+        // warm start from previous dV, which must be zero when clamped
+        if (pVertexClamp[pLocalIDX[i]]) x[i] = 0.0;
+        bnorm2 += pB[i]*pB[i];
+    }
+    _allreduce(&bnorm2, 1);
+
+    pLastIter = 0;
+    if (bnorm2 == 0.0) {
+        std::fill(pX.begin(), pX.end(), 0.0);
+        return;
+    }
+    double tol2 = pRTol*pRTol*bnorm2;
+
+    std::copy(x, x+n, p);
+    _spmv(p, q);
+    // {r.z, r.r}
+    double sums[2] = {0.0, 0.0};
+    for (uint i = 0; i < n; ++i) {
+        r[i] = pB[i] - q[i];
+        z[i] = pInvDiag[i] * r[i];
+        p[i] = z[i];
+        sums[0] += r[i]*z[i];
+        sums[1] += r[i]*r[i];
+    }
+    _allreduce(sums, 2);
+    double rz = sums[0];
+    double rnorm2 = sums[1];
+
+    while (rnorm2 > tol2) {
+        if (pLastIter == pMaxIter) {
+            std::ostringstream os;
+            os << "dVSolverDist did not converge in " << pMaxIter << " iterations ";
+            os << "(relative residual " << std::sqrt(rnorm2/bnorm2) << ").";
+            ProgErrLog(os.str());
+        }
+        ++pLastIter;
+
+        _spmv(p, q);
+        double pq = 0.0;
+        for (uint i = 0; i < n; ++i) pq += p[i]*q[i];
+        _allreduce(&pq, 1);
+
+        double alpha = rz/pq;
+        sums[0] = 0.0;
+        sums[1] = 0.0;
+        for (uint i = 0; i < n; ++i) {
+            x[i] += alpha*p[i];
+            r[i] -= alpha*q[i];
+            z[i] = pInvDiag[i]*r[i];
+            sums[0] += r[i]*z[i];
+            sums[1] += r[i]*r[i];
+        }
+        _allreduce(sums, 2);
+
+        double beta = sums[0]/rz;
+        rz = sums[0];
+        rnorm2 = sums[1];
+        for (uint i = 0; i < n; ++i) p[i] = z[i] + beta*p[i];
+    }
+}
+
+}  // namespace efield
+}  // namespace solver
+}  // namespace steps
@@ -0,0 +1,189 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################
+
+ */
+
+
+#ifndef STEPS_SOLVER_EFIELD_DVSOLVER_DIST_HPP
+#define STEPS_SOLVER_EFIELD_DVSOLVER_DIST_HPP 1
+
+// STL headers.
+#include <vector>
+
+#include <mpi.h>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/solver/efield/dVsolver.hpp"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+/// Distributed dV solver using Jacobi-preconditioned conjugate gradients.
+///
+/// Each rank owns a set of vertices and the matrix rows for them, and
+/// a set of triangles whose currents it supplies through setTriI().
+/// The values of non-owned vertices that a rank reads (neighbours of
+/// its rows and vertices of its triangles) are exchanged point to point
+/// with the ranks owning them; vertex currents of a rank's triangles are
+/// summed into the owning ranks the same way.
+///
+/// After advance() only the potentials of owned and exchanged vertices
+/// are current; gatherPotential() brings every vertex up to date on all
+/// ranks.
+
+class dVSolverDist: public dVSolverBase {
+public:
+    /// \param comm Communicator over all ranks sharing the mesh.
+    /// \param rtol Relative residual tolerance for convergence.
+    /// \param maxiter Maximum number of CG iterations per solve.
+    explicit dVSolverDist(MPI_Comm comm, double rtol = 1.0e-10, uint maxiter = 10000);
+
+    /// Set the owning rank of each vertex and triangle, in the index
+    /// order given to EField::initMesh. May be called before initMesh(),
+    /// or afterwards to repartition, which gathers the potential first.
+    void setPartition(std::vector<int> const & vert_hosts, std::vector<int> const & tri_hosts);
+
+    /// Initialize mesh and build the local part of the matrix
+    void initMesh(TetMesh *mesh) override;
+
+    /// Assemble and solve the distributed system; the matrix is only
+    /// reassembled when dt changes or it has been marked stale.
+    void advance(double dt) override;
+
+    /// Update the potential of all vertices on all ranks (collective).
+    void gatherPotential();
+
+    /// Number of iterations used by the last solve.
+    inline uint lastIterations() const
+    { return pLastIter; }
+
+    /// Number of vertices owned by this rank.
+    inline uint countOwnedVertices() const
+    { return pNOwned; }
+
+private:
+    /// Build local numbering, matrix pattern and exchange lists.
+    void _setupPartition();
+
+    /// Fill local matrix rows and Jacobi preconditioner for given dt.
+    void _assemble(double dt);
+
+    /// Fill pB from potentials and the currents of owned triangles.
+    void _populateLocalRHS();
+
+    /// Solve by PCG, using pX as initial guess.
+    void _solve();
+
+    /// y = A x over owned rows; x is local-indexed, its ghost
+    /// entries are refreshed from the owners.
+    void _spmv(double *x, double *y);
+
+    /// Send owned entries of values to the ranks reading them and
+    /// receive the ghost entries.
+    void _startExchange(const double *values);
+    void _finishExchange(double *values);
+
+    /// Add the ghost entries of values into their owners' entries.
+    void _reduceGhosts(double *values);
+
+    /// Sum n doubles over all ranks in place.
+    void _allreduce(double *values, int n) const;
+
+    MPI_Comm                    pComm;
+    int                         pRank;
+    int                         pSize;
+
+    double                      pRTol;
+    uint                        pMaxIter;
+    uint                        pLastIter;
+
+    /// dt used for the current matrix values.
+    double                      pAssembledDT;
+
+    /// Owners in initMesh index order, as given to setPartition().
+    std::vector<int>            pVertHosts;
+    std::vector<int>            pTriHosts;
+
+    /// Local index of each vertex (by IDX), or -1. Owned vertices come
+    /// first, followed by the ghost vertices read from other ranks.
+    std::vector<int>            pLocal;
+    std::vector<uint>           pLocalIDX;
+    uint                        pNOwned;
+
+    /// Vertex elements of owned rows.
+    std::vector<VertexElement*> pOwnedVE;
+
+    /// Triangles whose currents are supplied on this rank.
+    std::vector<uint>           pOwnTris;
+
+    /// Owned rows without and with ghost columns.
+    std::vector<uint>           pInteriorRows;
+    std::vector<uint>           pBoundaryRows;
+
+    // CSR matrix over owned rows in local column indices. Row i holds
+    // the diagonal first, followed by the neighbours of the vertex.
+    std::vector<uint>           pRowPtr;
+    std::vector<uint>           pColIdx;
+    std::vector<double>         pVal;
+
+    /// Inverse of the matrix diagonal (Jacobi preconditioner).
+    std::vector<double>         pInvDiag;
+
+    /// Right hand side and solution over owned rows; pX is kept between
+    /// steps as warm start.
+    std::vector<double>         pB;
+    std::vector<double>         pX;
+
+    // CG work vectors; pP and pW span owned and ghost entries.
+    std::vector<double>         pR;
+    std::vector<double>         pZ;
+    std::vector<double>         pP;
+    std::vector<double>         pQ;
+    std::vector<double>         pW;
+
+    // Exchange partners. For peer k, the owned entries
+    // pSendIdx[pSendPtr[k]..pSendPtr[k+1]) are read by it and the ghost
+    // entries pRecvIdx[pRecvPtr[k]..pRecvPtr[k+1]) are owned by it.
+    std::vector<int>            pPeers;
+    std::vector<uint>           pSendPtr;
+    std::vector<uint>           pSendIdx;
+    std::vector<uint>           pRecvPtr;
+    std::vector<uint>           pRecvIdx;
+    std::vector<double>         pSendBuf;
+    std::vector<double>         pRecvBuf;
+    std::vector<MPI_Request>    pRequests;
+
+    // Owned vertices (by IDX) of all ranks, for gatherPotential().
+    std::vector<int>            pOwnedCounts;
+    std::vector<int>            pOwnedDispls;
+    std::vector<uint>           pAllOwnedIDX;
+};
+
+}}} // namespace steps::efield::solver
+
+#endif // ndef STEPS_SOLVER_EFIELD_DVSOLVER_DIST_HPP
+
+// END
@@ -160,6 +160,7 @@ void sefield::EField::restore(std::fstream & cp_file)
     cp_file.read((char*)&pCPerm.front(), sizeof(uint) * nCPerm);
 
     pMesh->restore(cp_file);
+    pVProp->setMatrixStale();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -174,6 +175,7 @@ void sefield::EField::setMembCapac(uint midx, double cm)
     // specific capacitance in pF/um2.
     // Argument is in F/m^2: 1 F/m^2 = 1 pF / um^2 so no conversion needed!
     pMesh->applySurfaceCapacitance(cm);
+    pVProp->setMatrixStale();
 }
 
 void sefield::EField::setTriCapac(uint tidx, double cm)
@@ -188,6 +190,7 @@ void sefield::EField::setTriCapac(uint tidx, double cm)
     // Argument is in F/m^2: 1 F/m^2 = 1 pF / um^2 so no conversion needed!
 
     pMesh->applyTriCapacitance(tidx, cm);
+    pVProp->setMatrixStale();
 
 }
 
@@ -208,6 +211,7 @@ void sefield::EField::setMembVolRes(uint midx, double ro)
 {
     AssertLog(ro >= 0.0);
     pMesh->applyConductance(1.0/(ro*1.0e-3));
+    pVProp->setMatrixStale();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
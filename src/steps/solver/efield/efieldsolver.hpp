@@ -71,6 +71,9 @@ struct EFieldSolver {
     /** Set additional current injection for area associated with vertex i to c (pA) */
     virtual void setVertIClamp(int i, double c) =0;
 
+    /** Notify that capacitances or conductances in the mesh have changed */
+    virtual void setMatrixStale() =0;
+
     /** Solve for voltage with given dt */
     virtual void advance(double dt) =0;
 };
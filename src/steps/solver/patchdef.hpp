@@ -43,6 +43,7 @@
 #include "steps/common.h"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/api.hpp"
+#include "steps/solver/sparse_stoich.hpp"
 #include "steps/geom/patch.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -275,6 +276,22 @@ public:
     int * sreac_upd_O_bgn(uint lidx) const;
     int * sreac_upd_O_end(uint lidx) const;
 
+    // Return the nonzero (species, order) and (species, change) entries of
+    // the lhs and update arrays of the surface reaction specified by local
+    // index argument.
+    inline SparseStoich::Row sreac_lhs_I_sparse(uint lidx) const
+    { return pSReac_LHS_I_Sparse.row(lidx); }
+    inline SparseStoich::Row sreac_lhs_S_sparse(uint lidx) const
+    { return pSReac_LHS_S_Sparse.row(lidx); }
+    inline SparseStoich::Row sreac_lhs_O_sparse(uint lidx) const
+    { return pSReac_LHS_O_Sparse.row(lidx); }
+    inline SparseStoich::Row sreac_upd_I_sparse(uint lidx) const
+    { return pSReac_UPD_I_Sparse.row(lidx); }
+    inline SparseStoich::Row sreac_upd_S_sparse(uint lidx) const
+    { return pSReac_UPD_S_Sparse.row(lidx); }
+    inline SparseStoich::Row sreac_upd_O_sparse(uint lidx) const
+    { return pSReac_UPD_O_Sparse.row(lidx); }
+
     /// Return pointer to flags on surface reactions for this patch.
     inline uint * srflags() const
     { return pSReacFlags; }
@@ -467,6 +484,22 @@ public:
     int * vdepsreac_upd_O_bgn(uint lidx) const;
     int * vdepsreac_upd_O_end(uint lidx) const;
 
+    // Return the nonzero (species, order) and (species, change) entries of
+    // the lhs and update arrays of the voltage-dependent surface reaction
+    // specified by local index argument.
+    inline SparseStoich::Row vdepsreac_lhs_I_sparse(uint lidx) const
+    { return pVDepSReac_LHS_I_Sparse.row(lidx); }
+    inline SparseStoich::Row vdepsreac_lhs_S_sparse(uint lidx) const
+    { return pVDepSReac_LHS_S_Sparse.row(lidx); }
+    inline SparseStoich::Row vdepsreac_lhs_O_sparse(uint lidx) const
+    { return pVDepSReac_LHS_O_Sparse.row(lidx); }
+    inline SparseStoich::Row vdepsreac_upd_I_sparse(uint lidx) const
+    { return pVDepSReac_UPD_I_Sparse.row(lidx); }
+    inline SparseStoich::Row vdepsreac_upd_S_sparse(uint lidx) const
+    { return pVDepSReac_UPD_S_Sparse.row(lidx); }
+    inline SparseStoich::Row vdepsreac_upd_O_sparse(uint lidx) const
+    { return pVDepSReac_UPD_O_Sparse.row(lidx); }
+
 
     ////////////////////////////////////////////////////////////////////////
     // SOLVER METHODS: SURFACE REACTIONS
@@ -587,6 +620,12 @@ private:
     int                               * pSReac_UPD_I_Spec;
     int                               * pSReac_UPD_S_Spec;
     int                               * pSReac_UPD_O_Spec;
+    SparseStoich                        pSReac_LHS_I_Sparse;
+    SparseStoich                        pSReac_LHS_S_Sparse;
+    SparseStoich                        pSReac_LHS_O_Sparse;
+    SparseStoich                        pSReac_UPD_I_Sparse;
+    SparseStoich                        pSReac_UPD_S_Sparse;
+    SparseStoich                        pSReac_UPD_O_Sparse;
 
     ////////////////////////////////////////////////////////////////////////
     // DATA: SURFACE DIFFUSION RULES
@@ -645,6 +684,12 @@ private:
     int                               * pVDepSReac_UPD_I_Spec;
     int                               * pVDepSReac_UPD_S_Spec;
     int                               * pVDepSReac_UPD_O_Spec;
+    SparseStoich                        pVDepSReac_LHS_I_Sparse;
+    SparseStoich                        pVDepSReac_LHS_S_Sparse;
+    SparseStoich                        pVDepSReac_LHS_O_Sparse;
+    SparseStoich                        pVDepSReac_UPD_I_Sparse;
+    SparseStoich                        pVDepSReac_UPD_S_Sparse;
+    SparseStoich                        pVDepSReac_UPD_O_Sparse;
 
     ////////////////////////////////////////////////////////////////////////
     // DATA: OHMIC CURRENTS
@@ -0,0 +1,125 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_SOLVER_SPARSESTOICH_HPP
+#define STEPS_SOLVER_SPARSESTOICH_HPP 1
+
+// STL headers.
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+
+ namespace steps {
+ namespace solver {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Nonzero entry of a stoichiometry row: the local index of a species and its
+/// coefficient (reaction order for lhs tables, molecule change for update
+/// tables).
+struct SpecCoeff
+{
+    uint                                lidx;
+    int                                 coeff;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Row-compressed copy of a dense (rule x species) stoichiometry table.
+///
+/// Rate and apply kernels iterate over the handful of species a rule
+/// actually involves instead of scanning every species of the compartment
+/// or patch. Entries of a row are kept in increasing species order.
+class SparseStoich
+{
+
+public:
+
+    /// Contiguous range of the nonzero entries of one row.
+    struct Row
+    {
+        SpecCoeff const * begin() const
+        { return pBegin; }
+        SpecCoeff const * end() const
+        { return pEnd; }
+        uint size() const
+        { return static_cast<uint>(pEnd - pBegin); }
+
+        SpecCoeff const *               pBegin;
+        SpecCoeff const *               pEnd;
+    };
+
+    SparseStoich()
+    : pEntries()
+    , pOffsets(1, 0)
+    {
+    }
+
+    /// Build from a dense row-major table of nrows x nspecs entries.
+    /// A null table (e.g. no inner or outer compartment) gives empty rows.
+    template <typename T>
+    void assign(T const * dense, uint nrows, uint nspecs)
+    {
+        pEntries.clear();
+        pOffsets.assign(1, 0);
+        pOffsets.reserve(nrows + 1);
+        for (uint r = 0; r < nrows; ++r)
+        {
+            T const * row = dense + r * nspecs;
+            for (uint s = 0; dense != nullptr && s < nspecs; ++s)
+            {
+                if (row[s] == 0) continue;
+                pEntries.push_back(SpecCoeff{s, static_cast<int>(row[s])});
+            }
+            pOffsets.push_back(pEntries.size());
+        }
+        pEntries.shrink_to_fit();
+    }
+
+    /// Return the nonzero entries of row r.
+    Row row(uint r) const
+    {
+        SpecCoeff const * base = pEntries.data();
+        return Row{base + pOffsets[r], base + pOffsets[r + 1]};
+    }
+
+private:
+
+    std::vector<SpecCoeff>              pEntries;
+    std::vector<uint>                   pOffsets;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif
+// STEPS_SOLVER_SPARSESTOICH_HPP
+
+// END
@@ -258,6 +258,38 @@ ssolver::Statedef::Statedef(steps::model::Model * m, steps::wm::Geom * g, steps:
         (*db)->setup();
     for (SDiffBoundaryDefPVecI sdb = pSDiffBoundarydefs.begin(); sdb != pSDiffBoundarydefs.end(); ++sdb)
         (*sdb)->setup();
+
+    // Index all string identifiers for the name lookups.
+    for (uint cidx = 0; cidx < ncomps; ++cidx)
+        pCompIdxMap.emplace(pGeom->_getComp(cidx)->getID(), cidx);
+    for (uint pidx = 0; pidx < npatches; ++pidx)
+        pPatchIdxMap.emplace(pGeom->_getPatch(pidx)->getID(), pidx);
+    for (uint sidx = 0; sidx < nspecs; ++sidx)
+        pSpecIdxMap.emplace(pModel->_getSpec(sidx)->getID(), sidx);
+    for (uint ridx = 0; ridx < nreacs; ++ridx)
+        pReacIdxMap.emplace(pModel->_getReac(ridx)->getID(), ridx);
+    for (uint sridx = 0; sridx < nsreacs; ++sridx)
+        pSReacIdxMap.emplace(pModel->_getSReac(sridx)->getID(), sridx);
+    for (uint didx = 0; didx < nvdiffs; ++didx)
+        pDiffIdxMap.emplace(pModel->_getVDiff(didx)->getID(), didx);
+    for (uint didx = 0; didx < nsdiffs; ++didx)
+        pSurfDiffIdxMap.emplace(pModel->_getSDiff(didx)->getID(), didx);
+    for (uint vdtidx = 0; vdtidx < nvdtrans; ++vdtidx)
+        pVDepTransIdxMap.emplace(pModel->_getVDepTrans(vdtidx)->getID(), vdtidx);
+    for (uint vdsridx = 0; vdsridx < nvdsreacs; ++vdsridx)
+        pVDepSReacIdxMap.emplace(pModel->_getVDepSReac(vdsridx)->getID(), vdsridx);
+    for (uint ocidx = 0; ocidx < nohmiccurrs; ++ocidx)
+        pOhmicCurrIdxMap.emplace(pModel->_getOhmicCurr(ocidx)->getID(), ocidx);
+    for (uint ghkidx = 0; ghkidx < nghkcurrs; ++ghkidx)
+        pGHKcurrIdxMap.emplace(pModel->_getGHKcurr(ghkidx)->getID(), ghkidx);
+
+    if (auto * tetmesh = dynamic_cast<steps::tetmesh::Tetmesh *>(pGeom))
+    {
+        for (uint dbidx = 0; dbidx < pDiffBoundarydefs.size(); ++dbidx)
+            pDiffBoundaryIdxMap.emplace(tetmesh->_getDiffBoundary(dbidx)->getID(), dbidx);
+        for (uint sdbidx = 0; sdbidx < pSDiffBoundarydefs.size(); ++sdbidx)
+            pSDiffBoundaryIdxMap.emplace(tetmesh->_getSDiffBoundary(sdbidx)->getID(), sdbidx);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -467,6 +499,21 @@ void ssolver::Statedef::restore(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+template <typename GetID>
+uint ssolver::Statedef::_lookupIdx(IdxMap const & map, std::string const & id, uint n, GetID getID)
+{
+    auto hit = map.find(id);
+    if (hit != map.end() && id == getID(hit->second)) return hit->second;
+    // Not indexed under this name, e.g. renamed after construction.
+    for (uint idx = 0; idx < n; ++idx)
+    {
+        if (id == getID(idx)) return idx;
+    }
+    return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ssolver::Compdef * ssolver::Statedef::compdef(uint gidx) const
 {
     AssertLog(gidx < pCompdefs.size());
@@ -480,12 +527,9 @@ uint ssolver::Statedef::getCompIdx(std::string const & c) const
     uint maxcidx = pCompdefs.size();
     AssertLog(maxcidx > 0);
     AssertLog(maxcidx == pGeom->_countComps());
-    uint cidx = 0;
-    while(cidx < maxcidx)
-    {
-        if (c == pGeom->_getComp(cidx)->getID()) return cidx;
-        ++cidx;
-    }
+    uint cidx = _lookupIdx(pCompIdxMap, c, maxcidx,
+        [this](uint i) { return pGeom->_getComp(i)->getID(); });
+    if (cidx < maxcidx) return cidx;
     std::ostringstream os;
     os << "Geometry does not contain comp with string identifier '" << c << "'.";
     ArgErrLog(os.str());
@@ -523,12 +567,9 @@ uint ssolver::Statedef::getPatchIdx(std::string const & p) const
 {
     uint maxpidx = pPatchdefs.size();
     AssertLog(maxpidx == pGeom->_countPatches());
-    uint pidx = 0;
-    while(pidx < maxpidx)
-    {
-        if (p == pGeom->_getPatch(pidx)->getID()) return pidx;
-        ++pidx;
-    }
+    uint pidx = _lookupIdx(pPatchIdxMap, p, maxpidx,
+        [this](uint i) { return pGeom->_getPatch(i)->getID(); });
+    if (pidx < maxpidx) return pidx;
     std::ostringstream os;
     os << "Geometry does not contain patch with string identifier '" << p << "'.";
     ArgErrLog(os.str());
@@ -566,12 +607,9 @@ uint ssolver::Statedef::getSpecIdx(std::string const & s) const
     uint maxsidx = pSpecdefs.size();
     AssertLog(maxsidx > 0);
     AssertLog(maxsidx == pModel->_countSpecs());
-    uint sidx = 0;
-    while(sidx < maxsidx)
-    {
-        if (s == pModel->_getSpec(sidx)->getID()) return sidx;
-        ++sidx;
-    }
+    uint sidx = _lookupIdx(pSpecIdxMap, s, maxsidx,
+        [this](uint i) { return pModel->_getSpec(i)->getID(); });
+    if (sidx < maxsidx) return sidx;
     std::ostringstream os;
     os << "Model does not contain species with string identifier '" << s << "'.";
     ArgErrLog(os.str());
@@ -609,12 +647,9 @@ uint ssolver::Statedef::getReacIdx(std::string const & r) const
 {
     uint maxridx = pReacdefs.size();
     AssertLog(maxridx == pModel->_countReacs());
-    uint ridx = 0;
-    while(ridx < maxridx)
-    {
-        if (r == pModel->_getReac(ridx)->getID()) return ridx;
-        ++ridx;
-    }
+    uint ridx = _lookupIdx(pReacIdxMap, r, maxridx,
+        [this](uint i) { return pModel->_getReac(i)->getID(); });
+    if (ridx < maxridx) return ridx;
     std::ostringstream os;
     os << "Model does not contain reac with string identifier '" << r <<"'.";
     ArgErrLog(os.str());
@@ -651,12 +686,9 @@ uint ssolver::Statedef::getSReacIdx(std::string const & sr) const
 {
     uint maxsridx = pSReacdefs.size();
     AssertLog(maxsridx == pModel->_countSReacs());
-    uint sridx = 0;
-    while(sridx < maxsridx)
-    {
-        if (sr == pModel->_getSReac(sridx)->getID()) return sridx;
-        ++sridx;
-    }
+    uint sridx = _lookupIdx(pSReacIdxMap, sr, maxsridx,
+        [this](uint i) { return pModel->_getSReac(i)->getID(); });
+    if (sridx < maxsridx) return sridx;
     std::ostringstream os;
     os << "Model does not contain sreac with string identifier '" << sr <<"'.";
     ArgErrLog(os.str());
@@ -693,12 +725,9 @@ uint ssolver::Statedef::getDiffIdx(std::string const & d) const
 {
     uint maxdidx = pDiffdefs.size();
     AssertLog(maxdidx == pModel->_countVDiffs());
-    uint didx = 0;
-    while(didx < maxdidx)
-    {
-        if (d == pModel->_getVDiff(didx)->getID()) return didx;
-        ++didx;
-    }
+    uint didx = _lookupIdx(pDiffIdxMap, d, maxdidx,
+        [this](uint i) { return pModel->_getVDiff(i)->getID(); });
+    if (didx < maxdidx) return didx;
     std::ostringstream os;
     os << "Model does not contain diff with string identifier '" << d <<"'.";
     ArgErrLog(os.str());
@@ -735,12 +764,9 @@ uint ssolver::Statedef::getSurfDiffIdx(std::string const & d) const
 {
     uint maxdidx = pSurfDiffdefs.size();
     AssertLog(maxdidx == pModel->_countSDiffs());
-    uint didx = 0;
-    while(didx < maxdidx)
-    {
-        if (d == pModel->_getSDiff(didx)->getID()) return didx;
-        ++didx;
-    }
+    uint didx = _lookupIdx(pSurfDiffIdxMap, d, maxdidx,
+        [this](uint i) { return pModel->_getSDiff(i)->getID(); });
+    if (didx < maxdidx) return didx;
     std::ostringstream os;
     os << "Model does not contain diff with string identifier '" << d <<"'.";
     ArgErrLog(os.str());
@@ -777,12 +803,9 @@ uint ssolver::Statedef::getOhmicCurrIdx(std::string const & oc) const
 {
     uint maxocidx = pOhmicCurrdefs.size();
     AssertLog(maxocidx == pModel->_countOhmicCurrs());
-    uint ocidx = 0;
-    while(ocidx < maxocidx)
-    {
-        if (oc == pModel->_getOhmicCurr(ocidx)->getID()) return ocidx;
-        ++ocidx;
-    }
+    uint ocidx = _lookupIdx(pOhmicCurrIdxMap, oc, maxocidx,
+        [this](uint i) { return pModel->_getOhmicCurr(i)->getID(); });
+    if (ocidx < maxocidx) return ocidx;
     std::ostringstream os;
     os << "Model does not contain ohmic current with string identifier '" << oc <<"'.";
     ArgErrLog(os.str());
@@ -819,12 +842,9 @@ uint ssolver::Statedef::getVDepTransIdx(std::string const & vdt) const
 {
     uint maxvdtidx = pVDepTransdefs.size();
     AssertLog(maxvdtidx == pModel->_countVDepTrans());
-    uint vdtidx = 0;
-    while(vdtidx < maxvdtidx)
-    {
-        if (vdt == pModel->_getVDepTrans(vdtidx)->getID()) return vdtidx;
-        ++vdtidx;
-    }
+    uint vdtidx = _lookupIdx(pVDepTransIdxMap, vdt, maxvdtidx,
+        [this](uint i) { return pModel->_getVDepTrans(i)->getID(); });
+    if (vdtidx < maxvdtidx) return vdtidx;
     std::ostringstream os;
     os << "Model does not contain voltage-dependent transition with string identifier '" << vdt <<"'.";
     ArgErrLog(os.str());
@@ -861,12 +881,9 @@ uint ssolver::Statedef::getVDepSReacIdx(std::string const & vdsr) const
 {
     uint maxvdsridx = pVDepSReacdefs.size();
     AssertLog(maxvdsridx == pModel->_countVDepSReacs());
-    uint vdsridx = 0;
-    while(vdsridx < maxvdsridx)
-    {
-        if (vdsr == pModel->_getVDepSReac(vdsridx)->getID()) return vdsridx;
-        ++vdsridx;
-    }
+    uint vdsridx = _lookupIdx(pVDepSReacIdxMap, vdsr, maxvdsridx,
+        [this](uint i) { return pModel->_getVDepSReac(i)->getID(); });
+    if (vdsridx < maxvdsridx) return vdsridx;
     std::ostringstream os;
     os << "Model does not contain voltage-dependent reaction with string identifier '" << vdsr <<"'.";
     ArgErrLog(os.str());
@@ -903,12 +920,9 @@ uint ssolver::Statedef::getGHKcurrIdx(std::string const & ghk) const
 {
     uint maxghkidx = pGHKcurrdefs.size();
     AssertLog(maxghkidx == pModel->_countGHKcurrs());
-    uint ghkidx = 0;
-    while(ghkidx < maxghkidx)
-    {
-        if (ghk == pModel->_getGHKcurr(ghkidx)->getID()) return ghkidx;
-        ++ghkidx;
-    }
+    uint ghkidx = _lookupIdx(pGHKcurrIdxMap, ghk, maxghkidx,
+        [this](uint i) { return pModel->_getGHKcurr(i)->getID(); });
+    if (ghkidx < maxghkidx) return ghkidx;
     std::ostringstream os;
     os << "Model does not contain ghk current with string identifier '" << ghk <<"'.";
     ArgErrLog(os.str());
@@ -985,12 +999,9 @@ uint ssolver::Statedef::getDiffBoundaryIdx(std::string const & d) const
     if (steps::tetmesh::Tetmesh * tetmesh = dynamic_cast<steps::tetmesh::Tetmesh *>(pGeom))
     {
         AssertLog(maxdidx == tetmesh->_countDiffBoundaries());
-        uint didx = 0;
-        while(didx < maxdidx)
-        {
-            if (d == tetmesh->_getDiffBoundary(didx)->getID()) return didx;
-            ++didx;
-        }
+        uint didx = _lookupIdx(pDiffBoundaryIdxMap, d, maxdidx,
+            [tetmesh](uint i) { return tetmesh->_getDiffBoundary(i)->getID(); });
+        if (didx < maxdidx) return didx;
         std::ostringstream os;
         os << "Geometry does not contain diff boundary with string identifier '" << d <<"'.";
         ArgErrLog(os.str());
@@ -1045,12 +1056,9 @@ uint ssolver::Statedef::getSDiffBoundaryIdx(std::string const & sd) const
     if (steps::tetmesh::Tetmesh * tetmesh = dynamic_cast<steps::tetmesh::Tetmesh *>(pGeom))
     {
         AssertLog(maxsdidx == tetmesh->_countSDiffBoundaries());
-        uint sdidx = 0;
-        while(sdidx < maxsdidx)
-        {
-            if (sd == tetmesh->_getSDiffBoundary(sdidx)->getID()) return sdidx;
-            ++sdidx;
-        }
+        uint sdidx = _lookupIdx(pSDiffBoundaryIdxMap, sd, maxsdidx,
+            [tetmesh](uint i) { return tetmesh->_getSDiffBoundary(i)->getID(); });
+        if (sdidx < maxsdidx) return sdidx;
         std::ostringstream os;
         os << "Geometry does not contain surface diffusion boundary with string identifier '" << sd <<"'.";
         ArgErrLog(os.str());
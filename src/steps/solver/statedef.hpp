@@ -37,6 +37,7 @@
 
 // STL headers.
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <fstream>
 
@@ -615,6 +616,29 @@ private:
     std::vector<OhmicCurrdef *>         pOhmicCurrdefs;
     std::vector<GHKcurrdef *>           pGHKcurrdefs;
 
+    // Global indices keyed by string identifier, built at construction
+    // so that the get...Idx(std::string) lookups need not scan.
+    typedef std::unordered_map<std::string, uint> IdxMap;
+
+    IdxMap                              pCompIdxMap;
+    IdxMap                              pPatchIdxMap;
+    IdxMap                              pSpecIdxMap;
+    IdxMap                              pReacIdxMap;
+    IdxMap                              pSReacIdxMap;
+    IdxMap                              pDiffIdxMap;
+    IdxMap                              pSurfDiffIdxMap;
+    IdxMap                              pVDepTransIdxMap;
+    IdxMap                              pVDepSReacIdxMap;
+    IdxMap                              pOhmicCurrIdxMap;
+    IdxMap                              pGHKcurrIdxMap;
+    IdxMap                              pDiffBoundaryIdxMap;
+    IdxMap                              pSDiffBoundaryIdxMap;
+
+    // Index of the object with string identifier id among the n objects
+    // whose identifiers getID(idx) returns, or n if there is none.
+    template <typename GetID>
+    static uint _lookupIdx(IdxMap const & map, std::string const & id, uint n, GetID getID);
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
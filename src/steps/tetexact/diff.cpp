@@ -53,7 +53,6 @@ stex::Diff::Diff(ssolver::Diffdef * ddef, stex::Tet * tet)
 : 
  pDiffdef(ddef)
 , pTet(tet)
-, pUpdVec()
 , pScaledDcst(0.0)
 , pDcst(0.0)
 , pCDFSelector()
@@ -61,6 +60,7 @@ stex::Diff::Diff(ssolver::Diffdef * ddef, stex::Tet * tet)
 {
     AssertLog(pDiffdef != 0);
     AssertLog(pTet != 0);
+    type = KP_DIFF;
     stex::Tet * next[4] =
     {
         pTet->nextTet(0),
@@ -165,11 +165,6 @@ void stex::Diff::checkpoint(std::fstream & cp_file)
     cp_file.write((char*)pDiffBndActive, sizeof(bool) * 4);
     cp_file.write((char*)pDiffBndDirection, sizeof(bool) * 4);
     cp_file.write((char*)pNeighbCompLidx, sizeof(int) * 4);
-
-    cp_file.write((char*)&(crData.recorded), sizeof(bool));
-    cp_file.write((char*)&(crData.pow), sizeof(int));
-    cp_file.write((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.write((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -196,11 +191,6 @@ void stex::Diff::restore(std::fstream & cp_file)
     cp_file.read((char*)pDiffBndActive, sizeof(bool) * 4);
     cp_file.read((char*)pDiffBndDirection, sizeof(bool) * 4);
     cp_file.read((char*)pNeighbCompLidx, sizeof(int) * 4);
-
-    cp_file.read((char*)&(crData.recorded), sizeof(bool));
-    cp_file.read((char*)&(crData.pow), sizeof(int));
-    cp_file.read((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.read((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -221,6 +211,9 @@ void stex::Diff::setupDeps()
     // a triangle, there is no need to filter out duplicate dependent
     // kprocs.
 
+    // One update vector per direction, selected by the return of apply().
+    pUpdVecs.assign(4, std::vector<KProc*>());
+
     // Search for dependencies in the 'source' tetrahedron.
     std::set<stex::KProc*> local;
 
@@ -292,7 +285,7 @@ void stex::Diff::setupDeps()
         }
 
         // Copy the set to the update vector.
-        pUpdVec[i].assign(local2.begin(), local2.end());
+        pUpdVecs[i].assign(local2.begin(), local2.end());
     }
 }
 
@@ -332,12 +325,6 @@ void stex::Diff::reset()
     setDcst(dcst);
 
     setActive(true);
-
-    crData.recorded = false;
-    crData.pow = 0;
-    crData.pos = 0;
-    crData.rate = 0.0;
-
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -545,7 +532,7 @@ double stex::Diff::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::Diff::apply(steps::rng::RNG * rng, double dt, double simtime)
+uint stex::Diff::apply(steps::rng::RNG * rng, double dt, double simtime)
 {
     //uint lidxTet = this->lidxTet;
     // Pre-fetch some general info.
@@ -583,20 +570,7 @@ std::vector<stex::KProc*> const & stex::Diff::apply(steps::rng::RNG * rng, doubl
 
     rExtent++;
 
-    return pUpdVec[iSel];
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-uint stex::Diff::updVecSize() const
-{
-    uint maxsize = pUpdVec[0].size();
-    for (uint i=1; i <= 3; ++i)
-    {
-        if (pUpdVec[i].size() > maxsize)
-            maxsize = pUpdVec[i].size();
-    }
-    return maxsize;
+    return iSel;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -94,9 +94,8 @@ public:
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri);
     void reset();
     double rate(steps::tetexact::Tetexact * solver = 0);
-    std::vector<KProc*> const & apply(steps::rng::RNG * rng, double dt, double simtime);
+    uint apply(steps::rng::RNG * rng, double dt, double simtime);
 
-    uint updVecSize() const;
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -119,7 +118,6 @@ private:
     uint                                lidxTet;
     steps::solver::Diffdef            * pDiffdef;
     steps::tetexact::Tet              * pTet;
-    std::vector<KProc*>                 pUpdVec[4];
     std::map<uint, double>              directionalDcsts;
 
     // Storing the species local index for each neighbouring tet: Needed
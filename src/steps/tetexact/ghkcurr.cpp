@@ -57,11 +57,11 @@ stex::GHKcurr::GHKcurr(ssolver::GHKcurrdef * ghkdef, stex::Tri * tri)
 : 
  pGHKcurrdef(ghkdef)
 , pTri(tri)
-, pUpdVec()
 , pEffFlux(true)
 {
     AssertLog(pGHKcurrdef != 0);
     AssertLog(pTri != 0);
+    type = KP_GHK;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -76,11 +76,6 @@ void stex::GHKcurr::checkpoint(std::fstream & cp_file)
     cp_file.write((char*)&rExtent, sizeof(uint));
     cp_file.write((char*)&pFlags, sizeof(uint));
     cp_file.write((char*)&pEffFlux, sizeof(bool));
-
-    cp_file.write((char*)&(crData.recorded), sizeof(bool));
-    cp_file.write((char*)&(crData.pow), sizeof(int));
-    cp_file.write((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.write((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,11 +85,6 @@ void stex::GHKcurr::restore(std::fstream & cp_file)
     cp_file.read((char*)&rExtent, sizeof(uint));
     cp_file.read((char*)&pFlags, sizeof(uint));
     cp_file.read((char*)&pEffFlux, sizeof(bool));
-
-    cp_file.read((char*)&(crData.recorded), sizeof(bool));
-    cp_file.read((char*)&(crData.pow), sizeof(int));
-    cp_file.read((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.read((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -102,10 +92,6 @@ void stex::GHKcurr::restore(std::fstream & cp_file)
 void stex::GHKcurr::reset()
 {
 
-    crData.recorded = false;
-    crData.pow = 0;
-    crData.pos = 0;
-    crData.rate = 0.0;
     setActive(true);
     pEffFlux = true;    //TODO: come back to this and check if rate needs to be recalculated here
 }
@@ -173,7 +159,7 @@ void stex::GHKcurr::setupDeps()
         }
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdVecs.assign(1, std::vector<KProc*>(updset.begin(), updset.end()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -260,7 +246,7 @@ double stex::GHKcurr::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::GHKcurr::apply(steps::rng::RNG * rng, double dt, double simtime)
+uint stex::GHKcurr::apply(steps::rng::RNG * rng, double dt, double simtime)
 {
     stex::WmVol * itet = pTri->iTet();
     stex::WmVol * otet = pTri->oTet();
@@ -315,7 +301,7 @@ std::vector<stex::KProc*> const & stex::GHKcurr::apply(steps::rng::RNG * rng, do
 
     rExtent++;
 
-    return pUpdVec;
+    return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,7 +90,7 @@ public:
     double rate(steps::tetexact::Tetexact * solver);
 
     // double rate(double v, double T);
-    std::vector<KProc*> const & apply(steps::rng::RNG * rng, double dt, double simtime);
+    uint apply(steps::rng::RNG * rng, double dt, double simtime);
 
     inline bool efflux() const
     { return pEffFlux; }
@@ -98,8 +98,6 @@ public:
     void setEffFlux(bool efx)
     { pEffFlux = efx; }
 
-    uint updVecSize() const
-    { return pUpdVec.size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -109,7 +107,6 @@ private:
 
     steps::solver::GHKcurrdef         * pGHKcurrdef;
     steps::tetexact::Tri              * pTri;
-    std::vector<KProc*>                 pUpdVec;
 
     // Flag if flux is outward, positive flux (true) or inward, negative flux (false)
     bool                                pEffFlux;
@@ -45,7 +45,8 @@ stex::KProc::KProc()
 : rExtent(0)
 , pFlags(0)
 , pSchedIDX(0)
- 
+, type(0)
+, pUpdVecs()
 {
 }
 
@@ -41,9 +41,6 @@
 #include "steps/rng/rng.hpp"
 //#include "tetexact.hpp"
 
-// Tetexact CR header
-#include "steps/tetexact/crstruct.hpp"
-
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace steps{
@@ -67,6 +64,8 @@ typedef KProcPVec::const_iterator       KProcPVecCI;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+enum TYPE {KP_REAC, KP_SREAC, KP_DIFF, KP_SDIFF, KP_GHK, KP_VDEPSREAC, KP_VDEPTRANS};
+
 class KProc
 
 {
@@ -112,6 +111,9 @@ public:
     void setSchedIDX(uint idx)
     { pSchedIDX = idx; }
 
+    uint getType() const
+    { return type; }
+
     ////////////////////////////////////////////////////////////////////////
     // VIRTUAL INTERFACE METHODS
     ////////////////////////////////////////////////////////////////////////
@@ -144,14 +146,25 @@ public:
     virtual double h();
 
     /// Apply a single discrete instance of the kinetic process, returning
-    /// a vector of kproc schedule indices that need to be updated as a
-    /// result.
+    /// the index of the update vector (see updVec()) whose kprocs need to
+    /// be updated as a result.
     ///
     // NOTE: Random number generator available to this function for use
     // by Diff
-    virtual std::vector<KProc*> const & apply(steps::rng::RNG * rng, double dt, double simtime) = 0;
+    virtual uint apply(steps::rng::RNG * rng, double dt, double simtime) = 0;
+
+    /// Number of update vectors computed by setupDeps(): one per diffusion
+    /// direction for Diff and SDiff, one for all other kprocs.
+    uint countUpdVecs() const
+    { return pUpdVecs.size(); }
+
+    std::vector<KProc*> const & updVec(uint i) const
+    { return pUpdVecs[i]; }
 
-    virtual uint updVecSize() const = 0;
+    /// Release the update vectors once the solver has copied them into its
+    /// own dependency tables.
+    void clearUpdVecs()
+    { std::vector<std::vector<KProc*> >().swap(pUpdVecs); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -168,11 +181,6 @@ public:
     virtual steps::solver::SReacdef * defsr() const;
     */// compileerror; // check this
 
-    ////////////////////////////////////////////////////////////////////////
-
-    // data for CR SSA
-    CRKProcData                         crData;
-
 protected:
 
     uint                                rExtent;
@@ -183,6 +191,11 @@ protected:
 
     uint                                pSchedIDX;
 
+    uint                                type;
+
+    // Filled by setupDeps(), indexed by the return value of apply().
+    std::vector<std::vector<KProc*> >   pUpdVecs;
+
     ////////////////////////////////////////////////////////////////////////
 };
 
@@ -71,12 +71,12 @@ stex::Reac::Reac(ssolver::Reacdef * rdef, stex::WmVol * tet)
 : 
  pReacdef(rdef)
 , pTet(tet)
-, pUpdVec()
 , pCcst(0.0)
 , pKcst(0.0)
 {
     AssertLog(pReacdef != 0);
     AssertLog(pTet != 0);
+    type = KP_REAC;
 
     uint lridx = pTet->compdef()->reacG2L(pReacdef->gidx());
     double kcst = pTet->compdef()->kcst(lridx);
@@ -99,11 +99,6 @@ void stex::Reac::checkpoint(std::fstream & cp_file)
 
     cp_file.write((char*)&pCcst, sizeof(double));
     cp_file.write((char*)&pKcst, sizeof(double));
-
-    cp_file.write((char*)&(crData.recorded), sizeof(bool));
-    cp_file.write((char*)&(crData.pow), sizeof(int));
-    cp_file.write((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.write((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -115,11 +110,6 @@ void stex::Reac::restore(std::fstream & cp_file)
 
     cp_file.read((char*)&pCcst, sizeof(double));
     cp_file.read((char*)&pKcst, sizeof(double));
-
-    cp_file.read((char*)&(crData.recorded), sizeof(bool));
-    cp_file.read((char*)&(crData.pow), sizeof(int));
-    cp_file.read((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.read((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -127,10 +117,6 @@ void stex::Reac::restore(std::fstream & cp_file)
 void stex::Reac::reset()
 {
 
-    crData.recorded = false;
-    crData.pow = 0;
-    crData.pos = 0;
-    crData.rate = 0.0;
     resetExtent();
     resetCcst();
     setActive(true);
@@ -198,7 +184,7 @@ void stex::Reac::setupDeps()
         }
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdVecs.assign(1, std::vector<KProc*>(updset.begin(), updset.end()));
     //pUpdObjVec.assign(updset_obj.begin(), updset_obj.end());
 }
 
@@ -226,18 +212,14 @@ double stex::Reac::rate(steps::tetexact::Tetexact * solver)
 
     // Prefetch some variables.
     ssolver::Compdef * cdef = pTet->compdef();
-    uint nspecs = cdef->countSpecs();
-    uint * lhs_vec = cdef->reac_lhs_bgn(cdef->reacG2L(pReacdef->gidx()));
     uint * cnt_vec = pTet->pools();
 
     // Compute combinatorial part.
     double h_mu = 1.0;
-    for (uint pool = 0; pool < nspecs; ++pool)
+    for (auto const & sc : cdef->reac_lhs_sparse(cdef->reacG2L(pReacdef->gidx())))
     {
-        uint lhs = lhs_vec[pool];
-        if (lhs == 0) { continue;
-}
-        uint cnt = cnt_vec[pool];
+        uint lhs = sc.coeff;
+        uint cnt = cnt_vec[sc.lidx];
         if (lhs > cnt)
         {
             h_mu = 0.0;
@@ -276,23 +258,21 @@ double stex::Reac::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::Reac::apply(steps::rng::RNG * rng, double dt, double simtime)
+uint stex::Reac::apply(steps::rng::RNG * rng, double dt, double simtime)
 {
     uint * local = pTet->pools();
     ssolver::Compdef * cdef = pTet->compdef();
     uint l_ridx = cdef->reacG2L(pReacdef->gidx());
-    int * upd_vec = cdef->reac_upd_bgn(l_ridx);
-    uint nspecs = cdef->countSpecs();
-    for (uint i = 0; i < nspecs; ++i)
+    for (auto const & sc : cdef->reac_upd_sparse(l_ridx))
     {
+        uint i = sc.lidx;
         if (pTet->clamped(i) == true) continue;
-        int j = upd_vec[i];
-        if (j == 0) continue;
+        int j = sc.coeff;
         int nc = static_cast<int>(local[i]) + j;
         pTet->setCount(i, static_cast<uint>(nc));
     }
     rExtent++;
-    return pUpdVec;
+    return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
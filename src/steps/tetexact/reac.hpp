@@ -103,10 +103,8 @@ public:
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri);
     void reset();
     double rate(steps::tetexact::Tetexact * solver = 0);
-    std::vector<KProc*> const & apply(steps::rng::RNG * rng, double dt, double simtime);
+    uint apply(steps::rng::RNG * rng, double dt, double simtime);
 
-    uint updVecSize() const
-    { return pUpdVec.size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -116,7 +114,6 @@ private:
 
     steps::solver::Reacdef                              * pReacdef;
     steps::tetexact::WmVol                              * pTet;
-    std::vector<KProc*>                                   pUpdVec;
     /// Properly scaled reaction constant.
     double                                                pCcst;
     // Also store the K constant for convenience
@@ -58,7 +58,6 @@ stex::SDiff::SDiff(ssolver::Diffdef * sdef, stex::Tri * tri)
 : 
  pSDiffdef(sdef)
 , pTri(tri)
-, pUpdVec()
 , pScaledDcst(0.0)
 , pDcst(0.0)
 , pCDFSelector()
@@ -67,6 +66,7 @@ stex::SDiff::SDiff(ssolver::Diffdef * sdef, stex::Tri * tri)
 {
     AssertLog(pSDiffdef != 0);
     AssertLog(pTri != 0);
+    type = KP_SDIFF;
     stex::Tri * next[3] =
     {
         pTri->nextTri(0),
@@ -169,11 +169,6 @@ void stex::SDiff::checkpoint(std::fstream & cp_file)
     cp_file.write((char*)pSDiffBndActive, sizeof(bool) * 3);
     cp_file.write((char*)pSDiffBndDirection, sizeof(bool) * 3);
     cp_file.write((char*)pNeighbPatchLidx, sizeof(int) * 3);
-
-    cp_file.write((char*)&(crData.recorded), sizeof(bool));
-    cp_file.write((char*)&(crData.pow), sizeof(int));
-    cp_file.write((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.write((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -199,11 +194,6 @@ void stex::SDiff::restore(std::fstream & cp_file)
     cp_file.read((char*)pSDiffBndActive, sizeof(bool) * 3);
     cp_file.read((char*)pSDiffBndDirection, sizeof(bool) * 3);
     cp_file.read((char*)pNeighbPatchLidx, sizeof(int) * 3);
-
-    cp_file.read((char*)&(crData.recorded), sizeof(bool));
-    cp_file.read((char*)&(crData.pow), sizeof(int));
-    cp_file.read((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.read((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -222,6 +212,9 @@ void stex::SDiff::setupDeps()
     //
 
 
+    // One update vector per direction, selected by the return of apply().
+    pUpdVecs.assign(3, std::vector<KProc*>());
+
     // Search for dependencies in the 'source' triangle.
     std::set<stex::KProc*> local;
 
@@ -289,7 +282,7 @@ void stex::SDiff::setupDeps()
         }
 
         // Copy the set to the update vector.
-        pUpdVec[i].assign(local2.begin(), local2.end());
+        pUpdVecs[i].assign(local2.begin(), local2.end());
     }
 
 }
@@ -328,12 +321,6 @@ void stex::SDiff::reset()
     setDcst(dcst);
 
     setActive(true);
-
-    crData.recorded = false;
-    crData.pow = 0;
-    crData.pos = 0;
-    crData.rate = 0.0;
-
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -528,7 +515,7 @@ double stex::SDiff::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::SDiff::apply(steps::rng::RNG * rng, double dt, double simtime)
+uint stex::SDiff::apply(steps::rng::RNG * rng, double dt, double simtime)
 {
     //uint lidxTet = this->lidxTet;
     // Pre-fetch some general info.
@@ -565,20 +552,7 @@ std::vector<stex::KProc*> const & stex::SDiff::apply(steps::rng::RNG * rng, doub
 
     rExtent++;
 
-    return pUpdVec[iSel];
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-uint stex::SDiff::updVecSize() const
-{
-    uint maxsize = pUpdVec[0].size();
-    for (uint i=1; i <= 2; ++i)
-    {
-        if (pUpdVec[i].size() > maxsize)
-            maxsize = pUpdVec[i].size();
-    }
-    return maxsize;
+    return iSel;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
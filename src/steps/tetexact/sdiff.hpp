@@ -95,9 +95,8 @@ public:
     void reset();
     double rate(steps::tetexact::Tetexact * solver = 0);
 
-    std::vector<KProc*> const & apply(steps::rng::RNG * rng, double dt, double simtime);
+    uint apply(steps::rng::RNG * rng, double dt, double simtime);
 
-    uint updVecSize() const;
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -115,7 +114,6 @@ private:
     uint                                lidxTri;
     steps::solver::Diffdef              * pSDiffdef;
     steps::tetexact::Tri                * pTri;
-    std::vector<KProc*>                 pUpdVec[3];
 
     // Storing the species local index for each neighbouring tri: Needed
     // because neighbours may belong to different patches if we ever
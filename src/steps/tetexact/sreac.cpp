@@ -88,12 +88,12 @@ stex::SReac::SReac(ssolver::SReacdef * srdef, stex::Tri * tri)
 : 
  pSReacdef(srdef)
 , pTri(tri)
-, pUpdVec()
 , pCcst(0.0)
 , pKcst(0.0)
 {
     AssertLog(pSReacdef != 0);
     AssertLog(pTri != 0);
+    type = KP_SREAC;
 
     uint lsridx = pTri->patchdef()->sreacG2L(pSReacdef->gidx());
     double kcst = pTri->patchdef()->kcst(lsridx);
@@ -139,12 +139,6 @@ void stex::SReac::checkpoint(std::fstream & cp_file)
 
     cp_file.write((char*)&pCcst, sizeof(double));
     cp_file.write((char*)&pKcst, sizeof(double));
-
-    cp_file.write((char*)&(crData.recorded), sizeof(bool));
-    cp_file.write((char*)&(crData.pow), sizeof(int));
-    cp_file.write((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.write((char*)&(crData.rate), sizeof(double));
-
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -156,11 +150,6 @@ void stex::SReac::restore(std::fstream & cp_file)
 
     cp_file.read((char*)&pCcst, sizeof(double));
     cp_file.read((char*)&pKcst, sizeof(double));
-
-    cp_file.read((char*)&(crData.recorded), sizeof(bool));
-    cp_file.read((char*)&(crData.pow), sizeof(int));
-    cp_file.read((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.read((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -168,10 +157,6 @@ void stex::SReac::restore(std::fstream & cp_file)
 void stex::SReac::reset()
 {
 
-    crData.recorded = false;
-    crData.pow = 0;
-    crData.pos = 0;
-    crData.rate = 0.0;
     resetExtent();
     resetCcst();
     setActive(true);
@@ -361,7 +346,7 @@ void stex::SReac::setupDeps()
         }
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdVecs.assign(1, std::vector<KProc*>(updset.begin(), updset.end()));
     //pUpdObjVec.assign(updset_obj.begin(), updset_obj.end());
 }
 
@@ -413,15 +398,11 @@ double stex::SReac::rate(steps::tetexact::Tetexact * solver)
 
         double h_mu = 1.0;
 
-        uint * lhs_s_vec = pdef->sreac_lhs_S_bgn(lidx);
         uint * cnt_s_vec = pTri->pools();
-        uint nspecs_s = pdef->countSpecs();
-        for (uint s = 0; s < nspecs_s; ++s)
+        for (auto const & sc : pdef->sreac_lhs_S_sparse(lidx))
         {
-            uint lhs = lhs_s_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_s_vec[s];
+            uint lhs = sc.coeff;
+            uint cnt = cnt_s_vec[sc.lidx];
             if (lhs > cnt)
             {
                 return 0.0;
@@ -455,15 +436,11 @@ double stex::SReac::rate(steps::tetexact::Tetexact * solver)
 
         if (pSReacdef->inside())
         {
-            uint * lhs_i_vec = pdef->sreac_lhs_I_bgn(lidx);
             uint * cnt_i_vec = pTri->iTet()->pools();
-            uint nspecs_i = pdef->countSpecs_I();
-            for (uint s = 0; s < nspecs_i; ++s)
+            for (auto const & sc : pdef->sreac_lhs_I_sparse(lidx))
             {
-                uint lhs = lhs_i_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_i_vec[s];
+                uint lhs = sc.coeff;
+                uint cnt = cnt_i_vec[sc.lidx];
                 if (lhs > cnt)
                 {
                     return 0.0;
@@ -497,15 +474,11 @@ double stex::SReac::rate(steps::tetexact::Tetexact * solver)
         }
         else if (pSReacdef->outside())
         {
-            uint * lhs_o_vec = pdef->sreac_lhs_O_bgn(lidx);
             uint * cnt_o_vec = pTri->oTet()->pools();
-            uint nspecs_o = pdef->countSpecs_O();
-            for (uint s = 0; s < nspecs_o; ++s)
+            for (auto const & sc : pdef->sreac_lhs_O_sparse(lidx))
             {
-                uint lhs = lhs_o_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_o_vec[s];
+                uint lhs = sc.coeff;
+                uint cnt = cnt_o_vec[sc.lidx];
                 if (lhs > cnt)
                 {
                     return 0.0;
@@ -543,7 +516,7 @@ double stex::SReac::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::SReac::apply(steps::rng::RNG * rng, double dt, double simtime)
+uint stex::SReac::apply(steps::rng::RNG * rng, double dt, double simtime)
 {
     ssolver::Patchdef * pdef = pTri->patchdef();
     uint lidx = pdef->sreacG2L(pSReacdef->gidx());
@@ -570,12 +543,11 @@ std::vector<stex::KProc*> const & stex::SReac::apply(steps::rng::RNG * rng, doub
         pTri->setOCchange(oc, cs_lidx, dt, simtime);
     }
 
-    uint nspecs_s = pdef->countSpecs();
-    for (uint s = 0; s < nspecs_s; ++s)
+    for (auto const & sc : pdef->sreac_upd_S_sparse(lidx))
     {
+        uint s = sc.lidx;
         if (pTri->clamped(s) == true) continue;
-        int upd = upd_s_vec[s];
-        if (upd == 0) continue;
+        int upd = sc.coeff;
         int nc = static_cast<int>(cnt_s_vec[s]) + upd;
         AssertLog(nc >= 0);
         pTri->setCount(s, static_cast<uint>(nc));
@@ -585,14 +557,12 @@ std::vector<stex::KProc*> const & stex::SReac::apply(steps::rng::RNG * rng, doub
     stex::WmVol * itet = pTri->iTet();
     if (itet != 0)
     {
-        int * upd_i_vec = pdef->sreac_upd_I_bgn(lidx);
         uint * cnt_i_vec = itet->pools();
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
+        for (auto const & sc : pdef->sreac_upd_I_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (itet->clamped(s) == true) continue;
-            int upd = upd_i_vec[s];
-            if (upd == 0) continue;
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_i_vec[s]) + upd;
             AssertLog(nc >= 0);
             itet->setCount(s, static_cast<uint>(nc));
@@ -603,14 +573,12 @@ std::vector<stex::KProc*> const & stex::SReac::apply(steps::rng::RNG * rng, doub
     stex::WmVol * otet = pTri->oTet();
     if (otet != 0)
     {
-        int * upd_o_vec = pdef->sreac_upd_O_bgn(lidx);
         uint * cnt_o_vec = otet->pools();
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
+        for (auto const & sc : pdef->sreac_upd_O_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (otet->clamped(s) == true) continue;
-            int upd = upd_o_vec[s];
-            if (upd == 0) continue;
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_o_vec[s]) + upd;
             AssertLog(nc >= 0);
             otet->setCount(s, static_cast<uint>(nc));
@@ -619,7 +587,7 @@ std::vector<stex::KProc*> const & stex::SReac::apply(steps::rng::RNG * rng, doub
 
     rExtent++;
 
-    return pUpdVec;
+    return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -104,10 +104,8 @@ public:
     bool depSpecTri(uint gidx, steps::tetexact::Tri * tri);
     void reset();
     double rate(steps::tetexact::Tetexact * solver = 0);
-    std::vector<KProc*> const & apply(steps::rng::RNG * rng, double dt, double simtime);
+    uint apply(steps::rng::RNG * rng, double dt, double simtime);
 
-    uint updVecSize() const
-    { return pUpdVec.size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -122,7 +120,6 @@ private:
 
     steps::solver::SReacdef           * pSReacdef;
     steps::tetexact::Tri              * pTri;
-    std::vector<KProc*>                 pUpdVec;
     /// Properly scaled reaction constant.
     double                              pCcst;
     // Store the kcst for convenience
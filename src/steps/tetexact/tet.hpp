@@ -34,6 +34,7 @@
 
 // STEPS headers.
 #include "steps/common.h"
+#include "steps/error.hpp"
 #include "steps/solver/compdef.hpp"
 #include "steps/tetexact/kproc.hpp"
 #include "steps/tetexact/wmvol.hpp"
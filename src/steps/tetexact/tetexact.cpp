@@ -78,6 +78,7 @@
 #include "steps/util/distribute.hpp"
 
 #include "steps/solver/efield/dVsolver.hpp"
+#include "steps/solver/efield/dVsolver_cg.hpp"
 #include "steps/solver/efield/efield.hpp"
 
 // logging
@@ -115,6 +116,7 @@ stex::Tetexact::Tetexact(steps::model::Model * m, steps::wm::Geom * g, steps::rn
 , pTris()
 , pWmVols()
 , pA0(0.0)
+, pUpdStamp(1)
 //, pBuilt(false)
 , pEFoption(static_cast<EF_solver>(calcMembPot))
 , pTemp(0.0)
@@ -153,14 +155,6 @@ stex::Tetexact::~Tetexact()
     for (auto wvol: pWmVols) delete wvol;
     for (auto t: pTets) delete t;
     for (auto t: pTris) delete t;
-    for (auto g: nGroups) {
-        g->free_indices();
-        delete g;
-    }
-    for (auto g: pGroups) {
-        g->free_indices();
-        delete g;
-    }
 
     if (efflag())
     {
@@ -239,41 +233,7 @@ void stex::Tetexact::checkpoint(std::string const & file_name)
 
     // checkpoint CR SSA
 
-    cp_file.write((char*)&pSum, sizeof(double));
-    cp_file.write((char*)&nSum, sizeof(double));
-    cp_file.write((char*)&pA0, sizeof(double));
-
-    uint n_ngroups = nGroups.size();
-    uint n_pgroups = pGroups.size();
-
-    cp_file.write((char*)&n_ngroups, sizeof(uint));
-    cp_file.write((char*)&n_pgroups, sizeof(uint));
-
-    for (uint i = 0; i < n_ngroups; i++) {
-        CRGroup* group = nGroups[i];
-        cp_file.write((char*)&(group->capacity), sizeof(unsigned));
-        cp_file.write((char*)&(group->size), sizeof(unsigned));
-        cp_file.write((char*)&(group->max), sizeof(double));
-        cp_file.write((char*)&(group->sum), sizeof(double));
-
-        for (uint j = 0; j < group->size; j++) {
-            uint idx = group->indices[j]->schedIDX();
-            cp_file.write((char*)&idx, sizeof(uint));
-        }
-    }
-
-    for (uint i = 0; i < n_pgroups; i++) {
-        CRGroup* group = pGroups[i];
-        cp_file.write((char*)&(group->capacity), sizeof(unsigned));
-        cp_file.write((char*)&(group->size), sizeof(unsigned));
-        cp_file.write((char*)&(group->max), sizeof(double));
-        cp_file.write((char*)&(group->sum), sizeof(double));
-
-        for (uint j = 0; j < group->size; j++) {
-            uint idx = group->indices[j]->schedIDX();
-            cp_file.write((char*)&idx, sizeof(uint));
-        }
-    }
+    pCRSched.checkpoint(cp_file, [](uint idx) { return idx; });
 
     cp_file.close();
     CLOG(INFO, "general_log") << "complete.\n";
@@ -352,64 +312,8 @@ void stex::Tetexact::restore(std::string const & file_name)
     }
 
     // restore CR SSA
-    cp_file.read((char*)&pSum, sizeof(double));
-    cp_file.read((char*)&nSum, sizeof(double));
-    cp_file.read((char*)&pA0, sizeof(double));
-
-    uint n_ngroups;
-    uint n_pgroups;
-
-    cp_file.read((char*)&n_ngroups, sizeof(uint));
-    cp_file.read((char*)&n_pgroups, sizeof(uint));
-
-    nGroups.resize(n_ngroups);
-    pGroups.resize(n_pgroups);
-
-    for (uint i = 0; i < n_ngroups; i++) {
-        unsigned capacity;
-        unsigned size;
-        double max;
-        double sum;
-
-        cp_file.read((char*)&capacity, sizeof(unsigned));
-        cp_file.read((char*)&size, sizeof(unsigned));
-        cp_file.read((char*)&max, sizeof(double));
-        cp_file.read((char*)&sum, sizeof(double));
-
-        nGroups[i] = new CRGroup(0, capacity);
-        nGroups[i]->size = size;
-        nGroups[i]->max = max;
-        nGroups[i]->sum = sum;
-
-        for (uint j = 0; j < size; j++) {
-            uint idx;
-            cp_file.read((char*)&idx, sizeof(uint));
-            nGroups[i]->indices[j] = pKProcs[idx];
-        }
-    }
-
-    for (uint i = 0; i < n_pgroups; i++) {
-        unsigned capacity;
-        unsigned size;
-        double max;
-        double sum;
-
-        cp_file.read((char*)&capacity, sizeof(unsigned));
-        cp_file.read((char*)&size, sizeof(unsigned));
-        cp_file.read((char*)&max, sizeof(double));
-        cp_file.read((char*)&sum, sizeof(double));
-
-        pGroups[i] = new CRGroup(0, capacity);
-        pGroups[i]->size = size;
-        pGroups[i]->max = max;
-        pGroups[i]->sum = sum;
-
-        for (uint j = 0; j < size; j++) {
-            uint idx;
-            cp_file.read((char*)&idx, sizeof(uint));
-            pGroups[i]->indices[j] = pKProcs[idx];
-        }
-    }
+    pCRSched.restore(cp_file, [](uint idx) { return idx; });
+    _updateSum();
 
     cp_file.close();
 
@@ -1008,6 +912,17 @@ void stex::Tetexact::_setup()
         for (auto k: t->kprocs()) k->setupDeps();
     }
 
+    _setupDepCSR();
+
+    for (auto t: pTets)
+        if (t) t->setupSpecDeps();
+
+    for (auto wmv: pWmVols)
+        if (wmv) wmv->setupSpecDeps();
+
+    for (auto t: pTris)
+        if (t) t->setupSpecDeps();
+
     // Create EField structures if EField is to be calculated
     if (efflag() == true) _setupEField();
 
@@ -1036,6 +951,9 @@ void stex::Tetexact::_setupEField()
     case EF_DV_BDSYS:
         pEField = make_EField<dVSolverBanded>();
         break;
+    case EF_DV_CG:
+        pEField = make_EField<dVSolverCG>();
+        break;
     default:
         ArgErrLog("Unsupported E-Field solver.");
     }
@@ -1395,22 +1313,7 @@ void stex::Tetexact::reset()
         (*t)->reset();
     }
 
-    uint ngroups = nGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(nGroups[i]->indices);
-        delete nGroups[i];
-    }
-    nGroups.clear();
-
-    ngroups = pGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(pGroups[i]->indices);
-        delete pGroups[i];
-    }
-    pGroups.clear();
-
-    pSum = 0.0;
-    nSum = 0.0;
+    pCRSched.reset();
     pA0 = 0.0;
 
     _update();
@@ -1513,8 +1416,8 @@ void stex::Tetexact::run(double endtime)
 
             pEField->advance(ef_dt);
 
-            // TODO: Replace this with something that only resets voltage-dependent things
-            _update();
+            // Only voltage-dependent propensities can have changed
+            _updateVDep();
         }
     }
 
@@ -1633,7 +1536,8 @@ void stex::Tetexact::_setCompCount(uint cidx, uint sidx, double n)
     steps::util::distribute_quantity(n, comp->bgnTet(), comp->endTet(),
         weight, set_count, inc_count, *rng(), comp->def()->vol());
 
-    for (auto &tet: comp->tets()) _updateSpec(tet, slidx);
+    for (auto &tet: comp->tets()) _queueSpecUpdate(tet, slidx);
+    _flushSpecUpdates();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1865,7 +1769,8 @@ void stex::Tetexact::_setPatchCount(uint pidx, uint sidx, double n)
     steps::util::distribute_quantity(n, patch->bgnTri(), patch->endTri(),
         weight, set_count, inc_count, *rng(), patch->def()->area());
 
-    for (auto &tri: patch->tris()) _updateSpec(tri, slidx);
+    for (auto &tri: patch->tris()) _queueSpecUpdate(tri, slidx);
+    _flushSpecUpdates();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2299,6 +2204,18 @@ void stex::Tetexact::addKProc(steps::tetexact::KProc * kp)
     SchedIDX nidx = pKProcs.size();
     pKProcs.push_back(kp);
     kp->setSchedIDX(nidx);
+
+    pCRSched.store().add();
+    pKProcType.push_back(kp->getType());
+    pKProcUpdStamp.push_back(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void stex::Tetexact::addVDepKProc(steps::tetexact::KProc * kp)
+{
+    AssertLog(kp != 0);
+    pVDepKProcs.push_back(kp);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2314,134 +2231,11 @@ void stex::Tetexact::_build()
 
 steps::tetexact::KProc * stex::Tetexact::_getNext() const
 {
-
     AssertLog(pA0 >= 0.0);
     // Quick check to see whether nothing is there.
     if (pA0 == 0.0) return NULL;
 
-    double selector = pA0 * rng()->getUnfII();
-
-    double partial_sum = 0.0;
-
-    uint n_neg_groups = nGroups.size();
-    uint n_pos_groups = pGroups.size();
-
-    for (uint i = 0; i < n_neg_groups; i++) {
-        CRGroup* group = nGroups[i];
-        if (group->size == 0) continue;
-
-        if (selector > partial_sum + group->sum) {
-            partial_sum += group->sum;
-
-            continue;
-        }
-
-        double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
-        uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
-        KProc* random_kp = group->indices[random_pos];
-
-        while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
-            random_kp = group->indices[random_pos];
-        }
-
-        return random_kp;
-    }
-
-
-    for (uint i = 0; i < n_pos_groups; i++) {
-        CRGroup* group = pGroups[i];
-        if (group->size == 0) continue;
-
-        if (selector > partial_sum + group->sum) {
-            partial_sum += group->sum;
-            continue;
-        }
-
-        double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
-        uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
-        KProc* random_kp = group->indices[random_pos];
-
-
-        while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
-            random_kp = group->indices[random_pos];
-        }
-
-        return random_kp;
-    }
-
-    // Precision rounding error force clean up
-    // Force the search in the last non-empty group
-    for (int i = n_pos_groups - 1; i >= 0; i--) {
-        CRGroup* group = pGroups[i];
-        if (group->size == 0) continue;
-
-        double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
-        uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
-        KProc* random_kp = group->indices[random_pos];
-
-
-        while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
-            random_kp = group->indices[random_pos];
-
-        }
-
-        return random_kp;
-    }
-
-    for (int i = n_neg_groups - 1; i >= 0; i--) {
-        CRGroup* group = nGroups[i];
-        if (group->size == 0) continue;
-
-        double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
-        uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
-        KProc* random_kp = group->indices[random_pos];
-
-
-
-        while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
-            random_kp = group->indices[random_pos];
-
-        }
-
-        return random_kp;
-    }
-
-    // Precision rounding error force clean up - Complete
-
-    std::ostringstream os;
-    os << "Cannot find any suitable entry.\n";
-    os << "A0: " << std::setprecision (15) << pA0 << "\n";
-    os << "Selector: " << std::setprecision (15) << selector << "\n";
-    os << "Current Partial Sum: " << std::setprecision (15) << partial_sum << "\n";
-
-    os << "Distribution of group sums\n";
-    os << "Negative groups\n";
-
-    for (uint i = 0; i < n_neg_groups; i++) {
-        os << i << ": " << std::setprecision (15) << nGroups[i]->sum << "\n";
-    }
-    os << "Positive groups\n";
-    for (uint i = 0; i < n_pos_groups; i++) {
-        os << i << ": " << std::setprecision (15) << pGroups[i]->sum << "\n";
-    }
-
-    ProgErrLog(os.str());
+    return pKProcs[pCRSched.select(rng())];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2455,8 +2249,8 @@ void stex::Tetexact::_reset()
 
 void stex::Tetexact::_executeStep(steps::tetexact::KProc * kp, double dt)
 {
-    std::vector<KProc*> const & upd = kp->apply(rng(), dt, statedef()->time());
-    _update(upd.begin(), upd.end());
+    uint row = kp->apply(rng(), dt, statedef()->time());
+    _updateDepRow(pDepRow[kp->schedIDX()] + row);
     statedef()->incTime(dt);
     statedef()->incNSteps(1);
 }
@@ -2465,25 +2259,29 @@ void stex::Tetexact::_executeStep(steps::tetexact::KProc * kp, double dt)
 
 void stex::Tetexact::_updateSpec(steps::tetexact::WmVol * tet, uint spec_lidx)
 {
-    std::set<KProc*> updset;
-
-    // Loop over tet.
-    for (auto &kproc: tet->kprocs()) updset.insert(kproc);
+    _update(tet->specDepBegin(spec_lidx), tet->specDepEnd(spec_lidx));
+}
 
-    for (auto &tri: tet->nexttris()) {
-        if (!tri) continue;
-        for (auto &kproc: tri->kprocs()) updset.insert(kproc);
-    }
+////////////////////////////////////////////////////////////////////////////////
 
-    // Send the list of kprocs that need to be updated to the schedule.
-    _update(updset.begin(), updset.end());
+void stex::Tetexact::_updateSpec(steps::tetexact::Tri * tri, uint spec_lidx)
+{
+    _update(tri->specDepBegin(spec_lidx), tri->specDepEnd(spec_lidx));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Tetexact::_updateSpec(steps::tetexact::Tri * tri, uint spec_lidx)
+void stex::Tetexact::_flushSpecUpdates()
 {
-    _update(tri->kprocBegin(), tri->kprocEnd());
+    for (auto idx: pUpdQueue) _updateElement(idx);
+    _updateSum();
+
+    pUpdQueue.clear();
+    // Start a new generation; on wrap-around clear all stamps.
+    if (++pUpdStamp == 0) {
+        std::fill(pKProcUpdStamp.begin(), pKProcUpdStamp.end(), 0);
+        pUpdStamp = 1;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4234,139 +4032,56 @@ void stex::Tetexact::_setMembVolRes(uint midx, double ro)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Tetexact::_updateElement(KProc* kp)
+void stex::Tetexact::_updateElement(uint idx)
 {
+    pCRSched.update(idx, _kprocRate(idx));
+}
 
-    double new_rate = kp->rate(this);
-
-    CRKProcData & data = kp->crData;
-    double old_rate = data.rate;
-
-    data.rate = new_rate;
-
-    if (old_rate == new_rate)  return;
-
-
-    // new rate in positive groups
-    if (new_rate >= 0.5) {
-
-        // pow is the same
-        int old_pow = data.pow;
-        int new_pow;
-        double temp = frexp(new_rate, &new_pow);
-
-        if (old_pow == new_pow && data.recorded) {
-
-            CRGroup* old_group = _getGroup(old_pow);
-
-            old_group->sum += (new_rate - old_rate);
-        }
-        // pow is not the same
-        else {
-            data.pow = new_pow;
-
-
-            if (data.recorded) {
-
-                // remove old
-                CRGroup* old_group = _getGroup(old_pow);
-                (old_group->size) --;
-
-                if (old_group->size == 0) old_group->sum = 0.0;
-                else {
-                    old_group->sum -= old_rate;
-
-                    KProc* last = old_group->indices[old_group->size];
-                    old_group->indices[data.pos] = last;
-                    last->crData.pos = data.pos;
-                }
-            }
-
-            // add new
-            if (pGroups.size() <= new_pow) _extendPGroups(new_pow + 1);
-
-            CRGroup* new_group = pGroups[new_pow];
-
-            AssertLog(new_group != NULL);
-            if (new_group->size == new_group->capacity) _extendGroup(new_group);
-            uint pos = new_group->size;
-            new_group->indices[pos] = kp;
-            new_group->size++;
-            new_group->sum += new_rate;
-            data.pos = pos;
-
-        }
-        data.recorded = true;
-
-    }
-    // new rate in negative group
-    else if (new_rate < 0.5 && new_rate > 1e-20) {
-        int old_pow = data.pow;
-        int new_pow;
-        double temp = frexp(new_rate, &new_pow);
-
-        if (old_pow == new_pow && data.recorded) {
-
-            CRGroup* old_group = _getGroup(old_pow);
-
-            old_group->sum += (new_rate - old_rate);
-        }
-        // pow is not the same
-        else {
-            data.pow = new_pow;
-
-            if (data.recorded) {
-                CRGroup* old_group = _getGroup(old_pow);
-                (old_group->size) --;
-
-                if (old_group->size == 0) old_group->sum = 0.0;
-                else {
-                    old_group->sum -= old_rate;
-
-                    KProc* last = old_group->indices[old_group->size];
-                    old_group->indices[data.pos] = last;
-                    last->crData.pos = data.pos;
-                }
-            }
-
-            // add new
-
-            if (nGroups.size() <= -new_pow) _extendNGroups(-new_pow + 1);
-
-            CRGroup* new_group = nGroups[-new_pow];
-
-            if (new_group->size == new_group->capacity) _extendGroup(new_group);
-            uint pos = new_group->size;
-            new_group->indices[pos] = kp;
-            new_group->size++;
-            new_group->sum += new_rate;
-            data.pos = pos;
+////////////////////////////////////////////////////////////////////////////////
 
-        }
-        data.recorded = true;
+double stex::Tetexact::_kprocRate(uint idx)
+{
+    // Qualified calls let the compiler bind (and inline) the concrete
+    // rate() without going through the vtable.
+    KProc * kp = pKProcs[idx];
+    switch (pKProcType[idx]) {
+        case KP_REAC:
+            return static_cast<Reac*>(kp)->Reac::rate(this);
+        case KP_DIFF:
+            return static_cast<Diff*>(kp)->Diff::rate(this);
+        case KP_SREAC:
+            return static_cast<SReac*>(kp)->SReac::rate(this);
+        case KP_SDIFF:
+            return static_cast<SDiff*>(kp)->SDiff::rate(this);
+        case KP_VDEPSREAC:
+            return static_cast<VDepSReac*>(kp)->VDepSReac::rate(this);
+        case KP_VDEPTRANS:
+            return static_cast<VDepTrans*>(kp)->VDepTrans::rate(this);
+        case KP_GHK:
+            return static_cast<GHKcurr*>(kp)->GHKcurr::rate(this);
+        default:
+            return kp->rate(this);
     }
+}
 
-    else {
-
-        if (data.recorded) {
-
-            CRGroup* old_group = _getGroup(data.pow);
-
-            // remove old
-            old_group->size --;
+////////////////////////////////////////////////////////////////////////////////
 
-            if (old_group->size == 0) old_group->sum = 0.0;
-            else {
-                old_group->sum -= old_rate;
+void stex::Tetexact::_setupDepCSR()
+{
+    pDepRow.assign(1, 0);
+    pDepOffset.assign(1, 0);
+    pDepIdx.clear();
 
-                KProc* last = old_group->indices[old_group->size];
-                old_group->indices[data.pos] = last;
-                last->crData.pos = data.pos;
-            }
+    for (auto kp: pKProcs) {
+        uint nvecs = kp->countUpdVecs();
+        for (uint r = 0; r < nvecs; ++r) {
+            for (auto dep: kp->updVec(r)) pDepIdx.push_back(dep->schedIDX());
+            pDepOffset.push_back(pDepIdx.size());
         }
-        data.recorded = false;
+        pDepRow.push_back(pDepOffset.size() - 1);
+        // The kproc's own copy is no longer needed.
+        kp->clearUpdVecs();
     }
-
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4840,7 +4555,8 @@ void stex::Tetexact::setROICount(std::string ROI_id, std::string const & s, doub
                 *rng(),
                 total_weight);
 
-            for (auto &tri: apply) _updateSpec(tri, tri->patchdef()->specG2L(sgidx));
+            for (auto &tri: apply) _queueSpecUpdate(tri, tri->patchdef()->specG2L(sgidx));
+            _flushSpecUpdates();
         }
         break;
 
@@ -4867,7 +4583,8 @@ void stex::Tetexact::setROICount(std::string ROI_id, std::string const & s, doub
                 *rng(),
                 total_weight);
 
-            for (auto &tet: apply) _updateSpec(tet, tet->compdef()->specG2L(sgidx));
+            for (auto &tet: apply) _queueSpecUpdate(tet, tet->compdef()->specG2L(sgidx));
+            _flushSpecUpdates();
         }
         break;
 
@@ -4931,7 +4648,8 @@ void stex::Tetexact::setROIConc(std::string ROI_id, std::string const & s, doubl
         *rng(),
         total_weight);
 
-    for (auto &tet: apply) _updateSpec(tet, tet->compdef()->specG2L(sgidx));
+    for (auto &tet: apply) _queueSpecUpdate(tet, tet->compdef()->specG2L(sgidx));
+    _flushSpecUpdates();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -49,7 +49,7 @@
 #include "steps/tetexact/patch.hpp"
 #include "steps/tetexact/diffboundary.hpp"
 #include "steps/tetexact/sdiffboundary.hpp"
-#include "steps/tetexact/crstruct.hpp"
+#include "steps/solver/crscheduler.hpp"
 #include "steps/solver/efield/efield.hpp"
 
 // logging
@@ -433,6 +433,11 @@ public:
     // Called from local Comp or Patch objects. Add KProc to this object
     void addKProc(steps::tetexact::KProc * kp);
 
+    // Called from local Tri objects. Register a KProc whose propensity
+    // depends on the membrane potential (VDepTrans, VDepSReac, GHKcurr),
+    // so that only these are refreshed after each EField step.
+    void addVDepKProc(steps::tetexact::KProc * kp);
+
     inline uint countKProcs() const
     { return pKProcs.size(); }
 
@@ -536,24 +541,38 @@ public:
 
     void _executeStep(steps::tetexact::KProc * kp, double dt);
 
-    // TODO: Change the following so that only the kprocs depending on
-    // the species are updated. These functions are called from interface
-    // methods setting compartment or patch counts.
-    /// Update the kproc's of a tet, after a species has been changed.
-    /// This also updates kproc's in surrounding triangles.
-    ///
-    /// Currently doesn't care about the species.
+    // These functions are called from interface methods setting
+    // compartment or patch counts.
+    /// Update the kproc's of a tet that depend on species spec_lidx, after
+    /// its count has been changed. This includes kproc's in surrounding
+    /// triangles.
     ///
     void _updateSpec(steps::tetexact::WmVol * tet, uint spec_lidx);
 
-    /// Update the kproc's of a triangle, after a species has been changed.
-    /// This does not need to update the kproc's of any neighbouring
-    /// tetrahedrons.
-    ///
-    /// Currently doesn't care about the species.
+    /// Update the kproc's of a triangle that depend on species spec_lidx,
+    /// after its count has been changed. This does not need to update the
+    /// kproc's of any neighbouring tetrahedrons.
     ///
     void _updateSpec(steps::tetexact::Tri * tri, uint spec_lidx);
 
+    /// Queue the kproc's of an element (tet or triangle) that depend on
+    /// species spec_lidx for a later _flushSpecUpdates(). A kproc shared
+    /// by several queued elements is only queued once.
+    ///
+    template <typename ElemP>
+    inline void _queueSpecUpdate(ElemP elem, uint spec_lidx) {
+        uint const * e = elem->specDepEnd(spec_lidx);
+        for (uint const * k = elem->specDepBegin(spec_lidx); k != e; ++k) {
+            if (pKProcUpdStamp[*k] == pUpdStamp) continue;
+            pKProcUpdStamp[*k] = pUpdStamp;
+            pUpdQueue.push_back(*k);
+        }
+    }
+
+    /// Update all queued kproc's and the total propensity.
+    ///
+    void _flushSpecUpdates();
+
 
     ////////////////////////// ADDED FOR EFIELD ////////////////////////////
 
@@ -606,14 +625,32 @@ private:
     // CR SSA Kernel Data and Methods
     ////////////////////////////////////////////////////////////////////////
     uint                                        nEntries;
-    double                                      pSum;
-    double                                      nSum;
     double                                      pA0;
 
     std::vector<KProc*>                         pKProcs;
 
-    std::vector<CRGroup*>                       nGroups;
-    std::vector<CRGroup*>                       pGroups;
+    // Subset of pKProcs whose rate depends on the membrane potential
+    std::vector<KProc*>                         pVDepKProcs;
+
+    // Type tag of each kproc, indexed by schedule index.
+    std::vector<uint>                           pKProcType;
+
+    // Dependency lists of all kprocs in compressed sparse row form.
+    // Kproc i owns rows pDepRow[i] .. pDepRow[i+1]-1, one row per update
+    // vector; row r spans pDepIdx[pDepOffset[r]] .. pDepIdx[pDepOffset[r+1]-1].
+    std::vector<uint>                           pDepRow;
+    std::vector<uint>                           pDepOffset;
+    std::vector<uint>                           pDepIdx;
+
+    // Pending updates from bulk count setters. A kproc is in pUpdQueue
+    // iff its pKProcUpdStamp equals the current generation pUpdStamp.
+    std::vector<uint>                           pKProcUpdStamp;
+    uint                                        pUpdStamp;
+    std::vector<uint>                           pUpdQueue;
+
+    // CR scheduler over schedule indices; it keeps the rate, group and
+    // position of each kproc in parallel arrays.
+    steps::solver::CRScheduler<steps::solver::CRIndexStore> pCRSched;
 
     ////////////////////////////////////////////////////////////////////////////////
 
@@ -625,115 +662,43 @@ private:
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline void _update() {
-        _update(pKProcs.begin(), pKProcs.end());
+    /// Update the kprocs in dependency row \a row of the CSR table.
+    inline void _updateDepRow(uint row) {
+        uint const * b = pDepIdx.data() + pDepOffset[row];
+        uint const * e = pDepIdx.data() + pDepOffset[row + 1];
+        while (b != e) _updateElement(*b++);
+        _updateSum();
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline CRGroup* _getGroup(int pow) {
-        #ifdef SSA_DEBUG
-        CLOG(INFO, "general_log") << "SSA: get group with power " << pow << "\n";
-        #endif
-
-        if (pow >= 0) {
-            #ifdef SSA_DEBUG
-            CLOG(INFO, "general_log") << "positive group" << pow << "\n";
-            #endif
-            return pGroups[pow];
-        }
-        else {
-            #ifdef SSA_DEBUG
-            CLOG(INFO, "general_log") << "negative group" << -pow << "\n";
-            #endif
-            return nGroups[-pow];
-        }
-        #ifdef SSA_DEBUG
-        CLOG(INFO, "general_log") << "--------------------------------------------------------\n";
-        #endif
+    inline void _update() {
+        _update(pKProcs.begin(), pKProcs.end());
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline void _extendPGroups(uint new_size) {
-        uint curr_size = pGroups.size();
-
-        #ifdef SSA_DEBUG
-        CLOG(INFO, "general_log") << "SSA: extending positive group size to " << new_size;
-        CLOG(INFO, "general_log") << " from " << curr_size << ".\n";
-        CLOG(INFO, "general_log") << "--------------------------------------------------------\n";
-        #endif
-
-        while (curr_size < new_size) {
-            pGroups.push_back(new CRGroup(curr_size));
-            curr_size ++;
-        }
+    /// Update only the voltage-dependent kprocs, e.g. after an EField step.
+    inline void _updateVDep() {
+        _update(pVDepKProcs.begin(), pVDepKProcs.end());
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline void _extendNGroups(uint new_size) {
-
-        uint curr_size = nGroups.size();
-
-        #ifdef SSA_DEBUG
-        CLOG(INFO, "general_log") << "SSA: extending negative group size to " << new_size;
-        CLOG(INFO, "general_log") << " from " << curr_size << ".\n";
-        CLOG(INFO, "general_log") << "--------------------------------------------------------\n";
-        #endif
-
-        while (curr_size < new_size) {
-
-            nGroups.push_back(new CRGroup(-curr_size));
-            curr_size ++;
-        }
-    }
-
-    ////////////////////////////////////////////////////////////////////////////////
+    void _updateElement(uint idx);
 
-    inline void _extendGroup(CRGroup* group, uint size = 1024) {
-        #ifdef SSA_DEBUG
-        CLOG(INFO, "general_log") << "SSA: extending group storage\n";
-        CLOG(INFO, "general_log") << "current capacity: " << group->capacity << "\n";
-        #endif
-
-        group->capacity += size;
-        group->indices = (KProc**)realloc(group->indices,
-                                          sizeof(KProc*) * group->capacity);
-        if (group->indices == NULL) {
-            SysErrLog("DirectCR: unable to allocate memory for SSA group.");
-        }
-        #ifdef SSA_DEBUG
-        CLOG(INFO, "general_log") << "capacity after extending: " << group->capacity << "\n";
-        CLOG(INFO, "general_log") << "--------------------------------------------------------\n";
-        #endif
+    inline void _updateElement(KProc* kp) {
+        _updateElement(kp->schedIDX());
     }
 
-    ////////////////////////////////////////////////////////////////////////////////
+    /// Compute the rate of kproc \a idx, dispatching on its type tag.
+    double _kprocRate(uint idx);
 
-    void _updateElement(KProc* kp);
+    /// Flatten the per-kproc update vectors into the CSR dependency table.
+    void _setupDepCSR();
 
     inline void _updateSum() {
-        #ifdef SSA_DEBUG
-        CLOG(INFO, "general_log") << "update A0 from " << pA0 << " to ";
-        #endif
-
-        pA0 = 0.0;
-
-        uint n_neg_groups = nGroups.size();
-        uint n_pos_groups = pGroups.size();
-
-        for (uint i = 0; i < n_neg_groups; i++) {
-            pA0 += nGroups[i]->sum;
-        }
-
-        for (uint i = 0; i < n_pos_groups; i++) {
-            pA0 += pGroups[i]->sum;
-        }
-
-        #ifdef SSA_DEBUG
-        CLOG(INFO, "general_log") << pA0 << "\n";
-        #endif
+        pA0 = pCRSched.getA0();
     }
 
 
@@ -74,6 +74,8 @@ stex::Tri::Tri(uint idx, steps::solver::Patchdef * patchdef, double area,
 , pPoolCount(nullptr)
 , pPoolFlags(nullptr)
 , pKProcs()
+, pSpecDepOffset()
+, pSpecDepIdx()
 , pECharge(nullptr)
 , pECharge_last(nullptr)
 , pOCchan_timeintg(nullptr)
@@ -256,6 +258,7 @@ void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
             AssertLog(vdt != 0);
             pKProcs[j++] = vdt;
             tex->addKProc(vdt);
+            tex->addVDepKProc(vdt);
         }
 
         uint nvdsreacs = patchdef()->countVDepSReacs();
@@ -266,6 +269,7 @@ void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
             AssertLog(vdsr != 0);
             pKProcs[j++] = vdsr;
             tex->addKProc(vdsr);
+            tex->addVDepKProc(vdsr);
         }
 
         uint nghkcurrs = patchdef()->countGHKcurrs();
@@ -276,12 +280,36 @@ void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
             AssertLog(ghk != 0);
             pKProcs[j++] = ghk;
             tex->addKProc(ghk);
+            tex->addVDepKProc(ghk);
         }
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void stex::Tri::setupSpecDeps()
+{
+    uint nspecs = patchdef()->countSpecs();
+    pSpecDepOffset.assign(1, 0);
+    pSpecDepIdx.clear();
+
+    for (uint i = 0; i < nspecs; ++i)
+    {
+        uint gidx = patchdef()->specL2G(i);
+        uint first = pSpecDepIdx.size();
+
+        for (auto &kp: pKProcs)
+        {
+            if (kp->depSpecTri(gidx, this)) pSpecDepIdx.push_back(kp->schedIDX());
+        }
+
+        std::sort(pSpecDepIdx.begin() + first, pSpecDepIdx.end());
+        pSpecDepOffset.push_back(pSpecDepIdx.size());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void stex::Tri::reset()
 {
     uint nspecs = patchdef()->countSpecs();
@@ -34,6 +34,7 @@
 
 // STEPS headers.
 #include "steps/common.h"
+#include "steps/error.hpp"
 #include "steps/solver/patchdef.hpp"
 #include "steps/tetexact/kproc.hpp"
 #include "steps/solver/types.hpp"
@@ -117,6 +118,11 @@ public:
     ///
     void setupKProcs(stex::Tetexact * tex, bool efield = false);
 
+    /// Build the per-species lists of dependent kprocs -- to be called
+    /// once all kprocs have been created and given a schedule index.
+    ///
+    void setupSpecDeps();
+
     /// Set all pool flags and molecular populations to zero.
     void reset();
 
@@ -238,6 +244,13 @@ public:
     stex::VDepSReac * vdepsreac(uint lidx) const;
     stex::GHKcurr * ghkcurr(uint lidx) const;
 
+    /// Schedule indices of the kprocs in this triangle whose rate
+    /// depends on species lidx.
+    inline uint const * specDepBegin(uint lidx) const
+    { return pSpecDepIdx.data() + pSpecDepOffset[lidx]; }
+    inline uint const * specDepEnd(uint lidx) const
+    { return pSpecDepIdx.data() + pSpecDepOffset[lidx + 1]; }
+
     ////////////////////////////////////////////////////////////////////////
 
 private:
@@ -279,6 +292,10 @@ private:
     /// The kinetic processes.
     std::vector<stex::KProc *>          pKProcs;
 
+    /// Dependent kprocs of each species, indexed by local species index.
+    std::vector<uint>                   pSpecDepOffset;
+    std::vector<uint>                   pSpecDepIdx;
+
     /// For the EFIELD calculation. An integer storing the amount of
     /// elementary charge from inner tet to outer tet (positive if
     /// net flux is positive, negative if net flux is negative) for
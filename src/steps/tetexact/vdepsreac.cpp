@@ -52,11 +52,11 @@ stex::VDepSReac::VDepSReac(ssolver::VDepSReacdef * vdsrdef, stex::Tri * tri)
 : 
  pVDepSReacdef(vdsrdef)
 , pTri(tri)
-, pUpdVec()
 , pScaleFactor(0.0)
 {
     AssertLog(pVDepSReacdef != 0);
     AssertLog(pTri != 0);
+    type = KP_VDEPSREAC;
 
     if (pVDepSReacdef->surf_surf() == false)
     {
@@ -103,11 +103,6 @@ void stex::VDepSReac::checkpoint(std::fstream & cp_file)
     cp_file.write((char*)&pFlags, sizeof(uint));
 
     cp_file.write((char*)&pScaleFactor, sizeof(double));
-
-    cp_file.write((char*)&(crData.recorded), sizeof(bool));
-    cp_file.write((char*)&(crData.pow), sizeof(int));
-    cp_file.write((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.write((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -118,11 +113,6 @@ void stex::VDepSReac::restore(std::fstream & cp_file)
     cp_file.read((char*)&pFlags, sizeof(uint));
 
     cp_file.read((char*)&pScaleFactor, sizeof(double));
-
-    cp_file.read((char*)&(crData.recorded), sizeof(bool));
-    cp_file.read((char*)&(crData.pow), sizeof(int));
-    cp_file.read((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.read((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -130,10 +120,6 @@ void stex::VDepSReac::restore(std::fstream & cp_file)
 void stex::VDepSReac::reset()
 {
 
-    crData.recorded = false;
-    crData.pow = 0;
-    crData.pos = 0;
-    crData.rate = 0.0;
     resetExtent();
     setActive(true);
 }
@@ -246,7 +232,7 @@ void stex::VDepSReac::setupDeps()
         }
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdVecs.assign(1, std::vector<KProc*>(updset.begin(), updset.end()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -297,15 +283,11 @@ double stex::VDepSReac::rate(steps::tetexact::Tetexact * solver)
 
         double h_mu = 1.0;
 
-        uint * lhs_s_vec = pdef->vdepsreac_lhs_S_bgn(lidx);
         uint * cnt_s_vec = pTri->pools();
-        uint nspecs_s = pdef->countSpecs();
-        for (uint s = 0; s < nspecs_s; ++s)
+        for (auto const & sc : pdef->vdepsreac_lhs_S_sparse(lidx))
         {
-            uint lhs = lhs_s_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_s_vec[s];
+            uint lhs = sc.coeff;
+            uint cnt = cnt_s_vec[sc.lidx];
             if (lhs > cnt)
             {
                 return 0.0;
@@ -339,15 +321,11 @@ double stex::VDepSReac::rate(steps::tetexact::Tetexact * solver)
 
         if (pVDepSReacdef->inside())
         {
-            uint * lhs_i_vec = pdef->vdepsreac_lhs_I_bgn(lidx);
             uint * cnt_i_vec = pTri->iTet()->pools();
-            uint nspecs_i = pdef->countSpecs_I();
-            for (uint s = 0; s < nspecs_i; ++s)
+            for (auto const & sc : pdef->vdepsreac_lhs_I_sparse(lidx))
             {
-                uint lhs = lhs_i_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_i_vec[s];
+                uint lhs = sc.coeff;
+                uint cnt = cnt_i_vec[sc.lidx];
                 if (lhs > cnt)
                 {
                     return 0.0;
@@ -381,15 +359,11 @@ double stex::VDepSReac::rate(steps::tetexact::Tetexact * solver)
         }
         else if (pVDepSReacdef->outside())
         {
-            uint * lhs_o_vec = pdef->vdepsreac_lhs_O_bgn(lidx);
             uint * cnt_o_vec = pTri->oTet()->pools();
-            uint nspecs_o = pdef->countSpecs_O();
-            for (uint s = 0; s < nspecs_o; ++s)
+            for (auto const & sc : pdef->vdepsreac_lhs_O_sparse(lidx))
             {
-                uint lhs = lhs_o_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_o_vec[s];
+                uint lhs = sc.coeff;
+                uint cnt = cnt_o_vec[sc.lidx];
                 if (lhs > cnt)
                 {
                     return 0.0;
@@ -431,7 +405,7 @@ double stex::VDepSReac::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::VDepSReac::apply(steps::rng::RNG * rng, double dt, double simtime)
+uint stex::VDepSReac::apply(steps::rng::RNG * rng, double dt, double simtime)
 {
     // NOTE: simtime is BEFORE the update has taken place
 
@@ -460,12 +434,11 @@ std::vector<stex::KProc*> const & stex::VDepSReac::apply(steps::rng::RNG * rng,
     }
 
     // Update triangle pools.
-    uint nspecs_s = pdef->countSpecs();
-    for (uint s = 0; s < nspecs_s; ++s)
+    for (auto const & sc : pdef->vdepsreac_upd_S_sparse(lidx))
     {
+        uint s = sc.lidx;
         if (pTri->clamped(s) == true) continue;
-        int upd = upd_s_vec[s];
-        if (upd == 0) continue;
+        int upd = sc.coeff;
         int nc = static_cast<int>(cnt_s_vec[s]) + upd;
         AssertLog(nc >= 0);
         pTri->setCount(s, static_cast<uint>(nc));
@@ -475,14 +448,12 @@ std::vector<stex::KProc*> const & stex::VDepSReac::apply(steps::rng::RNG * rng,
     stex::WmVol * itet = pTri->iTet();
     if (itet != 0)
     {
-        int * upd_i_vec = pdef->vdepsreac_upd_I_bgn(lidx);
         uint * cnt_i_vec = itet->pools();
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
+        for (auto const & sc : pdef->vdepsreac_upd_I_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (itet->clamped(s) == true) continue;
-            int upd = upd_i_vec[s];
-            if (upd == 0) continue;
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_i_vec[s]) + upd;
             AssertLog(nc >= 0);
             itet->setCount(s, static_cast<uint>(nc));
@@ -493,14 +464,12 @@ std::vector<stex::KProc*> const & stex::VDepSReac::apply(steps::rng::RNG * rng,
     stex::WmVol * otet = pTri->oTet();
     if (otet != 0)
     {
-        int * upd_o_vec = pdef->vdepsreac_upd_O_bgn(lidx);
         uint * cnt_o_vec = otet->pools();
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
+        for (auto const & sc : pdef->vdepsreac_upd_O_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (otet->clamped(s) == true) continue;
-            int upd = upd_o_vec[s];
-            if (upd == 0) continue;
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_o_vec[s]) + upd;
             AssertLog(nc >= 0);
             otet->setCount(s, static_cast<uint>(nc));
@@ -509,7 +478,7 @@ std::vector<stex::KProc*> const & stex::VDepSReac::apply(steps::rng::RNG * rng,
 
     rExtent++;
 
-    return pUpdVec;
+    return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
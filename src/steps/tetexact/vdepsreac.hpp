@@ -87,10 +87,8 @@ public:
     void reset();
 
     double rate(steps::tetexact::Tetexact * solver = 0);
-    std::vector<KProc*> const & apply(steps::rng::RNG * rng, double dt, double simtime);
+    uint apply(steps::rng::RNG * rng, double dt, double simtime);
 
-    uint updVecSize() const
-    { return pUpdVec.size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -100,7 +98,6 @@ private:
 
     steps::solver::VDepSReacdef       * pVDepSReacdef;
     steps::tetexact::Tri              * pTri;
-    std::vector<KProc*>                   pUpdVec;
 
     // The information about the size of the comaprtment or patch, and the
     // dimensions. Important for scaling the constant.
@@ -51,10 +51,10 @@ stex::VDepTrans::VDepTrans(ssolver::VDepTransdef * vdtdef, stex::Tri * tri)
 : 
  pVDepTransdef(vdtdef)
 , pTri(tri)
-, pUpdVec()
 {
     AssertLog(pVDepTransdef != 0);
     AssertLog(pTri != 0);
+    type = KP_VDEPTRANS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -68,11 +68,6 @@ void stex::VDepTrans::checkpoint(std::fstream & cp_file)
 {
     cp_file.write((char*)&rExtent, sizeof(uint));
     cp_file.write((char*)&pFlags, sizeof(uint));
-
-    cp_file.write((char*)&(crData.recorded), sizeof(bool));
-    cp_file.write((char*)&(crData.pow), sizeof(int));
-    cp_file.write((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.write((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -81,11 +76,6 @@ void stex::VDepTrans::restore(std::fstream & cp_file)
 {
     cp_file.read((char*)&rExtent, sizeof(uint));
     cp_file.read((char*)&pFlags, sizeof(uint));
-
-    cp_file.read((char*)&(crData.recorded), sizeof(bool));
-    cp_file.read((char*)&(crData.pow), sizeof(int));
-    cp_file.read((char*)&(crData.pos), sizeof(unsigned));
-    cp_file.read((char*)&(crData.rate), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -93,10 +83,6 @@ void stex::VDepTrans::restore(std::fstream & cp_file)
 void stex::VDepTrans::reset()
 {
 
-    crData.recorded = false;
-    crData.pow = 0;
-    crData.pos = 0;
-    crData.rate = 0.0;
     setActive(true);
 }
 
@@ -115,7 +101,7 @@ void stex::VDepTrans::setupDeps()
             updset.insert(*k);
     }
 
-    pUpdVec.assign(updset.begin(), updset.end());
+    pUpdVecs.assign(1, std::vector<KProc*>(updset.begin(), updset.end()));
 
 }
 
@@ -153,7 +139,7 @@ double stex::VDepTrans::rate(steps::tetexact::Tetexact * solver)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<stex::KProc*> const & stex::VDepTrans::apply(steps::rng::RNG * rng, double dt, double simtime)
+uint stex::VDepTrans::apply(steps::rng::RNG * rng, double dt, double simtime)
 {
     ssolver::Patchdef * pdef = pTri->patchdef();
     uint lidx = pdef->vdeptransG2L(pVDepTransdef->gidx());
@@ -193,7 +179,7 @@ std::vector<stex::KProc*> const & stex::VDepTrans::apply(steps::rng::RNG * rng,
 
     rExtent++;
 
-    return pUpdVec;
+    return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,10 +88,8 @@ public:
 
     double rate(steps::tetexact::Tetexact * solver);
 
-    std::vector<KProc*> const & apply(steps::rng::RNG * rng, double dt,double simtime);
+    uint apply(steps::rng::RNG * rng, double dt,double simtime);
 
-    uint updVecSize() const
-    { return pUpdVec.size(); }
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -101,7 +99,6 @@ private:
 
     steps::solver::VDepTransdef       * pVDepTransdef;
     steps::tetexact::Tri              * pTri;
-    std::vector<KProc*>                 pUpdVec;
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -66,6 +66,8 @@ stex::WmVol::WmVol
 , pVol(vol)
 , pPoolCount(nullptr)
 , pPoolFlags(nullptr)
+, pSpecDepOffset()
+, pSpecDepIdx()
 , pKProcs()
 , pNextTris()
 {
@@ -143,6 +145,37 @@ void stex::WmVol::setupKProcs(stex::Tetexact * tex)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void stex::WmVol::setupSpecDeps()
+{
+    uint nspecs = compdef()->countSpecs();
+    pSpecDepOffset.assign(1, 0);
+    pSpecDepIdx.clear();
+
+    for (uint i = 0; i < nspecs; ++i)
+    {
+        uint gidx = compdef()->specL2G(i);
+        uint first = pSpecDepIdx.size();
+
+        for (auto &kp: pKProcs)
+        {
+            if (kp->depSpecTet(gidx, this)) pSpecDepIdx.push_back(kp->schedIDX());
+        }
+        for (auto &tri: pNextTris)
+        {
+            if (tri == nullptr) continue;
+            for (auto &kp: tri->kprocs())
+            {
+                if (kp->depSpecTet(gidx, this)) pSpecDepIdx.push_back(kp->schedIDX());
+            }
+        }
+
+        std::sort(pSpecDepIdx.begin() + first, pSpecDepIdx.end());
+        pSpecDepOffset.push_back(pSpecDepIdx.size());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void stex::WmVol::reset()
 {
     uint nspecs = compdef()->countSpecs();
@@ -105,6 +105,11 @@ public:
 
     virtual void setNextTri(stex::Tri *t);
 
+    /// Build the per-species lists of dependent kprocs -- to be called
+    /// once all kprocs have been created and given a schedule index.
+    ///
+    void setupSpecDeps();
+
     ////////////////////////////////////////////////////////////////////////
 
     virtual void reset();
@@ -167,6 +172,13 @@ public:
 
     stex::Reac * reac(uint lidx) const;
 
+    /// Schedule indices of the kprocs, in this volume and in its
+    /// neighbouring triangles, whose rate depends on species lidx.
+    inline uint const * specDepBegin(uint lidx) const
+    { return pSpecDepIdx.data() + pSpecDepOffset[lidx]; }
+    inline uint const * specDepEnd(uint lidx) const
+    { return pSpecDepIdx.data() + pSpecDepOffset[lidx + 1]; }
+
     ////////////////////////////////////////////////////////////////////////
 
 protected:
@@ -194,6 +206,10 @@ private:
     /// Flags on these pools -- stored as machine word flags.
     uint                              * pPoolFlags;
 
+    /// Dependent kprocs of each species, indexed by local species index.
+    std::vector<uint>                   pSpecDepOffset;
+    std::vector<uint>                   pSpecDepIdx;
+
     ////////////////////////////////////////////////////////////////////////
 
 };
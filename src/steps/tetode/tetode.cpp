@@ -60,6 +60,7 @@
 #include "third_party/cvode-2.6.0/src/sundials/sundials_types.h"     /* definition of type realtype */
 
 #include "steps/solver/efield/dVsolver.hpp"
+#include "steps/solver/efield/dVsolver_cg.hpp"
 #include "steps/solver/efield/efield.hpp"
 
 // logging
@@ -1470,6 +1471,9 @@ void stode::TetODE::_setupEField()
     case EF_DV_BDSYS:
         pEField = make_EField<dVSolverBanded>();
         break;
+    case EF_DV_CG:
+        pEField = make_EField<dVSolverCG>();
+        break;
     default:
         ArgErrLog("Unsupported E-Field solver.");
     }
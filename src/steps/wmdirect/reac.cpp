@@ -196,18 +196,14 @@ double swmd::Reac::rate() const
 
     // Prefetch some variables.
     ssolver::Compdef * cdef = pComp->def();
-    uint nspecs = cdef->countSpecs();
-    uint * lhs_vec = cdef->reac_lhs_bgn(cdef->reacG2L(defr()->gidx()));
     double * cnt_vec = cdef->pools();
 
     // Compute combinatorial part.
         double h_mu = 1.0;
-        for (uint pool = 0; pool < nspecs; ++pool)
+        for (auto const & sc : cdef->reac_lhs_sparse(cdef->reacG2L(defr()->gidx())))
         {
-            uint lhs = lhs_vec[pool];
-            if (lhs == 0) { continue;
-}
-            auto cnt = static_cast<uint>(cnt_vec[pool]);
+            uint lhs = sc.coeff;
+            auto cnt = static_cast<uint>(cnt_vec[sc.lidx]);
             if (lhs > cnt)
             {
                 h_mu = 0.0;
@@ -252,13 +248,11 @@ std::vector<uint> const & swmd::Reac::apply()
     ssolver::Compdef * cdef = pComp->def();
     double * local = cdef->pools();
     uint l_ridx = cdef->reacG2L(defr()->gidx());
-    int * upd_vec = cdef->reac_upd_bgn(l_ridx);
-    uint nspecs = cdef->countSpecs();
-    for (uint i=0; i < nspecs; ++i)
+    for (auto const & sc : cdef->reac_upd_sparse(l_ridx))
     {
+        uint i = sc.lidx;
         if (cdef->clamped(i) == true) continue;
-        int j = upd_vec[i];
-        if (j == 0) continue;
+        int j = sc.coeff;
         int nc = static_cast<int>(local[i]) + j;
         cdef->setCount(i, static_cast<double>(nc));
     }
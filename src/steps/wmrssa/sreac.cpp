@@ -339,15 +339,11 @@ double swmrssa::SReac::rate(steps::wmrssa::PropensityRSSA prssa)
 
     double h_mu = 1.0;
 
-    uint * lhs_s_vec = pdef->sreac_lhs_S_bgn(lidx);
     double * cnt_s_vec = pPatch->pools(prssa);
-    uint nspecs_s = pdef->countSpecs();
-    for (uint s = 0; s < nspecs_s; ++s)
+    for (auto const & sc : pdef->sreac_lhs_S_sparse(lidx))
     {
-        uint lhs = lhs_s_vec[s];
-        if (lhs == 0) { continue;
-}
-        auto cnt = static_cast<uint>(cnt_s_vec[s]);
+        uint lhs = sc.coeff;
+        auto cnt = static_cast<uint>(cnt_s_vec[sc.lidx]);
         if (lhs > cnt)
         {
             return 0.0;
@@ -381,15 +377,11 @@ double swmrssa::SReac::rate(steps::wmrssa::PropensityRSSA prssa)
 
     if (defsr()->inside())
     {
-        uint * lhs_i_vec = pdef->sreac_lhs_I_bgn(lidx);
         double * cnt_i_vec = pPatch->iComp()->pools(prssa);
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
+        for (auto const & sc : pdef->sreac_lhs_I_sparse(lidx))
         {
-            uint lhs = lhs_i_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = static_cast<double>(cnt_i_vec[s]);
+            uint lhs = sc.coeff;
+            uint cnt = static_cast<double>(cnt_i_vec[sc.lidx]);
             if (lhs > cnt)
             {
                 return 0.0;
@@ -423,15 +415,11 @@ double swmrssa::SReac::rate(steps::wmrssa::PropensityRSSA prssa)
     }
     else if (defsr()->outside())
     {
-        uint * lhs_o_vec = pdef->sreac_lhs_O_bgn(lidx);
         double * cnt_o_vec = pPatch->oComp()->pools(prssa);
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
+        for (auto const & sc : pdef->sreac_lhs_O_sparse(lidx))
         {
-            uint lhs = lhs_o_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = static_cast<double>(cnt_o_vec[s]);
+            uint lhs = sc.coeff;
+            uint cnt = static_cast<double>(cnt_o_vec[sc.lidx]);
             if (lhs > cnt)
             {
                 return 0.0;
@@ -477,15 +465,13 @@ std::vector<uint> const & swmrssa::SReac::apply()
     uint lidx = pdef->sreacG2L(defsr()->gidx());
 
     // Update patch pools.
-    int * upd_s_vec = pdef->sreac_upd_S_bgn(lidx);
     double * cnt_s_vec = pdef->pools();
-    uint nspecs_s = pdef->countSpecs();
 
-    for (uint s = 0; s < nspecs_s; ++s)
+    for (auto const & sc : pdef->sreac_upd_S_sparse(lidx))
     {
+        uint s = sc.lidx;
         if (pdef->clamped(s) == true) continue;
-        int upd = upd_s_vec[s];
-        if (upd == 0) continue;
+        int upd = sc.coeff;
         int nc = static_cast<int>(cnt_s_vec[s]) + upd;
         AssertLog(nc >= 0);
         pdef->setCount(s, static_cast<double>(nc));
@@ -502,14 +488,12 @@ std::vector<uint> const & swmrssa::SReac::apply()
     Comp * icomp = pPatch->iComp();
     if (icomp != 0)
     {
-        int * upd_i_vec = pdef->sreac_upd_I_bgn(lidx);
         double * cnt_i_vec = icomp->def()->pools();
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
+        for (auto const & sc : pdef->sreac_upd_I_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (icomp->def()->clamped(s) == true) continue;
-            int upd = upd_i_vec[s];
-            if (upd == 0) continue;
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_i_vec[s]) + upd;
             AssertLog(nc >= 0);
             icomp->def()->setCount(s, static_cast<double>(nc));
@@ -527,14 +511,12 @@ std::vector<uint> const & swmrssa::SReac::apply()
     Comp * ocomp = pPatch->oComp();
     if (ocomp != 0)
     {
-        int * upd_o_vec = pdef->sreac_upd_O_bgn(lidx);
         double * cnt_o_vec = ocomp->def()->pools();
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
+        for (auto const & sc : pdef->sreac_upd_O_sparse(lidx))
         {
+            uint s = sc.lidx;
             if (ocomp->def()->clamped(s) == true) continue;
-            int upd = upd_o_vec[s];
-            if (upd == 0) continue;
+            int upd = sc.coeff;
             int nc = static_cast<int>(cnt_o_vec[s]) + upd;
             AssertLog(nc >= 0);
             ocomp->def()->setCount(s, static_cast<double>(nc));
@@ -0,0 +1,56 @@
+#ifndef TEST_SUPPORT_KUHN_CUBE_HPP
+#define TEST_SUPPORT_KUHN_CUBE_HPP
+
+#include <vector>
+
+// Cube of n^3 cells of side h, each cut into the six Kuhn tetrahedra
+// sharing the cell diagonal so that the faces of neighbouring cells
+// match. The triangles of the z = 0 face are listed in tris.
+struct KuhnCube {
+    unsigned int n;
+    std::vector<double> verts;
+    std::vector<unsigned int> tets;
+    std::vector<unsigned int> tris;
+
+    explicit KuhnCube(unsigned int n_, double h = 1.0): n(n_) {
+        for (unsigned int i = 0; i <= n; ++i)
+            for (unsigned int j = 0; j <= n; ++j)
+                for (unsigned int k = 0; k <= n; ++k) {
+                    verts.push_back(i * h);
+                    verts.push_back(j * h);
+                    verts.push_back(k * h);
+                }
+
+        // one tetrahedron per order of stepping along the axes
+        const unsigned int axes[6][3] = {{0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}};
+        for (unsigned int i = 0; i < n; ++i)
+            for (unsigned int j = 0; j < n; ++j)
+                for (unsigned int k = 0; k < n; ++k)
+                    for (auto const & a : axes) {
+                        unsigned int c[3] = {i, j, k};
+                        tets.push_back(vertex(c[0], c[1], c[2]));
+                        for (unsigned int s = 0; s < 3; ++s) {
+                            c[a[s]] += 1;
+                            tets.push_back(vertex(c[0], c[1], c[2]));
+                        }
+                    }
+
+        for (unsigned int i = 0; i < n; ++i)
+            for (unsigned int j = 0; j < n; ++j) {
+                unsigned int tri0[3] = {vertex(i,j,0), vertex(i+1,j,0), vertex(i+1,j+1,0)};
+                unsigned int tri1[3] = {vertex(i,j,0), vertex(i,j+1,0), vertex(i+1,j+1,0)};
+                tris.insert(tris.end(), tri0, tri0+3);
+                tris.insert(tris.end(), tri1, tri1+3);
+            }
+    }
+
+    unsigned int vertex(unsigned int i, unsigned int j, unsigned int k) const {
+        return (i * (n + 1) + j) * (n + 1) + k;
+    }
+
+    unsigned int nverts() const { return verts.size()/3; }
+    unsigned int ntets() const { return tets.size()/4; }
+    unsigned int ntris() const { return tris.size()/3; }
+};
+
+#endif // ndef TEST_SUPPORT_KUHN_CUBE_HPP
@@ -1,9 +1,11 @@
+#include <algorithm>
 #include <iterator>
 #include <numeric>
 #include <cmath>
 
 #include "steps/math/point.hpp"
 #include "steps/math/bbox.hpp"
+#include "steps/math/bbox_grid.hpp"
 
 #include "gtest/gtest.h"
 
@@ -93,3 +95,33 @@ TEST(BoundingBox,clear) {
     ASSERT_EQ(b.min(),p[0]);
     ASSERT_EQ(b.max(),p[0]);
 }
+
+TEST(BoundingBoxGrid,candidates) {
+    std::vector<bounding_box> boxes;
+    for (int i=0; i<20; ++i) {
+        double x=0.1*i;
+        boxes.emplace_back(point3d(x,0,0),point3d(x+0.25,0.5,1));
+    }
+    bbox_grid grid(boxes);
+    ASSERT_FALSE(grid.empty());
+
+    std::vector<point3d> probes={{0,0,0},{0.37,0.2,0.5},{1.0,0.5,1.0},{2.15,0.25,0.1},{0.9,0.6,0.5}};
+    for (const auto &p: probes) {
+        std::vector<uint> expect;
+        for (uint i=0; i<boxes.size(); ++i) if (boxes[i].contains(p)) expect.push_back(i);
+
+        auto range=grid.candidates(p);
+        std::vector<uint> got(range.first,range.second);
+        ASSERT_TRUE(std::is_sorted(got.begin(),got.end()));
+        for (uint i: expect) ASSERT_TRUE(std::binary_search(got.begin(),got.end(),i));
+    }
+
+    bounding_box q(point3d(0.52,0.1,0.1),point3d(0.61,0.2,0.2));
+    std::vector<uint> got=grid.candidates(q);
+    ASSERT_TRUE(std::is_sorted(got.begin(),got.end()));
+    ASSERT_TRUE(std::adjacent_find(got.begin(),got.end())==got.end());
+    for (uint i: {3u,4u,5u,6u}) ASSERT_TRUE(std::binary_search(got.begin(),got.end(),i));
+
+    ASSERT_TRUE(grid.candidates(bounding_box(point3d(5,5,5),point3d(6,6,6))).empty());
+    ASSERT_TRUE(bbox_grid().candidates(q).empty());
+}
@@ -161,3 +161,55 @@ TYPED_TEST(LinSystemImplTest,Bw7) {
         EXPECT_NEAR(x0[i],x.get(i),std::abs(x[i])*relerr);
     }
 }
+
+TYPED_TEST(LinSystemImplTest,ReuseFactorization) {
+    typedef TypeParam Impl;
+    typedef typename Impl::matrix_type matrix_type;
+    typedef typename Impl::vector_type vector_type;
+
+    constexpr size_t n=6;
+    constexpr int h=1; // half-bandwidth
+
+    // tridiagonal, diagonally dominant
+    double A_full[n][n]={
+        {   4,  -1,   0,   0,   0,   0},
+        {  -1,   4,  -1,   0,   0,   0},
+        {   0,  -1,   4,  -1,   0,   0},
+        {   0,   0,  -1,   4,  -1,   0},
+        {   0,   0,   0,  -1,   4,  -1},
+        {   0,   0,   0,   0,  -1,   4}
+    };
+
+    Impl B(n,h);
+
+    matrix_type &A=B.A();
+    for (int i=0;i<n;++i) {
+        int jmin=std::max(0,i-h);
+        int jmax=std::min((int)n-1,i+h);
+
+        for (int j=jmin;j<=jmax;++j) 
+            A.set(i,j,A_full[i][j]);
+    }
+
+    B.factorize();
+
+    // back-substitute several right hand sides against one factorization
+    for (int r=0;r<3;++r) {
+        double x0[n];
+        for (int i=0;i<n;++i) x0[i]=1+i+r*n;
+
+        vector_type &b=B.b();
+        for (int i=0;i<n;++i) {
+            double y=0;
+            for (size_t j=0;j<n;++j) y+=A_full[i][j]*x0[j];
+            b.set(i,y);
+        }
+
+        B.backsolve();
+
+        const vector_type &x=B.x();
+        for (int i=0;i<n;++i) {
+            EXPECT_NEAR(x0[i],x.get(i),1e-12*std::abs(x0[i]));
+        }
+    }
+}
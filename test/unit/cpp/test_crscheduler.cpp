@@ -0,0 +1,105 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "steps/rng/create.hpp"
+#include "steps/rng/rng.hpp"
+#include "steps/solver/crscheduler.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace steps::solver;
+
+typedef CRScheduler<CRIndexStore> IndexScheduler;
+
+static double exact_sum(std::vector<double> const & rates) {
+    double sum = 0.0;
+    for (double r: rates) if (r > 1e-20) sum += r;
+    return sum;
+}
+
+TEST(CRScheduler, a0TracksRates) {
+    IndexScheduler cr;
+    std::vector<double> rates = {0.0, 3.5, 1e-3, 7e5, 0.75, 2.0};
+    for (uint i=0; i<rates.size(); ++i) cr.store().add();
+    for (uint i=0; i<rates.size(); ++i) cr.update(i, rates[i]);
+
+    ASSERT_NEAR(exact_sum(rates), cr.getA0(), 1e-9*exact_sum(rates));
+
+    // Same group, different group, and dropping out entirely.
+    rates[1] = 3.0; cr.update(1, rates[1]);
+    rates[4] = 40.0; cr.update(4, rates[4]);
+    rates[2] = 1e-30; cr.update(2, rates[2]);
+    ASSERT_NEAR(exact_sum(rates), cr.getA0(), 1e-9*exact_sum(rates));
+    ASSERT_FALSE(cr.store().recorded(2));
+    ASSERT_TRUE(cr.store().recorded(4));
+
+    for (uint i=0; i<rates.size(); ++i) cr.update(i, 0.0);
+    ASSERT_EQ(0.0, cr.getA0());
+}
+
+TEST(CRScheduler, resumBoundsDrift) {
+    IndexScheduler cr;
+    const uint n = 200;
+    std::vector<double> rates(n, 0.0);
+    for (uint i=0; i<n; ++i) cr.store().add();
+
+    std::unique_ptr<steps::rng::RNG> r(steps::rng::create("mt19937", 512));
+    r->initialize(13);
+    for (uint k=0; k<100000; ++k) {
+        uint i = r->get() % n;
+        rates[i] = std::ldexp(r->getUnfIE(), static_cast<int>(r->get() % 40) - 20);
+        cr.update(i, rates[i]);
+    }
+    ASSERT_NEAR(exact_sum(rates), cr.getA0(), 1e-9*exact_sum(rates));
+
+    cr.resum();
+    ASSERT_NEAR(exact_sum(rates), cr.getA0(), 1e-12*exact_sum(rates));
+}
+
+TEST(CRScheduler, selectionFollowsRates) {
+    IndexScheduler cr;
+    // Rates spread over several groups, one entry never selectable.
+    std::vector<double> rates = {1.0, 0.3, 5.0, 0.0, 0.01, 12.0, 3.0};
+    for (uint i=0; i<rates.size(); ++i) cr.store().add();
+    for (uint i=0; i<rates.size(); ++i) cr.update(i, rates[i]);
+
+    std::unique_ptr<steps::rng::RNG> r(steps::rng::create("mt19937", 512));
+    r->initialize(7);
+
+    const uint ndraws = 400000;
+    std::vector<uint> hits(rates.size(), 0);
+    for (uint k=0; k<ndraws; ++k) hits[cr.select(r.get())]++;
+
+    double a0 = exact_sum(rates);
+    ASSERT_EQ(0u, hits[3]);
+    for (uint i=0; i<rates.size(); ++i) {
+        double p = rates[i]/a0;
+        double sd = std::sqrt(ndraws*p*(1-p));
+        ASSERT_NEAR(ndraws*p, hits[i], 5*sd + 1);
+    }
+}
+
+namespace {
+struct Member {
+    CRKProcData crData;
+};
+}
+
+TEST(CRScheduler, memberStore) {
+    CRScheduler<CRMemberStore<Member>> cr;
+    std::vector<Member> m(3);
+    cr.update(&m[0], 2.0);
+    cr.update(&m[1], 6.0);
+    cr.update(&m[2], 0.25);
+    ASSERT_DOUBLE_EQ(8.25, cr.getA0());
+    ASSERT_TRUE(m[1].crData.recorded);
+    ASSERT_EQ(6.0, m[1].crData.rate);
+
+    cr.update(&m[1], 0.0);
+    ASSERT_FALSE(m[1].crData.recorded);
+
+    std::unique_ptr<steps::rng::RNG> r(steps::rng::create("mt19937", 512));
+    r->initialize(3);
+    for (uint k=0; k<1000; ++k) ASSERT_NE(&m[1], cr.select(r.get()));
+}
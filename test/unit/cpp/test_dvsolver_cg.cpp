@@ -0,0 +1,63 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "steps/solver/efield/efield.hpp"
+#include "steps/solver/efield/dVsolver.hpp"
+#include "steps/solver/efield/dVsolver_cg.hpp"
+
+#include "gtest/gtest.h"
+
+#include "kuhn_cube.hpp"
+
+using namespace steps::solver::efield;
+
+static std::vector<double> simulate(std::unique_ptr<EFieldSolver> impl, KuhnCube &g) {
+    EField ef(std::move(impl));
+    ef.initMesh(g.nverts(), &g.verts[0], g.ntris(), &g.tris[0],
+                g.ntets(), &g.tets[0], 1, "", 0.0);
+    ef.setSurfaceResistivity(0, 1.0, -0.065);
+
+    for (uint step = 0; step < 40; ++step) {
+        for (uint t = 0; t < g.ntris(); ++t)
+            ef.setTriI(t, (t % 3 == 0 ? 1.0e-12 : -0.5e-12));
+
+        if (step == 10) ef.setMembCapac(0, 0.02);
+        if (step == 20) ef.setVertVClamped(0, true);
+        if (step == 30) ef.setMembVolRes(0, 2.0);
+
+        ef.advance(step % 7 == 6 ? 2.0e-6 : 1.0e-5);
+    }
+
+    std::vector<double> v(g.nverts());
+    for (uint i = 0; i < g.nverts(); ++i) v[i] = ef.getVertV(i);
+    return v;
+}
+
+TEST(dVSolverCG, MatchesBanded) {
+    KuhnCube g(4);
+
+    std::vector<double> v_band = simulate(std::unique_ptr<EFieldSolver>(new dVSolverBanded()), g);
+    std::vector<double> v_cg = simulate(std::unique_ptr<EFieldSolver>(new dVSolverCG(1.0e-12)), g);
+
+    ASSERT_EQ(v_band.size(), v_cg.size());
+    for (size_t i = 0; i < v_band.size(); ++i) {
+        EXPECT_NEAR(v_band[i], v_cg[i], 1.0e-9);
+    }
+}
+
+TEST(dVSolverCG, NoCurrentIsSteadyState) {
+    KuhnCube g(2);
+
+    EField ef(std::unique_ptr<EFieldSolver>(new dVSolverCG()));
+    ef.initMesh(g.nverts(), &g.verts[0], g.ntris(), &g.tris[0],
+                g.ntets(), &g.tets[0], 1, "", 0.0);
+    ef.setSurfaceResistivity(0, 1.0, -0.065);
+    ef.setMembPotential(0, -0.065);
+
+    for (uint step = 0; step < 5; ++step) ef.advance(1.0e-5);
+
+    for (uint i = 0; i < g.nverts(); ++i) {
+        EXPECT_DOUBLE_EQ(ef.getVertV(i), -0.065);
+    }
+}
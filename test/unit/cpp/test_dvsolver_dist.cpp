@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <mpi.h>
+
+#include "steps/error.hpp"
+#include "steps/solver/efield/efield.hpp"
+#include "steps/solver/efield/dVsolver.hpp"
+#include "steps/solver/efield/dVsolver_cg.hpp"
+#include "steps/solver/efield/dVsolver_dist.hpp"
+
+#include "gtest/gtest.h"
+
+#include "kuhn_cube.hpp"
+
+using namespace steps::solver::efield;
+
+int main(int argc, char **argv) {
+    int r=0;
+
+    ::testing::InitGoogleTest(&argc, argv);
+    MPI_Init(&argc,&argv);
+    r=RUN_ALL_TESTS();
+    MPI_Finalize();
+    return r;
+}
+
+// Owners striped along z for vertices and round robin for triangles,
+// so that every rank has both rows and triangles on the others.
+static void stripedPartition(KuhnCube const &g, int nranks,
+                             std::vector<int> &vert_hosts, std::vector<int> &tri_hosts) {
+    double zmax = g.verts[3*(g.nverts()-1) + 2];
+    vert_hosts.resize(g.nverts());
+    for (uint i = 0; i < g.nverts(); ++i)
+        vert_hosts[i] = std::min(nranks-1, static_cast<int>(g.verts[3*i+2] / (zmax+1) * nranks));
+    tri_hosts.resize(g.ntris());
+    for (uint t = 0; t < g.ntris(); ++t)
+        tri_hosts[t] = (nranks-1) - t % nranks;
+}
+
+// Every rank sets the currents of all triangles; for the distributed
+// solver only those of the rank's own triangles are used.
+static std::vector<double> simulate(std::unique_ptr<EFieldSolver> impl, KuhnCube &g,
+                                    dVSolverDist *dist = nullptr, bool repartition = false) {
+    EField ef(std::move(impl));
+    ef.initMesh(g.nverts(), &g.verts[0], g.ntris(), &g.tris[0],
+                g.ntets(), &g.tets[0], 1, "", 0.0);
+    ef.setSurfaceResistivity(0, 1.0, -0.065);
+
+    for (uint step = 0; step < 40; ++step) {
+        for (uint t = 0; t < g.ntris(); ++t)
+            ef.setTriI(t, (t % 3 == 0 ? 1.0e-12 : -0.5e-12));
+
+        if (step == 10) ef.setMembCapac(0, 0.02);
+        if (step == 20 && repartition) {
+            int nranks = 1;
+            MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+            std::vector<int> vert_hosts, tri_hosts;
+            stripedPartition(g, nranks, vert_hosts, tri_hosts);
+            dist->setPartition(vert_hosts, tri_hosts);
+        }
+        if (step == 30) ef.setMembVolRes(0, 2.0);
+
+        ef.advance(step % 7 == 6 ? 2.0e-6 : 1.0e-5);
+    }
+
+    if (dist) dist->gatherPotential();
+
+    std::vector<double> v(g.nverts());
+    for (uint i = 0; i < g.nverts(); ++i) v[i] = ef.getVertV(i);
+    return v;
+}
+
+TEST(dVSolverDist, MatchesBanded) {
+    KuhnCube g(4);
+
+    std::vector<double> v_band = simulate(std::unique_ptr<EFieldSolver>(new dVSolverBanded()), g);
+    dVSolverDist *dist = new dVSolverDist(MPI_COMM_WORLD, 1.0e-12);
+    std::vector<double> v_dist = simulate(std::unique_ptr<EFieldSolver>(dist), g, dist);
+
+    ASSERT_EQ(v_band.size(), v_dist.size());
+    for (size_t i = 0; i < v_band.size(); ++i) {
+        EXPECT_NEAR(v_band[i], v_dist[i], 1.0e-9);
+    }
+}
+
+TEST(dVSolverDist, MatchesBandedAfterRepartition) {
+    KuhnCube g(4);
+
+    std::vector<double> v_band = simulate(std::unique_ptr<EFieldSolver>(new dVSolverBanded()), g);
+    dVSolverDist *dist = new dVSolverDist(MPI_COMM_WORLD, 1.0e-12);
+    std::vector<double> v_dist = simulate(std::unique_ptr<EFieldSolver>(dist), g, dist, true);
+
+    for (size_t i = 0; i < v_band.size(); ++i) {
+        EXPECT_NEAR(v_band[i], v_dist[i], 1.0e-9);
+    }
+}
+
+// Reference solution from the serial CG solver, on every rank.
+TEST(dVSolverDist, MatchesCG) {
+    KuhnCube g(4);
+
+    std::vector<double> v_cg = simulate(std::unique_ptr<EFieldSolver>(new dVSolverCG(1.0e-12)), g);
+    for (bool repartition: {false, true}) {
+        dVSolverDist *dist = new dVSolverDist(MPI_COMM_WORLD, 1.0e-12);
+        std::vector<double> v_dist = simulate(std::unique_ptr<EFieldSolver>(dist), g, dist, repartition);
+
+        ASSERT_EQ(v_cg.size(), v_dist.size());
+        for (size_t i = 0; i < v_cg.size(); ++i) {
+            EXPECT_NEAR(v_cg[i], v_dist[i], 1.0e-9);
+        }
+    }
+}
+
+TEST(dVSolverDist, OwnsEveryVertexOnce) {
+    KuhnCube g(3);
+    int nranks = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+    std::vector<int> vert_hosts, tri_hosts;
+    stripedPartition(g, nranks, vert_hosts, tri_hosts);
+
+    dVSolverDist *dist = new dVSolverDist(MPI_COMM_WORLD);
+    dist->setPartition(vert_hosts, tri_hosts);
+    EField ef{std::unique_ptr<EFieldSolver>(dist)};
+    ef.initMesh(g.nverts(), &g.verts[0], g.ntris(), &g.tris[0],
+                g.ntets(), &g.tets[0], 1, "", 0.0);
+
+    int owned = dist->countOwnedVertices();
+    int total = 0;
+    MPI_Allreduce(&owned, &total, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    EXPECT_EQ(total, static_cast<int>(g.nverts()));
+}
+
+TEST(dVSolverDist, BadPartition) {
+    KuhnCube g(2);
+    int nranks = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+    dVSolverDist *dist = new dVSolverDist(MPI_COMM_WORLD);
+    dist->setPartition(std::vector<int>(g.nverts(), nranks), std::vector<int>(g.ntris(), 0));
+    EField ef{std::unique_ptr<EFieldSolver>(dist)};
+    ASSERT_THROW(ef.initMesh(g.nverts(), &g.verts[0], g.ntris(), &g.tris[0],
+                             g.ntets(), &g.tets[0], 1, "", 0.0), steps::ArgErr);
+
+    dVSolverDist *short_dist = new dVSolverDist(MPI_COMM_WORLD);
+    short_dist->setPartition(std::vector<int>(g.nverts() - 1, 0), std::vector<int>(g.ntris(), 0));
+    EField short_ef{std::unique_ptr<EFieldSolver>(short_dist)};
+    ASSERT_THROW(short_ef.initMesh(g.nverts(), &g.verts[0], g.ntris(), &g.tris[0],
+                                   g.ntets(), &g.tets[0], 1, "", 0.0), steps::ArgErr);
+}
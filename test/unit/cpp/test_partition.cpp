@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "steps/error.hpp"
+#include "steps/geom/tetmesh.hpp"
+#include "steps/geom/tetmesh_partition.hpp"
+
+#include "gtest/gtest.h"
+
+#include "kuhn_cube.hpp"
+
+using steps::tetmesh::Tetmesh;
+using steps::tetmesh::partitionMesh;
+
+struct PartitionTest: public ::testing::Test {
+    std::unique_ptr<Tetmesh> mesh;
+    static const unsigned int n = 8;
+
+    virtual void SetUp() {
+        KuhnCube cube(n);
+        mesh.reset(new Tetmesh(cube.verts, cube.tets));
+    }
+
+    unsigned int cutFaces(std::vector<unsigned int> const & hosts) const {
+        unsigned int cut = 0;
+        for (unsigned int t = 0; t < mesh->countTets(); ++t) {
+            const int * neighbs = mesh->_getTetTetNeighb(t);
+            for (unsigned int j = 0; j < 4; ++j)
+                if (neighbs[j] >= 0 && hosts[neighbs[j]] != hosts[t]) cut++;
+        }
+        return cut / 2;
+    }
+};
+
+TEST_F(PartitionTest,balance) {
+    const unsigned int nparts = 5;
+    std::vector<double> weights(mesh->countTets(), 1.0);
+    std::vector<unsigned int> tet_hosts;
+    std::map<unsigned int, unsigned int> tri_hosts;
+    partitionMesh(*mesh, weights, {}, nparts, tet_hosts, tri_hosts);
+
+    ASSERT_EQ(tet_hosts.size(), mesh->countTets());
+    std::vector<double> load(nparts, 0.0);
+    for (auto h : tet_hosts) {
+        ASSERT_LT(h, nparts);
+        load[h] += 1.0;
+    }
+    double mean = mesh->countTets() / double(nparts);
+    for (auto l : load) {
+        EXPECT_GT(l, 0.0);
+        EXPECT_LE(l, mean * 1.03 + 1.0);
+    }
+    EXPECT_TRUE(tri_hosts.empty());
+}
+
+TEST_F(PartitionTest,refinement_reduces_cut) {
+    std::vector<double> weights(mesh->countTets(), 1.0);
+    std::vector<unsigned int> rcb_hosts;
+    std::vector<unsigned int> tet_hosts;
+    std::map<unsigned int, unsigned int> tri_hosts;
+    partitionMesh(*mesh, weights, {}, 3, rcb_hosts, tri_hosts, 0.03, 0);
+    partitionMesh(*mesh, weights, {}, 3, tet_hosts, tri_hosts);
+
+    EXPECT_LE(cutFaces(tet_hosts), cutFaces(rcb_hosts));
+}
+
+TEST_F(PartitionTest,weighted) {
+    // all work in the lower half along x
+    std::vector<double> weights(mesh->countTets(), 0.0);
+    double total = 0.0;
+    for (unsigned int t = 0; t < mesh->countTets(); ++t) {
+        if (mesh->_getTetBarycenter(t)[0] < n / 2) weights[t] = 1.0;
+        total += weights[t];
+    }
+    std::vector<unsigned int> tet_hosts;
+    std::map<unsigned int, unsigned int> tri_hosts;
+    partitionMesh(*mesh, weights, {}, 2, tet_hosts, tri_hosts);
+
+    double load[2] = {0.0, 0.0};
+    for (unsigned int t = 0; t < mesh->countTets(); ++t) load[tet_hosts[t]] += weights[t];
+    EXPECT_NEAR(load[0], total / 2, total * 0.03 + 1.0);
+    EXPECT_NEAR(load[1], total / 2, total * 0.03 + 1.0);
+}
+
+TEST_F(PartitionTest,triangles_follow_tets) {
+    // a membrane of triangles across the middle plane of the cube
+    std::map<unsigned int, double> tri_weights;
+    for (unsigned int tri = 0; tri < mesh->countTris(); ++tri) {
+        const int * tets = mesh->_getTriTetNeighb(tri);
+        if (tets[0] < 0 || tets[1] < 0) continue;
+        if (std::abs(mesh->_getTriBarycenter(tri)[0] - n / 2) < 1e-3) tri_weights[tri] = 4.0;
+    }
+    ASSERT_FALSE(tri_weights.empty());
+
+    std::vector<double> weights(mesh->countTets(), 1.0);
+    std::vector<unsigned int> tet_hosts;
+    std::map<unsigned int, unsigned int> tri_hosts;
+    partitionMesh(*mesh, weights, tri_weights, 4, tet_hosts, tri_hosts);
+
+    ASSERT_EQ(tri_hosts.size(), tri_weights.size());
+    for (auto const & th : tri_hosts) {
+        const int * tets = mesh->_getTriTetNeighb(th.first);
+        EXPECT_EQ(th.second, tet_hosts[tets[0]]);
+        EXPECT_EQ(th.second, tet_hosts[tets[1]]);
+    }
+}
+
+TEST_F(PartitionTest,errors) {
+    std::vector<unsigned int> tet_hosts;
+    std::map<unsigned int, unsigned int> tri_hosts;
+    std::vector<double> weights(mesh->countTets(), 1.0);
+    std::vector<double> short_weights(mesh->countTets() - 1, 1.0);
+
+    ASSERT_THROW(partitionMesh(*mesh, short_weights, {}, 2, tet_hosts, tri_hosts), steps::ArgErr);
+    ASSERT_THROW(partitionMesh(*mesh, weights, {}, 0, tet_hosts, tri_hosts), steps::ArgErr);
+    ASSERT_THROW(partitionMesh(*mesh, weights, {{mesh->countTris(), 1.0}}, 2, tet_hosts, tri_hosts),
+                 steps::ArgErr);
+}
@@ -5,8 +5,13 @@
 #include <iostream>
 #include <iterator>
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <thread>
 
 #include "steps/rng/create.hpp"
+#include "steps/rng/r123.hpp"
 #include "steps/math/tools.hpp"
 
 #include "gtest/gtest.h"
@@ -172,3 +177,320 @@ TEST(rng, kendall_r123) {
     kendall_rank_correlation_check("r123", 1000, 0.95, 1, 2);
 }
 
+
+/// Restoring a checkpoint mid-buffer reproduces the original stream
+void checkpoint_check(const std::string &str, uint bufsize, uint n_skip, uint n_cmp) {
+    const std::string file_name = "test_rng_checkpoint_" + str + ".bin";
+
+    RNG* rng1 = create(str, bufsize);
+    rng1->initialize(4321u);
+    for (uint i=0; i<n_skip; ++i) rng1->get();
+
+    std::fstream out(file_name.c_str(), std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    rng1->checkpoint(out);
+    out.close();
+
+    std::vector<uint> expected(n_cmp);
+    for (auto &x: expected) x = rng1->get();
+
+    RNG* rng2 = create(str, bufsize);
+    rng2->initialize(1u);
+    std::fstream in(file_name.c_str(), std::fstream::in | std::fstream::binary);
+    rng2->restore(in);
+    in.close();
+    std::remove(file_name.c_str());
+
+    for (uint i=0; i<n_cmp; ++i) ASSERT_EQ(expected[i], rng2->get());
+
+    delete rng1;
+    delete rng2;
+}
+
+TEST(rng, checkpoint_mt) {
+    checkpoint_check("mt19937", 100, 37, 1000);
+}
+
+TEST(rng, checkpoint_r123) {
+    checkpoint_check("r123", 100, 37, 1000);
+}
+
+/// Reference Philox4x32-8 blocks from the scalar Random123 generator
+std::vector<uint> philox_reference(R123::r123_type::ctr_type ctr, R123::r123_type::key_type key, uint nblocks) {
+    R123::r123_type r;
+    std::vector<uint> out;
+    for (uint i = 0; i < nblocks; ++i) {
+        R123::r123_type::ctr_type rn = r(ctr, key);
+        out.insert(out.end(), rn.begin(), rn.end());
+        uint64_t x = ctr[0] + ((uint64_t)ctr[1] << 32) + 1;
+        ctr[0] = x;
+        ctr[1] = x >> 32;
+    }
+    return out;
+}
+
+TEST(rng, philox_lanes_r123) {
+    // the low counter word carries into the high one within the blocks
+    R123::r123_type::ctr_type ctr = {{0xfffffff5u, 7u, 0xdeadbeefu, 0x01234567u}};
+    R123::r123_type::key_type key = {{0x12345678u, 0x9abcdef0u}};
+    const uint nblocks = 45;
+    std::vector<uint> expected = philox_reference(ctr, key, nblocks + 1);
+
+    for (uint lanes: {1u, 8u, 16u}) {
+        R123::r123_type::ctr_type c = ctr;
+        std::vector<uint> out(4 * nblocks);
+        philoxFill(c, key, out.data(), nblocks, lanes);
+        for (uint i = 0; i < out.size(); ++i) ASSERT_EQ(expected[i], out[i]) << "lanes " << lanes << " number " << i;
+
+        // the counter continues after the last block
+        philoxFill(c, key, out.data(), 1, lanes);
+        for (uint i = 0; i < 4; ++i) ASSERT_EQ(expected[4 * nblocks + i], out[i]) << "lanes " << lanes;
+    }
+}
+
+TEST(rng, stream_r123) {
+    // a buffer size that is not a multiple of four uses part of a block
+    const uint bufsize = 1001;
+    const ulong seed = 0x123456789abcdefUL;
+    RNG* rng = create("r123", bufsize);
+    rng->initialize(seed);
+
+    R123::r123_type::ctr_type ctr = {{0u, 0u, (uint32_t)seed, (uint32_t)(seed >> 32)}};
+    R123::r123_type::key_type key = {{0u, 0u}};
+    const uint nfills = 3;
+    std::vector<uint> blocks = philox_reference(ctr, key, nfills * (bufsize / 4 + 1));
+    for (uint f = 0; f < nfills; ++f) {
+        for (uint i = 0; i < bufsize; ++i) {
+            ASSERT_EQ(blocks[f * 4 * (bufsize / 4 + 1) + i], rng->get()) << "fill " << f << " number " << i;
+        }
+    }
+
+    delete rng;
+}
+
+/// Chi-squared goodness of fit test of a continuous sampler, binned into
+/// equiprobable classes through its CDF
+template <typename Sampler, typename CDF>
+void continuous_check(const std::string &str, Sampler sample, CDF cdf, uint n_bins, uint n_sample, double level_confidence) {
+    RNG* rng = create(str, 1000);
+    rng->initialize(2468u);
+
+    std::vector<uint> vec_observed(n_bins, 0);
+    uint n_fine = 0;
+    for (uint n = 0; n < n_sample; ++n) {
+        double x = sample(*rng);
+        uint k = std::min(n_bins - 1, static_cast<uint>(n_bins * cdf(x)));
+        ++vec_observed[k];
+        // samples are not rounded to single precision
+        if (static_cast<double>(static_cast<float>(x)) != x) ++n_fine;
+    }
+
+    double expected = n_sample / static_cast<double>(n_bins);
+    double chi = 0.0;
+    for (uint k = 0; k < n_bins; ++k)
+        chi += (vec_observed[k] - expected) * (vec_observed[k] - expected) / expected;
+
+    double p_value = cdf_chi_squared_distribution(chi, n_bins - 1);
+    ASSERT_LE(p_value, level_confidence) << "FAILED Goodness of Fit test (chi-squared) with level of confidence "
+                                         << level_confidence << ": p_value is " << p_value << std::endl;
+#ifndef STEPS_LEGACY_RNG_SAMPLERS
+    ASSERT_GT(n_fine, n_sample * 0.99);
+#endif
+
+    delete rng;
+}
+
+double sample_std_exp(RNG &r) { return r.getStdExp(); }
+double sample_std_nrm(RNG &r) { return r.getStdNrm(); }
+double cdf_std_exp(double x) { return 1.0 - std::exp(-x); }
+double cdf_std_nrm(double x) { return cdf_normal_distribution(x); }
+
+TEST(rng, exponential_mt) {
+    continuous_check("mt19937", sample_std_exp, cdf_std_exp, 50, 200000, 0.999);
+}
+
+TEST(rng, exponential_r123) {
+    continuous_check("r123", sample_std_exp, cdf_std_exp, 50, 200000, 0.999);
+}
+
+TEST(rng, normal_mt) {
+    continuous_check("mt19937", sample_std_nrm, cdf_std_nrm, 50, 200000, 0.999);
+}
+
+TEST(rng, normal_r123) {
+    continuous_check("r123", sample_std_nrm, cdf_std_nrm, 50, 200000, 0.999);
+}
+
+TEST(rng, tails_r123) {
+    // beyond the base strip of the ziggurats: P(X > 7.69711) = 4.54e-4
+    // for the exponential and P(|X| > 3.44262) = 5.76e-4 for the normal
+    RNG* rng = create("r123", 1000);
+    rng->initialize(97531u);
+    const uint n_sample = 2000000;
+    uint n_exp = 0, n_nrm = 0;
+    double max_exp = 0.0;
+    for (uint n = 0; n < n_sample; ++n) {
+        double e = rng->getStdExp();
+        if (e > 7.697117470131487) ++n_exp;
+        max_exp = std::max(max_exp, e);
+        if (std::fabs(rng->getStdNrm()) > 3.442619855899) ++n_nrm;
+    }
+    const double p_exp = std::exp(-7.697117470131487);
+    const double p_nrm = 2.0 * (1.0 - cdf_normal_distribution(3.442619855899));
+    ASSERT_NEAR(n_exp, n_sample * p_exp, 5.0 * std::sqrt(n_sample * p_exp));
+    ASSERT_NEAR(n_nrm, n_sample * p_nrm, 5.0 * std::sqrt(n_sample * p_nrm));
+    ASSERT_GT(max_exp, 7.697117470131487);
+    delete rng;
+}
+
+#ifndef STEPS_LEGACY_RNG_SAMPLERS
+TEST(rng, samplers_concurrent) {
+    // generators in different threads give the same samples as when used alone
+    const uint n_sample = 100000;
+    std::vector<std::vector<double>> expected(4), got(4);
+    auto draw = [n_sample](ulong seed, std::vector<double> &out) {
+        RNG* rng = create(seed % 2 ? "r123" : "mt19937", 1000);
+        rng->initialize(seed);
+        out.resize(2 * n_sample);
+        for (uint n = 0; n < n_sample; ++n) {
+            out[2 * n] = rng->getStdExp();
+            out[2 * n + 1] = rng->getStdNrm();
+        }
+        delete rng;
+    };
+    for (uint t = 0; t < 4; ++t) draw(t + 11, expected[t]);
+
+    std::vector<std::thread> threads;
+    for (uint t = 0; t < 4; ++t) threads.emplace_back(draw, t + 11, std::ref(got[t]));
+    for (auto &th: threads) th.join();
+
+    for (uint t = 0; t < 4; ++t) ASSERT_TRUE(expected[t] == got[t]) << "thread " << t;
+}
+#endif
+
+/// Chi-squared goodness of fit test of getBinom() for larger numbers of
+/// trials, merging the classes with small expected counts at both ends
+void binomial_fit_check(const std::string &str, uint t, double p, uint n_sample, double level_confidence) {
+    RNG* rng = create(str, 1000);
+    rng->initialize(8642u);
+
+    std::map<uint, uint> observed;
+    for (uint n = 0; n < n_sample; ++n) {
+        uint x = rng->getBinom(t, p);
+        ASSERT_LE(x, t);
+        ++observed[x];
+    }
+
+    std::vector<double> expected, counts;
+    double acc_e = 0.0, acc_o = 0.0;
+    for (uint k = 0; k <= t; ++k) {
+        double lpmf = lgamma(t + 1.0) - lgamma(k + 1.0) - lgamma(t - k + 1.0);
+        if (p > 0.0) lpmf += k * std::log(p);
+        if (p < 1.0) lpmf += (t - k) * std::log1p(-p);
+        acc_e += n_sample * std::exp(lpmf);
+        auto it = observed.find(k);
+        if (it != observed.end()) acc_o += it->second;
+        if (acc_e >= 20.0) {
+            expected.push_back(acc_e);
+            counts.push_back(acc_o);
+            acc_e = acc_o = 0.0;
+        }
+    }
+    expected.back() += acc_e;
+    counts.back() += acc_o;
+
+    double chi = 0.0;
+    for (uint k = 0; k < expected.size(); ++k)
+        chi += (counts[k] - expected[k]) * (counts[k] - expected[k]) / expected[k];
+
+    double p_value = cdf_chi_squared_distribution(chi, expected.size() - 1);
+    ASSERT_LE(p_value, level_confidence) << "FAILED Goodness of Fit test (chi-squared) of binomial(" << t << ", " << p
+                                         << "): p_value is " << p_value << std::endl;
+    delete rng;
+}
+
+TEST(rng, binomial_fit_r123) {
+    // single trials
+    binomial_fit_check("r123", 3, 0.2, 100000, 0.999);
+    binomial_fit_check("r123", 16, 0.6, 100000, 0.999);
+    // inversion
+    binomial_fit_check("r123", 10, 0.0001, 100000, 0.999);
+    binomial_fit_check("r123", 50, 0.02, 100000, 0.999);
+    binomial_fit_check("r123", 1000, 0.025, 100000, 0.999);
+    binomial_fit_check("r123", 40, 0.9, 100000, 0.999);
+    // BTPE
+    binomial_fit_check("r123", 100, 0.4, 100000, 0.999);
+    binomial_fit_check("r123", 5000, 0.7, 100000, 0.999);
+    binomial_fit_check("r123", 200000, 0.005, 100000, 0.999);
+}
+
+TEST(rng, binomial_fit_mt) {
+    binomial_fit_check("mt19937", 20, 0.3, 100000, 0.999);
+    binomial_fit_check("mt19937", 300, 0.5, 100000, 0.999);
+}
+
+TEST(rng, binomial_edges) {
+    RNG* rng = create("r123", 1000);
+    rng->initialize(1u);
+    for (uint i = 0; i < 100; ++i) {
+        ASSERT_EQ(0u, rng->getBinom(0, 0.5));
+        ASSERT_EQ(0u, rng->getBinom(100, 0.0));
+        ASSERT_EQ(100u, rng->getBinom(100, 1.0));
+        ASSERT_EQ(4000000000u, rng->getBinom(4000000000u, 1.0));
+        ASSERT_LE(rng->getBinom(4000000000u, 0.5), 4000000000u);
+    }
+    delete rng;
+}
+
+TEST(rng, binomial_batch) {
+    const uint k = 1000;
+    std::vector<uint> n(k), out(k);
+    std::vector<double> p(k);
+    for (uint i = 0; i < k; ++i) {
+        n[i] = (i * 7919) % 2000;
+        p[i] = ((i * 104729) % 1000) / 999.0;
+    }
+
+    RNG* rng1 = create("r123", 1000);
+    RNG* rng2 = create("r123", 1000);
+    rng1->initialize(55u);
+    rng2->initialize(55u);
+    rng1->getBinomBatch(n.data(), p.data(), out.data(), k);
+    for (uint i = 0; i < k; ++i) ASSERT_EQ(rng2->getBinom(n[i], p[i]), out[i]) << "element " << i;
+
+    delete rng1;
+    delete rng2;
+}
+
+TEST(rng, stream_switch_r123) {
+    // a buffer size that is not a multiple of four uses part of a block
+    R123 rng(6);
+    rng.initialize(77u);
+    rng.get();
+
+    const ulong seed = 0xfedcba9876543210UL;
+    R123::r123_type::key_type key = {{0x76543210u, 0xfedcba98u}};
+    for (uint elem: {5u, 6u, 5u}) {
+        rng.setStream(seed, 3u, elem, 11u);
+        R123::r123_type::ctr_type ctr = {{0u, 3u, elem, 11u}};
+        std::vector<uint> blocks = philox_reference(ctr, key, 6);
+        // the buffer is refilled from the stream start; the tail of each
+        // partial fill is dropped
+        for (uint f = 0; f < 3; ++f) {
+            for (uint i = 0; i < 6; ++i) {
+                ASSERT_EQ(blocks[8 * f + i], rng.get()) << "element " << elem << " number " << 6 * f + i;
+            }
+        }
+    }
+}
+
+TEST(rng, stream_key_r123) {
+    const ulong seed = 0xfedcba9876543210UL;
+    R123::r123_type::key_type key = {{0x76543210u, 0xfedcba98u}};
+    for (uint id: {0u, 1u, 9u}) {
+        R123::r123_type::ctr_type ctr = {{id, 0u, 0u, 0u}};
+        std::vector<uint> block = philox_reference(ctr, key, 1);
+        ASSERT_EQ((static_cast<ulong>(block[1]) << 32) | block[0], R123::streamKey(seed, id)) << "id " << id;
+    }
+    ASSERT_NE(R123::streamKey(seed, 0u), R123::streamKey(seed, 1u));
+    ASSERT_NE(R123::streamKey(seed, 0u), R123::streamKey(seed + 1, 0u));
+}
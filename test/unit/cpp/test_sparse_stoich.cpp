@@ -0,0 +1,46 @@
+#include <vector>
+
+#include "steps/solver/sparse_stoich.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace steps::solver;
+
+TEST(SparseStoich, empty) {
+    SparseStoich st;
+    st.assign(static_cast<uint const *>(nullptr), 3, 5);
+    for (uint r=0; r<3; ++r) {
+        ASSERT_EQ(0u, st.row(r).size());
+        ASSERT_EQ(st.row(r).begin(), st.row(r).end());
+    }
+}
+
+TEST(SparseStoich, rows) {
+    // 3 rules over 6 species.
+    std::vector<int> dense = {
+         0, -1,  0,  0,  2,  0,
+         0,  0,  0,  0,  0,  0,
+         1,  0,  0,  0,  0, -2
+    };
+
+    SparseStoich st;
+    st.assign(dense.data(), 3, 6);
+
+    ASSERT_EQ(2u, st.row(0).size());
+    ASSERT_EQ(0u, st.row(1).size());
+    ASSERT_EQ(2u, st.row(2).size());
+
+    for (uint r=0; r<3; ++r) {
+        std::vector<int> rebuilt(6, 0);
+        uint last = 0;
+        bool first = true;
+        for (auto const & sc: st.row(r)) {
+            ASSERT_NE(0, sc.coeff);
+            if (!first) ASSERT_LT(last, sc.lidx);
+            last = sc.lidx;
+            first = false;
+            rebuilt[sc.lidx] = sc.coeff;
+        }
+        for (uint s=0; s<6; ++s) ASSERT_EQ(dense[r*6+s], rebuilt[s]);
+    }
+}
@@ -2,8 +2,14 @@
 #include <memory>
 #include <limits>
 #include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
 
+#include "steps/error.hpp"
 #include "steps/geom/tetmesh.hpp"
+#include "steps/math/tetrahedron.hpp"
+#include "steps/math/triangle.hpp"
 
 #include "gtest/gtest.h"
 
@@ -13,6 +19,8 @@
 #undef COORDS
 #undef TETINDICES
 
+#include "kuhn_cube.hpp"
+
 using steps::tetmesh::Tetmesh;
 using steps::math::point3d;
 
@@ -56,3 +64,130 @@ TEST_F(TetmeshTest,tri_norm) {
         ASSERT_DOUBLE_EQ(n[2],m[2]);
     }
 }
+
+struct GridMeshTest: public ::testing::Test {
+    std::unique_ptr<Tetmesh> mesh;
+    std::mt19937 rng{1234};
+
+    virtual void SetUp() {
+        KuhnCube cube(5);
+        mesh.reset(new Tetmesh(cube.verts,cube.tets));
+    }
+
+    std::vector<double> random_point(double lo,double hi) {
+        std::uniform_real_distribution<double> u(lo,hi);
+        return {u(rng),u(rng),u(rng)};
+    }
+
+    int linear_find(const std::vector<double> &p) const {
+        point3d x{p[0],p[1],p[2]};
+        for (uint t=0; t<mesh->countTets(); ++t) {
+            const uint *v=mesh->_getTet(t);
+            if (steps::math::tet_inside(mesh->_getVertex(v[0]),mesh->_getVertex(v[1]),
+                                        mesh->_getVertex(v[2]),mesh->_getVertex(v[3]),x)) return t;
+        }
+        return -1;
+    }
+};
+
+TEST_F(GridMeshTest,find_tets_by_points) {
+    std::vector<double> points;
+    for (int i=0; i<500; ++i) {
+        auto p=random_point(-0.5,5.5);
+        points.insert(points.end(),p.begin(),p.end());
+    }
+    // vertices and shared faces resolve to the first tetrahedron
+    for (double x: {0.0,1.0,2.5,5.0}) {
+        points.insert(points.end(),{x,x,x});
+        points.insert(points.end(),{x,1.0,0.5});
+    }
+
+    std::vector<int> found=mesh->findTetsByPoints(points);
+    ASSERT_EQ(found.size(),points.size()/3);
+    for (size_t i=0; i<found.size(); ++i) {
+        std::vector<double> p(points.begin()+3*i,points.begin()+3*i+3);
+        ASSERT_EQ(found[i],linear_find(p));
+        ASSERT_EQ(found[i],mesh->findTetByPoint(p));
+    }
+
+    std::vector<int> np(found.size());
+    mesh->findTetsByPointsNP(points.data(),points.size(),np.data(),np.size());
+    ASSERT_EQ(np,found);
+    ASSERT_THROW(mesh->findTetsByPointsNP(points.data(),points.size(),np.data(),np.size()-1),steps::ArgErr);
+}
+
+TEST_F(GridMeshTest,concurrent_first_queries) {
+    std::vector<double> points;
+    for (int i=0; i<200; ++i) {
+        auto p=random_point(-0.5,5.5);
+        points.insert(points.end(),p.begin(),p.end());
+    }
+    std::vector<double> centre{2.5,2.5,2.5};
+
+    // the grids are not built yet: every thread races to the first query
+    const int nthreads=4;
+    std::vector<std::vector<int>> found(nthreads);
+    std::vector<std::vector<uint>> near(nthreads);
+    std::vector<std::thread> threads;
+    for (int i=0; i<nthreads; ++i) {
+        threads.emplace_back([&,i]() {
+            found[i]=mesh->findTetsByPoints(points);
+            near[i]=mesh->getSurfTrisNearPoint(centre,3.0);
+        });
+    }
+    for (auto &t: threads) t.join();
+
+    for (int i=0; i<nthreads; ++i) {
+        ASSERT_EQ(found[i],mesh->findTetsByPoints(points));
+        ASSERT_EQ(near[i],mesh->getSurfTrisNearPoint(centre,3.0));
+    }
+}
+
+TEST_F(GridMeshTest,tets_in_regions) {
+    for (int r=0; r<20; ++r) {
+        auto a=random_point(-1,6), b=random_point(-1,6);
+        std::vector<double> lo{std::min(a[0],b[0]),std::min(a[1],b[1]),std::min(a[2],b[2])};
+        std::vector<double> hi{std::max(a[0],b[0]),std::max(a[1],b[1]),std::max(a[2],b[2])};
+        double radius=0.2*r;
+        point3d pa{a[0],a[1],a[2]}, pb{b[0],b[1],b[2]}, axis=pb-pa;
+
+        std::vector<uint> in_box, in_sphere, in_cyl;
+        for (uint t=0; t<mesh->countTets(); ++t) {
+            const point3d &c=mesh->_getTetBarycenter(t);
+            if (c[0]>=lo[0] && c[1]>=lo[1] && c[2]>=lo[2] && c[0]<=hi[0] && c[1]<=hi[1] && c[2]<=hi[2]) in_box.push_back(t);
+            if (steps::math::distance(c,pa)<=radius) in_sphere.push_back(t);
+            double s=dot(c-pa,axis)/dot(axis,axis);
+            if (s>=0 && s<=1 && steps::math::distance(c,pa+s*axis)<=radius*(1+1e-12)) in_cyl.push_back(t);
+        }
+
+        ASSERT_EQ(mesh->getTetsInBox(lo,hi),in_box);
+        ASSERT_EQ(mesh->getTetsInSphere(a,radius),in_sphere);
+        ASSERT_EQ(mesh->getTetsInCylinder(a,b,radius),in_cyl);
+    }
+    std::vector<double> short_point(2,0.0), p(3,1.0);
+    ASSERT_THROW(mesh->getTetsInSphere(short_point,1.0),steps::ArgErr);
+    ASSERT_THROW(mesh->getTetsInCylinder(p,p,1.0),steps::ArgErr);
+}
+
+TEST_F(GridMeshTest,surf_tris_near_point) {
+    std::vector<int> surf=mesh->getSurfTris();
+    for (int r=0; r<50; ++r) {
+        auto p=random_point(-1,6);
+        point3d x{p[0],p[1],p[2]};
+        double radius=0.1*(r%10);
+
+        std::vector<uint> expect;
+        for (int t: surf) {
+            const uint *v=mesh->_getTri(t);
+            const point3d &v0=mesh->_getVertex(v[0]), &v1=mesh->_getVertex(v[1]), &v2=mesh->_getVertex(v[2]);
+            point3d c=steps::math::tri_closest_point(v0,v1,v2,x);
+            // no vertex nor sampled point of the triangle is closer
+            ASSERT_LE(steps::math::distance(c,x),steps::math::distance(v0,x)+1e-12);
+            ASSERT_LE(steps::math::distance(c,x),steps::math::distance(v1,x)+1e-12);
+            ASSERT_LE(steps::math::distance(c,x),steps::math::distance(v2,x)+1e-12);
+            ASSERT_LE(steps::math::distance(c,x),steps::math::distance(steps::math::tri_ranpnt(v0,v1,v2,0.3,0.6),x)+1e-12);
+            if (steps::math::distance(c,x)<=radius) expect.push_back(t);
+        }
+        ASSERT_EQ(mesh->getSurfTrisNearPoint(p,radius),expect);
+    }
+}
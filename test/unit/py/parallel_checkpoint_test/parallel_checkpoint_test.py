@@ -0,0 +1,187 @@
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+# STEPS - STochastic Engine for Pathway Simulation
+# Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+# Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+# See the file AUTHORS for details.
+#
+# This file is part of STEPS.
+#
+# STEPS is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# STEPS is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+# Test that a checkpoint restores the same simulation on every process,
+# and that a bad checkpoint fails on every process without changing the
+# state
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+from __future__ import print_function
+import unittest2
+import os
+import tempfile
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+class CheckpointTestCase(unittest2.TestCase):
+    """ 
+    Test checkpoint() and restore() of TetOpSplit.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+        self.vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('F', self.vsys, lhs = [A], rhs = [B], kcst = 50.0)
+        smodel.Reac('R', self.vsys, lhs = [B], rhs = [A], kcst = 20.0)
+        smodel.Diff('D_A', self.vsys, A, 1e-11)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+        else:
+            self.mesh = meshio.importAbaqus('multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+
+        self.rng = srng.create('r123', 512)
+        self.rng.initialize(1000 + steps.mpi.rank)
+
+        self.tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        self.solver = solv.TetOpSplit(self.model, self.mesh, self.rng, solv.EF_NONE, self.tet_hosts)
+        ntets = self.mesh.ntets
+        for t in range(ntets):
+            if self.mesh.getTetBarycenter(t)[0] < -15e-6:
+                self.solver.setTetCount(t, 'A', 10)
+        self.tets = list(range(ntets))
+
+        # the same name on every process
+        self.cp_file = os.path.join(tempfile.gettempdir(),
+                                    'parallel_checkpoint_test_%d.cp' % steps.mpi.nhosts)
+
+    def tearDown(self):
+        for name in [self.cp_file, '%s.rank%d' % (self.cp_file, steps.mpi.rank)]:
+            if os.path.exists(name):
+                os.remove(name)
+        self.solver = None
+        self.model = None
+        self.mesh = None
+        self.rng = None
+
+    def state(self):
+        return (self.solver.getTime(),
+                self.solver.getBatchTetCounts(self.tets, 'A'),
+                self.solver.getBatchTetCounts(self.tets, 'B'),
+                self.solver.getCompReacExtent('comp', 'F'))
+
+    def testRoundTrip(self):
+        self.solver.run(0.01)
+        self.solver.checkpoint(self.cp_file)
+        saved = self.state()
+
+        self.solver.run(0.02)
+        continued = self.state()
+        self.assertNotEqual(continued[1], saved[1])
+
+        # the restored run takes the same path, random numbers included
+        self.solver.restore(self.cp_file)
+        self.assertEqual(self.state(), saved)
+        self.solver.run(0.02)
+        self.assertEqual(self.state(), continued)
+
+    def testRestoreOtherPartition(self):
+        self.solver.run(0.01)
+        self.solver.checkpoint(self.cp_file)
+        saved = self.state()
+        total = sum(saved[1]) + sum(saved[2])
+
+        # restore moves the elements back to the stored partition, both
+        # after a rebalance and in a solver started on another partition;
+        # kproc updates are ordered by address, so the continued runs
+        # only agree in distribution
+        self.solver.run(0.02)
+        self.solver.rebalance()
+        self.solver.restore(self.cp_file)
+        self.assertEqual(self.state(), saved)
+        self.solver.run(0.02)
+        state = self.state()
+        self.assertEqual(sum(state[1]) + sum(state[2]), total)
+        self.assertGreater(state[3], saved[3])
+
+        rng = srng.create('r123', 512)
+        rng.initialize(2000 + steps.mpi.rank)
+        reversed_hosts = [steps.mpi.nhosts - 1 - h for h in self.tet_hosts]
+        self.solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, reversed_hosts)
+        self.solver.restore(self.cp_file)
+        self.assertEqual(self.state(), saved)
+        self.solver.run(0.02)
+        state = self.state()
+        self.assertEqual(sum(state[1]) + sum(state[2]), total)
+        self.assertGreater(state[3], saved[3])
+
+    def testMissingFile(self):
+        self.solver.run(0.01)
+        saved = self.state()
+        with self.assertRaises(RuntimeError):
+            self.solver.restore(self.cp_file + '.missing')
+        self.assertEqual(self.state(), saved)
+
+    def testTruncatedFile(self):
+        self.solver.run(0.01)
+        self.solver.checkpoint(self.cp_file)
+        self.solver.run(0.02)
+        saved = self.state()
+
+        # only the last process has a bad file, all of them must fail
+        if steps.mpi.rank == steps.mpi.nhosts - 1:
+            name = '%s.rank%d' % (self.cp_file, steps.mpi.rank)
+            with open(name, 'r+b') as f:
+                f.truncate(os.path.getsize(name) - 1)
+        with self.assertRaises(RuntimeError):
+            self.solver.restore(self.cp_file)
+        self.assertEqual(self.state(), saved)
+
+        # the solver is still usable
+        self.solver.run(0.03)
+        self.assertGreater(self.solver.getCompReacExtent('comp', 'F'), saved[3])
+
+    def testOtherRNGBuffer(self):
+        self.solver.run(0.01)
+        self.solver.checkpoint(self.cp_file)
+
+        # only the last process has a generator of another buffer size
+        bufsize = 1024 if steps.mpi.rank == steps.mpi.nhosts - 1 else 512
+        rng = srng.create('r123', bufsize)
+        rng.initialize(2000 + steps.mpi.rank)
+        self.solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, self.tet_hosts)
+        self.solver.run(0.005)
+        saved = self.state()
+        with self.assertRaises(RuntimeError):
+            self.solver.restore(self.cp_file)
+        self.assertEqual(self.state(), saved)
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest2.makeSuite(CheckpointTestCase, "test"))
+    return unittest2.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest2.TextTestRunner(verbosity=2).run(suite())
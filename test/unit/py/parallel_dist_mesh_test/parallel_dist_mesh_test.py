@@ -0,0 +1,175 @@
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+# STEPS - STochastic Engine for Pathway Simulation
+# Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+# Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+# See the file AUTHORS for details.
+#
+# This file is part of STEPS.
+#
+# STEPS is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# STEPS is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+# Test TetOpSplit on a mesh of which each process only holds its own part
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+from __future__ import print_function
+import os
+import tempfile
+import unittest2
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+class DistMeshTestCase(unittest2.TestCase):
+    """
+    Test that a solver given only the part of the mesh of its process
+    behaves as one given the whole mesh.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+        R = smodel.Spec('R', self.model)
+        AR = smodel.Spec('AR', self.model)
+        self.vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('F', self.vsys, lhs = [A], rhs = [B], kcst = 10)
+        smodel.Reac('R', self.vsys, lhs = [B], rhs = [A], kcst = 10)
+        smodel.Diff('D_A', self.vsys, A, 1e-11)
+        smodel.Diff('D_B', self.vsys, B, 1e-12)
+        self.ssys = smodel.Surfsys('ssys', self.model)
+        smodel.SReac('bind', self.ssys, ilhs = [A], slhs = [R], srhs = [AR], kcst = 1e10)
+        smodel.SReac('unbind', self.ssys, slhs = [AR], irhs = [A], srhs = [R], kcst = 10)
+        smodel.Diff('D_R', self.ssys, R, 1e-13)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+        else:
+            self.mesh = meshio.importAbaqus('multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+        self.memb_tris = list(self.mesh.getSurfTris())
+        self.patch = sgeom.TmPatch('patch', self.mesh, self.memb_tris, self.tmcomp)
+        self.patch.addSurfsys('ssys')
+
+        self.tet_hosts = [int(h) for h in gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)]
+        self.tri_hosts = gd.partitionTris(self.mesh, self.tet_hosts, self.memb_tris)
+        self.part, self.part_tet_hosts, self.part_tri_hosts, self.tet_gidx, self.tri_gidx = \
+            gd.distributeMesh(self.mesh, self.tet_hosts, self.tri_hosts, steps.mpi.rank)
+
+        self.start = [t for t in range(self.mesh.ntets) if self.mesh.getTetBarycenter(t)[0] < -15e-6]
+        self.tets = list(range(self.mesh.ntets))
+
+        # the same name on every process
+        self.cp_file = os.path.join(tempfile.gettempdir(),
+                                    'parallel_dist_mesh_test_%d.cp' % steps.mpi.nhosts)
+
+    def tearDown(self):
+        for name in [self.cp_file, '%s.rank%d' % (self.cp_file, steps.mpi.rank)]:
+            if os.path.exists(name):
+                os.remove(name)
+        self.model = None
+        self.mesh = None
+        self.part = None
+
+    def createSolver(self, distributed):
+        rng = srng.create('r123', 512)
+        rng.initialize(1000 + steps.mpi.rank)
+        if distributed:
+            solver = solv.TetOpSplit(self.model, self.part, rng, solv.EF_NONE, self.part_tet_hosts,
+                                     self.part_tri_hosts, [], self.tet_gidx, self.tri_gidx)
+        else:
+            solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, self.tet_hosts, self.tri_hosts)
+        solver.setElementRNG(True, 7)
+        for t in self.start:
+            solver.setTetCount(t, 'A', 40)
+            solver.setTetCount(t, 'B', 10)
+        for t in self.memb_tris[::2]:
+            solver.setTriCount(t, 'R', 2)
+        return solver
+
+    def counts(self, solver):
+        return (solver.getBatchTetCounts(self.tets, 'A') + solver.getBatchTetCounts(self.tets, 'B'),
+                solver.getBatchTriCounts(self.memb_tris, 'R') + solver.getBatchTriCounts(self.memb_tris, 'AR'))
+
+    def testPartOfMesh(self):
+        self.assertLess(self.part.ntets, self.mesh.ntets)
+        self.assertEqual(len(self.part_tet_hosts), self.part.ntets)
+        self.assertEqual(len(self.tri_gidx), self.part.ntris)
+        owned = [t for t in self.tets if self.tet_hosts[t] == steps.mpi.rank]
+        self.assertTrue(set(owned).issubset(self.tet_gidx))
+
+    def testSameAsWholeMesh(self):
+        whole = self.createSolver(False)
+        dist = self.createSolver(True)
+        whole.run(0.05)
+        dist.run(0.05)
+        self.assertGreater(dist.getCompReacExtent('comp', 'F'), 0)
+        self.assertGreater(dist.getPatchSReacExtent('patch', 'bind'), 0)
+        self.assertEqual(self.counts(dist), self.counts(whole))
+        self.assertEqual(dist.getCompReacExtent('comp', 'F'), whole.getCompReacExtent('comp', 'F'))
+        self.assertEqual(dist.getCompCount('comp', 'A'), whole.getCompCount('comp', 'A'))
+        self.assertEqual(dist.getPatchCount('patch', 'AR'), whole.getPatchCount('patch', 'AR'))
+
+    def testElements(self):
+        dist = self.createSolver(True)
+        self.assertAlmostEqual(dist.getCompVol('comp'), self.tmcomp.getVol(), delta = 1e-6 * self.tmcomp.getVol())
+        self.assertAlmostEqual(dist.getPatchArea('patch'), self.patch.getArea(), delta = 1e-6 * self.patch.getArea())
+        for t in [0, self.mesh.ntets // 2, self.mesh.ntets - 1]:
+            self.assertAlmostEqual(dist.getTetVol(t), self.mesh.getTetVol(t))
+            dist.setTetCount(t, 'B', 123)
+            self.assertEqual(dist.getTetCount(t, 'B'), 123)
+        tri = self.memb_tris[-1]
+        dist.setTriCount(tri, 'AR', 5)
+        self.assertEqual(dist.getTriCount(tri, 'AR'), 5)
+
+        dist.setCompCount('comp', 'A', 1000)
+        self.assertAlmostEqual(dist.getCompCount('comp', 'A'), 1000)
+        dist.setPatchCount('patch', 'R', 500)
+        self.assertAlmostEqual(dist.getPatchCount('patch', 'R'), 500)
+
+    def testCheckpoint(self):
+        dist = self.createSolver(True)
+        dist.run(0.01)
+        dist.checkpoint(self.cp_file)
+        saved = self.counts(dist)
+        dist.run(0.02)
+        continued = self.counts(dist)
+        dist.restore(self.cp_file)
+        self.assertEqual(self.counts(dist), saved)
+        dist.run(0.02)
+        self.assertEqual(self.counts(dist), continued)
+
+    def testNotSupported(self):
+        dist = self.createSolver(True)
+        with self.assertRaises(RuntimeError):
+            dist.getROICount('roi', 'A')
+        with self.assertRaises(RuntimeError):
+            dist.rebalance()
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest2.makeSuite(DistMeshTestCase, "test"))
+    return unittest2.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest2.TextTestRunner(verbosity=2).run(suite())
@@ -0,0 +1,173 @@
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+# STEPS - STochastic Engine for Pathway Simulation
+# Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+# Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+# See the file AUTHORS for details.
+#
+# This file is part of STEPS.
+#
+# STEPS is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# STEPS is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+# Test that per-element random streams make runs independent of the
+# partition
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+from __future__ import print_function
+import unittest2
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+class ElementRNGTestCase(unittest2.TestCase):
+    """ 
+    Test that a diffusion-only model gives the same tet counts with all
+    tetrahedrons on one process as with the mesh split over all of them.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+        self.vsys = smodel.Volsys('vsys', self.model)
+        smodel.Diff('D_A', self.vsys, A, 1e-11)
+        smodel.Diff('D_B', self.vsys, B, 1e-12)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+        else:
+            self.mesh = meshio.importAbaqus('multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+
+    def runCounts(self, tet_hosts, nlevels):
+        # the solver generators differ between processes and partitions
+        rng = srng.create('r123', 512)
+        rng.initialize(1000 + steps.mpi.rank + 10 * max(tet_hosts))
+        solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, tet_hosts)
+        solver.setDiffusionRateLevels(nlevels)
+        solver.setElementRNG(True, 7)
+
+        for t in range(self.mesh.ntets):
+            if self.mesh.getTetBarycenter(t)[0] < -15e-6:
+                solver.setTetCount(t, 'A', 40)
+                solver.setTetCount(t, 'B', 10)
+        solver.run(0.1)
+        solver.run(0.2)
+        tets = range(self.mesh.ntets)
+        return solver.getBatchTetCounts(tets, 'A') + solver.getBatchTetCounts(tets, 'B')
+
+    def testPartitionIndependent(self):
+        one_rank = [0] * self.mesh.ntets
+        split = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        start = [t for t in range(self.mesh.ntets) if self.mesh.getTetBarycenter(t)[0] < -15e-6]
+        for nlevels in [1, 2]:
+            counts = self.runCounts(one_rank, nlevels)
+            self.assertEqual(self.runCounts(split, nlevels), counts)
+            self.assertEqual(sum(counts), 50 * len(start))
+            # A left the tets it started in
+            self.assertLess(sum(counts[t] for t in start), 40 * len(start))
+
+class ElementRNGReacTestCase(unittest2.TestCase):
+    """ 
+    Test that a model with volume and surface reactions gives the same
+    counts with all elements on one process, with the mesh split over all
+    of them, and after rebalancing from one process.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+        R = smodel.Spec('R', self.model)
+        AR = smodel.Spec('AR', self.model)
+        self.vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('F', self.vsys, lhs = [A], rhs = [B], kcst = 10)
+        smodel.Reac('R', self.vsys, lhs = [B], rhs = [A], kcst = 10)
+        smodel.Diff('D_A', self.vsys, A, 1e-11)
+        smodel.Diff('D_B', self.vsys, B, 1e-12)
+        self.ssys = smodel.Surfsys('ssys', self.model)
+        smodel.SReac('bind', self.ssys, ilhs = [A], slhs = [R], srhs = [AR], kcst = 1e10)
+        smodel.SReac('unbind', self.ssys, slhs = [AR], irhs = [A], srhs = [R], kcst = 10)
+        smodel.Diff('D_R', self.ssys, R, 1e-13)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+        else:
+            self.mesh = meshio.importAbaqus('multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+        self.memb_tris = list(self.mesh.getSurfTris())
+        self.patch = sgeom.TmPatch('patch', self.mesh, self.memb_tris, self.tmcomp)
+        self.patch.addSurfsys('ssys')
+        self.start = [t for t in range(self.mesh.ntets) if self.mesh.getTetBarycenter(t)[0] < -15e-6]
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+
+    def runCounts(self, tet_hosts, rebalance):
+        tri_hosts = gd.partitionTris(self.mesh, tet_hosts, self.memb_tris)
+        rng = srng.create('r123', 512)
+        rng.initialize(1000 + steps.mpi.rank + 10 * max(tet_hosts))
+        solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, tet_hosts, tri_hosts)
+        solver.setElementRNG(True, 7)
+
+        for t in self.start:
+            solver.setTetCount(t, 'A', 40)
+            solver.setTetCount(t, 'B', 10)
+        # placed by hand, setPatchCount draws from the solver generator
+        for t in self.memb_tris[::2]:
+            solver.setTriCount(t, 'R', 2)
+        solver.run(0.05)
+        if rebalance:
+            solver.rebalance()
+        solver.run(0.1)
+        self.assertGreater(solver.getCompReacExtent('comp', 'F'), 0)
+        self.assertGreater(solver.getPatchSReacExtent('patch', 'bind'), 0)
+        tets = range(self.mesh.ntets)
+        return (solver.getBatchTetCounts(tets, 'A') + solver.getBatchTetCounts(tets, 'B'),
+                solver.getBatchTriCounts(self.memb_tris, 'R') + solver.getBatchTriCounts(self.memb_tris, 'AR'))
+
+    def testPartitionIndependent(self):
+        one_rank = [0] * self.mesh.ntets
+        split = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        tet_counts, tri_counts = self.runCounts(one_rank, False)
+        self.assertEqual(self.runCounts(split, False), (tet_counts, tri_counts))
+        self.assertEqual(self.runCounts(one_rank, True), (tet_counts, tri_counts))
+        # molecules of A and B, bound or not, and of R are conserved
+        nbound = sum(tri_counts[len(self.memb_tris):])
+        self.assertEqual(sum(tet_counts) + nbound, 50 * len(self.start))
+        self.assertEqual(sum(tri_counts), 2 * len(self.memb_tris[::2]))
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest2.makeSuite(ElementRNGTestCase, "test"))
+    all_tests.append(unittest2.makeSuite(ElementRNGReacTestCase, "test"))
+    return unittest2.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest2.TextTestRunner(verbosity=2).run(suite())
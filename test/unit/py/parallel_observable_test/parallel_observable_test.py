@@ -0,0 +1,142 @@
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+# STEPS - STochastic Engine for Pathway Simulation
+# Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+# Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+# See the file AUTHORS for details.
+#
+# This file is part of STEPS.
+#
+# STEPS is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# STEPS is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+# Test that recorded observables hold the same counts as the batch
+# getters, both gathered on rank 0 and kept rank-local
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+from __future__ import print_function
+import unittest2
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+class ObservableTestCase(unittest2.TestCase):
+    """ 
+    Test addTetCountObservable, recordObservables and flushObservables
+    against getBatchTetCounts sampled at the same times.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+        self.vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('R', self.vsys, lhs = [A], rhs = [B], kcst = 5.0)
+        smodel.Diff('D_A', self.vsys, A, 1e-11)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+        else:
+            self.mesh = meshio.importAbaqus('multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+
+        self.rng = srng.create('r123', 512)
+        self.rng.initialize(1000 + steps.mpi.rank)
+
+        self.tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        self.solver = solv.TetOpSplit(self.model, self.mesh, self.rng, solv.EF_NONE, self.tet_hosts)
+        self.solver.setCompCount('comp', 'A', 20000)
+
+        # tets spread over all processes, out of mesh order and with a repeat
+        ntets = self.mesh.ntets
+        self.tets = list(range(ntets - 1, 0, -97)) + [3, 3]
+        self.obsA = self.solver.addTetCountObservable(self.tets, 'A')
+        self.obsB = self.solver.addTetCountObservable(self.tets, 'B')
+
+    def tearDown(self):
+        self.solver = None
+        self.model = None
+        self.mesh = None
+        self.rng = None
+
+    def record(self, times):
+        # reference counts from the collective getters at the same times
+        expected = {self.obsA: [], self.obsB: []}
+        for t in times:
+            self.solver.run(t)
+            self.solver.recordObservables()
+            expected[self.obsA].append(self.solver.getBatchTetCounts(self.tets, 'A'))
+            expected[self.obsB].append(self.solver.getBatchTetCounts(self.tets, 'B'))
+        return expected
+
+    def rows(self, data, width):
+        return [list(data[i:i + width]) for i in range(0, len(data), width)]
+
+    def testGatheredFlush(self):
+        expected = self.record([0.01, 0.02, 0.03])
+        self.solver.flushObservables()
+
+        self.assertEqual(self.solver.getObservableTimes(), [0.01, 0.02, 0.03])
+        for obs in [self.obsA, self.obsB]:
+            data = self.solver.getObservableData(obs)
+            if steps.mpi.rank == 0:
+                self.assertEqual(self.rows(data, len(self.tets)), expected[obs])
+            else:
+                self.assertEqual(len(data), 0)
+            self.assertEqual(len(self.solver.getObservableLocalData(obs)),
+                             3 * len(self.solver.getObservableLocalPositions(obs)))
+        self.assertNotEqual(expected[self.obsB][-1], [0.0] * len(self.tets))
+
+    def testRankLocalFlush(self):
+        gathered = self.record([0.01])
+        self.solver.flushObservables()
+        local = self.record([0.02, 0.03])
+        self.solver.flushObservables(True)
+
+        times = self.solver.getObservableTimes()
+        self.assertEqual(times, [0.01, 0.02, 0.03])
+        for obs in [self.obsA, self.obsB]:
+            pos = self.solver.getObservableLocalPositions(obs)
+            for k in pos:
+                self.assertEqual(self.tet_hosts[self.tets[k]], steps.mpi.rank)
+
+            # one row per time, the sample flushed to rank 0 reads zero
+            rows = self.rows(self.solver.getObservableLocalData(obs), len(pos))
+            self.assertEqual(len(rows), len(times))
+            if pos:
+                self.assertEqual(rows[0], [0.0] * len(pos))
+                self.assertEqual(rows[1:], [[row[k] for k in pos] for row in local[obs]])
+
+            data = self.solver.getObservableData(obs)
+            if steps.mpi.rank == 0:
+                rows = self.rows(data, len(self.tets))
+                self.assertEqual(len(rows), len(times))
+                self.assertEqual(rows[0], gathered[obs][0])
+                self.assertEqual(rows[1:], [[0.0] * len(self.tets)] * 2)
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest2.makeSuite(ObservableTestCase, "test"))
+    return unittest2.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest2.TextTestRunner(verbosity=2).run(suite())
@@ -0,0 +1,114 @@
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+# STEPS - STochastic Engine for Pathway Simulation
+# Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+# Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+# See the file AUTHORS for details.
+#
+# This file is part of STEPS.
+#
+# STEPS is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# STEPS is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+# Test that multi-rate diffusion agrees with single-rate diffusion
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+from __future__ import print_function
+import unittest2
+import math
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+NSEEDS = 3
+# tolerated relative difference of the means, on top of 3 standard errors
+TOLERANCE = 0.05
+
+class RateLevelsTestCase(unittest2.TestCase):
+    """ 
+    Test that a pure-diffusion model, with a species four times slower
+    than the other, spreads the same with one and with two rate levels.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+        self.vsys = smodel.Volsys('vsys', self.model)
+        smodel.Diff('D_A', self.vsys, A, 1e-11)
+        smodel.Diff('D_B', self.vsys, B, 2.5e-12)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+        else:
+            self.mesh = meshio.importAbaqus('multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+
+        ntets = self.mesh.ntets
+        self.start = [t for t in range(ntets) if self.mesh.getTetBarycenter(t)[0] < -15e-6]
+        self.rest = [t for t in range(ntets) if self.mesh.getTetBarycenter(t)[0] >= -15e-6]
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+
+    def runSpread(self, nlevels, seed):
+        rng = srng.create('r123', 512)
+        rng.initialize(100 * seed + steps.mpi.rank)
+        tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, tet_hosts)
+        solver.setDiffusionRateLevels(nlevels)
+        self.assertEqual(solver.getDiffusionRateLevels(), nlevels)
+
+        for t in self.start:
+            solver.setTetCount(t, 'A', 40)
+            solver.setTetCount(t, 'B', 40)
+        # several runs, so windows of the slow level are cut at run ends
+        for endtime in [0.1, 0.25, 0.4]:
+            solver.run(endtime)
+        self.assertEqual(solver.getCompCount('comp', 'B'), 40 * len(self.start))
+        return (sum(solver.getBatchTetCounts(self.rest, 'A')),
+                sum(solver.getBatchTetCounts(self.rest, 'B')))
+
+    def meanAndError(self, values):
+        n = len(values)
+        mean = sum(values) / float(n)
+        var = sum((v - mean) ** 2 for v in values) / float(n - 1)
+        return mean, math.sqrt(var / n)
+
+    def testTwoLevelsMatchOne(self):
+        single = [self.runSpread(1, s) for s in range(NSEEDS)]
+        multi = [self.runSpread(2, s) for s in range(NSEEDS)]
+        self.assertNotEqual(single, multi)
+        for i in range(2):
+            m1, e1 = self.meanAndError([res[i] for res in single])
+            m2, e2 = self.meanAndError([res[i] for res in multi])
+            self.assertGreater(m1, 0)
+            self.assertLessEqual(abs(m2 - m1), TOLERANCE * m1 + 3.0 * math.sqrt(e1 ** 2 + e2 ** 2))
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest2.makeSuite(RateLevelsTestCase, "test"))
+    return unittest2.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest2.TextTestRunner(verbosity=2).run(suite())
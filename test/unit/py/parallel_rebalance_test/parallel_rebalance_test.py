@@ -0,0 +1,249 @@
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+# STEPS - STochastic Engine for Pathway Simulation
+# Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+# Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+# See the file AUTHORS for details.
+#
+# This file is part of STEPS.
+#
+# STEPS is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# STEPS is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+# Test that rebalancing keeps the per-tetrahedron state: rate constants,
+# diffusion constants, active flags, extents and counts, and that
+# automatic rebalancing keeps the membrane potential and the recorded
+# observables
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+from __future__ import print_function
+import unittest2
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+DCST = 0.08e-10
+
+class RebalanceTestCase(unittest2.TestCase):
+    """ 
+    Test that rebalance() keeps the state set on single tetrahedrons,
+    both for tetrahedrons that move to another process and for those
+    that stay.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+
+        self.vsys = smodel.Volsys('vsys', self.model)
+
+        self.reac = smodel.Reac('R', self.vsys, lhs = [A], rhs = [B], kcst = 50.0)
+        self.diff = smodel.Diff('D_A', self.vsys, A, DCST)
+    
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../parallel_diff_sel_test/meshes/test_mesh.inp', 1e-7)[0]
+        else:
+            self.mesh = meshio.importAbaqus('parallel_diff_sel_test/meshes/test_mesh.inp', 1e-7)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+
+        self.rng = srng.create('r123', 512)
+        self.rng.initialize(1000 + steps.mpi.rank)
+        
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+        self.rng = None
+
+    def neighb(self, t):
+        return [n for n in self.mesh.getTetTetNeighb(t) if n >= 0][0]
+
+    def tetState(self, sim, tets):
+        return [(sim.getTetReacK(t, 'R'), sim.getTetReacActive(t, 'R'),
+                 sim.getTetDiffD(t, 'D_A'), sim.getTetDiffD(t, 'D_A', self.neighb(t)))
+                for t in tets]
+
+    def testRebalanceKeepsState(self):
+        ntets = self.mesh.ntets
+        tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        solver = solv.TetOpSplit(self.model, self.mesh, self.rng, solv.EF_NONE, tet_hosts)
+
+        # all the work on the first process, so that rebalancing moves tets
+        for t in range(ntets):
+            if tet_hosts[t] == 0:
+                solver.setTetCount(t, 'A', 20)
+
+        set_tets = range(0, ntets, 7)
+        for t in set_tets:
+            solver.setTetReacK(t, 'R', 1.0 + t)
+            solver.setTetDiffD(t, 'D_A', DCST * (2 + t % 5))
+            solver.setTetDiffD(t, 'D_A', DCST * 10, self.neighb(t))
+        inactive_tets = range(3, ntets, 11)
+        for t in inactive_tets:
+            solver.setTetReacActive(t, 'R', False)
+        tets = sorted(set(set_tets) | set(inactive_tets))
+
+        solver.run(2e-5)
+        state = self.tetState(solver, tets)
+        extent = solver.getCompReacExtent('comp', 'R')
+        count = solver.getCompCount('comp', 'A')
+
+        solver.rebalance()
+
+        self.assertEqual(solver.getRebalanceCount(), 1)
+        self.assertEqual(self.tetState(solver, tets), state)
+        self.assertEqual(solver.getCompReacExtent('comp', 'R'), extent)
+        self.assertEqual(solver.getCompCount('comp', 'A'), count)
+        self.assertNotEqual(extent, 0)
+
+        # the moved kprocs keep working
+        solver.run(4e-5)
+        self.assertGreaterEqual(solver.getCompReacExtent('comp', 'R'), extent)
+
+class AutoRebalanceTestCase(unittest2.TestCase):
+    """ 
+    Test automatic rebalancing of a model with a membrane potential and
+    recorded observables, the work all on the first process.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+        self.vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('F', self.vsys, lhs = [A], rhs = [B], kcst = 1e4)
+        smodel.Reac('R', self.vsys, lhs = [B], rhs = [A], kcst = 1e4)
+        smodel.Diff('D_A', self.vsys, A, 1e-12)
+
+        # a fixed number of open channels, so the potential is the same
+        # whatever the partition
+        self.ssys = smodel.Surfsys('ssys', self.model)
+        L = smodel.Chan('L', self.model)
+        Leak = smodel.ChanState('Leak', self.model, L)
+        smodel.OhmicCurr('OC_L', self.ssys, chanstate = Leak, erev = -65e-3, g = 1e-11)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+        else:
+            self.mesh = meshio.importAbaqus('multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+
+        ntets = self.mesh.ntets
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(ntets))
+        self.tmcomp.addVolsys('vsys')
+        self.memb_tris = list(self.mesh.getSurfTris())
+        self.patch = sgeom.TmPatch('patch', self.mesh, self.memb_tris, self.tmcomp)
+        self.patch.addSurfsys('ssys')
+        self.memb = sgeom.Memb('membrane', self.mesh, [self.patch])
+
+        self.tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        self.tri_hosts = gd.partitionTris(self.mesh, self.tet_hosts, self.memb_tris)
+        self.loaded = [t for t in range(ntets) if self.tet_hosts[t] == 0]
+        self.tets = list(range(ntets - 1, 0, -37))
+        self.verts = [self.mesh.getTri(t)[0] for t in self.memb_tris[::50]]
+        self.times = [1e-4 * (i + 1) for i in range(10)]
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+
+    def runModel(self, ef, interval):
+        rng = srng.create('r123', 512)
+        rng.initialize(1000 + steps.mpi.rank)
+        solver = solv.TetOpSplit(self.model, self.mesh, rng, ef, self.tet_hosts, self.tri_hosts)
+        solver.setEfieldDT(1e-5)
+        solver.setMembPotential('membrane', 0.0)
+        solver.setMembCapac('membrane', 0.01)
+        solver.setMembVolRes('membrane', 1.0)
+        solver.setPatchCount('patch', 'Leak', 700)
+        for t in self.loaded:
+            solver.setTetCount(t, 'A', 20)
+        if interval > 0:
+            solver.setRebalanceInterval(interval, 1.05)
+        obs = solver.addTetCountObservable(self.tets, 'A')
+
+        # the samples stay buffered across the rebalances
+        counts = []
+        potentials = []
+        for t in self.times:
+            solver.run(t)
+            solver.recordObservables()
+            counts.extend(solver.getBatchTetCounts(self.tets, 'A'))
+            potentials.append([solver.getVertV(v) for v in self.verts])
+        solver.flushObservables()
+        return solver, obs, counts, potentials
+
+    def testAutomaticRebalance(self):
+        for ef in [solv.EF_DEFAULT, solv.EF_DV_DIST]:
+            ref, ref_obs, ref_counts, ref_v = self.runModel(ef, 0)
+            solver, obs, counts, v = self.runModel(ef, 10)
+            self.assertEqual(ref.getRebalanceCount(), 0)
+            self.assertGreater(solver.getRebalanceCount(), 0)
+
+            self.assertEqual(solver.getObservableTimes(), self.times)
+            data = solver.getObservableData(obs)
+            if steps.mpi.rank == 0:
+                self.assertEqual(data, counts)
+                self.assertNotEqual(data, [0.0] * len(data))
+            self.assertEqual(len(solver.getObservableLocalData(obs)),
+                             len(self.times) * len(solver.getObservableLocalPositions(obs)))
+
+            # membrane potential follows the leak alone
+            for row, ref_row in zip(v, ref_v):
+                for x, y in zip(row, ref_row):
+                    self.assertAlmostEqual(x, y, delta = 1e-9)
+            self.assertLess(v[-1][0], -1e-3)
+
+    def testRankLocalObservables(self):
+        rng = srng.create('r123', 512)
+        rng.initialize(1000 + steps.mpi.rank)
+        solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, self.tet_hosts, self.tri_hosts)
+        for t in self.loaded:
+            solver.setTetCount(t, 'A', 20)
+        obs = solver.addTetCountObservable(self.tets, 'A')
+
+        solver.run(1e-4)
+        solver.recordObservables()
+        solver.flushObservables(True)
+        solver.run(2e-4)
+        solver.recordObservables()
+
+        # the buffered sample is flushed rank-local, then all rows move
+        solver.rebalance()
+        pos = solver.getObservableLocalPositions(obs)
+        self.assertEqual(solver.getObservableTimes(), [1e-4, 2e-4])
+        self.assertEqual(solver.getObservableLocalData(obs), [0.0] * (2 * len(pos)))
+
+        solver.run(3e-4)
+        solver.recordObservables()
+        expected = solver.getBatchTetCounts(self.tets, 'A')
+        solver.flushObservables(True)
+        self.assertEqual(solver.getObservableTimes(), [1e-4, 2e-4, 3e-4])
+        self.assertEqual(solver.getObservableLocalData(obs),
+                         [0.0] * (2 * len(pos)) + [expected[k] for k in pos])
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest2.makeSuite(RebalanceTestCase, "test"))
+    all_tests.append(unittest2.makeSuite(AutoRebalanceTestCase, "test"))
+    return unittest2.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest2.TextTestRunner(verbosity=2).run(suite())
@@ -0,0 +1,102 @@
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+# STEPS - STochastic Engine for Pathway Simulation
+# Copyright (C) 2007-2018 Okinawa Institute of Science and Technology, Japan.
+# Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#
+# See the file AUTHORS for details.
+#
+# This file is part of STEPS.
+#
+# STEPS is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# STEPS is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+# Test that thread-parallel diffusion gives the same result as a single
+# thread when diffusion draws from per-element random streams
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+from __future__ import print_function
+import unittest2
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+class DiffusionThreadsTestCase(unittest2.TestCase):
+    """ 
+    Test that the tet counts of a diffusion-only model do not depend on
+    the number of diffusion threads for a fixed seed.
+    """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        self.vsys = smodel.Volsys('vsys', self.model)
+        self.diff = smodel.Diff('D_A', self.vsys, A, 1e-11)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.importAbaqus('../multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+        else:
+            self.mesh = meshio.importAbaqus('multi_sys_test/meshes/brick_40_4_4_1400tets.inp', 1e-6)[0]
+
+        self.tmcomp = sgeom.TmComp('comp', self.mesh, range(self.mesh.ntets))
+        self.tmcomp.addVolsys('vsys')
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+
+    def runCounts(self, nthreads):
+        rng = srng.create('r123', 512)
+        rng.initialize(1000 + steps.mpi.rank)
+        tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, tet_hosts)
+        solver.setDiffusionThreads(nthreads)
+        solver.setElementRNG(True, 42)
+        self.assertEqual(solver.getDiffusionThreads(), nthreads)
+
+        # all molecules start at one end of the brick
+        for t in range(self.mesh.ntets):
+            if self.mesh.getTetBarycenter(t)[0] < -15e-6:
+                solver.setTetCount(t, 'A', 50)
+        solver.run(0.2)
+        return solver.getBatchTetCounts(range(self.mesh.ntets), 'A')
+
+    def testThreadsMatchSingleThread(self):
+        single = self.runCounts(1)
+        self.assertEqual(self.runCounts(4), single)
+        self.assertEqual(self.runCounts(3), single)
+        # the molecules did spread
+        self.assertNotEqual(single, [50 if self.mesh.getTetBarycenter(t)[0] < -15e-6 else 0
+                                     for t in range(self.mesh.ntets)])
+
+    def testInvalidThreads(self):
+        rng = srng.create('r123', 512)
+        rng.initialize(1000)
+        solver = solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE,
+                                 gd.binTetsByAxis(self.mesh, steps.mpi.nhosts))
+        with self.assertRaises(Exception):
+            solver.setDiffusionThreads(0)
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest2.makeSuite(DiffusionThreadsTestCase, "test"))
+    return unittest2.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest2.TextTestRunner(verbosity=2).run(suite())
@@ -25,9 +25,19 @@
 import unittest2
 import nose
 import parallel_diff_sel_test
+import parallel_rebalance_test
+import parallel_threads_test
+import parallel_element_rng_test
+import parallel_rate_levels_test
+import parallel_observable_test
+import parallel_checkpoint_test
+import parallel_dist_mesh_test
 
 def suite():
-    all_tests = [ parallel_diff_sel_test.suite() ]
+    all_tests = [ parallel_diff_sel_test.suite(), parallel_rebalance_test.suite(),
+                  parallel_threads_test.suite(), parallel_element_rng_test.suite(),
+                  parallel_rate_levels_test.suite(), parallel_observable_test.suite(),
+                  parallel_checkpoint_test.suite(), parallel_dist_mesh_test.suite() ]
     return unittest2.TestSuite(all_tests)
 
 if __name__ == "__main__":
@@ -0,0 +1,104 @@
+########################################################################
+
+# Stochastic reaction-diffusion with multi-rate diffusion.
+
+# AIMS: to verify that binning diffusions into rate levels
+# (setDiffusionRateLevels) reproduces the single-rate scheme when
+# molecules react during the longer windows of the slow levels.
+# Note:
+# 1. This is not validated against analytical result, but against
+# the mean of the single-rate simulation over the same seeds.
+# 2. B diffuses ten times slower than A, so with 4 levels it is applied
+# once every 8 update periods while it is consumed by the reaction.
+
+########################################################################
+from __future__ import print_function, absolute_import
+
+import steps.model as smod
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as ssolv
+
+import math
+import steps.utilities.meshio as meshio
+import steps.utilities.geom_decompose as gd
+########################################################################
+
+NSEEDS = 10
+ENDTIME = 0.02
+NLEVELS = 4
+# tolerated relative difference of the means, on top of 3 standard errors
+TOLERANCE = 0.05
+
+def get_model():
+    mdl  = smod.Model()
+    A = smod.Spec('A', mdl)
+    B = smod.Spec('B', mdl)
+    C = smod.Spec('C', mdl)
+    volsys = smod.Volsys('vsys',mdl)
+    R1 = smod.Reac('R1', volsys, lhs = [A, B], rhs = [C])
+    R1.setKcst(1e8)
+    R2 = smod.Reac('R2', volsys, lhs = [C], rhs = [A, B])
+    R2.setKcst(10)
+    D_A = smod.Diff('D_A', volsys, A)
+    D_A.setDcst(1e-11)
+    D_B = smod.Diff('D_B', volsys, B)
+    D_B.setDcst(1e-12)
+    D_C = smod.Diff('D_C', volsys, C)
+    D_C.setDcst(2e-12)
+    return mdl
+
+def get_geom():
+    if __name__== "__main__":
+        mesh_loc = "meshes/1x1x1.inp"
+    else:
+        mesh_loc = "validation_rd_mpi/meshes/1x1x1.inp"
+    mesh = meshio.importAbaqus(mesh_loc, 1e-6)[0]
+    comp = sgeom.TmComp("comp", mesh, range(mesh.ntets))
+    comp.addVolsys("vsys")
+    return mesh
+
+def run_sim(mdl, geom, nlevels, seed):
+    r = srng.create('r123', 1000)
+    r.initialize(1000 * seed + steps.mpi.rank)
+    tet_hosts = gd.binTetsByAxis(geom, steps.mpi.nhosts)
+    sim = ssolv.TetOpSplit(mdl, geom, r, ssolv.EF_NONE, tet_hosts)
+    sim.setDiffusionRateLevels(nlevels)
+
+    # A everywhere, B only in the half x < 0
+    left = [t for t in range(geom.ntets) if geom.getTetBarycenter(t)[0] < 0.0]
+    right = [t for t in range(geom.ntets) if geom.getTetBarycenter(t)[0] >= 0.0]
+    sim.setCompCount("comp", "A", 4000)
+    for t in left:
+        sim.setTetCount(t, "B", 2)
+
+    sim.run(ENDTIME)
+    return (sum(sim.getBatchTetCounts(left, "C")), sum(sim.getBatchTetCounts(right, "C")),
+            sum(sim.getBatchTetCounts(right, "B")))
+
+def mean_and_error(values):
+    n = len(values)
+    mean = sum(values) / float(n)
+    var = sum((v - mean) ** 2 for v in values) / float(n - 1)
+    return mean, math.sqrt(var / n)
+
+def validate(mdl, geom):
+    single = [run_sim(mdl, geom, 1, s) for s in range(NSEEDS)]
+    multi = [run_sim(mdl, geom, NLEVELS, s) for s in range(NSEEDS)]
+    for i, name in enumerate(["C left", "C right", "B right"]):
+        m1, e1 = mean_and_error([res[i] for res in single])
+        m2, e2 = mean_and_error([res[i] for res in multi])
+        if __name__== "__main__" and steps.mpi.rank == 0:
+            print(name, "single-rate: ", m1, "+-", e1, "multi-rate: ", m2, "+-", e2)
+        assert(abs(m2 - m1) <= TOLERANCE * m1 + 3.0 * math.sqrt(e1 ** 2 + e2 ** 2))
+
+def test_multirate_TetOpSplit():
+    "Multi-rate reaction-diffusion (TetOpSplit)"
+    if __name__== "__main__" and steps.mpi.rank == 0: print("Multi-rate reaction-diffusion (TetOpSplit)")
+    mdl = get_model()
+    geom = get_geom()
+    validate(mdl, geom)
+
+if __name__== "__main__":
+  test_multirate_TetOpSplit()